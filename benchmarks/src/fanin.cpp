@@ -0,0 +1,101 @@
+/*******************************************************************************
+FILE:			fanin.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This sender benchmarks the send-receive-reply when a number
+				of senders share the one receiver. numSenders children are
+				forked, each sending 1 KB messages round trip numPasses of
+				times. The receiver must therefore keep track of, and reply
+				to, numSenders different reply fifos.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const int numSenders = 8, numPasses = 100000, memLimit = 1024;
+
+static int sendLoop(int);
+
+int main(void)
+{
+pid_t childPid[numSenders];
+time_t total;
+struct timeval start, stop;
+int status, failed = 0;
+
+gettimeofday(&start, NULL);
+
+for (int i = 0; i < numSenders; ++i)
+	{
+	childPid[i] = fork();
+	if (childPid[i] == -1)
+		{
+		cout << "Failed fork" << endl;
+		exit(EXIT_FAILURE);
+		}
+	else if (childPid[i] == 0)
+		exit(sendLoop(i));
+	}
+
+for (int i = 0; i < numSenders; ++i)
+	{
+	if (waitpid(childPid[i], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status))
+		failed++;
+	}
+
+gettimeofday(&stop, NULL);
+
+if (failed)
+	{
+	cout << "fanin: " << failed << " senders failed" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+total = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+cout << "fanin: senders=" << numSenders << " time taken=" << total / (numSenders * numPasses);
+cout << " microseconds/KB/per pass" << endl;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	sendLoop(int)
+
+PURPOSE:	Each forked child becomes a separate SIMPL sender and sends
+			numPasses messages to the common receiver.
+
+RETURNS:	EXIT_SUCCESS/EXIT_FAILURE
+**********************************************************************/
+
+static int sendLoop(int num)
+{
+string sname("FANIN_" + to_string(num)), rname("RECEIVER"), host;
+char in[memLimit], out[memLimit]; // no need to set a message
+int receiverId;
+
+SRY noo(sname);
+
+if ((receiverId = noo.Locate(host, rname, memLimit, SIM_LOCAL)) == -1)
+	{
+	cout << "Can't locate receiver " << rname << endl;
+	return EXIT_FAILURE;
+	}
+
+for (int j = 0; j < numPasses; ++j)
+	if (noo.Send(receiverId, out, sizeof out, in, sizeof in) == -1)
+		{
+		cout << "Failed send" << endl;
+		return EXIT_FAILURE;
+		}
+
+return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*******************************************************************************
+FILE:			fanout.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This publisher benchmarks a publish/subscribe channel against
+				sending the same update to each of a number of receivers.
+				numSubscribers children are forked, each subscribing to the
+				channel, and numPasses 1 KB messages are published to them 
+				all at once. The time per message published is to be set 
+				against that of a Send() round trip times numSubscribers, as
+				measured by sender and fanin.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const int numSubscribers = 8, numPasses = 100000, memLimit = 1024;
+const unsigned depth = 4096;
+
+static int readLoop(int);
+
+int main(void)
+{
+pid_t childPid[numSubscribers];
+time_t total;
+struct timeval start, stop;
+char out[memLimit]; // no need to set a message
+void *sender;
+int channel, status, failed = 0;
+
+SRY nee("FANOUT");
+
+if ((channel = nee.OpenChannel("FANOUT_CHANNEL", memLimit, depth)) == -1)
+	{
+	cout << "Can't open channel" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+for (int i = 0; i < numSubscribers; ++i)
+	{
+	childPid[i] = fork();
+	if (childPid[i] == -1)
+		{
+		cout << "Failed fork" << endl;
+		exit(EXIT_FAILURE);
+		}
+	else if (childPid[i] == 0)
+		{
+		// the parent's SIM name and channel are not the child's
+		nee.closeSRYchild();
+		exit(readLoop(i));
+		}
+	}
+
+// each subscriber triggers once it has subscribed
+for (int i = 0; i < numSubscribers; ++i)
+	if (nee.Receive(&sender, NULL, 0) >= -1)
+		{
+		cout << "Failed receive" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+gettimeofday(&start, NULL);
+
+for (int j = 0; j < numPasses; ++j)
+	if (nee.Publish(channel, out, sizeof out) == -1)
+		{
+		cout << "Failed publish" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+gettimeofday(&stop, NULL);
+
+// the subscribers read to the end of the closed channel
+nee.CloseChannel(channel);
+
+for (int i = 0; i < numSubscribers; ++i)
+	{
+	if (waitpid(childPid[i], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status))
+		failed++;
+	}
+
+if (failed)
+	{
+	cout << "fanout: " << failed << " subscribers failed" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+total = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+cout << "fanout: subscribers=" << numSubscribers << " time taken=" << 
+										(double)total / numPasses;
+cout << " microseconds/KB/per publish" << endl;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	readLoop(int)
+
+PURPOSE:	Each forked child becomes a separate SIMPL subscriber and 
+			reads the channel until it is closed, reporting the messages
+			lost to overrun.
+
+RETURNS:	EXIT_SUCCESS/EXIT_FAILURE
+**********************************************************************/
+
+static int readLoop(int num)
+{
+string sname("FANOUT_" + to_string(num)), pname("FANOUT"), host;
+char in[memLimit];
+unsigned long count = 0;
+int publisherId, channel;
+
+SRY noo(sname);
+
+if ((channel = noo.Subscribe("FANOUT_CHANNEL")) == -1)
+	{
+	cout << "Can't subscribe to channel" << endl;
+	return EXIT_FAILURE;
+	}
+
+if ((publisherId = noo.Locate(host, pname, 0, SIM_LOCAL)) == -1 || 
+											noo.Trigger(publisherId, 1) == -1)
+	{
+	cout << "Can't trigger publisher " << pname << endl;
+	return EXIT_FAILURE;
+	}
+
+while (noo.ReadChannel(channel, in, sizeof in, NULL) != -1)
+	count++;
+
+cout << sname << ": read=" << count << " lost=" << noo.getChannelLost(channel);
+cout << endl;
+
+return (count + noo.getChannelLost(channel) == numPasses) ? 
+												EXIT_SUCCESS : EXIT_FAILURE;
+}
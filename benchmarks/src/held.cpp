@@ -0,0 +1,144 @@
+/*******************************************************************************
+FILE:			held.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This receiver benchmarks holding many senders reply-blocked
+				at once, as a gateway deferring its replies does. numSenders
+				children are forked, each sending one 1 KB message. All of
+				them are received before any is replied to. Each child then
+				sends a second message, and all of those are received and 
+				left unreplied until the receiver closes, which must fail 
+				every one of them rather than leave any blocked.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const int numSenders = 500, memLimit = 1024;
+
+static int holdLoop(int);
+
+int main(void)
+{
+vector<pid_t> childPid(numSenders);
+vector<void *> senderId(numSenders);
+time_t total;
+struct timeval start, stop;
+char buf[memLimit];
+int status, failed = 0;
+
+SRY *nee = new SRY("HELD");
+
+for (int i = 0; i < numSenders; ++i)
+	{
+	childPid[i] = fork();
+	if (childPid[i] == -1)
+		{
+		cout << "Failed fork" << endl;
+		exit(EXIT_FAILURE);
+		}
+	else if (childPid[i] == 0)
+		{
+		// the parent's SIM name is not the child's
+		nee->closeSRYchild();
+		exit(holdLoop(i));
+		}
+	}
+
+// every sender held reply-blocked before the first reply
+for (int i = 0; i < numSenders; ++i)
+	if (nee->Receive(&senderId[i], buf, sizeof buf) == -1)
+		{
+		cout << "Failed receive" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+gettimeofday(&start, NULL);
+
+for (int i = 0; i < numSenders; ++i)
+	if (nee->Reply(senderId[i], buf, sizeof buf) == -1)
+		{
+		cout << "Failed reply" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+gettimeofday(&stop, NULL);
+
+// held again, this time until closing
+for (int i = 0; i < numSenders; ++i)
+	if (nee->Receive(&senderId[i], buf, sizeof buf) == -1)
+		{
+		cout << "Failed receive" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+delete nee;
+
+for (int i = 0; i < numSenders; ++i)
+	{
+	if (waitpid(childPid[i], &status, 0) == -1 || !WIFEXITED(status) || 
+														WEXITSTATUS(status))
+		failed++;
+	}
+
+if (failed)
+	{
+	cout << "held: " << failed << " senders failed" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+total = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+cout << "held: senders=" << numSenders << " time taken=" << total * 1000 / numSenders;
+cout << " nanoseconds/reply" << endl;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	holdLoop(int)
+
+PURPOSE:	Each forked child becomes a separate SIMPL sender and sends
+			the receiver a message, which is replied to, and a second, 
+			which must fail when the receiver closes.
+
+RETURNS:	EXIT_SUCCESS/EXIT_FAILURE
+**********************************************************************/
+
+static int holdLoop(int num)
+{
+string sname("HELD_" + to_string(num)), rname("HELD"), host;
+char in[memLimit], out[memLimit]; // no need to set a message
+int receiverId;
+
+SRY noo(sname);
+
+if ((receiverId = noo.Locate(host, rname, memLimit, SIM_LOCAL)) == -1)
+	{
+	cout << "Can't locate receiver " << rname << endl;
+	return EXIT_FAILURE;
+	}
+
+if (noo.Send(receiverId, out, sizeof out, in, sizeof in) == -1)
+	{
+	cout << "Failed send" << endl;
+	return EXIT_FAILURE;
+	}
+
+if (noo.Send(receiverId, out, sizeof out, in, sizeof in) != -1)
+	{
+	cout << "Send not failed on close" << endl;
+	return EXIT_FAILURE;
+	}
+
+return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/*******************************************************************************
+FILE:			proxies.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This receiver benchmarks a storm of proxies. numTriggers
+				children are forked, each triggering numProxies proxies
+				drawn from numValues distinct values as fast as it can. The
+				proxies are first queued on the receive fifo one by one and
+				then coalesced in the receiver's proxy table, the receiver 
+				taking each distinct proxy once along with its count.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const int numTriggers = 4, numProxies = 250000, numValues = 8;
+
+static int triggerLoop(int);
+
+int main(void)
+{
+const char *pass[] = {"queued", "coalesced"};
+const int modes[] = {SIM_PROXY_QUEUE, SIM_PROXY_COALESCE};
+pid_t childPid[numTriggers];
+time_t total;
+struct timeval start, stop;
+SIM_OPTIONS opts;
+void *senderId;
+long counted;
+int rc, receives, status, failed;
+
+for (int p = 0; p < 2; p++)
+	{
+	if (initSimOptions(&opts) == -1)
+		{
+		cout << "Bad SIM options" << endl;
+		exit(EXIT_FAILURE);
+		}
+	opts.proxyMode = modes[p];
+
+	SRY nee("PROXIES", opts);
+
+	gettimeofday(&start, NULL);
+
+	for (int i = 0; i < numTriggers; ++i)
+		{
+		childPid[i] = fork();
+		if (childPid[i] == -1)
+			{
+			cout << "Failed fork" << endl;
+			exit(EXIT_FAILURE);
+			}
+		else if (childPid[i] == 0)
+			{
+			// the parent's SIM name is not the child's
+			nee.closeSRYchild();
+			exit(triggerLoop(i));
+			}
+		}
+
+	// a proxy of value 1 up, as many times as it was triggered
+	for (counted = 0, receives = 0; 
+						counted < (long)numTriggers * numProxies; receives++)
+		{
+		rc = nee.Receive(&senderId, NULL, 0);
+		if (rc > -2)
+			{
+			cout << "Failed receive" << endl;
+			exit(EXIT_FAILURE);
+			}
+		counted += nee.getProxyCount();
+		}
+
+	gettimeofday(&stop, NULL);
+
+	failed = 0;
+	for (int i = 0; i < numTriggers; ++i)
+		{
+		if (waitpid(childPid[i], &status, 0) == -1 || !WIFEXITED(status) || 
+														WEXITSTATUS(status))
+			failed++;
+		}
+	if (failed)
+		{
+		cout << "proxies: " << failed << " triggers failed" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+	total = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+	cout << "proxies " << pass[p] << ": triggers=" << counted << " receives=";
+	cout << receives << " time taken=" << total * 1000 / counted;
+	cout << " nanoseconds/proxy" << endl;
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	triggerLoop(int)
+
+PURPOSE:	Each forked child becomes a separate SIMPL program and 
+			triggers numProxies proxies at the common receiver.
+
+RETURNS:	EXIT_SUCCESS/EXIT_FAILURE
+**********************************************************************/
+
+static int triggerLoop(int num)
+{
+string sname("TRIGGER_" + to_string(num)), rname("PROXIES"), host;
+int receiverId;
+
+SRY noo(sname);
+
+if ((receiverId = noo.Locate(host, rname, 0, SIM_LOCAL)) == -1)
+	{
+	cout << "Can't locate receiver " << rname << endl;
+	return EXIT_FAILURE;
+	}
+
+for (int j = 0; j < numProxies; ++j)
+	if (noo.Trigger(receiverId, 1 + j % numValues) == -1)
+		{
+		cout << "Failed trigger" << endl;
+		return EXIT_FAILURE;
+		}
+
+return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/*******************************************************************************
+FILE:			stream.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This consumer benchmarks a one-way stream of small records. 
+				A child is forked to produce numRecords 16 byte records, 
+				first committing them one at a time by way of WriteStream() 
+				and then batch of them at a time by way of ReserveStream() 
+				and CommitStream(). The time per record read is to be set 
+				against that of a Send() round trip, as measured by sender.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const unsigned long numRecords = 10000000;
+const unsigned depth = 4096;
+const int batch = 64;
+
+struct Record
+	{
+	unsigned long seq;
+	unsigned long check;
+	};
+
+static int writeLoop(void);
+
+int main(void)
+{
+const char *pass[] = {"one at a time", "batches of 64"};
+pid_t childPid;
+time_t total;
+struct timeval start, stop;
+Record rec;
+int stream, status;
+
+SRY nee("STREAM");
+
+if ((stream = nee.OpenStream("STREAM_RING", sizeof rec, depth, 
+												SIM_STREAM_BLOCK, 0)) == -1)
+	{
+	cout << "Can't open stream" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+childPid = fork();
+if (childPid == -1)
+	{
+	cout << "Failed fork" << endl;
+	exit(EXIT_FAILURE);
+	}
+else if (childPid == 0)
+	{
+	// the parent's SIM name and stream are not the child's
+	nee.closeSRYchild();
+	exit(writeLoop());
+	}
+
+// timed from the first record read, the producer having connected
+for (int p = 0; p < 2; p++)
+	{
+	for (unsigned long i = 0; i < numRecords; i++)
+		{
+		if (nee.ReadStream(stream, &rec, sizeof rec) != sizeof rec || 
+															rec.seq != i)
+			{
+			cout << "Failed read" << endl;
+			exit(EXIT_FAILURE);
+			}
+		if (i == 0)
+			gettimeofday(&start, NULL);
+		}
+	gettimeofday(&stop, NULL);
+
+	total = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+	cout << "stream: " << pass[p] << " time taken=" << 
+							(double)total * 1000 / numRecords << " nanoseconds/record";
+	cout << " records/sec=" << (total ? numRecords * 1000000 / total : 0) << endl;
+	}
+
+if (waitpid(childPid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status))
+	{
+	cout << "stream: producer failed" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	writeLoop(void)
+
+PURPOSE:	The forked child becomes a separate SIMPL program and produces
+			numRecords records twice over, first committing each record
+			as it is written and then batch records at a time.
+
+RETURNS:	EXIT_SUCCESS/EXIT_FAILURE
+**********************************************************************/
+
+static int writeLoop()
+{
+Record *rec, out;
+int stream;
+
+SRY noo("STREAM_PRODUCER");
+
+if ((stream = noo.ConnectStream("STREAM_RING")) == -1)
+	{
+	cout << "Can't connect to stream" << endl;
+	return EXIT_FAILURE;
+	}
+
+for (unsigned long i = 0; i < numRecords; i++)
+	{
+	out.seq = i;
+	out.check = ~i;
+	if (noo.WriteStream(stream, &out, sizeof out) == -1)
+		{
+		cout << "Failed write" << endl;
+		return EXIT_FAILURE;
+		}
+	}
+
+for (unsigned long i = 0; i < numRecords; )
+	{
+	for (int j = 0; j < batch && i < numRecords; j++, i++)
+		{
+		if ((rec = (Record *)noo.ReserveStream(stream, sizeof out)) == NULL)
+			{
+			cout << "Failed reserve" << endl;
+			return EXIT_FAILURE;
+			}
+		rec->seq = i;
+		rec->check = ~i;
+		}
+
+	if (noo.CommitStream(stream) == -1)
+		{
+		cout << "Failed commit" << endl;
+		return EXIT_FAILURE;
+		}
+	}
+
+noo.CloseStream(stream);
+
+return EXIT_SUCCESS;
+}
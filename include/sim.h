@@ -14,15 +14,189 @@ AUTHOR:			John Collins
 
 #include <unistd.h> 	// for pid_t
 #include <stdbool.h>	// true/false
+#include <sys/uio.h>	// struct iovec
+#include <sim_array_defs.h>	// name lengths
+
+// trigger/reply notification transports
+typedef enum
+	{
+	SIM_FIFO = 0,		// 12 byte fifo messages; the default
+	SIM_FUTEX			// futex words in shared memory
+	} SIM_TRANSPORTS;
+
+// how Send(), ReadReply() and Receive() wait
+typedef enum
+	{
+	SIM_WAIT_BLOCK = 0,	// block in the kernel; the default
+	SIM_WAIT_SPIN,		// spin on shared memory for a while, then block;
+						// needs SIM_FUTEX
+	SIM_WAIT_POLL		// spin on shared memory, never block; needs SIM_FUTEX
+	} SIM_WAIT_POLICIES;
+
+// message shared memory backends
+typedef enum
+	{
+	SIM_SHM_SYSV = 0,	// SysV shmget(); the default
+	SIM_SHM_MEMFD		// memfd_create() and mmap(); receivers map it by way of
+						// /proc/<pid>/fd, so they must be of the same user and 
+						// the sender dumpable (not setuid)
+	} SIM_SHM_BACKENDS;
+
+// huge pages for message shared memory
+typedef enum
+	{
+	SIM_HUGE_NONE = 0,		// normal pages; the default
+	SIM_HUGE_TRANSPARENT,	// ask for transparent huge pages
+	SIM_HUGE_EXPLICIT		// reserved huge pages (hugetlb)
+	} SIM_HUGE_PAGES;
+
+// how a fifo transport receiver reads triggers and writes replies; io_uring
+// is opt in, having shown no measured win (see benchmark-explanation.txt)
+typedef enum
+	{
+	SIM_IO_SYSCALL = 0,	// a read()/write() per message; the default
+	SIM_IO_URING		// io_uring, with triggers read and replies written in batches
+	} SIM_IO_ENGINES;
+
+// order in which Receive() hands over waiting messages and proxies
+typedef enum
+	{
+	SIM_ORDER_FIFO = 0,	// order of arrival; the default
+	SIM_ORDER_PRIORITY,	// highest priority first, see SendPriority()
+	SIM_ORDER_INHERIT	// as above, the receiving thread taking on the priority
+	} SIM_RECEIVE_ORDERS;
+
+// priorities from 0 (the default) up, for SendPriority()/TriggerPriority()
+#define SIM_MAX_PRIORITY	99
+
+// how proxies triggered at a receiver reach it, see getProxyCount()
+typedef enum
+	{
+	SIM_PROXY_QUEUE = 0,	// each proxy queued on the receive fifo; the default
+	SIM_PROXY_COALESCE		// counted in shared memory, one wakeup per burst
+	} SIM_PROXY_MODES;
+
+// how Send() spreads messages over a receiver group, see Locate("@group")
+typedef enum
+	{
+	SIM_GROUP_ROUND_ROBIN = 0,	// each member in turn; the default
+	SIM_GROUP_LEAST_LOADED		// member with the fewest messages outstanding
+	} SIM_GROUP_POLICIES;
+
+// what a stream producer does about a full ring, see OpenStream()
+typedef enum
+	{
+	SIM_STREAM_BLOCK = 0,	// wait for the consumer to make room
+	SIM_STREAM_DROP_OLDEST,	// make room by dropping the oldest records unread
+	SIM_STREAM_FAIL			// fail the reserve or write
+	} SIM_STREAM_POLICIES;
+
+// sryLogLevel() levels, SIM_LOG_LEVEL being the highest logged; sryLog() errors
+typedef enum
+	{
+	SIM_LOG_ERROR = 0,
+	SIM_LOG_WARN,
+	SIM_LOG_INFO,	// the default SIM_LOG_LEVEL
+	SIM_LOG_DEBUG
+	} SIM_LOG_LEVELS;
+
+// optional settings for openSRYopts()/SRY::SRY, see initSimOptions()
+typedef struct
+	{
+	int transport;		// SIM_TRANSPORTS
+	int waitPolicy;		// SIM_WAIT_POLICIES
+	unsigned spinCount;	// spins before blocking with SIM_WAIT_SPIN
+	int shmBackend;		// SIM_SHM_BACKENDS
+	int hugePages;		// SIM_HUGE_PAGES
+	int populate;		// prefault message shared memory if nonzero
+	unsigned shmReserve;// message size to make shared memory for at once
+	unsigned shmGrowth;	// percent to grow shared memory by when outgrown
+	int ioEngine;		// SIM_IO_ENGINES
+	int receiveOrder;	// SIM_RECEIVE_ORDERS
+	int proxyMode;		// SIM_PROXY_MODES
+	const char *group;	// receiver group to join, NULL for none
+	int groupPolicy;	// SIM_GROUP_POLICIES
+	bool perThread;		// open an instance for the calling thread alone
+	} SIM_OPTIONS;
+
+// counts of waits on shared memory, see getWaitStats()
+typedef struct
+	{
+	unsigned long waits;	// number of waits for a message or a reply
+	unsigned long spins;	// spins over all of the waits
+	unsigned long spinHits;	// waits that ended while spinning
+	unsigned long blocks;	// waits that went on to block
+	} SIM_WAIT_STATS;
+
+// in place view of a received message, see ReceiveView()
+typedef struct
+	{
+	void *sender;		// sender id as returned by Receive()
+	void *data;			// the message in the sender's shared memory
+	unsigned nbytes;	// size of the message
+	unsigned ybytes;	// largest reply the sender will take in place
+	} SIM_VIEW;
+
+// message handler run by the Serve() workers or Reactor(), see Serve();
+// one run by a Serve() worker cannot Send()
+typedef int (*SIM_HANDLER)(SIM_VIEW *, void *);
+
+// fd or timer callback run by Reactor(), see ReactorFd() and ReactorTimer()
+typedef int (*SIM_CALLBACK)(int, void *);
+
+// a running SIM program as registered, see getSimNames()
+typedef struct
+	{
+	char name[MAX_SIM_NAME_LEN + 1];
+	pid_t pid;
+	} SIM_NAME;
 
 #ifdef __cplusplus
 #include <string>
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#endif
+
+// reply to an SRY::SendAsync(), to be had once by way of get() or co_await
+/*
+The reply is read into the buffer given to SendAsync(), which must stay put
+until then. get() waits for the reply if need be, as does the destructor 
+should the reply not have been had. A coroutine that co_awaits the reply is 
+resumed by SRY::ResumeAsync() once the reply is in.
+*/
+
+class SRY_ASYNC final
+{
+private:
+	int ticket;		// of the posted message, -1 once the reply is had
+	int result;		// reply size or -1
+
+	SRY_ASYNC(const SRY_ASYNC&) = delete;				// no copy
+	SRY_ASYNC &operator=(const SRY_ASYNC&) = delete;	// no assignment
+
+public:
+	explicit SRY_ASYNC(int);
+	SRY_ASYNC(SRY_ASYNC&&);
+
+	bool valid(void);
+	bool ready(void);
+	int get(void);
+#ifdef __cpp_impl_coroutine
+	bool await_ready(void);
+	void await_suspend(std::coroutine_handle<>);
+	int await_resume(void);
+#endif
+
+	~SRY_ASYNC();
+};
 
 // SRY class definition. 
 /*
-Note that the SRY class is designed to be a singleton class, one 
-instantiation to a customer!
-Also, it cannot (at this time) act as a base class.
+Note that the SRY class is designed to be a singleton class per process!
+The threads of a process share its SRY, one call at a time. A thread may 
+have an SRY of its own, with its own SIM name, fifos and shmem, by opening 
+it with the perThread option; it should then destroy that SRY before it 
+ends. Also, it cannot (at this time) act as a base class.
 */
 
 class SRY final // no base class
@@ -34,18 +208,71 @@ private:
 public:
 	SRY(const char *);			// default constructor, C string type
 	SRY(const std::string&);	// constructor, C++ string type
+	SRY(const char *, const SIM_OPTIONS&);			// with options
+	SRY(const std::string&, const SIM_OPTIONS&);	// with options
 
 	int Receive(void **, void *, unsigned);
 	int Reply(void *, void *, unsigned);
 	int ReplyError(void *);
+	int ReceiveView(SIM_VIEW *);
+	int ReplyInPlace(void *, unsigned);
+	int ReplyV(void *, const struct iovec *, int);
 	int returnProxy(int);
+	int getProxyCount(void);
 	int Locate(const std::string&, const std::string&, int, const int);
 	int Locate(const char *, const char *, int, const int);
 	int Send(int, void *, unsigned, void *, unsigned);
-	int PostMessage(int, void *, unsigned, unsigned);
+	int SendTimed(int, void *, unsigned, void *, unsigned, unsigned);
+	int ReceiveTimed(void **, void *, unsigned, unsigned);
+	int LocateTimed(const std::string&, const std::string&, int, const int, 
+																	unsigned);
+	int LocateTimed(const char *, const char *, int, const int, unsigned);
+	int SendV(int, const struct iovec *, int, const struct iovec *, int);
+	void *AcquireSendBuffer(unsigned);
+	int SendLoaned(int, unsigned, unsigned);
+	int Reserve(unsigned);
+	int PostMessage(int, void *, unsigned, unsigned); // a ticket, not 0
 	int ReadReply(void *);
+	int ReadTicketReply(int, void *);
+	int ReadAnyReply(int *, void *);
+	SRY_ASYNC SendAsync(int, void *, unsigned, void *, unsigned);
+	int ChkTicketReply(int);
+	int WaitReplies(const int *, int);
+#ifdef __cpp_impl_coroutine
+	int ResumeAsync(bool);
+#endif
 	int Trigger(int, int);
+	int SendPriority(int, void *, unsigned, void *, unsigned, int);
+	int TriggerPriority(int, int, int);
+	int SendKeyed(int, void *, unsigned, void *, unsigned, unsigned);
+	int OpenChannel(const std::string&, unsigned, unsigned);
+	int OpenChannel(const char *, unsigned, unsigned);
+	int Subscribe(const std::string&);
+	int Subscribe(const char *);
+	int Publish(int, const void *, unsigned);
+	int ReadChannel(int, void *, unsigned, unsigned long *);
+	int ChkChannel(int);
+	int ChannelFd(int);
+	long getChannelLost(int);
+	int CloseChannel(int);
+	int OpenStream(const std::string&, unsigned, unsigned, int, int);
+	int OpenStream(const char *, unsigned, unsigned, int, int);
+	int ConnectStream(const std::string&);
+	int ConnectStream(const char *);
+	void *ReserveStream(int, unsigned);
+	int CommitStream(int);
+	int WriteStream(int, const void *, unsigned);
+	int ReadStream(int, void *, unsigned);
+	int ChkStream(int);
+	long getStreamLost(int);
+	int CloseStream(int);
 	int Relay(void *, int);
+	int Serve(SIM_HANDLER, void *, int);
+	int ReactorMsg(SIM_HANDLER, void *, void *, unsigned);
+	int ReactorFd(int, SIM_CALLBACK, void *);
+	int ReactorTimer(unsigned, bool, SIM_CALLBACK, void *);
+	int ReactorCancel(int);
+	int Reactor(void);
 	int getSenderName(void *, std::string&);
 	pid_t getSenderPid(void *);
 	int getSenderShmemSize(void *);
@@ -58,6 +285,7 @@ public:
 	void simRcopy(void *, void *, unsigned);
 	void simScopy(void *, unsigned);
 	int closeSRYchild(void);
+	int getWaitStats(SIM_WAIT_STATS *, bool);
 
 	~SRY();	// destructor	
 };
@@ -65,17 +293,61 @@ public:
 
 // C functions
 int openSRY(const char *);
+int openSRYopts(const char *, const SIM_OPTIONS *);
+int initSimOptions(SIM_OPTIONS *);
 int closeSRY(void);
 int Receive(void **, void *, unsigned);
 int Reply(void *, void *, unsigned);
 int ReplyError(void *);
+int ReceiveView(SIM_VIEW *);
+int ReplyInPlace(void *, unsigned);
+int ReplyV(void *, const struct iovec *, int);
 int returnProxy(int);
+int getProxyCount(void);
 int Locate(const char *, const char *, int, const int);
 int Send(int, void *, unsigned, void *, unsigned);
-int PostMessage(int, void *, unsigned, unsigned);
+int SendTimed(int, void *, unsigned, void *, unsigned, unsigned);
+int ReceiveTimed(void **, void *, unsigned, unsigned);
+int LocateTimed(const char *, const char *, int, const int, unsigned);
+int SendV(int, const struct iovec *, int, const struct iovec *, int);
+void *AcquireSendBuffer(unsigned);
+int SendLoaned(int, unsigned, unsigned);
+int Reserve(unsigned);
+int PostMessage(int, void *, unsigned, unsigned); // a ticket, not 0
 int ReadReply(void *);
+int ReadTicketReply(int, void *);
+int ReadAnyReply(int *, void *);
+int SendAsync(int, void *, unsigned, void *, unsigned);
+int ChkTicketReply(int);
+int WaitReplies(const int *, int);
 int Trigger(int, int);
+int SendPriority(int, void *, unsigned, void *, unsigned, int);
+int TriggerPriority(int, int, int);
+int SendKeyed(int, void *, unsigned, void *, unsigned, unsigned);
+int OpenChannel(const char *, unsigned, unsigned);
+int Subscribe(const char *);
+int Publish(int, const void *, unsigned);
+int ReadChannel(int, void *, unsigned, unsigned long *);
+int ChkChannel(int);
+int ChannelFd(int);
+long getChannelLost(int);
+int CloseChannel(int);
+int OpenStream(const char *, unsigned, unsigned, int, int);
+int ConnectStream(const char *);
+void *ReserveStream(int, unsigned);
+int CommitStream(int);
+int WriteStream(int, const void *, unsigned);
+int ReadStream(int, void *, unsigned);
+int ChkStream(int);
+long getStreamLost(int);
+int CloseStream(int);
 int Relay(void *, int);
+int Serve(SIM_HANDLER, void *, int);
+int ReactorMsg(SIM_HANDLER, void *, void *, unsigned);
+int ReactorFd(int, SIM_CALLBACK, void *);
+int ReactorTimer(unsigned, bool, SIM_CALLBACK, void *);
+int ReactorCancel(int);
+int Reactor(void);
 int getSenderName(void *, char *);
 pid_t getSenderPid(void *);
 int getSenderShmemSize(void *);
@@ -88,9 +360,14 @@ int yfd(void);
 void simRcopy(void *, void *, unsigned);
 void simScopy(void *, unsigned);
 int closeSRYchild(void);
+int getWaitStats(SIM_WAIT_STATS *, bool);
 
 // general functions
 int sryLog(const char *, ...);
+int sryLogLevel(int, const char *, ...);
+int sryLogFlush(void);
+pid_t getSimPid(const char *);
+int getSimNames(SIM_NAME *, int);
 
 // supported communication protocols
 typedef enum
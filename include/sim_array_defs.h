@@ -16,10 +16,33 @@ AUTHOR:			John Collins
 #define MAX_HOST_NAME_LEN			100 // bytes
 #define MAX_PROGRAM_NAME_LEN		100 // bytes
 #define MAX_SIM_NAME_LEN			100 // bytes
+#define MAX_LOG_LINE_LEN			160 // bytes
 
 // table sizes
-#define	MAX_NUM_REMOTE_RECEIVERS	100
-#define	MAX_NUM_BLOCKED_SENDERS		100
+#define	MIN_NUM_REMOTE_RECEIVERS	16  // first size, doubled as need be
+#define	MIN_NUM_BLOCKED_SENDERS		128 // a power of 2; doubled as need be
+#define	MIN_NUM_SENDER_MAPS			16  // first size, doubled as need be
+#define	MAX_NUM_SERVE_QUEUED		100 // messages waiting for Serve() workers
+#define	MAX_NUM_ATTACHED_SENDERS	100
+#define	MAX_NUM_REPLY_FIFOS			100
+#define	MAX_NUM_LOCATED_RECEIVERS	100
+#define	MAX_NUM_REGISTRY_ENTRIES	1024 // a power of 2
+#define	MAX_NUM_POSTED_MESSAGES		32
+#define	MAX_NUM_SIM_INSTANCES		128 // threads with a SIM name
+#define	MAX_NUM_SERVE_THREADS		64 // Serve() workers
+#define	MAX_NUM_REACTOR_FDS			32 // user fds watched by Reactor()
+#define	MAX_NUM_REACTOR_TIMERS		32
+#define	MAX_NUM_URING_TRIGGERS		64 // triggers read at once by io_uring
+#define	MAX_NUM_RETIRED_SHMEM		8  // shmem given up on by SendTimed()
+#define	MAX_NUM_PENDING_TRIGGERS	256 // triggers held for priority order
+#define	MAX_NUM_CHANNELS			8  // channels published or subscribed to
+#define	MAX_NUM_CHANNEL_SUBSCRIBERS	64 // subscribers to a channel
+#define	MAX_NUM_STREAMS				8  // streams consumed or produced
+#define	MAX_NUM_COALESCED_PROXIES	64 // distinct proxies counted in shared memory
+#define	MAX_NUM_GROUPS				8  // receiver groups located
+#define	MAX_NUM_GROUP_MEMBERS		64 // receivers in a group
+#define	MAX_NUM_LOG_RECORDS			256 // a power of 2; sryLog() lines not yet written
+#define	MAX_NUM_LOG_FORMATS			64 // a power of 2; sryLog() formats rate limited
 
 // TCP surrogate naming for the sim library (Locate) as well as the surrogates
 #define TCP_Surr_R					"_TCP_surrogate_R"
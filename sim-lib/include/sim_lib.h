@@ -15,7 +15,10 @@ AUTHOR:			John Collins
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <netdb.h>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdbool.h>
@@ -26,9 +29,21 @@ AUTHOR:			John Collins
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
 #include <sys/resource.h>
 #include <sys/shm.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <linux/futex.h>
+#include <linux/memfd.h>
+#ifndef SIM_NO_IO_URING
+#include <linux/io_uring.h>
+#endif
 
 // sim headers 
 #include <sim.h>
@@ -38,7 +53,107 @@ AUTHOR:			John Collins
 // global constants
 static const char *DefaultFifoPath = "/var/tmp";
 static const char *LogFile = "/var/tmp/sry.log";
-static const int MaxLogSize = 102400; //100k
+static const int MaxLogSize = 102400; //100k, then rotated to sry.log.1
+static const int DefaultLogRate = 10; // lines a second of the one sryLog() format
+static const unsigned DefaultSpinCount = 2000;
+static const unsigned DefaultShmGrowth = 100; // percent
+static const char *RegistryName = "sim.registry";
+static const unsigned MaxChannelDepth = 1 << 20; // messages held by a channel
+static const unsigned MaxStreamBytes = 1 << 30; // ring of a stream
+static const unsigned StreamPad = 0xffffffff; // record filling the end of a ring
+
+// processor hint for the inside of a spin loop
+#if defined(__i386__) || defined(__x86_64__)
+#define SIM_CPU_RELAX()		__builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define SIM_CPU_RELAX()		__asm__ __volatile__("yield")
+#else
+#define SIM_CPU_RELAX()
+#endif
+
+// start a shared member on a cache line of its own
+#define SIM_CACHE_ALIGNED	__attribute__((aligned(64)))
+
+// states of a receiver's mailbox futex word
+typedef enum
+	{
+	MBOX_RUNNING = 0,	// receiver not waiting in Receive(); use the fifo
+	MBOX_PARKED,		// receiver asleep in Receive() awaiting a handoff
+	MBOX_SPINNING,		// receiver spinning in Receive() awaiting a handoff
+	MBOX_CLAIMED,		// a sender is handing over its trigger
+	MBOX_HANDED,		// trigger is in the mailbox token
+	MBOX_NUDGED			// trigger went to the fifo while the receiver was asleep
+	} MBOX_STATES;
+
+// states of a sender's reply futex word
+typedef enum
+	{
+	REPLY_PENDING = 0,	// sent, no reply as yet
+	REPLY_WAITING,		// sender asleep awaiting the reply
+	REPLY_DONE,			// replied
+	REPLY_FAILED,		// replied with ReplyError()
+	REPLY_ABANDONED		// sender gave up waiting, see SendTimed()
+	} REPLY_STATES;
+
+// a futex transport receiver's mailbox, mapped from the M_ file by senders
+typedef struct
+	{
+	pid_t pid;			// receiver's pid
+	int state;			// futex word; MBOX_STATES
+	int token;			// FIFO_MSG handed straight to a parked receiver
+	pid_t tokenPid;
+	int tokenPriority;
+	int fifoCount;		// triggers written to the receive fifo but not read
+	} SIM_MAILBOX;
+
+// a proxy counted in a receiver's proxy table
+typedef struct
+	{
+	int proxy;			// proxy value, 0 if the slot is free
+	int count;			// triggers of the proxy not yet received
+	} PROXY_SLOT;
+
+// a coalescing receiver's proxy table, mapped from the Q_ file by senders
+typedef struct
+	{
+	pid_t pid;			// receiver's pid
+	int armed;			// a wakeup is on its way to the receiver
+	PROXY_SLOT slot[MAX_NUM_COALESCED_PROXIES];
+	} SIM_PROXY_TABLE;
+
+// a member of a receiver group
+typedef struct
+	{
+	pid_t pid;			// member's pid, 0 if the slot is free
+	int ready;			// the name is filled in
+	int outstanding;	// messages sent to the member and not yet replied to
+	unsigned generation;// bumped each time the slot is taken
+	char name[MAX_SIM_NAME_LEN + 1];
+	} GROUP_MEMBER;
+
+// a receiver group's table of members, mapped from the G_ file
+typedef struct
+	{
+	unsigned next;		// round robin turn, shared by all senders
+	GROUP_MEMBER member[MAX_NUM_GROUP_MEMBERS];
+	} SIM_GROUP_TABLE;
+
+// a sender's record of a located receiver group, see Locate("@group")
+typedef struct
+	{
+	SIM_GROUP_TABLE *table;// mapped G_ file, NULL if the entry is free
+	char name[MAX_SIM_NAME_LEN + 1];
+	int fd[MAX_NUM_GROUP_MEMBERS];	// member's receive fifo, -1 if not opened
+	unsigned generation[MAX_NUM_GROUP_MEMBERS];// of the member the fd is for
+	} SIM_GROUP;
+
+// proxies taken from the proxy table by Receive() and not yet handed over
+typedef struct
+	{
+	PROXY_SLOT slot[MAX_NUM_COALESCED_PROXIES];
+	int count;
+	int next;
+	} SIM_PROXY_BURST;
 
 typedef struct
 	{
@@ -49,12 +164,28 @@ typedef struct
 	int shmid;			// shared memory id
 	void *shmPtr;		// pointer to shared memory location; sender id
 	unsigned shmSize;	// size of shared memory
+	int transport;		// SIM_FIFO or SIM_FUTEX
+	SIM_MAILBOX *mbox;	// own mailbox with the futex transport, else NULL
+	int waitPolicy;		// SIM_WAIT_BLOCK, SIM_WAIT_SPIN or SIM_WAIT_POLL
+	unsigned spinCount;	// spins before blocking with SIM_WAIT_SPIN
+	int shmBackend;		// SIM_SHM_SYSV or SIM_SHM_MEMFD
+	int hugePages;		// SIM_HUGE_NONE, SIM_HUGE_TRANSPARENT or SIM_HUGE_EXPLICIT
+	int populate;		// prefault message shared memory if nonzero
+	unsigned shmGrowth;	// percent to grow shared memory by when outgrown
+	int ioEngine;		// SIM_IO_SYSCALL or SIM_IO_URING, as in use
+	int receiveOrder;	// SIM_ORDER_FIFO, SIM_ORDER_PRIORITY or SIM_ORDER_INHERIT
+	SIM_PROXY_TABLE *proxies;// own proxy table if coalescing proxies, else NULL
+	int groupPolicy;	// SIM_GROUP_ROUND_ROBIN or SIM_GROUP_LEAST_LOADED
+	SIM_GROUP_TABLE *group;// table of the receiver group joined, else NULL
+	int groupSlot;		// own member slot in the group table
 	} WHO_AM_I;
 
 // must be kept atomic
 typedef struct
 	{
-	int shmid;
+	int shmid;			// SysV shmid or memfd, proxy (< 0) or reply status
+	pid_t pid;			// owner of a memfd shmem, 0 otherwise
+	int priority;		// 0 up to SIM_MAX_PRIORITY, see SendPriority()
 	} FIFO_MSG;
 
 typedef struct
@@ -64,27 +195,702 @@ typedef struct
 	unsigned shmsize;
 	unsigned nbytes;
 	unsigned ybytes;
+	int replyVia;		// how the sender waits for the reply; SIM_TRANSPORTS
+	int replyState;		// futex word for SIM_FUTEX; REPLY_STATES
+	int shmBackend;		// SIM_SHM_BACKENDS of this shmem
+	unsigned segSize;	// size of this shmem, for unmapping
+	int shmid;			// SysV shmid or memfd of this shmem, for Relay()
+	int slot;			// 0 for Send(), PostMessage() slot + 1
+	int priority;		// of the trigger, for Relay()
+	pid_t groupPid;		// group member counting the message outstanding, or 0
 	char data;
 	} FCMSG_REC;
 
-// sry globals
-WHO_AM_I SimParms = {"", -1, -1, -1, -1, (void *)NULL, 0};
-int RemoteReceiverId[MAX_NUM_REMOTE_RECEIVERS];
-void *BlockedSenderId[MAX_NUM_BLOCKED_SENDERS];
-char SimFifoPath[MAX_FIFO_PATH_LEN + 1];
-volatile int SimSenderShmid = -1;
+/*
+The reply-blocked senders, open addressed on the sender id. A sender taken off
+leaves SENDER_GONE behind so that those probed past it are still found; growing
+the table, which only its own thread does, sweeps them up.
+*/
+typedef struct
+	{
+	void **slot;			// sender id, NULL if never used or SENDER_GONE
+	unsigned size;			// a power of 2, 0 until the first sender
+	unsigned used;			// slots not NULL, gone ones included
+	pthread_mutex_t lock;	// held to grow, and by Serve() workers to take off
+	} BLOCKED_SENDERS;
+
+// the surrogate_r fds of remote receivers, shut down on closeSRY()
+typedef struct
+	{
+	int *fd;
+	unsigned count;
+	unsigned size;			// 0 until the first remote receiver
+	} REMOTE_RECEIVERS;
+
+// a receiver's cached attachment to a sender's message shmem
+typedef struct
+	{
+	int shmid;				// sender's shared memory id (or memfd)
+	pid_t owner;			// owner of a memfd shmem, 0 for SysV shmem
+	ino_t ino;				// inode of a memfd shmem, 0 for SysV shmem
+	pid_t pid;				// sender's pid at the time of attachment
+	void *shmPtr;			// attached address; this is the sender id
+	unsigned long lastUse;	// value of SenderShmemClock when last received
+	} SENDER_SHMEM;
+
+/*
+The senders' memfd shmem mapped by this process, with the length each was 
+mapped with. Process wide since a Serve() worker unmaps what its dispatcher
+mapped.
+*/
+typedef struct
+	{
+	void *shmPtr;			// mapped address; the sender id
+	size_t mapSize;			// size of the memfd when mapped
+	} SENDER_MAP;
+
+typedef struct
+	{
+	SENDER_MAP *map;
+	unsigned count;
+	unsigned size;			// 0 until the first memfd shmem
+	pthread_mutex_t lock;
+	} SENDER_MAPS;
+
+// a sender's PostMessage() slot, with its own shmem; the slot is the ticket
+typedef struct
+	{
+	int shmid;				// shared memory id (or memfd)
+	void *shmPtr;			// attached address
+	unsigned shmSize;		// size of the shmem, 0 if not yet made
+	bool posted;			// posted and the reply not yet read
+	unsigned long seq;		// value of PostSlotClock when posted
+	void *inBuffer;			// SendAsync() reply buffer, NULL otherwise
+	} POST_SLOT;
+
+/*
+A Send() shmem given up on by SendTimed(). It is kept attached for a while so
+that its shmid (or memfd number) is not reused for a new shmem while receivers
+may still come to the abandoned message.
+*/
+typedef struct
+	{
+	int shmid;				// shared memory id (or memfd)
+	void *shmPtr;			// attached address
+	unsigned shmSize;		// size of the shmem, 0 if the entry is free
+	} RETIRED_SHMEM;
+
+// a trigger held by Receive() for priority order
+typedef struct
+	{
+	FIFO_MSG msg;
+	unsigned long seq;		// arrival order among triggers of equal priority
+	} PENDING_TRIGGER;
+
+// triggers held by Receive(), a heap with the highest priority on top
+typedef struct
+	{
+	PENDING_TRIGGER heap[MAX_NUM_PENDING_TRIGGERS];
+	int count;
+	unsigned long seq;
+	} SIM_PENDING;
+
+// scheduling of a SIM_ORDER_INHERIT receiving thread
+typedef struct
+	{
+	int priority;			// taken on from the last message, 0 for none
+	int policy;				// the thread's own, to go back to
+	struct sched_param param;
+	} SIM_INHERITED;
+
+// deadline of a SendTimed(), ReceiveTimed() or LocateTimed() in progress
+typedef struct
+	{
+	bool set;
+	struct timespec at;		// CLOCK_MONOTONIC
+	} SIM_DEADLINE;
+
+// a receiver's cached open descriptor to a sender's reply fifo
+typedef struct
+	{
+    char whom[MAX_PROGRAM_NAME_LEN + 1];// sender's SIM name
+	pid_t pid;				// sender's pid
+	int fd;					// open (write only) reply fifo fd
+	unsigned long lastUse;	// value of SenderShmemClock when last replied to
+	} REPLY_FIFO;
+
+// a sender's record of a located receiver's fifo and mailbox
+typedef struct
+	{
+	int fd;				// receive fifo fd as returned by Locate()
+	pid_t pid;			// receiver's pid
+	SIM_MAILBOX *mbox;	// receiver's mailbox, NULL for a fifo only receiver
+	SIM_PROXY_TABLE *proxies;// receiver's proxy table, NULL if not coalescing
+	char name[MAX_SIM_NAME_LEN + 1];// receiver's name, "" if not to be reused
+	unsigned generation;// registry generation of the receiver's name
+	dev_t dev;			// the fifo, in case fd has been closed and reused
+	ino_t ino;
+	} LOCATED_RECEIVER;
+
+// states of a name registry entry
+typedef enum
+	{
+	REG_EMPTY = 0,		// never used; ends a search
+	REG_USED,			// name registered to a running pid
+	REG_DELETED			// name deregistered; searches carry on past it
+	} REGISTRY_STATES;
+
+// an entry in the name registry
+typedef struct
+	{
+	int state;							// REGISTRY_STATES
+	pid_t pid;							// pid of the owner of the name
+	unsigned generation;				// registry generation when registered
+	char name[MAX_SIM_NAME_LEN + 1];	// SIM name
+	} REGISTRY_ENTRY;
+
+/*
+The name registry, a file under the fifo path mapped by every SIM process.
+Entries are hashed on the SIM name; the fifo names follow from name and pid.
+*/
+typedef struct
+	{
+	pid_t lock;				// thread id holding the registry, 0 if free
+	unsigned generation;	// bumped on every registration
+	int overflow;			// a name failed to register since there was last room
+	REGISTRY_ENTRY entry[MAX_NUM_REGISTRY_ENTRIES];
+	} SIM_REGISTRY;
+
+// a SIM instance open in this process, see addSimInstance()
+typedef struct
+	{
+	int used;							// slot claimed
+	pid_t pid;							// process that opened it
+	char whom[MAX_SIM_NAME_LEN + 1];	// SIM name
+	} SIM_INSTANCE;
+
+// a subscriber's place in a channel
+typedef struct
+	{
+	pid_t pid;				// subscriber, 0 if the place is free
+	unsigned generation;	// bumped whenever the place is taken or given up
+	int notify;				// a byte is wanted on the subscriber's S_ fifo
+	} CHANNEL_SUBSCRIBER;
+
+// a message in a channel ring
+typedef struct
+	{
+	unsigned long seq;		// of the message, 0 while it is being written
+	unsigned nbytes;
+	char data;
+	} CHANNEL_SLOT;
+
+/*
+A publish/subscribe channel, the P_ file under the fifo path mapped by the 
+publisher and its subscribers. The ring of slots follows the header.
+*/
+typedef struct
+	{
+	pid_t pid;				// publisher
+	int closed;				// the publisher has closed the channel
+	unsigned msgSize;		// largest message
+	unsigned slotSize;		// bytes to a slot, header included
+	unsigned numSlots;		// a power of 2
+	unsigned slotOffset;	// of the first slot from the start of the header
+	unsigned long head;		// sequence number of the last message published
+	int wake;				// futex word bumped by every message published
+	int sleepers;			// subscribers asleep on wake
+	CHANNEL_SUBSCRIBER sub[MAX_NUM_CHANNEL_SUBSCRIBERS];
+	} CHANNEL_HDR;
+
+// a channel published or subscribed to by this thread, free if hdr is NULL
+typedef struct
+	{
+	CHANNEL_HDR *hdr;		// mapped P_ file
+	size_t mapSize;
+	char name[MAX_SIM_NAME_LEN + 1];
+	bool publisher;
+	unsigned long next;		// subscriber: sequence number of the next message
+	unsigned long lost;		// subscriber: messages overrun before being read
+	int place;				// subscriber: its place in hdr->sub[]
+	int fd;					// subscriber: its S_ fifo, read end
+	int subFd[MAX_NUM_CHANNEL_SUBSCRIBERS];	// publisher: S_ fifos, write ends
+	unsigned subGeneration[MAX_NUM_CHANNEL_SUBSCRIBERS];// of the places then
+	} SIM_CHANNEL;
+
+// a record in a stream ring, its data following; 8 byte aligned
+typedef struct
+	{
+	unsigned nbytes;		// StreamPad for the filler at the end of the ring
+	unsigned spare;
+	} STREAM_REC;
+
+/*
+A one-way stream, the T_ file under the fifo path mapped by its consumer and 
+its producer. The head is only moved on by the producer and the tail by the 
+consumer, but for records dropped to make room; each is on a cache line of its
+own. The ring follows the header.
+*/
+typedef struct
+	{
+	pid_t pid;				// consumer
+	pid_t producer;			// 0 if none connected
+	unsigned connects;		// producers connected so far
+	int closed;				// the consumer has closed the stream
+	int policy;				// SIM_STREAM_POLICIES
+	int proxy;				// triggered on the consumer when asked for, or 0
+	unsigned recSize;		// largest record
+	unsigned size;			// bytes in the ring, a power of 2
+	unsigned ringOffset;	// of the ring from the start of the header
+	char whom[MAX_SIM_NAME_LEN + 1]; // consumer's SIM name, for the proxy
+	unsigned long head SIM_CACHE_ALIGNED; // bytes ever committed
+	unsigned long dropped;	// records dropped to make room
+	int headWake;			// futex word bumped for a sleeping consumer
+	int producerWaiting;	// producer asleep on tailWake
+	unsigned long tail SIM_CACHE_ALIGNED; // bytes ever read
+	int tailWake;			// futex word bumped for a sleeping producer
+	int consumerWaiting;	// consumer asleep on headWake
+	int notify;				// consumer wants the proxy on the next commit
+	} STREAM_HDR;
+
+// a stream consumed or produced by this thread, free if hdr is NULL
+typedef struct
+	{
+	STREAM_HDR *hdr;		// mapped T_ file
+	size_t mapSize;
+	char name[MAX_SIM_NAME_LEN + 1];
+	char *ring;
+	bool producer;
+	unsigned long reserve;	// producer: end of the records reserved so far
+	unsigned long cached;	// producer: tail, consumer: head, as last read
+	int consumerId;			// producer: located consumer, for the proxy
+	} SIM_STREAM;
+
+/*
+What a Serve() dispatcher shares with its worker threads. The queue holds the
+views of received messages not yet taken up by a worker, and whether the
+dispatcher could cache the shmem of each sender.
+*/
+typedef struct
+	{
+	SIM_HANDLER handler;				// run by the workers
+	void *arg;							// passed on to the handler
+	WHO_AM_I parms;						// the dispatcher's SIM instance
+	char fifoPath[MAX_FIFO_PATH_LEN + 1];
+	BLOCKED_SENDERS *blocked;			// the dispatcher's BlockedSenders
+	SIM_VIEW queue[MAX_NUM_SERVE_QUEUED];
+	bool cached[MAX_NUM_SERVE_QUEUED];	// the dispatcher cached the shmem
+	int head;							// next view to be taken up
+	int count;							// views queued
+	int stop;							// a handler has asked to stop
+	int wake;							// eventfd waking the dispatcher
+	pthread_mutex_t lock;
+	pthread_cond_t work;				// a view has been queued
+	pthread_cond_t room;				// a view has been taken up
+	} SIM_SERVE;
+
+// control proxies from here up, such as PROXY_SHUTDOWN, are never coalesced
+#define PROXY_CONTROL_MIN	0x7FFFFFF0
+
+// wakeup for a burst of proxies counted in a receiver's proxy table
+#define PROXY_COALESCED		PROXY_CONTROL_MIN
+
+// ids from here up returned by Locate("@group") are receiver groups, not fds
+#define SIM_GROUP_ID		0x40000000
+
+// left in the reply-blocked sender table by a sender taken off it
+#define SENDER_GONE			((void *)-1)
+
+// a sryLog() line waiting in the log ring
+typedef struct
+	{
+	unsigned long seq;		// ring position the record is good for, see putLog()
+	time_t tod;
+	int level;
+	char text[MAX_LOG_LINE_LEN];
+	} LOG_RECORD;
+
+/*
+The process' sryLog() lines, put by any thread without taking a lock and
+written to LogFile by the log flusher thread.
+*/
+typedef struct
+	{
+	unsigned long head;		// next position to be put
+	unsigned long tail;		// next position to be written out
+	unsigned long dropped;	// lines lost to a full ring
+	LOG_RECORD rec[MAX_NUM_LOG_RECORDS];
+	} SIM_LOG_RING;
+
+// the lines of a sryLog() format so far this second, for rate limiting
+typedef struct
+	{
+	const char *format;		// NULL if the entry is free
+	time_t second;
+	int count;
+	int suppressed;			// lines not logged, noted on the next one logged
+	} LOG_RATE;
+
+// sryLog() settings and the state of the log flusher
+typedef struct
+	{
+	int level;				// highest SIM_LOG_LEVELS logged
+	int rate;				// lines a second of a format, 0 for no limit
+	long maxSize;			// of LogFile before it is rotated
+	int started;			// the flusher thread is running
+	int idle;				// the flusher is waiting to be woken
+	int fd;					// LogFile kept open by drainLog(), -1 if not yet
+	} SIM_LOG;
+
+// a user fd watched by Reactor(), free if cb is NULL
+typedef struct
+	{
+	int fd;
+	SIM_CALLBACK cb;
+	void *arg;
+	} REACTOR_FD;
+
+// a Reactor() timer, free if cb is NULL
+typedef struct
+	{
+	unsigned msecs;			// period, or delay of a one shot timer
+	bool periodic;
+	struct timespec due;	// next expiry, CLOCK_MONOTONIC
+	SIM_CALLBACK cb;
+	void *arg;
+	} REACTOR_TIMER;
+
+// a thread's epoll reactor, see Reactor()
+typedef struct
+	{
+	int epfd;				// epoll set
+	int tfd;				// timerfd, armed for the earliest timer
+	pid_t pid;				// process that made them, 0 until first used
+	SIM_HANDLER handler;	// SIM messages and proxies, NULL if not wanted
+	void *arg;
+	void *buf;				// messages copied here, NULL for in place views
+	unsigned size;
+	REACTOR_FD fd[MAX_NUM_REACTOR_FDS];
+	REACTOR_TIMER timer[MAX_NUM_REACTOR_TIMERS];
+	} SIM_REACTOR;
+
+// what an epoll event is for; a user fd is REACTOR_FDS + its table index
+enum
+	{
+	REACTOR_MSGS = 0,
+	REACTOR_TIMERS,
+	REACTOR_FDS
+	};
+
+// a reply fifo write handed to io_uring and not yet completed
+typedef struct
+	{
+	bool busy;
+	pid_t pid;							// sender's pid
+	char whom[MAX_PROGRAM_NAME_LEN + 1];// sender's SIM name
+	FIFO_MSG msg;						// written from here
+	} URING_REPLY;
+
+/*
+A fifo transport receiver's io_uring, see openUring(). The receive fifo is 
+registered file 0 and the cached reply fifos ReplyFifo[i] are file i + 1.
+*/
+typedef struct
+	{
+	int fd;					// the ring
+	unsigned entries;		// submission queue entries
+	void *sqRing;			// mapped rings and submission queue entries
+	void *cqRing;
+	struct io_uring_sqe *sqes;
+	size_t sqRingSize;
+	size_t cqRingSize;
+	unsigned *sqHead;
+	unsigned *sqTail;
+	unsigned *sqMask;
+	unsigned *sqArray;
+	unsigned *cqHead;
+	unsigned *cqTail;
+	unsigned *cqMask;
+	struct io_uring_cqe *cqes;
+	int readResult;			// of the trigger read, once completed
+	bool reading;			// trigger read submitted and not yet completed
+	FIFO_MSG trigger[MAX_NUM_URING_TRIGGERS];// triggers read ahead
+	int next;				// next trigger to be received
+	int count;				// triggers read ahead and not yet received
+	URING_REPLY reply[MAX_NUM_URING_TRIGGERS];
+	int replies;			// replies handed over and not yet completed
+	} SIM_URING;
+
+// io_uring user data of the trigger read; that of a reply is its table index
+#define URING_TRIGGER_READ	(~0ULL)
+
+/*
+sry globals
+
+A SIM instance is its name, fifos, shmem and tables. The process has one, 
+SimDefault, used by every thread that has not opened one of its own with the
+perThread option of openSRYopts(); such a thread's SimState points at its own.
+A thread opening its own instance can send and receive independently of the 
+others; threads sharing SimDefault must take turns, as with a single threaded
+SIM process.
+*/
+typedef struct
+	{
+	WHO_AM_I parms;
+	SIM_WAIT_STATS waitStats;
+	REMOTE_RECEIVERS remoteReceivers;
+	BLOCKED_SENDERS blockedSenders;
+	char fifoPath[MAX_FIFO_PATH_LEN + 1];
+	SENDER_SHMEM senderShmem[MAX_NUM_ATTACHED_SENDERS];
+	unsigned long senderShmemClock;
+	REPLY_FIFO replyFifo[MAX_NUM_REPLY_FIFOS];
+	int replyFifoHint;
+	LOCATED_RECEIVER locatedReceiver[MAX_NUM_LOCATED_RECEIVERS];
+	int locatedReceiverHint;
+	SIM_REGISTRY *registry;
+	POST_SLOT postSlot[MAX_NUM_POSTED_MESSAGES];
+	unsigned long postSlotClock;
+	int replyFifoTokens;
+	RETIRED_SHMEM retiredShmem[MAX_NUM_RETIRED_SHMEM];
+	int retiredShmemNext;
+	SIM_DEADLINE deadline;
+	int sendPriority;
+	long sendKey;
+	SIM_PENDING pending;
+	SIM_INHERITED inherited;
+	SIM_PROXY_BURST proxyBurst;
+	int proxyCount;
+	SIM_CHANNEL channel[MAX_NUM_CHANNELS];
+	SIM_STREAM stream[MAX_NUM_STREAMS];
+	SIM_GROUP group[MAX_NUM_GROUPS];
+	int instanceSlot;			// in SimInstance[], -1 if none
+	bool serveWorker;			// a Serve() worker's, see openServeWorker()
+	bool perThread;				// opened by its thread, not SimDefault
+	SIM_REACTOR reactor;
+	SIM_URING uring;
+	void *asyncWaiter[MAX_NUM_POSTED_MESSAGES]; // see SRY::ResumeAsync()
+	} SIM_STATE;
+
+#define SIM_STATE_INIT {{"", -1, -1, -1, -1, (void *)NULL, 0, SIM_FIFO, \
+		NULL, SIM_WAIT_BLOCK, 0, SIM_SHM_SYSV, SIM_HUGE_NONE, 0, 0, SIM_IO_SYSCALL,\
+		SIM_ORDER_FIFO, NULL, SIM_GROUP_ROUND_ROBIN, NULL, -1}, {0, 0, 0, 0}, \
+		{NULL, 0, 0}, {NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER}, "", {}, 0, {}, 0, \
+		{}, 0, NULL, {}, 0, 0, {}, 0, {}, 0, -1, {}, {}, {}, 1, {}, {}, {}, -1, \
+		false, false, {}, {}, {}}
+
+#define SIM_THREAD __thread
+
+SIM_STATE SimDefault = SIM_STATE_INIT;
+SIM_THREAD SIM_STATE *SimState = &SimDefault;
+
+// the instance's state by the names of the globals it once was
+#define SimParms			(SimState->parms)
+#define SimWaitStats		(SimState->waitStats)
+#define RemoteReceivers		(SimState->remoteReceivers)
+#define BlockedSenders		(SimState->blockedSenders)
+#define SimFifoPath			(SimState->fifoPath)
+#define SenderShmem			(SimState->senderShmem)
+#define SenderShmemClock	(SimState->senderShmemClock)
+#define ReplyFifo			(SimState->replyFifo)
+#define ReplyFifoHint		(SimState->replyFifoHint)
+#define LocatedReceiver		(SimState->locatedReceiver)
+#define LocatedReceiverHint	(SimState->locatedReceiverHint)
+#define SimRegistry			(SimState->registry)
+#define PostSlot			(SimState->postSlot)
+#define PostSlotClock		(SimState->postSlotClock)
+#define ReplyFifoTokens		(SimState->replyFifoTokens)
+#define RetiredShmem		(SimState->retiredShmem)
+#define RetiredShmemNext	(SimState->retiredShmemNext)
+#define SimDeadline			(SimState->deadline)
+#define SimSendPriority		(SimState->sendPriority)
+#define SimSendKey			(SimState->sendKey)
+#define SimPending			(SimState->pending)
+#define SimInherited		(SimState->inherited)
+#define SimProxyBurst		(SimState->proxyBurst)
+#define SimProxyCount		(SimState->proxyCount)
+#define SimChannel			(SimState->channel)
+#define SimStream			(SimState->stream)
+#define SimGroup			(SimState->group)
+#define SimInstanceSlot		(SimState->instanceSlot)
+#define SimServeWorker		(SimState->serveWorker)
+#define SimReactor			(SimState->reactor)
+#define SimUring			(SimState->uring)
+#define AsyncWaiter			(SimState->asyncWaiter)
+
+// process wide globals
+SIM_INSTANCE SimInstance[MAX_NUM_SIM_INSTANCES];
+int SimExitHooked = 0;
 bool PrintSimError = false;
+SIM_LOG_RING SimLogRing;
+LOG_RATE SimLogRate[MAX_NUM_LOG_FORMATS];
+SIM_LOG SimLog = {SIM_LOG_INFO, DefaultLogRate, MaxLogSize, 0, 0, -1};
+SENDER_MAPS SenderMaps = {NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER};
+pthread_once_t SimLogOnce = PTHREAD_ONCE_INIT;
+pthread_mutex_t SimLogLock = PTHREAD_MUTEX_INITIALIZER;
 
 // shared memory functions
-int createShmem(unsigned);
-int detachShmem(void);
+int reserveShmem(unsigned, bool);
+int resizeShmem(int *, void **, unsigned *, unsigned, bool);
+int createShmem(unsigned, int *, void **, unsigned *);
+void *makeShmem(unsigned, int, int *);
+int detachShmem(int, void *, unsigned *);
+int collectPostedReply(int, void *);
+bool spinPostedReplies(const int *, int);
+void releaseAllPostSlots(void);
+int abandonSend(FCMSG_REC *, char *);
+void retireShmem(void);
+void releaseRetiredShmem(void);
+long getHugePageSize(void);
+void *attachSenderShmem(int, pid_t);
+void *mapSenderShmem(int, pid_t, ino_t *);
+void unmapSenderShmem(void *);
+int addSenderMap(void *, size_t);
+size_t takeSenderMap(void *);
+int releaseSenderShmem(void *);
+void doneSenderShmem(void *, bool);
+bool isSenderCached(void *);
+bool senderAlive(SENDER_SHMEM *);
+void releaseAllSenderShmem(void);
 
 // trigger fifo functions
 int createFifos(void);
 int detachFifos(void);
 int deleteFifos(void);
 int readFifoMsg(int, char *);
+int waitReplyFifo(FCMSG_REC *, char *);
 int getFifoName(const char *, char *);
+int openReplyFifo(const pid_t, const char *);
+int writeReplyFifo(FCMSG_REC *, char *);
+int putReplyFifo(const pid_t, const char *, char *);
+void closeReplyFifo(const pid_t, const char *);
+void closeAllReplyFifos(void);
+
+// futex transport functions
+int simFutex(int *, int, int);
+int createMailbox(void);
+int detachMailbox(void);
+int deleteMailbox(void);
+SIM_MAILBOX *attachMailbox(const char *);
+LOCATED_RECEIVER *addLocatedReceiver(int, const char *);
+LOCATED_RECEIVER *findLocatedReceiver(int);
+LOCATED_RECEIVER *findLocatedName(const char *);
+bool chkLocatedReceiver(LOCATED_RECEIVER *);
+void releaseAllLocatedReceivers(void);
+int writeTrigger(int, char *);
+int readTrigger(char *);
+int waitReplyFutex(FCMSG_REC *, char *);
+int postReplyFutex(FCMSG_REC *, char *);
+
+// priority order functions
+int takeTrigger(char *);
+int gatherTriggers(void);
+bool triggerReady(void);
+bool pendingBefore(const PENDING_TRIGGER *, const PENDING_TRIGGER *);
+void pushPending(const FIFO_MSG *);
+void popPending(FIFO_MSG *);
+void inheritPriority(int);
+
+// coalesced proxy functions
+int createProxyTable(void);
+int detachProxyTable(void);
+int deleteProxyTable(void);
+SIM_PROXY_TABLE *attachProxyTable(const char *);
+int postProxy(int, int);
+void drainProxyTable(void);
+bool takeProxyBurst(char *);
+
+// receiver group functions
+int locateGroup(const char *);
+SIM_GROUP_TABLE *attachGroupTable(const char *, bool);
+int joinGroup(const char *);
+void leaveGroup(void);
+void detachGroup(void);
+void releaseAllGroups(void);
+int pickGroupMember(SIM_GROUP *, int);
+int groupMemberFd(SIM_GROUP *, int);
+void dropGroupMember(SIM_GROUP *, int);
+int writeGroupTrigger(int, char *, FCMSG_REC *, int);
+int sendTrigger(int, char *, FCMSG_REC *, int);
+void uncountGroupMsg(FCMSG_REC *);
+
+// name registry functions
+int setFifoPath(void);
+int openRegistry(void);
+void closeRegistry(void);
+void lockRegistry(void);
+void unlockRegistry(void);
+unsigned hashName(const char *);
+int findRegistryEntry(const char *);
+int registerName(const char *, pid_t);
+void deregisterName(const char *, pid_t);
+pid_t lookupName(const char *, unsigned *);
+pid_t scanFifoPath(const char *, const char *);
+
+// publish/subscribe channel functions
+SIM_CHANNEL *getChannel(int, bool, const char *);
+int freeChannel(void);
+CHANNEL_HDR *createChannel(const char *, unsigned, unsigned, size_t *);
+CHANNEL_HDR *attachChannel(const char *, pid_t, size_t *);
+pid_t chkChannelPid(const char *);
+CHANNEL_SLOT *channelSlot(CHANNEL_HDR *, unsigned long);
+int joinChannel(SIM_CHANNEL *);
+void leaveChannel(SIM_CHANNEL *);
+int takeChannelMsg(SIM_CHANNEL *, void *, unsigned);
+unsigned long channelWaiting(SIM_CHANNEL *);
+int waitChannel(SIM_CHANNEL *);
+void notifySubscribers(SIM_CHANNEL *, bool);
+void releaseChannel(SIM_CHANNEL *, bool);
+void releaseAllChannels(bool);
+
+// stream functions
+SIM_STREAM *getStream(int, bool, const char *);
+int freeStream(void);
+STREAM_HDR *createStream(const char *, unsigned, unsigned, int, int, size_t *);
+STREAM_HDR *attachStream(const char *, pid_t, size_t *);
+pid_t chkStreamPid(const char *);
+STREAM_REC *streamRec(SIM_STREAM *, unsigned long);
+unsigned streamRecLen(unsigned);
+void commitStream(SIM_STREAM *);
+int makeStreamRoom(SIM_STREAM *, unsigned long);
+bool advanceStream(SIM_STREAM *, unsigned long, unsigned long);
+int waitStream(SIM_STREAM *);
+void releaseStream(SIM_STREAM *, bool);
+void releaseAllStreams(bool);
+
+// serve functions
+void *serveWorker(void *);
+int openServeWorker(SIM_SERVE *);
+void closeServeWorker(void);
+void stopServe(SIM_SERVE *);
+int releaseServedSender(BLOCKED_SENDERS *, void *);
+
+// io_uring functions
+int openUring(void);
+void closeUring(bool);
+void setUringFile(int, int);
+int queueUring(int, int, void *, unsigned, unsigned long long);
+int enterUring(unsigned);
+void reapUring(void);
+int readUringTrigger(char *);
+int writeUringReply(FCMSG_REC *, char *);
+
+// reactor functions
+int openReactor(void);
+void closeReactor(void);
+int armReactorTimer(void);
+int fireReactorTimers(void);
+int dispatchReactorMsg(void);
+
+// log functions
+void initLog(void);
+int putLog(int, const char *, va_list);
+int rateLog(const char *);
+int startLogFlusher(void);
+void *logFlusher(void *);
+int drainLog(void);
+void drainLogAtExit(void);
+void drainLogOnSignal(void);
+void forkedLog(void);
 
 // called and miscellaneous functions
 bool sim_check(void);
@@ -93,9 +899,28 @@ void hndlSignals(int);
 void exitFunc(void);
 int saveSenderId(void *);
 int removeSenderId(void *);
+bool isSenderBlocked(void *);
+unsigned hashSender(const void *, unsigned);
+int growBlockedSenders(void);
+int dropBlockedSender(BLOCKED_SENDERS *, void *);
+void releaseBlockedSenders(bool);
+int addRemoteReceiver(int);
+void releaseRemoteReceivers(bool);
 int getLocalHostName(char *);
 pid_t chkNamePid(const char *);
+bool isPidSuffix(const char *);
 bool chkStatus(const pid_t, const char *);
+void initSimTables(void);
+void removeSimFiles(const pid_t, const char *);
+void addSimInstance(void);
+void removeSimInstance(void);
+void removeAllSimInstances(void);
+int openSimState(void);
+void closeSimState(void);
+unsigned iovLength(const struct iovec *, int);
+void setDeadline(unsigned);
+bool pastDeadline(void);
+int pollDeadline(int);
 
 // include C++ bits C++ compiler
 #ifdef __cplusplus
@@ -109,15 +934,64 @@ which also provide the basis for a standalone C library.
 static int (*ReceivePtr)(void **, void *, unsigned) = Receive;
 static int (*ReplyPtr)(void *, void *, unsigned) = Reply;
 static int (*ReplyErrorPtr)(void *) = ReplyError;
+static int (*ReceiveViewPtr)(SIM_VIEW *) = ReceiveView;
+static int (*ReplyInPlacePtr)(void *, unsigned) = ReplyInPlace;
+static int (*ReplyVPtr)(void *, const struct iovec *, int) = ReplyV;
 static int (*returnProxyPtr)(int) = returnProxy;
+static int (*getProxyCountPtr)(void) = getProxyCount;
 static bool (*chkReceiverPtr)(const char *, pid_t) = chkReceiver;
 static bool (*chkSenderPtr)(void *) = chkSender;
 static int (*LocatePtr)(const char *, const char *, int, const int) = Locate;
 static int (*SendPtr)(int, void *, unsigned, void *, unsigned) = Send;
+static int (*SendTimedPtr)(int, void *, unsigned, void *, unsigned, unsigned) = 
+																	SendTimed;
+static int (*ReceiveTimedPtr)(void **, void *, unsigned, unsigned) = ReceiveTimed;
+static int (*LocateTimedPtr)(const char *, const char *, int, const int, 
+													unsigned) = LocateTimed;
+static int (*SendVPtr)(int, const struct iovec *, int, const struct iovec *, int) = 
+																		SendV;
+static void *(*AcquireSendBufferPtr)(unsigned) = AcquireSendBuffer;
+static int (*SendLoanedPtr)(int, unsigned, unsigned) = SendLoaned;
+static int (*ReservePtr)(unsigned) = Reserve;
 static int (*PostMessagePtr)(int, void *, unsigned, unsigned) = PostMessage;
 static int (*ReadReplyPtr)(void *) = ReadReply;
+static int (*ReadTicketReplyPtr)(int, void *) = ReadTicketReply;
+static int (*ReadAnyReplyPtr)(int *, void *) = ReadAnyReply;
+static int (*SendAsyncPtr)(int, void *, unsigned, void *, unsigned) = SendAsync;
+static int (*ChkTicketReplyPtr)(int) = ChkTicketReply;
+static int (*WaitRepliesPtr)(const int *, int) = WaitReplies;
 static int (*TriggerPtr)(int, int) = Trigger;
+static int (*SendPriorityPtr)(int, void *, unsigned, void *, unsigned, int) = 
+																SendPriority;
+static int (*TriggerPriorityPtr)(int, int, int) = TriggerPriority;
+static int (*SendKeyedPtr)(int, void *, unsigned, void *, unsigned, unsigned) = 
+																	SendKeyed;
+static int (*OpenChannelPtr)(const char *, unsigned, unsigned) = OpenChannel;
+static int (*SubscribePtr)(const char *) = Subscribe;
+static int (*PublishPtr)(int, const void *, unsigned) = Publish;
+static int (*ReadChannelPtr)(int, void *, unsigned, unsigned long *) = ReadChannel;
+static int (*ChkChannelPtr)(int) = ChkChannel;
+static int (*ChannelFdPtr)(int) = ChannelFd;
+static long (*getChannelLostPtr)(int) = getChannelLost;
+static int (*CloseChannelPtr)(int) = CloseChannel;
+static int (*OpenStreamPtr)(const char *, unsigned, unsigned, int, int) = 
+																OpenStream;
+static int (*ConnectStreamPtr)(const char *) = ConnectStream;
+static void *(*ReserveStreamPtr)(int, unsigned) = ReserveStream;
+static int (*CommitStreamPtr)(int) = CommitStream;
+static int (*WriteStreamPtr)(int, const void *, unsigned) = WriteStream;
+static int (*ReadStreamPtr)(int, void *, unsigned) = ReadStream;
+static int (*ChkStreamPtr)(int) = ChkStream;
+static long (*getStreamLostPtr)(int) = getStreamLost;
+static int (*CloseStreamPtr)(int) = CloseStream;
 static int (*RelayPtr)(void *, int) = Relay;
+static int (*ServePtr)(SIM_HANDLER, void *, int) = Serve;
+static int (*ReactorMsgPtr)(SIM_HANDLER, void *, void *, unsigned) = ReactorMsg;
+static int (*ReactorFdPtr)(int, SIM_CALLBACK, void *) = ReactorFd;
+static int (*ReactorTimerPtr)(unsigned, bool, SIM_CALLBACK, void *) = 
+																ReactorTimer;
+static int (*ReactorCancelPtr)(int) = ReactorCancel;
+static int (*ReactorPtr)(void) = Reactor;
 static pid_t (*getSenderPidPtr)(void *) = getSenderPid;
 static int (*getSenderShmemSizePtr)(void *) = getSenderShmemSize;
 static int (*getSenderMsgSizePtr)(void *) = getSenderMsgSize;
@@ -127,7 +1001,8 @@ static int (*yfdPtr)(void) = yfd;
 static void (*simRcopyPtr)(void *, void *, unsigned) = simRcopy;
 static void (*simScopyPtr)(void *, unsigned) = simScopy;
 static int (*closeSRYchildPtr)(void) = closeSRYchild;
+static int (*getWaitStatsPtr)(SIM_WAIT_STATS *, bool) = getWaitStats;
 
-// C++ global variable
+// C++ global variables
 static SRY *sryObj;
 #endif
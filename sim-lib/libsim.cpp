@@ -56,6 +56,44 @@ if (openSRY(name) == -1)
 sryObj = this;
 }
 
+/**********************************************************************
+FUNCTION:	SRY::SRY(const std::string&, const SIM_OPTIONS&)
+
+PURPOSE:	Constructor with options.
+***********************************************************************/
+
+SRY::SRY(const std::string &name, const SIM_OPTIONS &opts)
+{
+// openSRYopts() performs the sry setup
+if (openSRYopts(name.c_str(), &opts) == -1)
+	{
+	closeSRY();
+	exit(EXIT_FAILURE);
+	}
+	
+// use the global sry object pointer to store the sry object address
+sryObj = this;
+}
+
+/**********************************************************************
+FUNCTION:	SRY::SRY(const char *, const SIM_OPTIONS&)
+
+PURPOSE:	Constructor with options.
+***********************************************************************/
+
+SRY::SRY(const char *name, const SIM_OPTIONS &opts)
+{
+// openSRYopts() performs the sry setup
+if (openSRYopts(name, &opts) == -1)
+	{
+	closeSRY();
+	exit(EXIT_FAILURE);
+	}
+
+// use the global sry object pointer to store the sry object address
+sryObj = this;
+}
+
 /**********************************************************************
 FUNCTION:	SRY::~SRY(void)
 
@@ -82,6 +120,21 @@ int SRY::Receive(void **id, void *iPtr, unsigned iSize)
 return (*ReceivePtr)(id, iPtr, iSize);
 }
 
+/**********************************************************************
+FUNCTION:	int SRY::ReceiveTimed(void  **, void *, unsigned, unsigned)
+
+PURPOSE:	This method receives messages/proxies from other processes,
+			waiting no longer than msecs milliseconds.
+
+RETURNS:	success: number bytes in message >= 0 or proxy < -1
+			failure: -1, errno ETIMEDOUT if out of time
+***********************************************************************/
+
+int SRY::ReceiveTimed(void **id, void *iPtr, unsigned iSize, unsigned msecs)
+{
+return (*ReceiveTimedPtr)(id, iPtr, iSize, msecs);
+}
+
 /**********************************************************************
 FUNCTION:	int SRY::Reply(void *, void *, unsigned)
 
@@ -110,6 +163,52 @@ int SRY::ReplyError(void *id)
 return (*ReplyErrorPtr)(id);
 }
 
+/**********************************************************************
+FUNCTION:	int SRY::ReceiveView(SIM_VIEW *)
+
+PURPOSE:	This method receives messages/proxies from other processes
+			and leaves messages in place in the sender's shmem.
+			It is a blocking receive.
+
+RETURNS:	success: >= 0 msg size, < -1 proxy value
+			failure: -1
+***********************************************************************/
+
+int SRY::ReceiveView(SIM_VIEW *view)
+{
+return (*ReceiveViewPtr)(view);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReplyInPlace(void *, unsigned)
+
+PURPOSE:	This method replies the message already written in place in
+			the sender's shmem.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReplyInPlace(void *id, unsigned nbytes)
+{
+return (*ReplyInPlacePtr)(id, nbytes);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReplyV(void *, const struct iovec *, int)
+
+PURPOSE:	This method replies a message gathered from an array of
+			buffers to the sender.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReplyV(void *id, const struct iovec *iov, int iovcnt)
+{
+return (*ReplyVPtr)(id, iov, iovcnt);
+}
+
 /**********************************************************************
 FUNCTION:	SRY::returnProxy(int)
 
@@ -124,6 +223,20 @@ int SRY::returnProxy(int value)
 return (*returnProxyPtr)(value);
 }
 
+/**********************************************************************
+FUNCTION:	int SRY::getProxyCount(void)
+
+PURPOSE:	Return the number of times the proxy last received was
+			triggered.
+
+RETURNS:	>= 1
+***********************************************************************/
+
+int SRY::getProxyCount()
+{
+return (*getProxyCountPtr)();
+}
+
 /**********************************************************************
 FUNCTION:	int SRY::Locate(const std::string&, const std::string&, int,
 const int)
@@ -155,6 +268,41 @@ const int protocol)
 return (*LocatePtr)(hname, pname, msgSize, protocol);
 }
 
+/**********************************************************************
+FUNCTION:	int SRY::LocateTimed(const std::string&, const std::string&, 
+											int, const int, unsigned)
+
+PURPOSE:	Gets the sry id of a receiver process, locally or remotely,
+			taking no longer than msecs milliseconds.
+
+RETURNS:	success: sry id > 0
+			failure: -1, errno ETIMEDOUT if out of time
+***********************************************************************/
+
+int SRY::LocateTimed(const std::string &hname, const std::string &pname, 
+							int msgSize, const int protocol, unsigned msecs)
+{
+return (*LocateTimedPtr)(hname.c_str(), pname.c_str(), msgSize, protocol, 
+																	msecs);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::LocateTimed(const char *, const char *, int, const int,
+																unsigned)
+
+PURPOSE:	Gets the sry id of a receiver process, locally or remotely,
+			taking no longer than msecs milliseconds.
+
+RETURNS:	success: sry id > 0
+			failure: -1, errno ETIMEDOUT if out of time
+***********************************************************************/
+
+int SRY::LocateTimed(const char *hname, const char *pname, int msgSize, 
+									const int protocol, unsigned msecs)
+{
+return (*LocateTimedPtr)(hname, pname, msgSize, protocol, msecs);
+}
+
 /**********************************************************************
 FUNCTION:	int SRY::Send(int, void *, unsigned, void *, unsigned)
 
@@ -170,12 +318,93 @@ int SRY::Send(int id, void *oPtr, unsigned oSize, void *iPtr, unsigned iSize)
 return (*SendPtr)(id, oPtr, oSize, iPtr, iSize);
 }
 
+/**********************************************************************
+FUNCTION:	int SRY::SendTimed(int, void *, unsigned, void *, unsigned, 
+																unsigned)
+
+PURPOSE:	This method sends messages to other receiver processes,
+			waiting no longer than msecs milliseconds for the reply.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1, errno ETIMEDOUT if out of time
+***********************************************************************/
+
+int SRY::SendTimed(int id, void *oPtr, unsigned oSize, void *iPtr, 
+										unsigned iSize, unsigned msecs)
+{
+return (*SendTimedPtr)(id, oPtr, oSize, iPtr, iSize, msecs);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::SendV(int, const struct iovec *, int, 
+											const struct iovec *, int)
+
+PURPOSE:	This method sends a message gathered from an array of buffers 
+			to another receiver process and scatters the reply into another
+			array of buffers. It is a blocking send.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::SendV(int id, const struct iovec *out, int outcnt, 
+									const struct iovec *in, int incnt)
+{
+return (*SendVPtr)(id, out, outcnt, in, incnt);
+}
+
+/**********************************************************************
+FUNCTION:	void *SRY::AcquireSendBuffer(unsigned)
+
+PURPOSE:	This method lends the message area of the sender's shmem to
+			be filled in place ahead of SendLoaned().
+
+RETURNS:	success: pointer to the message area
+			failure: NULL
+***********************************************************************/
+
+void *SRY::AcquireSendBuffer(unsigned size)
+{
+return (*AcquireSendBufferPtr)(size);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::SendLoaned(int, unsigned, unsigned)
+
+PURPOSE:	This method sends the message built in the loaned buffer to
+			another receiver process. It is a blocking send and the reply
+			is left in the loaned buffer.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::SendLoaned(int id, unsigned oSize, unsigned iSize)
+{
+return (*SendLoanedPtr)(id, oSize, iSize);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::Reserve(unsigned)
+
+PURPOSE:	This method makes the sender's shmem ready for messages and
+			replies of up to size bytes.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::Reserve(unsigned size)
+{
+return (*ReservePtr)(size);
+}
+
 /**********************************************************************
 FUNCTION:	int SRY::PostMessage(int, void *, unsigned, void *, unsigned)
 
 PURPOSE:	This method sends messages to other receiver processes.
 
-RETURNS:	success: 0
+RETURNS:	success: ticket, 0 up to MAX_NUM_POSTED_MESSAGES - 1 (31)
 			failure: -1
 ***********************************************************************/
 
@@ -198,6 +427,36 @@ int SRY::ReadReply(void *iPtr)
 return (*ReadReplyPtr)(iPtr);
 }
 
+/**********************************************************************
+FUNCTION:	int SRY::ReadTicketReply(int, void *)
+
+PURPOSE:	This method reads the reply to the message posted with the
+			given ticket.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReadTicketReply(int ticket, void *iPtr)
+{
+return (*ReadTicketReplyPtr)(ticket, iPtr);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReadAnyReply(int *, void *)
+
+PURPOSE:	This method reads the reply to any of the posted messages and
+			sets the ticket it was posted with.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReadAnyReply(int *ticket, void *iPtr)
+{
+return (*ReadAnyReplyPtr)(ticket, iPtr);
+}
+
 /**********************************************************************
 FUNCTION:	int SRY::Trigger(int, int)
 
@@ -214,1570 +473,10697 @@ return (*TriggerPtr)(id, proxy);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::Relay(void *, int)
+FUNCTION:	int SRY::SendPriority(int, void *, unsigned, void *, unsigned, 
+																	int)
 
-PURPOSE:	This method relays a message to a receiver.
+PURPOSE:	This method sends messages to other receiver processes with a
+			priority, for receivers that take messages in priority order.
+			It is a blocking send.
 
-RETURNS:	success: 0
+RETURNS:	success: reply msg size >= 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::Relay(void *sender, int fd)
+int SRY::SendPriority(int id, void *oPtr, unsigned oSize, void *iPtr, 
+											unsigned iSize, int priority)
 {
-return (*RelayPtr)(sender, fd);
+return (*SendPriorityPtr)(id, oPtr, oSize, iPtr, iSize, priority);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::getSenderName(void *, std::string&)
+FUNCTION:	int SRY::TriggerPriority(int, int, int)
 
-PURPOSE:	This method returns the sender sim name after a Send() call. 
+PURPOSE:	This method kicks or triggers a receiver with a priority.
+			It is non-blocking; that is it doesn't require a reply.
 
 RETURNS:	success: 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::getSenderName(void *sender, std::string& senderName)
+int SRY::TriggerPriority(int id, int proxy, int priority)
 {
-FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
-int ret = 0;
-
-if (sender == nullptr)
-	ret = -1;
-else
-	senderName = msgPtr->whom;
-
-return ret;
+return (*TriggerPriorityPtr)(id, proxy, priority);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::getSenderPid(void *)
+FUNCTION:	int SRY::SendKeyed(int, void *, unsigned, void *, unsigned, 
+																unsigned)
 
-PURPOSE:	This method returns the sender pid after a Send() call. 
+PURPOSE:	This method sends a message to the member of a receiver group
+			that the key hashes to, so that messages of the same key go to
+			the same member while the group's membership stays the same.
 
-RETURNS:	success: pid_t
+RETURNS:	success: number of bytes from Reply >= 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::getSenderPid(void *id)
+int SRY::SendKeyed(int id, void *out, unsigned outSize, void *in, 
+												unsigned inSize, unsigned key)
 {
-return (*getSenderPidPtr)(id);
+return (*SendKeyedPtr)(id, out, outSize, in, inSize, key);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::getSenderShmemSize(void *)
+FUNCTION:	int SRY::OpenChannel(const std::string&, unsigned, unsigned)
 
-PURPOSE:	This method returns the sender shmem size in bytes after a Send() 
-			call.
+PURPOSE:	This method makes a named publish/subscribe channel for
+			messages of up to msgSize bytes, holding the last depth of
+			them for its subscribers.
 
-RETURNS:	success: >= 0
+RETURNS:	success: channel id >= 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::getSenderShmemSize(void *id)
+int SRY::OpenChannel(const std::string &name, unsigned msgSize, unsigned depth)
 {
-return (*getSenderShmemSizePtr)(id);
+return (*OpenChannelPtr)(name.c_str(), msgSize, depth);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::getSenderMsgSize(void *)
+FUNCTION:	int SRY::OpenChannel(const char *, unsigned, unsigned)
 
-PURPOSE:	This method returns the sender msg size in bytes after a Send() 
-			call.
+PURPOSE:	This method makes a named publish/subscribe channel for
+			messages of up to msgSize bytes, holding the last depth of
+			them for its subscribers.
 
-RETURNS:	success: >= 0
+RETURNS:	success: channel id >= 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::getSenderMsgSize(void *id)
+int SRY::OpenChannel(const char *name, unsigned msgSize, unsigned depth)
 {
-return (*getSenderMsgSizePtr)(id);
+return (*OpenChannelPtr)(name, msgSize, depth);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::getSenderRplySize(void *)
+FUNCTION:	int SRY::Subscribe(const std::string&)
 
-PURPOSE:	This method returns the sender reply msg size in bytes after a 
-			Send() call.
+PURPOSE:	This method subscribes to the messages published on a channel
+			from now on.
 
-RETURNS:	success: >= 0
+RETURNS:	success: channel id >= 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::getSenderRplySize(void *id)
+int SRY::Subscribe(const std::string &name)
 {
-return (*getSenderRplySizePtr)(id);
+return (*SubscribePtr)(name.c_str());
 }
 
 /**********************************************************************
-FUNCTION:	bool SRY::chkReceiver(const char *)
+FUNCTION:	int SRY::Subscribe(const char *)
 
-PURPOSE:	This method checks that a local receiver is still sry name
-			attached.
+PURPOSE:	This method subscribes to the messages published on a channel
+			from now on.
 
-RETURNS:	success: 0
+RETURNS:	success: channel id >= 0
 			failure: -1
 ***********************************************************************/
 
-bool SRY::chkReceiver(const char *name, pid_t pid)
+int SRY::Subscribe(const char *name)
 {
-return (*chkReceiverPtr)(name, pid);
+return (*SubscribePtr)(name);
 }
 
 /**********************************************************************
-FUNCTION:	bool SRY::chkSender(void *)
+FUNCTION:	int SRY::Publish(int, const void *, unsigned)
 
-PURPOSE:	This method checks that a local sender is still running.
+PURPOSE:	This method publishes a message to all of the subscribers of
+			a channel at once. It does not block.
 
 RETURNS:	success: 0
 			failure: -1
 ***********************************************************************/
 
-bool SRY::chkSender(void *id)
+int SRY::Publish(int channel, const void *oPtr, unsigned oSize)
 {
-return (*chkSenderPtr)(id);
+return (*PublishPtr)(channel, oPtr, oSize);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::rfd(void)
+FUNCTION:	int SRY::ReadChannel(int, void *, unsigned, unsigned long *)
 
-PURPOSE:	Return the file descriptor to the receive fifo.
+PURPOSE:	This method reads the next message published on a subscribed 
+			channel, waiting for one if need be.
 
-RETURNS:	success: a file descriptor > 2
+RETURNS:	success: message size >= 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::rfd(void)
+int SRY::ReadChannel(int channel, void *iPtr, unsigned iSize, unsigned long *seq)
 {
-return (*rfdPtr)();
+return (*ReadChannelPtr)(channel, iPtr, iSize, seq);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::yfd(void)
+FUNCTION:	int SRY::ChkChannel(int)
 
-PURPOSE:	Return the file descriptor to the reply fifo.
+PURPOSE:	This method checks for messages on a subscribed channel that 
+			are yet to be read. It does not block.
 
-RETURNS:	success: a file descriptor > 2
+RETURNS:	success: number of messages >= 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::yfd(void)
+int SRY::ChkChannel(int channel)
 {
-return (*yfdPtr)();
+return (*ChkChannelPtr)(channel);
 }
 
 /**********************************************************************
-FUNCTION:	void simRcopy(void *, void *, unsigned)
-
-PURPOSE:	Copy unsigned nbytes from the sender's shmem pointer
-			to the desired address void *dst 
+FUNCTION:	int SRY::ChannelFd(int)
 
-			Follows a Receiver(&id, NULL, 0) call.
+PURPOSE:	This method returns an fd that polls readable once there are 
+			messages on a subscribed channel.
 
-RETURNS:	nothing
+RETURNS:	success: fd >= 0
+			failure: -1
 ***********************************************************************/
 
-void SRY::simRcopy(void *sender, void *dst, unsigned nBytes)
+int SRY::ChannelFd(int channel)
 {
-return (*simRcopyPtr)(sender, dst, nBytes);
+return (*ChannelFdPtr)(channel);
 }
 
 /**********************************************************************
-FUNCTION:	void simScopy(void *, unsigned)
-
-PURPOSE:	Copy unsigned nbytes from the sender's global shmem pointer
-			to the desired address void * 
+FUNCTION:	long SRY::getChannelLost(int)
 
-			Follows a Send(id, void *, NULL, outSize, inSize) call
+PURPOSE:	This method returns the number of messages published on a
+			subscribed channel that were overwritten before being read.
 
-RETURNS:	nothing
+RETURNS:	success: number of messages >= 0
+			failure: -1
 ***********************************************************************/
 
-void SRY::simScopy(void *dst, unsigned nBytes)
+long SRY::getChannelLost(int channel)
 {
-return (*simScopyPtr)(dst, nBytes);
+return (*getChannelLostPtr)(channel);
 }
 
 /**********************************************************************
-FUNCTION:	int SRY::closeSRYchild(void)
+FUNCTION:	int SRY::CloseChannel(int)
 
-PURPOSE:	Close SRY fifos and shmem of a child process.
+PURPOSE:	This method closes a published channel, or a subscription.
 
 RETURNS:	success: 0
 			failure: -1
 ***********************************************************************/
 
-int SRY::closeSRYchild(void)
+int SRY::CloseChannel(int channel)
 {
-return (*closeSRYchildPtr)();
+return (*CloseChannelPtr)(channel);
 }
-/*#############################################################################
-							End SRY Class Methods
-##############################################################################*/
-#endif
-
-/*#############################################################################
-							Start SRY C/C++ Functions
-##############################################################################*/
 
 /**********************************************************************
-FUNCTION:	int openSRY(const char *)
+FUNCTION:	int SRY::OpenStream(const std::string&, unsigned, unsigned, int,
+																		int)
+
+PURPOSE:	This method makes a named one-way stream of records of up to
+			recSize bytes for this program to consume, holding depth of 
+			them. policy says what the producer does when it is full, and
+			proxy, if not 0, is triggered when records come in.
+
+RETURNS:	success: stream id >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::OpenStream(const std::string &name, unsigned recSize, unsigned depth, 
+														int policy, int proxy)
+{
+return (*OpenStreamPtr)(name.c_str(), recSize, depth, policy, proxy);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::OpenStream(const char *, unsigned, unsigned, int, int)
+
+PURPOSE:	This method makes a named one-way stream of records of up to
+			recSize bytes for this program to consume, holding depth of 
+			them. policy says what the producer does when it is full, and
+			proxy, if not 0, is triggered when records come in.
+
+RETURNS:	success: stream id >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::OpenStream(const char *name, unsigned recSize, unsigned depth, 
+														int policy, int proxy)
+{
+return (*OpenStreamPtr)(name, recSize, depth, policy, proxy);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ConnectStream(const std::string&)
+
+PURPOSE:	This method connects to a stream as its one producer.
+
+RETURNS:	success: stream id >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ConnectStream(const std::string &name)
+{
+return (*ConnectStreamPtr)(name.c_str());
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ConnectStream(const char *)
+
+PURPOSE:	This method connects to a stream as its one producer.
+
+RETURNS:	success: stream id >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ConnectStream(const char *name)
+{
+return (*ConnectStreamPtr)(name);
+}
+
+/**********************************************************************
+FUNCTION:	void *SRY::ReserveStream(int, unsigned)
+
+PURPOSE:	This method reserves room in a stream for a record of nbytes, 
+			to be written in place and sent on by CommitStream().
+
+RETURNS:	success: pointer to the record
+			failure: NULL
+***********************************************************************/
+
+void *SRY::ReserveStream(int stream, unsigned nbytes)
+{
+return (*ReserveStreamPtr)(stream, nbytes);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::CommitStream(int)
+
+PURPOSE:	This method sends on all of the records reserved in a stream
+			since the last commit.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::CommitStream(int stream)
+{
+return (*CommitStreamPtr)(stream);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::WriteStream(int, const void *, unsigned)
+
+PURPOSE:	This method writes a record to a stream. No reply is waited 
+			for.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::WriteStream(int stream, const void *oPtr, unsigned oSize)
+{
+return (*WriteStreamPtr)(stream, oPtr, oSize);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReadStream(int, void *, unsigned)
+
+PURPOSE:	This method reads the next record of a stream, waiting for one
+			if need be.
+
+RETURNS:	success: record size >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReadStream(int stream, void *iPtr, unsigned iSize)
+{
+return (*ReadStreamPtr)(stream, iPtr, iSize);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ChkStream(int)
+
+PURPOSE:	This method checks for records in a stream that are yet to be
+			read. It does not block.
+
+RETURNS:	success: bytes of records >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ChkStream(int stream)
+{
+return (*ChkStreamPtr)(stream);
+}
+
+/**********************************************************************
+FUNCTION:	long SRY::getStreamLost(int)
+
+PURPOSE:	This method returns the number of records of a stream dropped 
+			to make room before being read.
+
+RETURNS:	success: number of records >= 0
+			failure: -1
+***********************************************************************/
+
+long SRY::getStreamLost(int stream)
+{
+return (*getStreamLostPtr)(stream);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::CloseStream(int)
+
+PURPOSE:	This method closes a stream, or disconnects its producer.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::CloseStream(int stream)
+{
+return (*CloseStreamPtr)(stream);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::Relay(void *, int)
+
+PURPOSE:	This method relays a message to a receiver.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::Relay(void *sender, int fd)
+{
+return (*RelayPtr)(sender, fd);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::Serve(SIM_HANDLER, void *, int)
+
+PURPOSE:	This method receives messages and has them handled and replied
+			to by a pool of worker threads.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::Serve(SIM_HANDLER handler, void *arg, int nthreads)
+{
+return (*ServePtr)(handler, arg, nthreads);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReactorMsg(SIM_HANDLER, void *, void *, unsigned)
+
+PURPOSE:	This method has Reactor() receive messages and proxies and
+			pass them to a handler.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReactorMsg(SIM_HANDLER handler, void *arg, void *buf, unsigned size)
+{
+return (*ReactorMsgPtr)(handler, arg, buf, size);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReactorFd(int, SIM_CALLBACK, void *)
+
+PURPOSE:	This method has Reactor() watch a file descriptor.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReactorFd(int fd, SIM_CALLBACK cb, void *arg)
+{
+return (*ReactorFdPtr)(fd, cb, arg);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReactorTimer(unsigned, bool, SIM_CALLBACK, void *)
+
+PURPOSE:	This method sets a Reactor() timer.
+
+RETURNS:	success: timer id >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReactorTimer(unsigned msecs, bool periodic, SIM_CALLBACK cb, 
+																	void *arg)
+{
+return (*ReactorTimerPtr)(msecs, periodic, cb, arg);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ReactorCancel(int)
+
+PURPOSE:	This method cancels a Reactor() timer.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ReactorCancel(int timer)
+{
+return (*ReactorCancelPtr)(timer);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::Reactor(void)
+
+PURPOSE:	This method runs the callbacks of messages, fds and timers as
+			they become due.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::Reactor()
+{
+return (*ReactorPtr)();
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::getSenderName(void *, std::string&)
+
+PURPOSE:	This method returns the sender sim name after a Send() call. 
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::getSenderName(void *sender, std::string& senderName)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+int ret = 0;
+
+if (sender == nullptr)
+	ret = -1;
+else
+	senderName = msgPtr->whom;
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::getSenderPid(void *)
+
+PURPOSE:	This method returns the sender pid after a Send() call. 
+
+RETURNS:	success: pid_t
+			failure: -1
+***********************************************************************/
+
+int SRY::getSenderPid(void *id)
+{
+return (*getSenderPidPtr)(id);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::getSenderShmemSize(void *)
+
+PURPOSE:	This method returns the sender shmem size in bytes after a Send() 
+			call.
+
+RETURNS:	success: >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::getSenderShmemSize(void *id)
+{
+return (*getSenderShmemSizePtr)(id);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::getSenderMsgSize(void *)
+
+PURPOSE:	This method returns the sender msg size in bytes after a Send() 
+			call.
+
+RETURNS:	success: >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::getSenderMsgSize(void *id)
+{
+return (*getSenderMsgSizePtr)(id);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::getSenderRplySize(void *)
+
+PURPOSE:	This method returns the sender reply msg size in bytes after a 
+			Send() call.
+
+RETURNS:	success: >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY::getSenderRplySize(void *id)
+{
+return (*getSenderRplySizePtr)(id);
+}
+
+/**********************************************************************
+FUNCTION:	bool SRY::chkReceiver(const char *)
+
+PURPOSE:	This method checks that a local receiver is still sry name
+			attached.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+bool SRY::chkReceiver(const char *name, pid_t pid)
+{
+return (*chkReceiverPtr)(name, pid);
+}
+
+/**********************************************************************
+FUNCTION:	bool SRY::chkSender(void *)
+
+PURPOSE:	This method checks that a local sender is still running.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+bool SRY::chkSender(void *id)
+{
+return (*chkSenderPtr)(id);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::rfd(void)
+
+PURPOSE:	Return the file descriptor to the receive fifo.
+
+RETURNS:	success: a file descriptor > 2
+			failure: -1
+***********************************************************************/
+
+int SRY::rfd(void)
+{
+return (*rfdPtr)();
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::yfd(void)
+
+PURPOSE:	Return the file descriptor to the reply fifo.
+
+RETURNS:	success: a file descriptor > 2
+			failure: -1
+***********************************************************************/
+
+int SRY::yfd(void)
+{
+return (*yfdPtr)();
+}
+
+/**********************************************************************
+FUNCTION:	void simRcopy(void *, void *, unsigned)
+
+PURPOSE:	Copy unsigned nbytes from the sender's shmem pointer
+			to the desired address void *dst 
+
+			Follows a Receiver(&id, NULL, 0) call.
+
+RETURNS:	nothing
+***********************************************************************/
+
+void SRY::simRcopy(void *sender, void *dst, unsigned nBytes)
+{
+return (*simRcopyPtr)(sender, dst, nBytes);
+}
+
+/**********************************************************************
+FUNCTION:	void simScopy(void *, unsigned)
+
+PURPOSE:	Copy unsigned nbytes from the sender's global shmem pointer
+			to the desired address void * 
+
+			Follows a Send(id, void *, NULL, outSize, inSize) call
+
+RETURNS:	nothing
+***********************************************************************/
+
+void SRY::simScopy(void *dst, unsigned nBytes)
+{
+return (*simScopyPtr)(dst, nBytes);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::closeSRYchild(void)
+
+PURPOSE:	Close SRY fifos and shmem of a child process.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::closeSRYchild(void)
+{
+return (*closeSRYchildPtr)();
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::getWaitStats(SIM_WAIT_STATS *, bool)
+
+PURPOSE:	Get (and optionally reset) the counts of spins and blocks while
+			waiting for messages and replies.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::getWaitStats(SIM_WAIT_STATS *stats, bool reset)
+{
+return (*getWaitStatsPtr)(stats, reset);
+}
+
+/**********************************************************************
+FUNCTION:	SRY_ASYNC SRY::SendAsync(int, void *, unsigned, void *, unsigned)
+
+PURPOSE:	This method posts a message and returns at once with a handle
+			on the reply, which is read into iPtr.
+
+RETURNS:	the reply handle; not valid() should the post have failed
+***********************************************************************/
+
+SRY_ASYNC SRY::SendAsync(int id, void *oPtr, unsigned oSize, void *iPtr, 
+																unsigned iSize)
+{
+return SRY_ASYNC((*SendAsyncPtr)(id, oPtr, oSize, iPtr, iSize));
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ChkTicketReply(int)
+
+PURPOSE:	This method checks without waiting whether the message posted
+			with the given ticket has been replied to.
+
+RETURNS:	replied: 1
+			not yet: 0
+			failure: -1
+***********************************************************************/
+
+int SRY::ChkTicketReply(int ticket)
+{
+return (*ChkTicketReplyPtr)(ticket);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::WaitReplies(const int *, int)
+
+PURPOSE:	This method waits until any one of the posted messages with
+			the given tickets has been replied to.
+
+RETURNS:	success: ticket of a replied message
+			failure: -1
+***********************************************************************/
+
+int SRY::WaitReplies(const int *tickets, int count)
+{
+return (*WaitRepliesPtr)(tickets, count);
+}
+
+/**********************************************************************
+FUNCTION:	int SRY::ResumeAsync(bool)
+
+PURPOSE:	This method resumes the coroutines whose co_awaited SendAsync()
+			replies are in. If wait is set and none are, it first waits
+			for one of them. This is the event loop of a thread running 
+			coroutines that call receivers.
+
+RETURNS:	success: number of coroutines still awaiting replies
+			failure: -1
+***********************************************************************/
+
+#ifdef __cpp_impl_coroutine
+int SRY::ResumeAsync(bool wait)
+{
+int tickets[MAX_NUM_POSTED_MESSAGES];
+int count = 0, resumed = 0;
+void *waiter = NULL;
+// void *AsyncWaiter[] is global
+
+while (true)
+	{
+	count = 0;
+	resumed = 0;
+	for (int i = 0; i < MAX_NUM_POSTED_MESSAGES; i++)
+		{
+		if (AsyncWaiter[i] == NULL)
+			continue;
+
+		// replied or else gone; either way await_resume() has the outcome
+		if ((*ChkTicketReplyPtr)(i) == 0)
+			{
+			tickets[count++] = i;
+			continue;
+			}
+		waiter = AsyncWaiter[i];
+		AsyncWaiter[i] = NULL;
+		std::coroutine_handle<>::from_address(waiter).resume();
+		resumed++;
+		}
+
+	if (!wait || resumed || count == 0)
+		break;
+
+	if ((*WaitRepliesPtr)(tickets, count) == -1)
+		return -1;
+	}
+
+// the resumed coroutines may have gone on to await more replies
+count = 0;
+for (int i = 0; i < MAX_NUM_POSTED_MESSAGES; i++)
+	if (AsyncWaiter[i] != NULL)
+		count++;
+
+return count;
+}
+#endif
+
+/**********************************************************************
+FUNCTION:	SRY_ASYNC::SRY_ASYNC(int)
+
+PURPOSE:	Constructor, from a SendAsync() ticket.
+***********************************************************************/
+
+SRY_ASYNC::SRY_ASYNC(int t) : ticket(t), result(-1)
+{
+}
+
+/**********************************************************************
+FUNCTION:	SRY_ASYNC::SRY_ASYNC(SRY_ASYNC&&)
+
+PURPOSE:	Move constructor; the reply is the new handle's to have.
+***********************************************************************/
+
+SRY_ASYNC::SRY_ASYNC(SRY_ASYNC &&other) : ticket(other.ticket), 
+															result(other.result)
+{
+other.ticket = -1;
+}
+
+/**********************************************************************
+FUNCTION:	bool SRY_ASYNC::valid(void)
+
+PURPOSE:	Is there a reply still to be had?
+
+RETURNS:	true/false
+***********************************************************************/
+
+bool SRY_ASYNC::valid()
+{
+return ticket != -1;
+}
+
+/**********************************************************************
+FUNCTION:	bool SRY_ASYNC::ready(void)
+
+PURPOSE:	Can the reply be had without waiting?
+
+RETURNS:	true/false
+***********************************************************************/
+
+bool SRY_ASYNC::ready()
+{
+return ticket == -1 || ChkTicketReply(ticket) != 0;
+}
+
+/**********************************************************************
+FUNCTION:	int SRY_ASYNC::get(void)
+
+PURPOSE:	Read the reply, waiting for it if need be. Further calls 
+			return the same outcome.
+
+RETURNS:	success: size of replied message >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY_ASYNC::get()
+{
+if (ticket != -1)
+	{
+	result = ReadTicketReply(ticket, NULL);
+	ticket = -1;
+	}
+
+return result;
+}
+
+#ifdef __cpp_impl_coroutine
+/**********************************************************************
+FUNCTION:	bool SRY_ASYNC::await_ready(void)
+
+PURPOSE:	co_await carries straight on if the reply is already in.
+
+RETURNS:	true/false
+***********************************************************************/
+
+bool SRY_ASYNC::await_ready()
+{
+return ready();
+}
+
+/**********************************************************************
+FUNCTION:	void SRY_ASYNC::await_suspend(std::coroutine_handle<>)
+
+PURPOSE:	Note the suspended coroutine against the ticket for 
+			SRY::ResumeAsync() to resume once the reply is in.
+
+RETURNS:	nothing
+***********************************************************************/
+
+void SRY_ASYNC::await_suspend(std::coroutine_handle<> waiter)
+{
+// void *AsyncWaiter[] is global
+
+AsyncWaiter[ticket] = waiter.address();
+}
+
+/**********************************************************************
+FUNCTION:	int SRY_ASYNC::await_resume(void)
+
+PURPOSE:	The outcome of co_await is that of get().
+
+RETURNS:	success: size of replied message >= 0
+			failure: -1
+***********************************************************************/
+
+int SRY_ASYNC::await_resume()
+{
+return get();
+}
+#endif
+
+/**********************************************************************
+FUNCTION:	SRY_ASYNC::~SRY_ASYNC(void)
+
+PURPOSE:	Destructor; a reply not yet had is read and dropped so that
+			its PostMessage() slot is freed.
+***********************************************************************/
+
+SRY_ASYNC::~SRY_ASYNC()
+{
+get();
+}
+/*#############################################################################
+							End SRY Class Methods
+##############################################################################*/
+#endif
+
+/*#############################################################################
+							Start SRY C/C++ Functions
+##############################################################################*/
+
+/**********************************************************************
+FUNCTION:	int openSRY(const char *)
 
 PURPOSE:	Initializes SIM module.
 
-NOTE:		This function takes a string argument which serves as a unique 
-			identifier for a SIM enabled process. It is necessary for a SIM 
-			enabled process to have a unique name so that it can be located by 
-			name.
+NOTE:		This function takes a string argument which serves as a unique 
+			identifier for a SIM enabled process. It is necessary for a SIM 
+			enabled process to have a unique name so that it can be located by 
+			name.
+			Options are taken from the environment, see initSimOptions().
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int openSRY(const char *name)
+{
+return openSRYopts(name, NULL);
+}
+
+/**********************************************************************
+FUNCTION:	int openSRYopts(const char *, const SIM_OPTIONS *)
+
+PURPOSE:	Initializes SIM module with the given options. A NULL options
+			pointer takes the options from the environment.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int openSRYopts(const char *name, const SIM_OPTIONS *opts)
+{
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
+// REMOTE_RECEIVERS RemoteReceivers is global
+// BLOCKED_SENDERS BlockedSenders is global
+const char *fn = "openSRY";
+int len = 0;
+pid_t pid = -1;
+SIM_OPTIONS envOpts;
+
+// a thread may open an instance of its own rather than use the process' one
+if (opts != NULL && opts->perThread)
+	{
+	if (openSimState() == -1)
+		return -1;
+	}
+
+// is this process (or thread) already SIM enabled? 
+if (sim_check() == true)
+	{
+	sryLog("%s: SIM already active for this process.\n", fn);
+	return -1;
+	}
+
+// needed for a number of purposes such as unique naming, checking ...
+SimParms.pid = getpid();
+
+// set up the SIM name by checking the length of the passed in name 
+len = strlen(name);
+if (len == 0) // SIM name too short
+	{
+	sryLog("%s: SIM name too short.\n", fn);
+	return -1;
+	}
+else if (len <= (MAX_SIM_NAME_LEN)) // acceptable name for SIM
+	{
+	strcpy(SimParms.whom, name);
+	}
+else // passed in name too long
+	{
+	sryLog("%s: SIM name too long.\n", fn);
+	return -1;
+	}
+
+// set the global SimFifoPath
+if (setFifoPath() == -1)
+	return -1;
+
+// map the name registry; without it names are looked for in the fifo path
+if (openRegistry() == -1)
+	sryLog("%s: No SIM name registry, searching fifo path.\n", fn);
+
+// check if the name is already in use
+pid = chkNamePid(name);
+if (pid != -1)
+	{
+	// pid is real; is the program still running?
+	if (chkStatus(pid, name) == true)
+		{
+		sryLog("%s: SIM name is already in use.\n", fn);
+		return -1;
+		}
+	}
+
+// options not passed in come from the environment
+if (opts == NULL)
+	{
+	if (initSimOptions(&envOpts) == -1)
+		return -1;
+	opts = &envOpts;
+	}
+
+// set the trigger/reply transport and how to wait
+if (opts->transport != SIM_FIFO && opts->transport != SIM_FUTEX)
+	{
+	sryLog("%s: unknown SIM transport %d.\n", fn, opts->transport);
+	return -1;
+	}
+if (opts->waitPolicy < SIM_WAIT_BLOCK || opts->waitPolicy > SIM_WAIT_POLL)
+	{
+	sryLog("%s: unknown SIM wait policy %d.\n", fn, opts->waitPolicy);
+	return -1;
+	}
+// spinning watches the futex transport's shared memory
+if (opts->waitPolicy != SIM_WAIT_BLOCK && opts->transport != SIM_FUTEX)
+	{
+	sryLog("%s: SIM wait policy %d needs the futex transport.\n", fn, 
+														opts->waitPolicy);
+	return -1;
+	}
+if (opts->shmBackend != SIM_SHM_SYSV && opts->shmBackend != SIM_SHM_MEMFD)
+	{
+	sryLog("%s: unknown SIM shmem backend %d.\n", fn, opts->shmBackend);
+	return -1;
+	}
+// receivers reach a memfd shmem by way of /proc/<pid>/fd
+if (opts->shmBackend == SIM_SHM_MEMFD && prctl(PR_GET_DUMPABLE) != 1)
+	{
+	sryLog("%s: memfd shmem needs a dumpable (eg. not setuid) process.\n", fn);
+	return -1;
+	}
+if (opts->hugePages < SIM_HUGE_NONE || opts->hugePages > SIM_HUGE_EXPLICIT)
+	{
+	sryLog("%s: unknown SIM huge pages setting %d.\n", fn, opts->hugePages);
+	return -1;
+	}
+if (opts->ioEngine != SIM_IO_SYSCALL && opts->ioEngine != SIM_IO_URING)
+	{
+	sryLog("%s: unknown SIM io engine %d.\n", fn, opts->ioEngine);
+	return -1;
+	}
+if (opts->receiveOrder < SIM_ORDER_FIFO || opts->receiveOrder > SIM_ORDER_INHERIT)
+	{
+	sryLog("%s: unknown SIM receive order %d.\n", fn, opts->receiveOrder);
+	return -1;
+	}
+if (opts->proxyMode != SIM_PROXY_QUEUE && opts->proxyMode != SIM_PROXY_COALESCE)
+	{
+	sryLog("%s: unknown SIM proxy mode %d.\n", fn, opts->proxyMode);
+	return -1;
+	}
+if (opts->groupPolicy != SIM_GROUP_ROUND_ROBIN && 
+							opts->groupPolicy != SIM_GROUP_LEAST_LOADED)
+	{
+	sryLog("%s: unknown SIM group policy %d.\n", fn, opts->groupPolicy);
+	return -1;
+	}
+SimParms.transport = opts->transport;
+SimParms.waitPolicy = opts->waitPolicy;
+SimParms.spinCount = opts->spinCount;
+SimParms.shmBackend = opts->shmBackend;
+SimParms.hugePages = opts->hugePages;
+SimParms.populate = opts->populate;
+SimParms.shmGrowth = opts->shmGrowth;
+SimParms.receiveOrder = opts->receiveOrder;
+SimParms.groupPolicy = opts->groupPolicy;
+
+// a futex mailbox must be in place before senders can find the receive fifo
+if (SimParms.transport == SIM_FUTEX)
+	{
+	if (createMailbox() == -1)
+		{
+		sryLog("%s: Mailbox creation error\n", fn);
+		return -1;
+		}
+	}
+
+// as must the proxy table of a receiver coalescing proxies
+if (opts->proxyMode == SIM_PROXY_COALESCE)
+	{
+	if (createProxyTable() == -1)
+		{
+		sryLog("%s: Proxy table creation error\n", fn);
+		return -1;
+		}
+	}
+
+// name, create and open the receive and reply fifos
+if (createFifos() == -1)
+	{
+	sryLog("%s: Fifo creation error\n", fn);
+	return -1;
+	}
+
+// a receiver group member joins its group once its fifo can be found
+if (opts->group != NULL && opts->group[0])
+	{
+	if (joinGroup(opts->group) == -1)
+		{
+		sryLog("%s: Unable to join group %s\n", fn, opts->group);
+		return -1;
+		}
+	}
+
+// note the instance so that its fifos are removed whichever thread exits
+addSimInstance();
+
+// shmem size = 0 indicates shmem has not yet been made
+SimParms.shmSize = 0;
+
+// add a signal handler
+initSignalHandling();
+
+//add the exit functionality, once for all threads
+if (__atomic_exchange_n(&SimExitHooked, 1, __ATOMIC_ACQ_REL) == 0)
+	atexit(exitFunc);
+
+// initialize the tables of surrogates, senders, reply fifos and receivers
+initSimTables();
+
+// batch the trigger reads and reply writes if asked, else fall back on syscalls
+SimParms.ioEngine = SIM_IO_SYSCALL;
+if (opts->ioEngine == SIM_IO_URING)
+	{
+	if (SimParms.transport != SIM_FIFO)
+		sryLog("%s: io_uring is for the fifo transport, using syscalls.\n", fn);
+	else if (openUring() == -1)
+		sryLog("%s: No io_uring, using syscalls.\n", fn);
+	else
+		SimParms.ioEngine = SIM_IO_URING;
+	}
+
+// make shmem for the expected message size up front
+if (opts->shmReserve)
+	if (reserveShmem(opts->shmReserve, false) == -1)
+		sryLog("%s: Unable to reserve shmem, made on demand.\n", fn);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int initSimOptions(SIM_OPTIONS *)
+
+PURPOSE:	Set options to the defaults, as overridden by the environment
+			variables SIM_TRANSPORT (fifo/futex), SIM_WAIT_POLICY 
+			(block/spin/poll), SIM_SPIN_COUNT, SIM_SHM_BACKEND (sysv/memfd),
+			SIM_HUGE_PAGES (none/transparent/explicit), 
+			SIM_SHM_POPULATE (0/1), SIM_SHM_RESERVE (bytes), 
+			SIM_SHM_GROWTH (percent), SIM_IO_ENGINE (syscall/uring),
+			SIM_RECEIVE_ORDER (fifo/priority/inherit),
+			SIM_PROXY_MODE (queue/coalesce), SIM_GROUP (name) and
+			SIM_GROUP_POLICY (roundrobin/leastloaded).
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int initSimOptions(SIM_OPTIONS *opts)
+{
+const char *fn = "initSimOptions";
+char *p = NULL;
+
+opts->transport = SIM_FIFO;
+opts->waitPolicy = SIM_WAIT_BLOCK;
+// spinning on a single cpu only holds up the other party
+opts->spinCount = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? DefaultSpinCount : 0;
+opts->shmBackend = SIM_SHM_SYSV;
+opts->hugePages = SIM_HUGE_NONE;
+opts->populate = 0;
+opts->shmReserve = 0;
+opts->shmGrowth = DefaultShmGrowth;
+opts->ioEngine = SIM_IO_SYSCALL;
+opts->receiveOrder = SIM_ORDER_FIFO;
+opts->proxyMode = SIM_PROXY_QUEUE;
+opts->group = getenv("SIM_GROUP");
+opts->groupPolicy = SIM_GROUP_ROUND_ROBIN;
+opts->perThread = false;
+
+p = getenv("SIM_TRANSPORT");
+if (p != NULL)
+	{
+	if (!strcmp(p, "futex"))
+		opts->transport = SIM_FUTEX;
+	else if (strcmp(p, "fifo"))
+		{
+		sryLog("%s: unknown SIM transport %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+p = getenv("SIM_WAIT_POLICY");
+if (p != NULL)
+	{
+	if (!strcmp(p, "spin"))
+		opts->waitPolicy = SIM_WAIT_SPIN;
+	else if (!strcmp(p, "poll"))
+		opts->waitPolicy = SIM_WAIT_POLL;
+	else if (strcmp(p, "block"))
+		{
+		sryLog("%s: unknown SIM wait policy %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+p = getenv("SIM_SPIN_COUNT");
+if (p != NULL)
+	opts->spinCount = strtoul(p, NULL, 10);
+
+p = getenv("SIM_SHM_BACKEND");
+if (p != NULL)
+	{
+	if (!strcmp(p, "memfd"))
+		opts->shmBackend = SIM_SHM_MEMFD;
+	else if (strcmp(p, "sysv"))
+		{
+		sryLog("%s: unknown SIM shmem backend %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+p = getenv("SIM_HUGE_PAGES");
+if (p != NULL)
+	{
+	if (!strcmp(p, "transparent"))
+		opts->hugePages = SIM_HUGE_TRANSPARENT;
+	else if (!strcmp(p, "explicit"))
+		opts->hugePages = SIM_HUGE_EXPLICIT;
+	else if (strcmp(p, "none"))
+		{
+		sryLog("%s: unknown SIM huge pages setting %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+p = getenv("SIM_SHM_POPULATE");
+if (p != NULL)
+	opts->populate = atoi(p);
+
+p = getenv("SIM_SHM_RESERVE");
+if (p != NULL)
+	opts->shmReserve = strtoul(p, NULL, 10);
+
+p = getenv("SIM_SHM_GROWTH");
+if (p != NULL)
+	opts->shmGrowth = strtoul(p, NULL, 10);
+
+p = getenv("SIM_IO_ENGINE");
+if (p != NULL)
+	{
+	if (!strcmp(p, "uring"))
+		opts->ioEngine = SIM_IO_URING;
+	else if (strcmp(p, "syscall"))
+		{
+		sryLog("%s: unknown SIM io engine %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+p = getenv("SIM_RECEIVE_ORDER");
+if (p != NULL)
+	{
+	if (!strcmp(p, "priority"))
+		opts->receiveOrder = SIM_ORDER_PRIORITY;
+	else if (!strcmp(p, "inherit"))
+		opts->receiveOrder = SIM_ORDER_INHERIT;
+	else if (strcmp(p, "fifo"))
+		{
+		sryLog("%s: unknown SIM receive order %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+p = getenv("SIM_PROXY_MODE");
+if (p != NULL)
+	{
+	if (!strcmp(p, "coalesce"))
+		opts->proxyMode = SIM_PROXY_COALESCE;
+	else if (strcmp(p, "queue"))
+		{
+		sryLog("%s: unknown SIM proxy mode %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+p = getenv("SIM_GROUP_POLICY");
+if (p != NULL)
+	{
+	if (!strcmp(p, "leastloaded"))
+		opts->groupPolicy = SIM_GROUP_LEAST_LOADED;
+	else if (strcmp(p, "roundrobin"))
+		{
+		sryLog("%s: unknown SIM group policy %s.\n", fn, p);
+		return -1;
+		}
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int closeSRY(void)
+
+PURPOSE:	Removes SIM functionality upon process exit or SRY cancelled
+			SRY instantiation.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int closeSRY()
+{
+//const char *fn = "closeSRY";
+// WHO_AM_I SimParms is global 
+// REMOTE_RECEIVERS RemoteReceivers is global
+// BLOCKED_SENDERS BlockedSenders is global
+	
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+//	sryLog("%s: No SIM name attached.\n", fn);
+	return -1;
+	}
+
+// a Serve() worker only borrows its dispatcher's instance
+if (SimServeWorker)
+	{
+	closeServeWorker();
+	return 0;
+	}
+
+// release any reply-blocked senders
+releaseBlockedSenders(true);
+
+// write out the replies held by io_uring, if any, before the fifos go
+closeUring(true);
+
+// detach from all cached sender shmem and reply fifos
+releaseAllSenderShmem();
+closeAllReplyFifos();
+
+// remove any surrogates
+releaseRemoteReceivers(true);
+
+// unmap the mailboxes and proxy tables of located receivers and groups
+releaseAllLocatedReceivers();
+releaseAllGroups();
+
+// delete message shared memory segments
+if (SimParms.shmSize)
+	detachShmem(SimParms.shmid, SimParms.shmPtr, &SimParms.shmSize);
+releaseAllPostSlots();
+releaseRetiredShmem();
+
+// close the channels and streams while still registered
+releaseAllChannels(false);
+releaseAllStreams(false);
+
+// no longer to be sent to as one of a receiver group
+leaveGroup();
+
+// delete receive and reply fifos
+deleteFifos();
+
+// delete the futex transport mailbox, if any
+deleteMailbox();
+
+// and the proxy table of a coalescing receiver
+deleteProxyTable();
+
+// unmap the name registry
+closeRegistry();
+
+// the reactor watches the receive fifo
+closeReactor();
+
+// the receiving thread goes back to its own priority
+inheritPriority(0);
+
+// no longer one of this process' SIM instances
+removeSimInstance();
+
+// for checking purposes
+SimParms.pid = -1;
+
+// a thread's own instance goes, leaving it with the process' one
+closeSimState();
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int closeSRYchild(void)
+
+PURPOSE:	Removes a parent's SIM functionality from a child process.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int closeSRYchild()
+{
+// WHO_AM_I SimParms is global 
+const char *fn = "closeSRYchild";
+	
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: No SIM name attached.\n", fn);
+	return -1;
+	}
+
+// detach message shared memory segments
+if (SimParms.shmSize)
+	detachShmem(SimParms.shmid, SimParms.shmPtr, &SimParms.shmSize);
+releaseAllPostSlots();
+releaseRetiredShmem();
+
+// the parent's io_uring, and the replies it holds, are not the child's
+closeUring(false);
+
+// detach from any senders' shmem and reply fifos inherited from the parent
+releaseAllSenderShmem();
+closeAllReplyFifos();
+
+// detach from the receive and reply fifos
+detachFifos();
+
+// unmap the parent's mailbox, its proxy table and those of the receivers 
+// it located
+detachMailbox();
+detachProxyTable();
+releaseAllLocatedReceivers();
+
+// the parent's place in its receiver group is the parent's, as are the groups
+// it located
+detachGroup();
+releaseAllGroups();
+
+// the parent's epoll set is not the child's to change
+closeReactor();
+
+// nor are the parent's channels and streams the child's to close
+releaseAllChannels(true);
+releaseAllStreams(true);
+
+// the parent's SIM instances, this one included, are the parent's to remove
+for (int i = 0; i < MAX_NUM_SIM_INSTANCES; i++)
+	SimInstance[i].used = 0;
+SimInstanceSlot = -1;
+
+// for checking purposes
+SimParms.pid = -1;
+
+// a thread's own instance goes, and then the process' one, should the parent
+// have opened that too
+if (SimState->perThread)
+	{
+	closeSimState();
+	if (sim_check() == true)
+		return closeSRYchild();
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int Send(int, void *, unsigned, void *, unsigned)
+
+PURPOSE:	This function sends SIM messages to other processes.
+
+RETURNS:	success: number of bytes from Reply >= 0
+			failure: -1
+***********************************************************************/
+
+int Send(int fd, void *outBuffer, unsigned outBytes, void *inBuffer, unsigned 
+inBytes)
+{
+const char *fn = "Send";
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+unsigned bufSize = 0;
+FCMSG_REC *msgPtr = NULL;
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+// check the veracity of the fd
+if (fd < 3)
+	{
+	sryLog("%s: SIM id is out of range.\n", fn);
+	errno = EBADF;
+	return -1;
+	}
+
+// calculate the largest buffer size for this messaging
+bufSize = (outBytes >= inBytes) ? outBytes : inBytes;
+
+// build shmem as needed, with room to grow
+if (reserveShmem(bufSize, true) == -1)
+	{
+	sryLog("%s: Create shmem error\n", fn);
+	return -1;
+	}
+
+// copy the message into shmem to be read by the receiver
+msgPtr = (FCMSG_REC *)SimParms.shmPtr;
+strcpy(msgPtr->whom, SimParms.whom);
+msgPtr->pid = SimParms.pid;
+msgPtr->shmsize = bufSize;
+msgPtr->nbytes = outBytes;
+msgPtr->ybytes = inBytes;
+msgPtr->replyVia = SimParms.transport;
+msgPtr->replyState = REPLY_PENDING;
+msgPtr->slot = 0;
+msgPtr->priority = SimSendPriority;
+if (outBuffer != NULL)
+	memcpy((void *)&msgPtr->data, outBuffer, outBytes);
+
+// line up the triggering message for the fifo
+fifoMsg->shmid = SimParms.shmid;
+fifoMsg->pid = (SimParms.shmBackend == SIM_SHM_MEMFD) ? SimParms.pid : 0;
+fifoMsg->priority = SimSendPriority;
+
+/*
+sender writes on receiver's fifo (or mailbox), or that of a group member
+receiver will read the fifo and get sender's shmem id (schmid)
+*/
+if (sendTrigger(fd, fifoBuf, msgPtr, SimParms.groupPolicy) != sizeof(FIFO_MSG))
+	{
+	sryLog("%s: Unable to write to fifo -%s\n", fn, strerror(errno));
+	return -1;
+	}
+
+if (msgPtr->replyVia == SIM_FUTEX)
+	{
+	// wait for the receiver to set the reply futex in shmem
+	if (waitReplyFutex(msgPtr, fifoBuf) != sizeof(FIFO_MSG) &&
+					abandonSend(msgPtr, fifoBuf) != sizeof(FIFO_MSG))
+		{
+		if (errno != ETIMEDOUT)
+			sryLog("%s: Futex wait error -%s\n", fn, strerror(errno));
+		return -1;
+		}
+	}
+// wait for the receiver to send fifo message to trigger the reply
+else if (waitReplyFifo(msgPtr, fifoBuf) != sizeof(FIFO_MSG) &&
+					abandonSend(msgPtr, fifoBuf) != sizeof(FIFO_MSG))
+	{
+	// a SendTimed() deadline leaves the reply fifo as it is
+	if (errno == ETIMEDOUT)
+		return -1;
+	sryLog("%s: Fifo read error\n", fn);
+	close(SimParms.yfd);
+	SimParms.yfd = -1;
+	return -1;
+	}
+
+// was there a problem in the send such as a call to ReplyError()?
+if (fifoMsg->shmid == -1)
+	{
+	sryLog("%s: receive/reply problem ... could be a failed receiver.\n", fn);
+	return -1;
+	}
+
+// copy the reply message
+if (inBuffer != NULL)
+	if (msgPtr->nbytes)
+		memcpy(inBuffer, (void *)&msgPtr->data, msgPtr->nbytes);
+
+// return the size of the reply message
+return msgPtr->nbytes;
+}
+
+/**********************************************************************
+FUNCTION:	int SendTimed(int, void *, unsigned, void *, unsigned, unsigned)
+
+PURPOSE:	This function sends SIM messages to other processes as Send()
+			does, but gives up on the reply after msecs milliseconds. The
+			message is then abandoned: a receiver yet to receive it skips
+			it and a late Reply() to it fails, while the next message goes
+			in new shmem so that nothing late can land on it.
+
+RETURNS:	success: number of bytes from Reply >= 0
+			failure: -1, errno ETIMEDOUT if out of time
+
+NOTE:		After a timeout a buffer from AcquireSendBuffer() is no longer
+			good and must be acquired again.
+***********************************************************************/
+
+int SendTimed(int fd, void *outBuffer, unsigned outBytes, void *inBuffer, 
+											unsigned inBytes, unsigned msecs)
+{
+// SIM_DEADLINE SimDeadline is global
+int rc = -1;
+
+setDeadline(msecs);
+rc = Send(fd, outBuffer, outBytes, inBuffer, inBytes);
+SimDeadline.set = false;
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	void *AcquireSendBuffer(unsigned)
+
+PURPOSE:	This function lends the message area of the sender's shmem,
+			made at least size bytes, so that a message may be built in
+			place and sent by SendLoaned() without being copied. The reply
+			is read in place from the same area after SendLoaned().
+
+RETURNS:	success: pointer to the message area
+			failure: NULL
+
+NOTE:		The pointer remains good until shmem is rebuilt for a larger
+			message by Send(), SendV(), Reserve() or AcquireSendBuffer().
+***********************************************************************/
+
+void *AcquireSendBuffer(unsigned size)
+{
+const char *fn = "AcquireSendBuffer";
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return NULL;
+	}
+
+// build shmem as needed, with room to grow
+if (reserveShmem(size, true) == -1)
+	{
+	sryLog("%s: Create shmem error\n", fn);
+	return NULL;
+	}
+
+return (void *)&((FCMSG_REC *)SimParms.shmPtr)->data;
+}
+
+/**********************************************************************
+FUNCTION:	int SendLoaned(int, unsigned, unsigned)
+
+PURPOSE:	This function sends the message of outBytes already built in 
+			the buffer lent by AcquireSendBuffer() and waits for a reply of
+			up to inBytes, which is left in the same buffer.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SendLoaned(int fd, unsigned outBytes, unsigned inBytes)
+{
+const char *fn = "SendLoaned";
+unsigned bufSize = 0;
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+// check the veracity of the fd before touching shmem
+if (fd < 3)
+	{
+	sryLog("%s: SIM id is out of range.\n", fn);
+	errno = EBADF;
+	return -1;
+	}
+
+// calculate the largest buffer size for this messaging
+bufSize = (outBytes >= inBytes) ? outBytes : inBytes;
+
+// rebuilding shmem here would lose the message
+if (SimParms.shmSize < (bufSize + (unsigned)sizeof(FCMSG_REC)))
+	{
+	sryLog("%s: Message larger than the loaned buffer.\n", fn);
+	return -1;
+	}
+
+// the message is already in shmem and the reply is left there
+return Send(fd, NULL, outBytes, NULL, inBytes);
+}
+
+/**********************************************************************
+FUNCTION:	int SendV(int, const struct iovec *, int, const struct iovec *,
+																	int)
+
+PURPOSE:	This function gathers a message from outcnt buffers straight
+			into the sender's shmem, sends it and scatters the reply from
+			shmem straight into incnt buffers, saving the copy into and out
+			of one contiguous buffer.
+
+RETURNS:	success: reply msg size >= 0
+			failure: -1
+***********************************************************************/
+
+int SendV(int fd, const struct iovec *out, int outcnt, const struct iovec *in, 
+																	int incnt)
+{
+const char *fn = "SendV";
+unsigned outBytes = 0, inBytes = 0, bufSize = 0, left = 0, len = 0;
+char *p = NULL;
+int nbytes = -1, i = 0;
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+// check the veracity of the fd before touching shmem
+if (fd < 3)
+	{
+	sryLog("%s: SIM id is out of range.\n", fn);
+	errno = EBADF;
+	return -1;
+	}
+
+// calculate the largest buffer size for this messaging
+outBytes = iovLength(out, outcnt);
+inBytes = iovLength(in, incnt);
+bufSize = (outBytes >= inBytes) ? outBytes : inBytes;
+
+// build shmem as needed, with room to grow
+if (reserveShmem(bufSize, true) == -1)
+	{
+	sryLog("%s: Create shmem error\n", fn);
+	return -1;
+	}
+
+// gather the message into shmem
+p = (char *)&((FCMSG_REC *)SimParms.shmPtr)->data;
+for (i = 0; i < outcnt; i++)
+	{
+	memcpy(p, out[i].iov_base, out[i].iov_len);
+	p += out[i].iov_len;
+	}
+
+// the message is already in shmem and the reply is left there
+nbytes = Send(fd, NULL, outBytes, NULL, inBytes);
+if (nbytes <= 0)
+	return nbytes;
+
+// scatter the reply
+p = (char *)&((FCMSG_REC *)SimParms.shmPtr)->data;
+left = nbytes;
+for (i = 0; i < incnt && left; i++)
+	{
+	len = (in[i].iov_len < left) ? in[i].iov_len : left;
+	memcpy(in[i].iov_base, p, len);
+	p += len;
+	left -= len;
+	}
+
+return nbytes;
+}
+
+/**********************************************************************
+FUNCTION:	int Reserve(unsigned)
+
+PURPOSE:	This function makes the sender's shmem large enough for
+			messages and replies of up to size bytes ahead of time, so
+			that Send() and PostMessage() need not rebuild it. Shmem is
+			never made smaller.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Any pointer from AcquireSendBuffer() is no longer good if the
+			shmem had to be rebuilt.
+***********************************************************************/
+
+int Reserve(unsigned size)
+{
+const char *fn = "Reserve";
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+if (reserveShmem(size, false) == -1)
+	{
+	sryLog("%s: Create shmem error\n", fn);
+	return -1;
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int PostMesssage(int, void *, unsigned, unsigned)
+
+PURPOSE:	This function sends SIM messages to other processes, however
+			it does not return a reply. It is essentially the "top half"
+			of a Send(). Each posted message has its own slot and shmem 
+			so that up to MAX_NUM_POSTED_MESSAGES may be awaiting replies,
+			from the same or different receivers, alongside any Send().
+
+RETURNS:	success: ticket, 0 up to MAX_NUM_POSTED_MESSAGES - 1 (31), for
+					 ReadTicketReply()
+			failure: -1
+
+NOTE:		Before PostMessage() had slots it returned 0 on success; callers
+			testing for 0 rather than -1 must test for >= 0.
+***********************************************************************/
+
+int PostMessage(int fd, void *outBuffer, unsigned outBytes, unsigned inBytes)
+{
+const char *fn = "PostMessage";
+char fifoBuf[sizeof(FIFO_MSG)];
+unsigned bufSize = 0;
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+FCMSG_REC *msgPtr = NULL;
+POST_SLOT *slot = NULL;
+int ticket = -1;
+// WHO_AM_I SimParms is global 
+// POST_SLOT PostSlot[] is global
+// unsigned long PostSlotClock is global
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+// check the veracity of the fd
+if (fd < 3)
+	{
+	sryLog("%s: SIM id is out of range.\n", fn);
+	return -1;
+	}
+
+// find a free slot
+for (int i = 0; i < MAX_NUM_POSTED_MESSAGES; i++)
+	{
+	if (!PostSlot[i].posted)
+		{
+		ticket = i;
+		break;
+		}
+	}
+if (ticket == -1)
+	{
+	sryLog("%s: Too many messages awaiting replies.\n", fn);
+	return -1;
+	}
+slot = &PostSlot[ticket];
+
+// calculate the largest buffer size for this messaging
+bufSize = (outBytes >= inBytes) ? outBytes : inBytes;
+
+// build the slot's shmem as needed, with room to grow
+if (resizeShmem(&slot->shmid, &slot->shmPtr, &slot->shmSize, bufSize, 
+																true) == -1)
+	{
+	sryLog("%s: Create shmem error\n", fn);
+	return -1;
+	}
+
+// copy the message into shmem to be read by the receiver
+msgPtr = (FCMSG_REC *)slot->shmPtr;
+strcpy(msgPtr->whom, SimParms.whom);
+msgPtr->pid = SimParms.pid;
+msgPtr->shmsize = bufSize;
+msgPtr->nbytes = outBytes;
+msgPtr->ybytes = inBytes;
+/*
+Posted replies come by way of the reply fifo whatever the wait policy, so that
+yfd() stays pollable and ReadAnyReply() and WaitReplies() can wait on several;
+the spin and poll policies spin on the reply states first, see 
+spinPostedReplies().
+*/
+msgPtr->replyVia = SIM_FIFO;
+msgPtr->replyState = REPLY_PENDING;
+msgPtr->slot = ticket + 1;
+msgPtr->priority = SimSendPriority;
+if (outBuffer != NULL)
+	memcpy((void *)&msgPtr->data, outBuffer, outBytes);
+
+// line up the triggering message for the fifo
+fifoMsg->shmid = slot->shmid;
+fifoMsg->pid = (SimParms.shmBackend == SIM_SHM_MEMFD) ? SimParms.pid : 0;
+fifoMsg->priority = SimSendPriority;
+
+/*
+sender writes on receiver's fifo (or mailbox), or that of a group member
+receiver will read the fifo and get sender's shmem id (schmid)
+*/
+if (sendTrigger(fd, fifoBuf, msgPtr, SimParms.groupPolicy) != sizeof(FIFO_MSG))
+	{
+	sryLog("%s: Unable to write to fifo -%s\n", fn, strerror(errno));
+	return -1;
+	}
+
+slot->posted = true;
+slot->seq = ++PostSlotClock;
+slot->inBuffer = NULL;
+
+return ticket;
+}
+
+/**********************************************************************
+FUNCTION:	int ReadReply(void *)
+
+PURPOSE:	This function receives SIM reply messages from other processes.
+			It is essentially the "bottom half" of a Send(). Follows a call
+			to PostMessage(); with several messages posted it reads the 
+			reply to any one of them, see ReadAnyReply().
+
+RETURNS:	success: size of replied message >=0
+			failure: -1
+
+NOTE:		inBuffer must hold the inBytes given to PostMessage().
+***********************************************************************/
+
+int ReadReply(void *inBuffer)
+{
+return ReadAnyReply(NULL, inBuffer);
+}
+
+/**********************************************************************
+FUNCTION:	int ReadTicketReply(int, void *)
+
+PURPOSE:	This function waits for and reads the reply to the message 
+			posted by the PostMessage() that returned ticket.
+
+RETURNS:	success: size of replied message >=0
+			failure: -1
+
+NOTE:		inBuffer must hold the inBytes given to PostMessage().
+***********************************************************************/
+
+int ReadTicketReply(int ticket, void *inBuffer)
+{
+const char *fn = "ReadTicketReply";
+// POST_SLOT PostSlot[] is global
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+if (ticket < 0 || ticket >= MAX_NUM_POSTED_MESSAGES || 
+											!PostSlot[ticket].posted)
+	{
+	sryLog("%s: No message posted for ticket %d.\n", fn, ticket);
+	return -1;
+	}
+
+return collectPostedReply(ticket, inBuffer);
+}
+
+/**********************************************************************
+FUNCTION:	int ReadAnyReply(int *, void *)
+
+PURPOSE:	This function reads the reply to whichever posted message is 
+			replied first, the earliest posted if several already are, and
+			sets ticket (if not NULL) to its PostMessage() ticket.
+
+RETURNS:	success: size of replied message >=0
+			failure: -1
+
+NOTE:		inBuffer must hold the inBytes given to PostMessage().
+***********************************************************************/
+
+int ReadAnyReply(int *ticket, void *inBuffer)
+{
+const char *fn = "ReadAnyReply";
+char fifoBuf[sizeof(FIFO_MSG)];
+FCMSG_REC *msgPtr = NULL;
+int replied = -1, oldest = -1, state = REPLY_PENDING;
+// WHO_AM_I SimParms is global 
+// POST_SLOT PostSlot[] is global
+// int ReplyFifoTokens is global
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+while (true)
+	{
+	// look for the earliest of the posted messages, and of those replied
+	replied = -1;
+	oldest = -1;
+	for (int i = 0; i < MAX_NUM_POSTED_MESSAGES; i++)
+		{
+		if (!PostSlot[i].posted)
+			continue;
+		if (oldest == -1 || PostSlot[i].seq < PostSlot[oldest].seq)
+			oldest = i;
+		msgPtr = (FCMSG_REC *)PostSlot[i].shmPtr;
+		state = __atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE);
+		if (state != REPLY_DONE && state != REPLY_FAILED)
+			continue;
+		if (replied == -1 || PostSlot[i].seq < PostSlot[replied].seq)
+			replied = i;
+		}
+
+	if (replied != -1)
+		break;
+
+	if (oldest == -1)
+		{
+		sryLog("%s: No messages posted.\n", fn);
+		return -1;
+		}
+
+	// spin on the posted messages' reply states first, as the policy has it
+	if (spinPostedReplies(NULL, 0))
+		continue;
+
+	// wait for the next reply fifo message, whichever message it is for
+	if (readFifoMsg(SimParms.yfd, fifoBuf) != sizeof(FIFO_MSG))
+		{
+		sryLog("%s: Fifo read error\n", fn);
+		close(SimParms.yfd);
+		SimParms.yfd = -1;
+		return -1;
+		}
+	ReplyFifoTokens++;
+	}
+
+if (ticket != NULL)
+	*ticket = replied;
+
+return collectPostedReply(replied, inBuffer);
+}
+
+/**********************************************************************
+FUNCTION:	int SendAsync(int, void *, unsigned, void *, unsigned)
+
+PURPOSE:	This function posts a SIM message as PostMessage() does and
+			remembers where the reply is to go, so that the reply can be
+			read later with a NULL inBuffer. The sender carries on while
+			the receiver works on the message.
+
+RETURNS:	success: ticket >= 0 for ChkTicketReply(), WaitReplies() and
+					 ReadTicketReply()
+			failure: -1
+
+NOTE:		inBuffer must stay put until the reply has been read.
+***********************************************************************/
+
+int SendAsync(int fd, void *outBuffer, unsigned outBytes, void *inBuffer, 
+															unsigned inBytes)
+{
+int ticket = -1;
+// POST_SLOT PostSlot[] is global
+
+ticket = PostMessage(fd, outBuffer, outBytes, inBytes);
+if (ticket == -1)
+	return -1;
+
+PostSlot[ticket].inBuffer = inBuffer;
+
+return ticket;
+}
+
+/**********************************************************************
+FUNCTION:	int ChkTicketReply(int)
+
+PURPOSE:	This function checks without waiting whether the message 
+			posted with ticket has been replied to, in which case 
+			ReadTicketReply() will not have to wait for it.
+
+RETURNS:	replied: 1
+			not yet: 0
+			failure: -1
+***********************************************************************/
+
+int ChkTicketReply(int ticket)
+{
+const char *fn = "ChkTicketReply";
+FCMSG_REC *msgPtr = NULL;
+int state = REPLY_PENDING;
+// POST_SLOT PostSlot[] is global
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active\n", fn);
+	return -1;
+	}
+
+if (ticket < 0 || ticket >= MAX_NUM_POSTED_MESSAGES || 
+											!PostSlot[ticket].posted)
+	{
+	sryLog("%s: No message posted for ticket %d.\n", fn, ticket);
+	return -1;
+	}
+
+msgPtr = (FCMSG_REC *)PostSlot[ticket].shmPtr;
+state = __atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE);
+
+return (state == REPLY_DONE || state == REPLY_FAILED) ? 1 : 0;
+}
+
+/**********************************************************************
+FUNCTION:	int WaitReplies(const int *, int)
+
+PURPOSE:	This function waits until any one of count posted messages
+			has been replied to. The reply is not read; ReadTicketReply()
+			then reads it without waiting.
+
+RETURNS:	success: ticket of a replied message
+			failure: -1
+***********************************************************************/
+
+int WaitReplies(const int *tickets, int count)
+{
+const char *fn = "WaitReplies";
+char fifoBuf[sizeof(FIFO_MSG)];
+int rc = 0;
+// WHO_AM_I SimParms is global 
+// POST_SLOT PostSlot[] is global
+// int ReplyFifoTokens is global
+
+if (tickets == NULL || count < 1)
+	{
+	sryLog("%s: No tickets to wait on.\n", fn);
+	return -1;
+	}
+
+while (true)
+	{
+	for (int i = 0; i < count; i++)
+		{
+		rc = ChkTicketReply(tickets[i]);
+		if (rc == -1)
+			return -1;
+		if (rc == 1)
+			return tickets[i];
+		}
+
+	// spin on the tickets' reply states first, as the policy has it
+	if (spinPostedReplies(tickets, count))
+		continue;
+
+	// wait for the next reply fifo message, whichever message it is for
+	if (readFifoMsg(SimParms.yfd, fifoBuf) != sizeof(FIFO_MSG))
+		{
+		sryLog("%s: Fifo read error\n", fn);
+		close(SimParms.yfd);
+		SimParms.yfd = -1;
+		return -1;
+		}
+	ReplyFifoTokens++;
+	}
+}
+
+/**********************************************************************
+FUNCTION:	int Trigger(int, int)
+
+PURPOSE:	This function sends a proxy to a receiver type process.
+			A receiver coalescing proxies has it counted in its proxy
+			table instead, the receive fifo only carrying a wakeup for
+			the first of a burst.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int Trigger(int fd, int proxy)
+{
+const char *fn = "Trigger";
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+int rc = 0;
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+// check proxy value
+if (proxy < 1)
+	{
+	sryLog("%s: Improper proxy value, should be > 0.\n", fn);
+	return -1;
+	}
+
+// negative value marks a proxy
+fifoMsg->shmid = -proxy;
+fifoMsg->pid = 0;
+fifoMsg->priority = SimSendPriority;
+
+// a proxy to a receiver group goes to one of its members
+if (fd >= SIM_GROUP_ID)
+	rc = writeGroupTrigger(fd, fifoBuf, NULL, SimParms.groupPolicy);
+// counted in the receiver's proxy table, or else queued on the fifo as always
+else
+	{
+	rc = postProxy(fd, proxy);
+	if (rc == 0 && writeTrigger(fd, fifoBuf) != sizeof(FIFO_MSG))
+		rc = -1;
+	}
+
+if (rc == -1)
+	{
+	sryLog("%s: unable to write to fifo -%s\n", fn, strerror(errno));
+	return -1;
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int SendPriority(int, void *, unsigned, void *, unsigned, int)
+
+PURPOSE:	This function sends SIM messages to other processes as Send()
+			does, tagged with a priority from 0 up to SIM_MAX_PRIORITY. A
+			receiver taking messages in priority order receives the 
+			message ahead of any waiting ones of lower priority.
+
+RETURNS:	success: number of bytes from Reply >= 0
+			failure: -1
+***********************************************************************/
+
+int SendPriority(int fd, void *outBuffer, unsigned outBytes, void *inBuffer, 
+										unsigned inBytes, int priority)
+{
+const char *fn = "SendPriority";
+// int SimSendPriority is global
+int rc = -1;
+
+if (priority < 0 || priority > SIM_MAX_PRIORITY)
+	{
+	sryLog("%s: Priority %d is out of range.\n", fn, priority);
+	return -1;
+	}
+
+SimSendPriority = priority;
+rc = Send(fd, outBuffer, outBytes, inBuffer, inBytes);
+SimSendPriority = 0;
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int TriggerPriority(int, int, int)
+
+PURPOSE:	This function sends a proxy to a receiver type process as 
+			Trigger() does, tagged with a priority from 0 up to 
+			SIM_MAX_PRIORITY.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int TriggerPriority(int fd, int proxy, int priority)
+{
+const char *fn = "TriggerPriority";
+// int SimSendPriority is global
+int rc = -1;
+
+if (priority < 0 || priority > SIM_MAX_PRIORITY)
+	{
+	sryLog("%s: Priority %d is out of range.\n", fn, priority);
+	return -1;
+	}
+
+SimSendPriority = priority;
+rc = Trigger(fd, proxy);
+SimSendPriority = 0;
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int SendKeyed(int, void *, unsigned, void *, unsigned, unsigned)
+
+PURPOSE:	This function sends SIM messages to a receiver group located 
+			by Locate("@group") as Send() does, choosing the member by a
+			hash of the key rather than by the group policy, so that the
+			messages of a key go to the one member for as long as the
+			members stay the same. Sent to a lone receiver the key plays 
+			no part.
+
+RETURNS:	success: number of bytes from Reply >= 0
+			failure: -1
+***********************************************************************/
+
+int SendKeyed(int fd, void *outBuffer, unsigned outBytes, void *inBuffer, 
+										unsigned inBytes, unsigned key)
+{
+// long SimSendKey is global
+int rc = -1;
+
+SimSendKey = key;
+rc = Send(fd, outBuffer, outBytes, inBuffer, inBytes);
+SimSendKey = -1;
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int OpenChannel(const char *, unsigned, unsigned)
+
+PURPOSE:	This function makes a named publish/subscribe channel, a ring 
+			of depth messages of up to msgSize bytes each in memory shared
+			with the subscribers. The name is registered as a SIM name is
+			and so must not be in use by a SIM program, stream or another
+			channel.
+
+RETURNS:	success: channel id >= 0
+			failure: -1
+***********************************************************************/
+
+int OpenChannel(const char *name, unsigned msgSize, unsigned depth)
+{
+const char *fn = "OpenChannel";
+// WHO_AM_I SimParms is global
+// SIM_CHANNEL SimChannel[] is global
+SIM_CHANNEL *c = NULL;
+unsigned numSlots = 1;
+pid_t pid = -1;
+int ch = -1;
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+if (name == NULL || name[0] == '\0' || strlen(name) > MAX_SIM_NAME_LEN)
+	{
+	sryLog("%s: Channel name too short or too long.\n", fn);
+	return -1;
+	}
+
+if (msgSize == 0 || msgSize > INT_MAX || depth == 0 || depth > MaxChannelDepth)
+	{
+	sryLog("%s: Message size %u or depth %u out of range.\n", fn, msgSize, 
+																	depth);
+	return -1;
+	}
+
+// check if the name is already in use, by a SIM program, channel or stream
+pid = chkNamePid(name);
+if (pid == -1)
+	pid = chkChannelPid(name);
+if (pid == -1)
+	pid = chkStreamPid(name);
+if (pid != -1 && chkStatus(pid, name) == true)
+	{
+	sryLog("%s: Name %s is already in use.\n", fn, name);
+	return -1;
+	}
+
+ch = freeChannel();
+if (ch == -1)
+	{
+	sryLog("%s: No room for another channel.\n", fn);
+	return -1;
+	}
+c = &SimChannel[ch];
+
+// the ring is indexed by masking the sequence number
+while (numSlots < depth)
+	numSlots <<= 1;
+
+c->hdr = createChannel(name, msgSize, numSlots, &c->mapSize);
+if (c->hdr == NULL)
+	return -1;
+
+strcpy(c->name, name);
+c->publisher = true;
+for (int i = 0; i < MAX_NUM_CHANNEL_SUBSCRIBERS; i++)
+	{
+	c->subFd[i] = -1;
+	c->subGeneration[i] = 0;
+	}
+
+// subscribers find the channel by way of the registration
+registerName(name, SimParms.pid);
+
+return ch;
+}
+
+/**********************************************************************
+FUNCTION:	int Subscribe(const char *)
+
+PURPOSE:	This function subscribes to a channel made by OpenChannel(),
+			for the messages published on it from now on.
+
+RETURNS:	success: channel id >= 0
+			failure: -1
+***********************************************************************/
+
+int Subscribe(const char *name)
+{
+const char *fn = "Subscribe";
+// SIM_CHANNEL SimChannel[] is global
+SIM_CHANNEL *c = NULL;
+pid_t pid = -1;
+int ch = -1;
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+if (name == NULL || name[0] == '\0' || strlen(name) > MAX_SIM_NAME_LEN)
+	{
+	sryLog("%s: Channel name too short or too long.\n", fn);
+	return -1;
+	}
+
+// pid is real; is the publisher still running?
+pid = chkChannelPid(name);
+if (pid == -1 || chkStatus(pid, name) == false)
+	{
+	sryLog("%s: No channel %s.\n", fn, name);
+	return -1;
+	}
+
+ch = freeChannel();
+if (ch == -1)
+	{
+	sryLog("%s: No room for another channel.\n", fn);
+	return -1;
+	}
+c = &SimChannel[ch];
+
+c->hdr = attachChannel(name, pid, &c->mapSize);
+if (c->hdr == NULL)
+	{
+	sryLog("%s: Unable to attach to channel %s.\n", fn, name);
+	return -1;
+	}
+
+strcpy(c->name, name);
+c->publisher = false;
+if (joinChannel(c) == -1)
+	{
+	munmap(c->hdr, c->mapSize);
+	c->hdr = NULL;
+	return -1;
+	}
+
+// nothing published before now is read
+c->next = __atomic_load_n(&c->hdr->head, __ATOMIC_ACQUIRE) + 1;
+c->lost = 0;
+
+return ch;
+}
+
+/**********************************************************************
+FUNCTION:	int Publish(int, const void *, unsigned)
+
+PURPOSE:	This function writes a message once into the ring of a channel
+			for all of its subscribers to read. It never waits on the 
+			subscribers; one that falls more than the depth of the ring 
+			behind loses the messages written over.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int Publish(int channel, const void *outBuffer, unsigned outBytes)
+{
+const char *fn = "Publish";
+SIM_CHANNEL *c = NULL;
+CHANNEL_HDR *hdr = NULL;
+CHANNEL_SLOT *slot = NULL;
+unsigned long seq;
+
+c = getChannel(channel, true, fn);
+if (c == NULL)
+	return -1;
+hdr = c->hdr;
+
+if (outBytes > hdr->msgSize)
+	{
+	sryLog("%s: message size %u > channel message size %u\n", fn, outBytes,
+																hdr->msgSize);
+	return -1;
+	}
+
+// only the publisher moves the head on
+seq = hdr->head + 1;
+slot = channelSlot(hdr, seq);
+
+/*
+The slot's sequence number is cleared while the message is written over it, so
+that a subscriber copying out the message it held finds it has been overrun.
+*/
+__atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+__atomic_thread_fence(__ATOMIC_RELEASE);
+if (outBuffer != NULL)
+	memcpy(&slot->data, outBuffer, outBytes);
+slot->nbytes = outBytes;
+__atomic_store_n(&slot->seq, seq, __ATOMIC_RELEASE);
+__atomic_store_n(&hdr->head, seq, __ATOMIC_SEQ_CST);
+
+// wake the subscribers asleep in ReadChannel(), all of them at once
+__atomic_add_fetch(&hdr->wake, 1, __ATOMIC_SEQ_CST);
+if (__atomic_load_n(&hdr->sleepers, __ATOMIC_SEQ_CST))
+	simFutex(&hdr->wake, FUTEX_WAKE, INT_MAX);
+
+// and nudge those polling their ChannelFd()
+notifySubscribers(c, false);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int ReadChannel(int, void *, unsigned, unsigned long *)
+
+PURPOSE:	This function reads the next message published on a subscribed
+			channel, waiting for one if need be, along with its sequence
+			number. A gap in the sequence numbers is the number of 
+			messages lost to overrun, see getChannelLost().
+
+RETURNS:	success: message size in bytes
+			failure: -1, as well as once the channel is closed and read
+***********************************************************************/
+
+int ReadChannel(int channel, void *inBuffer, unsigned maxBytes, 
+														unsigned long *seq)
+{
+const char *fn = "ReadChannel";
+SIM_CHANNEL *c = NULL;
+int closed, nbytes;
+
+c = getChannel(channel, false, fn);
+if (c == NULL)
+	return -1;
+
+while (true)
+	{
+	// the messages published before the channel was closed are read first
+	closed = __atomic_load_n(&c->hdr->closed, __ATOMIC_ACQUIRE);
+
+	nbytes = takeChannelMsg(c, inBuffer, maxBytes);
+	if (nbytes != -1)
+		break;
+
+	if (closed)
+		{
+		sryLog("%s: Channel %s is closed.\n", fn, c->name);
+		return -1;
+		}
+
+	if (waitChannel(c) == -1)
+		return -1;
+	}
+
+// is the message larger than the subscriber's message buffer?
+if ((unsigned)nbytes > maxBytes)
+	{
+	sryLog("%s: message size %d > buffer size %u\n", fn, nbytes, maxBytes);
+	return -1;
+	}
+
+if (seq != NULL)
+	*seq = c->next - 1;
+
+return nbytes;
+}
+
+/**********************************************************************
+FUNCTION:	int ChkChannel(int)
+
+PURPOSE:	This function counts the messages on a subscribed channel yet
+			to be read, without waiting. A count of 0 also has the next
+			message published make ChannelFd() readable.
+
+RETURNS:	success: number of messages >= 0
+			failure: -1, as well as once the channel is closed and read
+***********************************************************************/
+
+int ChkChannel(int channel)
+{
+const char *fn = "ChkChannel";
+SIM_CHANNEL *c = NULL;
+unsigned long waiting;
+char nudge[64];
+int closed;
+
+c = getChannel(channel, false, fn);
+if (c == NULL)
+	return -1;
+
+// the nudges that made the fd readable are done with once looked at
+while (read(c->fd, nudge, sizeof nudge) > 0)
+	;
+
+closed = __atomic_load_n(&c->hdr->closed, __ATOMIC_ACQUIRE);
+
+waiting = channelWaiting(c);
+if (waiting == 0)
+	{
+	// ask for a nudge, then look again in case the message came in between
+	__atomic_store_n(&c->hdr->sub[c->place].notify, 1, __ATOMIC_SEQ_CST);
+	waiting = channelWaiting(c);
+	}
+
+if (waiting == 0 && closed)
+	{
+	sryLog("%s: Channel %s is closed.\n", fn, c->name);
+	return -1;
+	}
+
+return (waiting > INT_MAX) ? INT_MAX : (int)waiting;
+}
+
+/**********************************************************************
+FUNCTION:	int ChannelFd(int)
+
+PURPOSE:	This function returns the fd of a subscribed channel to be 
+			polled. It is readable once there are messages to read, 
+			which are then read by way of ReadChannel() for as long as 
+			ChkChannel() finds any.
+
+RETURNS:	success: fd >= 0
+			failure: -1
+***********************************************************************/
+
+int ChannelFd(int channel)
+{
+const char *fn = "ChannelFd";
+SIM_CHANNEL *c = NULL;
+char nudge = 0;
+
+c = getChannel(channel, false, fn);
+if (c == NULL)
+	return -1;
+
+// messages already waiting, or the close, nudge the fd straight away
+if (ChkChannel(channel) != 0)
+	write(c->fd, &nudge, 1);
+
+return c->fd;
+}
+
+/**********************************************************************
+FUNCTION:	long getChannelLost(int)
+
+PURPOSE:	This function returns the number of messages on a subscribed
+			channel that were written over before they could be read.
+
+RETURNS:	success: number of messages >= 0
+			failure: -1
+***********************************************************************/
+
+long getChannelLost(int channel)
+{
+const char *fn = "getChannelLost";
+SIM_CHANNEL *c = NULL;
+
+c = getChannel(channel, false, fn);
+if (c == NULL)
+	return -1;
+
+return (long)c->lost;
+}
+
+/**********************************************************************
+FUNCTION:	int CloseChannel(int)
+
+PURPOSE:	This function closes a channel made by OpenChannel(), its
+			subscribers reading what is left before ReadChannel() fails,
+			or gives up a subscription made by Subscribe().
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int CloseChannel(int channel)
+{
+const char *fn = "CloseChannel";
+// SIM_CHANNEL SimChannel[] is global
+
+if (channel < 0 || channel >= MAX_NUM_CHANNELS || SimChannel[channel].hdr == NULL)
+	{
+	sryLog("%s: No channel %d.\n", fn, channel);
+	return -1;
+	}
+
+releaseChannel(&SimChannel[channel], false);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int OpenStream(const char *, unsigned, unsigned, int, int)
+
+PURPOSE:	This function makes a named one-way stream for this program to
+			consume, a ring in memory shared with its one producer that
+			holds at least depth records of up to recSize bytes each. 
+			policy is what the producer does when the ring is full, see 
+			SIM_STREAM_POLICIES. proxy, if not 0, is triggered on this 
+			program when records come in after ChkStream() found none. 
+			The name is registered as a SIM name is and so must not be in
+			use by a SIM program, channel or another stream.
+
+RETURNS:	success: stream id >= 0
+			failure: -1
+***********************************************************************/
+
+int OpenStream(const char *name, unsigned recSize, unsigned depth, int policy,
+																	int proxy)
+{
+const char *fn = "OpenStream";
+// WHO_AM_I SimParms is global
+// SIM_STREAM SimStream[] is global
+SIM_STREAM *s = NULL;
+unsigned long long bytes;
+unsigned size = 1;
+pid_t pid = -1;
+int st = -1;
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+if (name == NULL || name[0] == '\0' || strlen(name) > MAX_SIM_NAME_LEN)
+	{
+	sryLog("%s: Stream name too short or too long.\n", fn);
+	return -1;
+	}
+
+if (recSize == 0 || recSize > MaxStreamBytes / 2 || depth < 2 || 
+	policy < SIM_STREAM_BLOCK || policy > SIM_STREAM_FAIL || proxy < 0)
+	{
+	sryLog("%s: Record size %u, depth %u, policy %d or proxy %d out of range.\n",
+											fn, recSize, depth, policy, proxy);
+	return -1;
+	}
+
+// with 2 records or more, one always fits along with the filler before it
+bytes = (unsigned long long)streamRecLen(recSize) * depth;
+if (bytes > MaxStreamBytes)
+	{
+	sryLog("%s: Stream of %llu bytes is too large.\n", fn, bytes);
+	return -1;
+	}
+
+// the ring is indexed by masking the byte count
+while (size < bytes)
+	size <<= 1;
+
+// check if the name is already in use, by a SIM program, channel or stream
+pid = chkNamePid(name);
+if (pid == -1)
+	pid = chkChannelPid(name);
+if (pid == -1)
+	pid = chkStreamPid(name);
+if (pid != -1 && chkStatus(pid, name) == true)
+	{
+	sryLog("%s: Name %s is already in use.\n", fn, name);
+	return -1;
+	}
+
+st = freeStream();
+if (st == -1)
+	{
+	sryLog("%s: No room for another stream.\n", fn);
+	return -1;
+	}
+s = &SimStream[st];
+
+s->hdr = createStream(name, recSize, size, policy, proxy, &s->mapSize);
+if (s->hdr == NULL)
+	return -1;
+
+strcpy(s->name, name);
+s->ring = (char *)s->hdr + s->hdr->ringOffset;
+s->producer = false;
+s->cached = 0;
+
+// the producer finds the stream by way of the registration
+registerName(name, SimParms.pid);
+
+return st;
+}
+
+/**********************************************************************
+FUNCTION:	int ConnectStream(const char *)
+
+PURPOSE:	This function connects to a stream made by OpenStream() as its
+			producer. There is one producer at a time; another may connect
+			once it has closed, or is gone.
+
+RETURNS:	success: stream id >= 0
+			failure: -1
+***********************************************************************/
+
+int ConnectStream(const char *name)
+{
+const char *fn = "ConnectStream";
+// WHO_AM_I SimParms is global
+// SIM_STREAM SimStream[] is global
+SIM_STREAM *s = NULL;
+STREAM_HDR *hdr = NULL;
+pid_t pid = -1, owner = 0;
+int st = -1;
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+if (name == NULL || name[0] == '\0' || strlen(name) > MAX_SIM_NAME_LEN)
+	{
+	sryLog("%s: Stream name too short or too long.\n", fn);
+	return -1;
+	}
+
+// pid is real; is the consumer still running?
+pid = chkStreamPid(name);
+if (pid == -1 || chkStatus(pid, name) == false)
+	{
+	sryLog("%s: No stream %s.\n", fn, name);
+	return -1;
+	}
+
+st = freeStream();
+if (st == -1)
+	{
+	sryLog("%s: No room for another stream.\n", fn);
+	return -1;
+	}
+s = &SimStream[st];
+
+hdr = attachStream(name, pid, &s->mapSize);
+if (hdr == NULL)
+	{
+	sryLog("%s: Unable to attach to stream %s.\n", fn, name);
+	return -1;
+	}
+
+// take the place of the producer, should it be gone
+if (!__atomic_compare_exchange_n(&hdr->producer, &owner, SimParms.pid, false,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+	// errno must be cleared prior to getpriority() call
+	errno = 0;
+	if (getpriority(PRIO_PROCESS, owner) != -1 || errno != ESRCH ||
+		!__atomic_compare_exchange_n(&hdr->producer, &owner, SimParms.pid, 
+								false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+		sryLog("%s: Stream %s already has a producer.\n", fn, name);
+		munmap(hdr, s->mapSize);
+		return -1;
+		}
+	}
+
+// the consumer to trigger the proxy on
+s->consumerId = -1;
+if (hdr->proxy)
+	{
+	s->consumerId = Locate("", hdr->whom, 0, SIM_LOCAL);
+	if (s->consumerId == -1)
+		{
+		sryLog("%s: Unable to locate consumer %s.\n", fn, hdr->whom);
+		__atomic_store_n(&hdr->producer, 0, __ATOMIC_RELEASE);
+		munmap(hdr, s->mapSize);
+		return -1;
+		}
+	}
+
+s->hdr = hdr;
+strcpy(s->name, name);
+s->ring = (char *)hdr + hdr->ringOffset;
+s->producer = true;
+
+// carry on from the last record committed by an earlier producer
+s->reserve = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+s->cached = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+__atomic_store_n(&hdr->producerWaiting, 0, __ATOMIC_RELAXED);
+__atomic_add_fetch(&hdr->connects, 1, __ATOMIC_RELEASE);
+
+return st;
+}
+
+/**********************************************************************
+FUNCTION:	void *ReserveStream(int, unsigned)
+
+PURPOSE:	This function reserves room in a stream for a record of nbytes,
+			to be written in place. Any number of records may be reserved
+			before CommitStream() sends them all on at once. A full ring
+			is dealt with as the stream's policy says, the records 
+			reserved so far being committed first.
+
+RETURNS:	success: pointer to the record
+			failure: NULL, without logging for a full SIM_STREAM_FAIL ring
+***********************************************************************/
+
+void *ReserveStream(int stream, unsigned nbytes)
+{
+const char *fn = "ReserveStream";
+SIM_STREAM *s = NULL;
+STREAM_HDR *hdr = NULL;
+STREAM_REC *rec = NULL;
+unsigned long need;
+unsigned len, pos;
+
+s = getStream(stream, true, fn);
+if (s == NULL)
+	return NULL;
+hdr = s->hdr;
+
+if (nbytes > hdr->recSize)
+	{
+	sryLog("%s: record size %u > stream record size %u\n", fn, nbytes, 
+																hdr->recSize);
+	return NULL;
+	}
+
+// a record does not wrap; the end of the ring is filled instead
+len = streamRecLen(nbytes);
+pos = s->reserve & (hdr->size - 1);
+need = (pos + len > hdr->size) ? hdr->size - pos + len : len;
+
+// the tail is only read again once the room last seen is used up
+if (s->reserve + need - s->cached > hdr->size)
+	{
+	s->cached = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+	if (s->reserve + need - s->cached > hdr->size && 
+											makeStreamRoom(s, need) == -1)
+		return NULL;
+	}
+
+if (need != len)
+	{
+	streamRec(s, s->reserve)->nbytes = StreamPad;
+	s->reserve += hdr->size - pos;
+	}
+
+rec = streamRec(s, s->reserve);
+rec->nbytes = nbytes;
+s->reserve += len;
+
+return rec + 1;
+}
+
+/**********************************************************************
+FUNCTION:	int CommitStream(int)
+
+PURPOSE:	This function sends on the records reserved in a stream since
+			the last commit, waking the consumer should it be waiting.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int CommitStream(int stream)
+{
+const char *fn = "CommitStream";
+SIM_STREAM *s = NULL;
+
+s = getStream(stream, true, fn);
+if (s == NULL)
+	return -1;
+
+if (__atomic_load_n(&s->hdr->closed, __ATOMIC_ACQUIRE))
+	{
+	sryLog("%s: Stream %s is closed.\n", fn, s->name);
+	return -1;
+	}
+
+commitStream(s);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int WriteStream(int, const void *, unsigned)
+
+PURPOSE:	This function writes a record to a stream and commits it. 
+			Nothing is waited for but, under SIM_STREAM_BLOCK, room in the
+			ring.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int WriteStream(int stream, const void *outBuffer, unsigned outBytes)
+{
+void *rec = NULL;
+
+rec = ReserveStream(stream, outBytes);
+if (rec == NULL)
+	return -1;
+
+if (outBuffer != NULL)
+	memcpy(rec, outBuffer, outBytes);
+
+return CommitStream(stream);
+}
+
+/**********************************************************************
+FUNCTION:	int ReadStream(int, void *, unsigned)
+
+PURPOSE:	This function reads the next record of a stream made by 
+			OpenStream(), waiting for one if need be.
+
+RETURNS:	success: record size in bytes
+			failure: -1, as well as once the producer has closed, or is 
+			gone, and its records are read
+***********************************************************************/
+
+int ReadStream(int stream, void *inBuffer, unsigned maxBytes)
+{
+const char *fn = "ReadStream";
+SIM_STREAM *s = NULL;
+STREAM_HDR *hdr = NULL;
+STREAM_REC *rec = NULL;
+unsigned long tail;
+unsigned nbytes, pos;
+bool gone;
+
+s = getStream(stream, false, fn);
+if (s == NULL)
+	return -1;
+hdr = s->hdr;
+
+while (true)
+	{
+	tail = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+
+	// the head is only read again once the records last seen are used up
+	if (tail >= s->cached)
+		{
+		// a producer gone is looked for before its last records are
+		gone = __atomic_load_n(&hdr->producer, __ATOMIC_ACQUIRE) == 0 &&
+							__atomic_load_n(&hdr->connects, __ATOMIC_ACQUIRE);
+		s->cached = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+		if (tail >= s->cached)
+			{
+			if (gone)
+				{
+				sryLog("%s: Stream %s has no producer.\n", fn, s->name);
+				return -1;
+				}
+
+			if (waitStream(s) == -1)
+				return -1;
+			continue;
+			}
+		}
+
+	pos = tail & (hdr->size - 1);
+	rec = streamRec(s, tail);
+	nbytes = __atomic_load_n(&rec->nbytes, __ATOMIC_RELAXED);
+
+	if (nbytes == StreamPad)
+		{
+		advanceStream(s, tail, tail + hdr->size - pos);
+		continue;
+		}
+
+	// only a record being dropped to make room is torn
+	if (nbytes > hdr->recSize || pos + streamRecLen(nbytes) > hdr->size)
+		{
+		if (hdr->policy == SIM_STREAM_DROP_OLDEST)
+			continue;
+		sryLog("%s: Stream %s is corrupt.\n", fn, s->name);
+		return -1;
+		}
+
+	if (inBuffer != NULL && nbytes <= maxBytes)
+		memcpy(inBuffer, rec + 1, nbytes);
+
+	// still the same record once copied?
+	if (advanceStream(s, tail, tail + streamRecLen(nbytes)))
+		break;
+	}
+
+// is the record larger than the consumer's buffer?
+if (nbytes > maxBytes)
+	{
+	sryLog("%s: record size %u > buffer size %u\n", fn, nbytes, maxBytes);
+	return -1;
+	}
+
+return (int)nbytes;
+}
+
+/**********************************************************************
+FUNCTION:	int ChkStream(int)
+
+PURPOSE:	This function measures the records of a stream yet to be read,
+			without waiting. Finding none also has the next commit, or the
+			producer closing, trigger the stream's proxy, if it has one.
+
+RETURNS:	success: bytes of records >= 0
+			failure: -1, as well as once the producer has closed, or is 
+			gone, and its records are read
+***********************************************************************/
+
+int ChkStream(int stream)
+{
+const char *fn = "ChkStream";
+SIM_STREAM *s = NULL;
+STREAM_HDR *hdr = NULL;
+unsigned long waiting;
+bool gone;
+
+s = getStream(stream, false, fn);
+if (s == NULL)
+	return -1;
+hdr = s->hdr;
+
+// a producer gone is looked for before its last records are
+gone = __atomic_load_n(&hdr->producer, __ATOMIC_SEQ_CST) == 0 &&
+							__atomic_load_n(&hdr->connects, __ATOMIC_ACQUIRE);
+
+waiting = __atomic_load_n(&hdr->head, __ATOMIC_SEQ_CST) - 
+								__atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+if (waiting == 0 && hdr->proxy)
+	{
+	// ask for the proxy, then look again in case a record came in between
+	__atomic_store_n(&hdr->notify, 1, __ATOMIC_SEQ_CST);
+	waiting = __atomic_load_n(&hdr->head, __ATOMIC_SEQ_CST) - 
+								__atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+	}
+
+if (waiting == 0 && gone)
+	{
+	sryLog("%s: Stream %s has no producer.\n", fn, s->name);
+	return -1;
+	}
+
+return (waiting > INT_MAX) ? INT_MAX : (int)waiting;
+}
+
+/**********************************************************************
+FUNCTION:	long getStreamLost(int)
+
+PURPOSE:	This function returns the number of records of a stream that 
+			were dropped to make room before they could be read.
+
+RETURNS:	success: number of records >= 0
+			failure: -1
+***********************************************************************/
+
+long getStreamLost(int stream)
+{
+const char *fn = "getStreamLost";
+// SIM_STREAM SimStream[] is global
+
+if (stream < 0 || stream >= MAX_NUM_STREAMS || SimStream[stream].hdr == NULL)
+	{
+	sryLog("%s: No stream %d.\n", fn, stream);
+	return -1;
+	}
+
+return (long)__atomic_load_n(&SimStream[stream].hdr->dropped, __ATOMIC_RELAXED);
+}
+
+/**********************************************************************
+FUNCTION:	int CloseStream(int)
+
+PURPOSE:	This function closes a stream made by OpenStream(), failing 
+			any further writes by its producer, or disconnects a producer,
+			the consumer reading what is left before ReadStream() fails.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int CloseStream(int stream)
+{
+const char *fn = "CloseStream";
+// SIM_STREAM SimStream[] is global
+
+if (stream < 0 || stream >= MAX_NUM_STREAMS || SimStream[stream].hdr == NULL)
+	{
+	sryLog("%s: No stream %d.\n", fn, stream);
+	return -1;
+	}
+
+releaseStream(&SimStream[stream], false);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int Receive(void **, void *, unsigned)
+
+PURPOSE:	This function receives SIM messages from other processes.
+
+RETURNS:	success: message size in bytes
+			failure: -1
+***********************************************************************/
+
+int Receive(void **sender, void *inBuffer, unsigned maxBytes)
+{
+const char *fn = "Receive";
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+FCMSG_REC *msgRec = NULL;
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+while (true)
+	{
+	// the rest of a burst of coalesced proxies goes ahead of any new trigger
+	if (takeProxyBurst(fifoBuf))
+		return (-1 + fifoMsg->shmid);
+
+	// wait on the fifo (or mailbox) for a triggering message from a sender
+	if (takeTrigger(fifoBuf) != sizeof(FIFO_MSG))
+		{
+		// a ReceiveTimed() deadline leaves the receive fifo as it is
+		if (SimDeadline.set && errno == ETIMEDOUT)
+			return -1;
+		sryLog("%s: Fifo read error.\n", fn);
+		close(SimParms.rfd);
+		SimParms.rfd = -1;
+		return -1;
+		} 
+
+	// a wakeup for proxies counted in this receiver's proxy table
+	if (fifoMsg->shmid == -PROXY_COALESCED && SimParms.proxies != NULL)
+		{
+		drainProxyTable();
+		continue;
+		}
+
+	// is the message a proxy?
+	if (fifoMsg->shmid < 0)
+		return (-1 + fifoMsg->shmid); // -2 or less (shmid is already negative)
+
+	/*
+	Attach the sender's shmem to this process, or reuse the attachment made for
+	an earlier message from the same sender.
+	Known to fail if sender suddenly disappears. 
+	Saving this value allows the Reply() to use the same shmem.
+	*/
+	*sender = attachSenderShmem(fifoMsg->shmid, fifoMsg->pid);
+	if (*sender == (void *)NULL)
+		{
+		sryLog("%s: shmid=%d cannot attach to shmem-%s\n", fn, fifoMsg->shmid, 
+															strerror(errno));
+		return -1;
+		}
+
+	// line up on the message
+	msgRec = (FCMSG_REC *)*sender;
+
+	/*
+	A sender whose SendTimed() ran out of time has retired the shmem and no 
+	longer waits on a reply; go on to the next message.
+	*/
+	if (msgRec->pid != 0 && 
+		__atomic_load_n(&msgRec->replyState, __ATOMIC_ACQUIRE) != REPLY_ABANDONED)
+		break;
+
+	// nor is it outstanding at this receiver any longer
+	uncountGroupMsg(msgRec);
+
+	// an attachment made for this message alone is of no further use
+	doneSenderShmem(msgRec, false);
+	}
+
+// copy the data out of the shmem or not?
+if (inBuffer != NULL)
+	{
+	// is the message larger than the receiver's message buffer?
+	if (msgRec->nbytes > maxBytes)
+		{
+		sryLog("%s: message size %d > buffer size %d\n", fn, msgRec->nbytes, 
+																	maxBytes);
+		ReplyError(*sender);
+		return -1;
+		}
+
+	// copy the message 
+	memcpy(inBuffer, (void *)&msgRec->data, msgRec->nbytes);
+	}
+
+// save this sender in case of failure before a reply can made
+saveSenderId(*sender);
+
+// return the size of the message
+return msgRec->nbytes;
+}
+
+/**********************************************************************
+FUNCTION:	int ReceiveTimed(void **, void *, unsigned, unsigned)
+
+PURPOSE:	This function receives SIM messages from other processes as
+			Receive() does, but waits no longer than msecs milliseconds 
+			for one to come.
+
+RETURNS:	success: >= 0 msg size, < -1 proxy value
+			failure: -1, errno ETIMEDOUT if out of time
+***********************************************************************/
+
+int ReceiveTimed(void **sender, void *inBuffer, unsigned maxBytes, 
+															unsigned msecs)
+{
+// SIM_DEADLINE SimDeadline is global
+int rc = -1;
+
+setDeadline(msecs);
+rc = Receive(sender, inBuffer, maxBytes);
+SimDeadline.set = false;
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int Reply(void *, void *, unsigned)
+
+PURPOSE:	This function replies SIM messages to sender processes.
+
+RETURNS:	success: number of reply bytes (nbytes) >= 0
+			failure: -1
+***********************************************************************/
+
+int Reply(void *sender, void *outBuffer, unsigned nbytes)
+{
+const char *fn = "Reply";
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+FCMSG_REC *msgPtr = NULL;
+int ret = -1, rc = 0;
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+// set a pointer to the sender's shmem
+msgPtr = (FCMSG_REC *)sender;
+fifoMsg->pid = 0;
+fifoMsg->priority = 0;
+
+// no longer outstanding at this receiver, as one of a group
+uncountGroupMsg(msgPtr);
+
+// the sender's SendTimed() ran out of time; its shmem is no longer in use
+if (__atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE) == REPLY_ABANDONED)
+	{
+	sryLog("%s: Sender gave up waiting.\n", fn);
+	removeSenderId(sender);
+	doneSenderShmem(sender, false);
+	return -1;
+	}
+
+// check that sender's reply buffer is large enough
+if (nbytes > msgPtr->ybytes)
+	{
+	// set up fifo trigger message for error
+	fifoMsg->shmid = -1;
+	// set error
+	sryLog("%s: Reply message too large.\n", fn);
+	}
+else
+	{
+	// set up fifo trigger message for success 
+	fifoMsg->shmid = 0;
+	// set the reply message header
+	msgPtr->nbytes = nbytes;
+	// copy the reply message into sender's shmem
+	if (outBuffer != NULL)
+		memcpy((void *)&msgPtr->data, outBuffer, nbytes);
+	ret = nbytes;
+	}
+
+/*
+the sender's shmem stays attached for its next message, unless it could not 
+be cached; it is released when the sender is found to be gone
+*/
+
+// unblock the sender by way of its reply futex or its (cached) reply fifo
+if (msgPtr->replyVia == SIM_FUTEX)
+	rc = postReplyFutex(msgPtr, fifoBuf);
+else
+	rc = writeReplyFifo(msgPtr, fifoBuf);
+if (rc == -1)
+	{
+	sryLog("%s: Unable to write to fifo-%s.\n", fn, strerror(errno));
+	removeSenderId(sender);
+	doneSenderShmem(sender, true);
+	return -1;
+	}
+
+// remove this sender that was saved in case of a failure
+removeSenderId(sender);
+doneSenderShmem(sender, false);
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	int ReplyError(void *)
+
+PURPOSE:	This function replies an error condition to a reply-blocked
+			sender.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int ReplyError(void *sender)
+{
+const char *fn = "ReplyError";
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+FCMSG_REC *msgPtr = NULL;
+int rc = 0;
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+	
+// remove this sender from the reply-blocked sender table
+removeSenderId(sender);
+
+// line up on the fifo message
+msgPtr = (FCMSG_REC *)sender;
+
+// no longer outstanding at this receiver, as one of a group
+uncountGroupMsg(msgPtr);
+
+// the sender's SendTimed() ran out of time; there is nobody to tell
+if (__atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE) == REPLY_ABANDONED)
+	{
+	sryLog("%s: Sender gave up waiting.\n", fn);
+	doneSenderShmem(sender, false);
+	return -1;
+	}
+
+// set up fifo message, -1 indicates an error condition
+fifoMsg->shmid = -1;
+fifoMsg->pid = 0;
+fifoMsg->priority = 0;
+
+// write the fifo trigger message on the sender's reply futex or reply fifo
+if (msgPtr->replyVia == SIM_FUTEX)
+	rc = postReplyFutex(msgPtr, fifoBuf);
+else
+	rc = writeReplyFifo(msgPtr, fifoBuf);
+if (rc == -1)
+	{
+	sryLog("%s: Fifo write failure -%s\n", fn, strerror(errno));
+	// the sender is gone so its shmem is no longer of any use
+	doneSenderShmem(sender, true);
+	return -1;
+	}
+
+doneSenderShmem(sender, false);
+
+// if we got this far the message has been sent and return success
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int ReceiveView(SIM_VIEW *)
+
+PURPOSE:	This function receives SIM messages from other processes 
+			without copying them. The view is set to the message in the 
+			sender's shmem, where it may be read, changed and replied in 
+			place with ReplyInPlace().
+
+RETURNS:	success: >= 0 msg size, < -1 proxy value
+			failure: -1
+
+NOTE:		The view is good until the sender is replied to.
+***********************************************************************/
+
+int ReceiveView(SIM_VIEW *view)
+{
+const char *fn = "ReceiveView";
+FCMSG_REC *msgRec = NULL;
+int rc = -1;
+
+if (view == NULL)
+	{
+	sryLog("%s: no view.\n", fn);
+	return -1;
+	}
+
+// receive without copying the message
+view->sender = NULL;
+view->data = NULL;
+view->nbytes = 0;
+view->ybytes = 0;
+rc = Receive(&view->sender, NULL, 0);
+if (rc < 0)
+	return rc;
+
+// line up on the message
+msgRec = (FCMSG_REC *)view->sender;
+view->data = (void *)&msgRec->data;
+view->nbytes = msgRec->nbytes;
+view->ybytes = msgRec->ybytes;
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int ReplyInPlace(void *, unsigned)
+
+PURPOSE:	This function replies the nbytes already written at the start
+			of the sender's shmem message area, typically by way of a 
+			ReceiveView(), without copying.
+
+RETURNS:	success: number of reply bytes (nbytes) >= 0
+			failure: -1
+***********************************************************************/
+
+int ReplyInPlace(void *sender, unsigned nbytes)
+{
+// Reply() checks nbytes against the sender's reply size
+return Reply(sender, NULL, nbytes);
+}
+
+/**********************************************************************
+FUNCTION:	int ReplyV(void *, const struct iovec *, int)
+
+PURPOSE:	This function gathers a reply from iovcnt buffers straight into
+			the sender's shmem and replies it.
+
+RETURNS:	success: number of reply bytes >= 0
+			failure: -1
+***********************************************************************/
+
+int ReplyV(void *sender, const struct iovec *iov, int iovcnt)
+{
+const char *fn = "ReplyV";
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+char *p = NULL;
+unsigned nbytes = 0;
+int i = 0;
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+// check the sender
+if (sender == NULL)
+	{
+	sryLog("%s: No sender to reply to.\n", fn);
+	return -1;
+	}
+
+// check the reply buffers
+if (iovcnt < 0 || (iov == NULL && iovcnt > 0))
+	{
+	sryLog("%s: Improper reply buffers.\n", fn);
+	return -1;
+	}
+
+nbytes = iovLength(iov, iovcnt);
+
+// a reply too large for the sender is failed by Reply() without copying
+if (nbytes <= msgPtr->ybytes)
+	{
+	p = (char *)&msgPtr->data;
+	for (i = 0; i < iovcnt; i++)
+		{
+		memcpy(p, iov[i].iov_base, iov[i].iov_len);
+		p += iov[i].iov_len;
+		}
+	}
+
+return Reply(sender, NULL, nbytes);
+}
+
+/**********************************************************************
+FUNCTION:	int Relay(void *, int)
+
+PURPOSE:	This function relays a SIM message to another process. To a
+			receiver group the message goes to the member with the fewest
+			messages outstanding.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int Relay(void *sender, int fd)
+{
+const char *fn = "Relay";
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+// WHO_AM_I SimParms is global 
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+/*
+The sender's shmem says where it is to be found, so that any of several 
+messages received but not yet replied to can be relayed.
+*/
+fifoMsg->shmid = msgPtr->shmid;
+fifoMsg->pid = (msgPtr->shmBackend == SIM_SHM_MEMFD) ? msgPtr->pid : 0;
+// the message keeps the priority it was sent with
+fifoMsg->priority = msgPtr->priority;
+
+// the message is no longer outstanding at this receiver, should it count it
+uncountGroupMsg(msgPtr);
+
+/*
+pass the sender's fifo message on to the next receiver, or to the member of a
+receiver group with the fewest messages outstanding
+*/
+if (sendTrigger(fd, fifoBuf, msgPtr, SIM_GROUP_LEAST_LOADED) != sizeof(FIFO_MSG))
+	{
+	sryLog("%s: unable to write to fifo\n", fn);
+	close(fd);
+	return -1;
+	}
+else
+	{
+	// remove this sender that was saved in case of failure
+	removeSenderId(sender);
+
+	/*
+	the sender's shmem stays attached, unless it could not be cached; the 
+	relayed message may well be followed by others from the same sender
+	*/
+	doneSenderShmem(sender, false);
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int Serve(SIM_HANDLER, void *, int)
+
+PURPOSE:	This function receives messages and hands them to nthreads
+			worker threads, each of which runs the handler on a message 
+			and replies to its sender, in whatever order they finish.
+			The calling receiver thread does the receiving.
+
+RETURNS:	success: 0, once a handler returns -1
+			failure: -1
+
+NOTE:		A handler is given the view of a message, as by ReceiveView(),
+			or of a proxy with a NULL sender and the proxy value in nbytes.
+			It replies with Reply(), ReplyInPlace(), ReplyV(), ReplyError()
+			or Relay(); a message it does not reply to is replied to with 
+			an error. It cannot send: a worker shares the dispatcher's name
+			and reply fifo, so making the shared memory to send from is 
+			refused and Send() fails.
+***********************************************************************/
+
+int Serve(SIM_HANDLER handler, void *arg, int nthreads)
+{
+const char *fn = "Serve";
+SIM_SERVE serve;
+pthread_t worker[MAX_NUM_SERVE_THREADS];
+SIM_VIEW view;
+struct pollfd pfd[2];
+int started = 0, rc = 0, ret = 0, i = 0;
+// WHO_AM_I SimParms is global
+// BLOCKED_SENDERS BlockedSenders is global
+
+// is this process SIM enabled? 
+if (sim_check() == false || SimServeWorker)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+if (handler == NULL || nthreads < 1 || nthreads > MAX_NUM_SERVE_THREADS)
+	{
+	sryLog("%s: No handler or improper number of threads %d.\n", fn, 
+																	nthreads);
+	return -1;
+	}
+
+// what the workers need to reply in this instance's name
+serve.handler = handler;
+serve.arg = arg;
+serve.parms = SimParms;
+strcpy(serve.fifoPath, SimFifoPath);
+serve.blocked = &BlockedSenders;
+serve.head = 0;
+serve.count = 0;
+serve.stop = 0;
+
+// the worker that stops the serving wakes the dispatcher by way of this
+serve.wake = eventfd(0, EFD_CLOEXEC);
+if (serve.wake == -1)
+	{
+	sryLog("%s: Unable to make the wake up eventfd-%s.\n", fn, 
+															strerror(errno));
+	return -1;
+	}
+
+pthread_mutex_init(&serve.lock, NULL);
+pthread_cond_init(&serve.work, NULL);
+pthread_cond_init(&serve.room, NULL);
+
+for (started = 0; started < nthreads; started++)
+	{
+	if (pthread_create(&worker[started], NULL, serveWorker, &serve) != 0)
+		{
+		sryLog("%s: Only %d of %d threads started-%s.\n", fn, started, 
+												nthreads, strerror(errno));
+		break;
+		}
+	}
+
+pfd[0].fd = SimParms.rfd;
+pfd[0].events = POLLIN;
+pfd[1].fd = serve.wake;
+pfd[1].events = POLLIN;
+
+while (started > 0)
+	{
+	/*
+	Wait for a message or for a worker to stop the serving. Triggers already
+	read ahead by io_uring, held for priority order or taken from the proxy 
+	table no longer show on the fifo.
+	*/
+	if (SimUring.count == 0 && SimPending.count == 0 && 
+								SimProxyBurst.next >= SimProxyBurst.count)
+		{
+		rc = poll(pfd, 2, -1);
+		if (rc == -1)
+			{
+			if (errno == EINTR)
+				continue;
+			sryLog("%s: poll error-%s.\n", fn, strerror(errno));
+			ret = -1;
+			break;
+			}
+
+		if (pfd[1].revents)
+			break;
+		}
+
+	/*
+	The message stays in the sender's shmem for the worker and the sender
+	stays on the reply-blocked table, so its shmem stays attached, until the
+	worker is done with it.
+	*/
+	rc = ReceiveView(&view);
+	if (rc == -1)
+		{
+		ret = -1;
+		break;
+		}
+
+	// a proxy has its value in place of a message
+	if (rc < -1)
+		{
+		view.sender = NULL;
+		view.data = NULL;
+		view.nbytes = returnProxy(rc);
+		view.ybytes = 0;
+		}
+
+	pthread_mutex_lock(&serve.lock);
+
+	// the workers are behind; leave the senders waiting on the fifo
+	while (serve.count == MAX_NUM_SERVE_QUEUED && !serve.stop)
+		pthread_cond_wait(&serve.room, &serve.lock);
+
+	// the wake up is on its way
+	if (serve.stop)
+		{
+		pthread_mutex_unlock(&serve.lock);
+		if (view.sender != NULL)
+			ReplyError(view.sender);
+		continue;
+		}
+
+	i = (serve.head + serve.count) % MAX_NUM_SERVE_QUEUED;
+	serve.queue[i] = view;
+	serve.cached[i] = isSenderCached(view.sender);
+	serve.count++;
+	pthread_cond_signal(&serve.work);
+	pthread_mutex_unlock(&serve.lock);
+	}
+
+// stop the workers, if they have not stopped themselves
+pthread_mutex_lock(&serve.lock);
+serve.stop = 1;
+pthread_cond_broadcast(&serve.work);
+pthread_mutex_unlock(&serve.lock);
+
+for (i = 0; i < started; i++)
+	pthread_join(worker[i], NULL);
+
+// messages no worker got to
+for (; serve.count > 0; serve.count--)
+	{
+	view = serve.queue[serve.head];
+	if (view.sender != NULL)
+		ReplyError(view.sender);
+	serve.head = (serve.head + 1) % MAX_NUM_SERVE_QUEUED;
+	}
+
+pthread_cond_destroy(&serve.room);
+pthread_cond_destroy(&serve.work);
+pthread_mutex_destroy(&serve.lock);
+close(serve.wake);
+
+return (started > 0) ? ret : -1;
+}
+
+/**********************************************************************
+FUNCTION:	int ReactorMsg(SIM_HANDLER, void *, void *, unsigned)
+
+PURPOSE:	This function has Reactor() receive the messages and proxies
+			sent to this receiver and pass them to the handler, by way of
+			a view as with Serve(). The message is copied into buf if one 
+			is given, else the view is of the message in place. A NULL 
+			handler stops the receiving.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int ReactorMsg(SIM_HANDLER handler, void *arg, void *buf, unsigned size)
+{
+const char *fn = "ReactorMsg";
+struct epoll_event ev;
+bool watched = false;
+// WHO_AM_I SimParms is global
+// SIM_REACTOR SimReactor is global
+
+// is this process SIM enabled? 
+if (sim_check() == false || SimServeWorker)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+if (openReactor() == -1)
+	return -1;
+
+watched = (SimReactor.handler != NULL);
+
+if (handler == NULL)
+	{
+	if (watched)
+		epoll_ctl(SimReactor.epfd, EPOLL_CTL_DEL, SimParms.rfd, NULL);
+	}
+else if (!watched)
+	{
+	ev.events = EPOLLIN;
+	ev.data.u64 = REACTOR_MSGS;
+	if (epoll_ctl(SimReactor.epfd, EPOLL_CTL_ADD, SimParms.rfd, &ev) == -1)
+		{
+		sryLog("%s: Unable to watch the receive fifo-%s.\n", fn, 
+															strerror(errno));
+		return -1;
+		}
+	}
+
+SimReactor.handler = handler;
+SimReactor.arg = arg;
+SimReactor.buf = buf;
+SimReactor.size = size;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int ReactorFd(int, SIM_CALLBACK, void *)
+
+PURPOSE:	This function has Reactor() call cb(fd, arg) whenever fd is 
+			readable. A NULL cb stops watching fd.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int ReactorFd(int fd, SIM_CALLBACK cb, void *arg)
+{
+const char *fn = "ReactorFd";
+REACTOR_FD *entry = NULL;
+struct epoll_event ev;
+int i = 0;
+// SIM_REACTOR SimReactor is global
+
+if (openReactor() == -1)
+	return -1;
+
+// already watched?
+for (i = 0; i < MAX_NUM_REACTOR_FDS; i++)
+	{
+	if (SimReactor.fd[i].cb != NULL && SimReactor.fd[i].fd == fd)
+		{
+		entry = &SimReactor.fd[i];
+		break;
+		}
+	}
+
+if (cb == NULL)
+	{
+	if (entry == NULL)
+		return -1;
+	epoll_ctl(SimReactor.epfd, EPOLL_CTL_DEL, fd, NULL);
+	entry->cb = NULL;
+	return 0;
+	}
+
+if (entry == NULL)
+	{
+	for (i = 0; i < MAX_NUM_REACTOR_FDS; i++)
+		{
+		if (SimReactor.fd[i].cb == NULL)
+			{
+			entry = &SimReactor.fd[i];
+			break;
+			}
+		}
+	if (entry == NULL)
+		{
+		sryLog("%s: Too many fds.\n", fn);
+		return -1;
+		}
+
+	ev.events = EPOLLIN;
+	ev.data.u64 = REACTOR_FDS + (entry - SimReactor.fd);
+	if (epoll_ctl(SimReactor.epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+		{
+		sryLog("%s: Unable to watch fd %d-%s.\n", fn, fd, strerror(errno));
+		return -1;
+		}
+	}
+
+entry->fd = fd;
+entry->cb = cb;
+entry->arg = arg;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int ReactorTimer(unsigned, bool, SIM_CALLBACK, void *)
+
+PURPOSE:	This function has Reactor() call cb(timer, arg) msecs from now,
+			and every msecs thereafter if periodic.
+
+RETURNS:	success: timer id >= 0
+			failure: -1
+***********************************************************************/
+
+int ReactorTimer(unsigned msecs, bool periodic, SIM_CALLBACK cb, void *arg)
+{
+const char *fn = "ReactorTimer";
+REACTOR_TIMER *timer = NULL;
+int i = 0;
+// SIM_REACTOR SimReactor is global
+
+if (cb == NULL || msecs == 0)
+	{
+	sryLog("%s: No callback or no time.\n", fn);
+	return -1;
+	}
+
+if (openReactor() == -1)
+	return -1;
+
+for (i = 0; i < MAX_NUM_REACTOR_TIMERS; i++)
+	{
+	if (SimReactor.timer[i].cb == NULL)
+		{
+		timer = &SimReactor.timer[i];
+		break;
+		}
+	}
+if (timer == NULL)
+	{
+	sryLog("%s: Too many timers.\n", fn);
+	return -1;
+	}
+
+timer->msecs = msecs;
+timer->periodic = periodic;
+clock_gettime(CLOCK_MONOTONIC, &timer->due);
+timer->due.tv_sec += msecs / 1000;
+timer->due.tv_nsec += (msecs % 1000) * 1000000L;
+if (timer->due.tv_nsec >= 1000000000L)
+	{
+	timer->due.tv_sec++;
+	timer->due.tv_nsec -= 1000000000L;
+	}
+timer->cb = cb;
+timer->arg = arg;
+
+if (armReactorTimer() == -1)
+	{
+	timer->cb = NULL;
+	return -1;
+	}
+
+return i;
+}
+
+/**********************************************************************
+FUNCTION:	int ReactorCancel(int)
+
+PURPOSE:	This function cancels a timer set by ReactorTimer().
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int ReactorCancel(int timer)
+{
+// SIM_REACTOR SimReactor is global
+
+if (timer < 0 || timer >= MAX_NUM_REACTOR_TIMERS || 
+										SimReactor.timer[timer].cb == NULL)
+	return -1;
+
+SimReactor.timer[timer].cb = NULL;
+
+return armReactorTimer();
+}
+
+/**********************************************************************
+FUNCTION:	int Reactor(void)
+
+PURPOSE:	This function waits on the receive fifo, the user fds and the
+			timers by way of epoll and runs their callbacks as they become
+			ready, until a callback returns -1. Triggers already read 
+			ahead by io_uring, held by Receive() for priority order or
+			coalesced proxies still to be received are handled before
+			waiting.
+
+RETURNS:	success: 0, once a callback returns -1
+			failure: -1
+***********************************************************************/
+
+int Reactor()
+{
+const char *fn = "Reactor";
+struct epoll_event ev[MAX_NUM_REACTOR_FDS + 2];
+REACTOR_FD *entry = NULL;
+int n = 0, rc = 0;
+unsigned tag = 0;
+// SIM_REACTOR SimReactor is global
+// SIM_URING SimUring is global
+
+if (openReactor() == -1)
+	return -1;
+
+while (true)
+	{
+	// triggers already read ahead by io_uring, held for priority order or 
+	// taken from the proxy table no longer show on the fifo
+	while (SimReactor.handler != NULL && (SimUring.count > 0 || 
+			SimPending.count > 0 || SimProxyBurst.next < SimProxyBurst.count))
+		{
+		rc = dispatchReactorMsg();
+		if (rc == 1)
+			return 0;
+		if (rc == -1)
+			return -1;
+		}
+
+	n = epoll_wait(SimReactor.epfd, ev, MAX_NUM_REACTOR_FDS + 2, -1);
+	if (n == -1)
+		{
+		if (errno == EINTR)
+			continue;
+		sryLog("%s: epoll error-%s.\n", fn, strerror(errno));
+		return -1;
+		}
+
+	for (int i = 0; i < n; i++)
+		{
+		tag = ev[i].data.u64;
+		if (tag == REACTOR_MSGS)
+			{
+			// the handler may have been taken away by an earlier callback
+			if (SimReactor.handler == NULL)
+				continue;
+			rc = dispatchReactorMsg();
+			}
+		else if (tag == REACTOR_TIMERS)
+			rc = fireReactorTimers();
+		else
+			{
+			entry = &SimReactor.fd[tag - REACTOR_FDS];
+			if (entry->cb == NULL)
+				continue;
+			rc = (entry->cb(entry->fd, entry->arg) == -1) ? 1 : 0;
+			}
+
+		// stop asked for (1) or failure (-1)
+		if (rc == 1)
+			return 0;
+		if (rc == -1)
+			return -1;
+		}
+	}
+}
+
+/**********************************************************************
+FUNCTION:	int returnProxy(int)
+
+PURPOSE:	Return the true value of a received proxy.
+
+RETURNS:	The true value of a proxy should be >= 1.
+			(the value entered should be <= -2)
+***********************************************************************/
+
+int returnProxy(int value)
+{
+return (value > -2) ? -1 : abs(value + 1);
+}
+
+/**********************************************************************
+FUNCTION:	int getProxyCount(void)
+
+PURPOSE:	Return the number of times the proxy last received was
+			triggered. A receiver coalescing proxies (SIM_PROXY_COALESCE)
+			receives each distinct proxy of a burst once, along with its
+			count; otherwise each trigger is received on its own.
+
+RETURNS:	>= 1
+***********************************************************************/
+
+int getProxyCount()
+{
+// int SimProxyCount is global
+
+return SimProxyCount;
+}
+
+/**********************************************************************
+FUNCTION:	int Locate(const char *, const char *, int, const int)
+
+PURPOSE:	Main purpose is to decide whether to use local or remote
+			name locating based on the type of host name (hName) string,
+			if any.
+			Returns the fd of the receive fifo of a sim receiver.
+
+RETURNS:	success: >= 0
+			failure: -1
+
+NOTE:		Locating a running local receiver again returns the same fd,
+			so close it only when done with the receiver. msgSize, the
+			largest message or reply expected, is used to size shmem.
+***********************************************************************/
+
+int Locate(const char *hostName, const char *processName, int msgSize,
+		 												  const int protocol)
+{
+const char *fn = "Locate";
+int rc = -1;
+pid_t pid = -1;
+
+// is this process SIM enabled? 
+if (sim_check() == false)
+	{
+	sryLog("%s: SIM not active.\n", fn);
+	return -1;
+	}
+
+// there must at least be a destination process name
+if (strlen(processName) == 0)
+	{
+	sryLog("%s: Missing receiver's SIM name.\n", fn);
+	return -1;
+	}
+
+// make shmem ready for the expected message size; Send() can still grow it
+if (msgSize > 0)
+	reserveShmem(msgSize, false);
+
+/*
+Local name locate: receiver treated as on same local host
+*/
+
+// no entry in host field indicates a process on local host
+if (strlen(hostName) == 0)
+	{
+	char fifoName[128];
+	LOCATED_RECEIVER *entry = NULL;
+
+	// a receiver group, its messages spread over its members by Send()
+	if (processName[0] == '@')
+		return locateGroup(processName + 1);
+
+	// a receiver located earlier that is still running keeps its fd
+	entry = findLocatedName(processName);
+	if (entry != NULL && chkLocatedReceiver(entry) == true)
+		return entry->fd;
+
+	// find the receiver's fifo
+	rc = getFifoName(processName, fifoName);
+	if (rc == -1)
+		{	
+		sryLog("%s: Unable to find receiver's fifo.\n", fn);
+		return -1;
+		}
+
+// check if the receiver SIM name is in use
+pid = chkNamePid(processName);
+if (pid == -1)
+	{
+	sryLog("%s: receiver SIM name not in use.\n", fn);
+	return -1;
+	}
+
+// pid is real; is the receiver program still running?
+if (chkStatus(pid, processName) == false)
+	{
+	sryLog("%s: receiver not SIM enabled.\n", fn);
+	return -1;
+	}
+
+/*
+open the fifo for triggering message passing; under a LocateTimed() deadline
+the open fails at once rather than wait on a receiver without its fifo open
+*/
+if (SimDeadline.set)
+	{
+	rc = open(fifoName, O_WRONLY | O_NONBLOCK);
+	if (rc != -1)
+		fcntl(rc, F_SETFL, fcntl(rc, F_GETFL) & ~O_NONBLOCK);
+	}
+else
+	rc = open(fifoName, O_WRONLY);
+if (rc == -1)
+	sryLog("%s: %s\n", fn, strerror(errno));
+else
+	// note the receiver's futex mailbox, if any, for the triggers to come
+	addLocatedReceiver(rc, fifoName);
+    // leave Locate, done with local needs
+	return rc;
+	}
+
+/*
+ Remote name locate: receiver treated as on remote host
+*/
+
+/*
+host name indicates that process is not local or is a surrogate loopback test
+using local host
+*/
+SUR_REQUEST_MSG lout;
+SUR_REQUEST_REPLY lin;
+SUR_NAME_LOCATE_MSG rout;
+SUR_NAME_LOCATE_REPLY rin;
+char surrogateParent[MAX_SIM_NAME_LEN + 1];
+char surrogateChild[MAX_SIM_NAME_LEN + 1];
+int wid = -1;
+// REMOTE_RECEIVERS RemoteReceivers is global
+
+// choose the communication protocol (TCP/IP, RS232 etc.)
+switch (protocol)
+	{
+	case SIM_RS232:
+		sprintf(surrogateParent, "%s", RS232_Surr_R);
+		break;
+
+	case SIM_LOCAL:
+	case SIM_TCP:
+	default:
+		sprintf(surrogateParent, "%s", TCP_Surr_R);
+		break;
+	}
+	
+// do a local name locate for *_surrogate_R
+// Note: the * indicates the surrogate protocol such as TCP etc.
+if ((wid = Locate("", surrogateParent, 0, protocol)) == -1)
+	{
+	sryLog("%s: surrogate R name locate failure.\n", fn);
+	return -1;
+	}
+
+// send request to surrogate_R for a local *_surrogate_r child
+lout.token = SUR_REQUEST;
+if (Send(wid, &lout, sizeof lout, &lin, sizeof lin) == -1)
+	{
+	sryLog("%s: surrogate R send failure.\n", fn);
+	return -1;
+	}
+
+// set the name of the *_surrogate_r program
+switch (protocol)
+	{
+	case SIM_RS232:
+		sprintf(surrogateChild, "%s%d", RS232_Surr_r, lin.pid);
+		break;
+
+	case SIM_LOCAL:
+	case SIM_TCP:
+	default:
+		sprintf(surrogateChild, "%s%d", TCP_Surr_r, lin.pid);
+		break;
+	}
+
+//printf("remote locate: local name=%s\n", surrogateChild);
+
+// do a local name locate for *_surrogate_r_pid
+if ((rc = Locate("", surrogateChild, 0, protocol)) == -1)
+	{
+	sryLog("%s: surrogate r name locate failure.\n", fn);
+	return -1;
+	}
+
+//printf("remote locate: found local %s\n", surrogateChild);
+
+// make char based msg to send to surrogate_r_pid
+snprintf(rout.hdr.token, sizeof rout.hdr.token, "%d", SUR_NAME_LOCATE);
+strcpy(rout.hostName, hostName);
+strcpy(rout.sryName, processName);
+snprintf(rout.maxSize, sizeof rout.maxSize, "%d", msgSize);
+
+//printf("remote locate: begin send to %s\n", surrogateChild);
+
+// send remote name locate msg to surrogate_r_pid
+if (Send(rc, &rout, sizeof rout, &rin, sizeof rin) == -1)
+	{
+	sryLog("%s: r send failure.\n", fn);
+	return -1;
+	}
+
+//printf("remote locate: finished send to %s\n", surrogateChild);
+
+// convert result back to binary
+if (atoi(rin.result) == -1)
+	{
+	sryLog("%s: remote locate failure.\n", fn);
+	return -1;
+	}
+
+// add to the remote receiver table, shut down on closeSRY()
+if (addRemoteReceiver(rc) == -1)
+	{
+	sryLog("%s: no room on the remote receiver table.\n", fn);
+	return -1;
+	}
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int LocateTimed(const char *, const char *, int, const int, 
+																unsigned)
+
+PURPOSE:	Locate a receiver as Locate() does, taking no longer than 
+			msecs milliseconds. A remote locate is made up of Send()s to
+			the surrogates, each of which is bound by the same deadline.
+
+RETURNS:	success: >= 0
+			failure: -1, errno ETIMEDOUT if out of time
+***********************************************************************/
+
+int LocateTimed(const char *hostName, const char *processName, int msgSize,
+										const int protocol, unsigned msecs)
+{
+// SIM_DEADLINE SimDeadline is global
+int rc = -1;
+
+setDeadline(msecs);
+rc = Locate(hostName, processName, msgSize, protocol);
+SimDeadline.set = false;
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	bool chkSender(void *sender)
+
+PURPOSE:	Checks on sender's existence. Called by a receiver between 
+			Receive() and Reply().
+
+RETURNS:	sender exists: true
+			sender does not exist: false
+***********************************************************************/
+
+bool chkSender(void *sender)
+{
+FCMSG_REC *rec = (FCMSG_REC *)sender;
+
+return chkStatus(rec->pid, rec->whom);
+} 
+
+/**********************************************************************
+FUNCTION:	bool chkReceiver(const char *receiverSIMname, pid_t pid)
+
+PURPOSE:	Can be used between multiple sends to the same receiver.
+
+RETURNS:	receiver exists: true
+			receiver does not exist: false
+***********************************************************************/
+
+bool chkReceiver(const char *name, pid_t pid)
+{
+bool ret = true;
+
+if (!pid)
+	pid = chkNamePid(name);
+
+if (pid != -1)
+	{
+	// pid is real; is the program still running?
+	if (chkStatus(pid, name) == false)
+		{
+		ret = false;
+		}
+	}
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	int getSenderName(void *, char *senderName)
+
+PURPOSE:	Returns the local sender's sim name after a Send() call.
+
+NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+			As well, make certain that the pointer senderName that is passed
+			in points to a character array that is large enough to accomodate 
+			the the sim name or the memcpy will fail.
+
+RETURNS:	sender exists: set sender's sim name and return 0 
+			sender shmem ptr is NULL: -1
+***********************************************************************/
+
+int getSenderName(void *sender, char *senderName)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+int ret = 0;
+
+if (sender == NULL)
+	ret = -1;
+else
+	memcpy(senderName, msgPtr->whom, MAX_PROGRAM_NAME_LEN);
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	pid_t getSenderPid(void *)
+
+PURPOSE:	Returns the value of the local sender's pid after a Send() call.
+
+NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+
+RETURNS:	sender exists: pid_t
+			sender shmem ptr is NULL: -1
+***********************************************************************/
+
+pid_t getSenderPid(void *sender)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+pid_t ret;
+
+if (sender == NULL)
+	ret = -1;
+else
+	ret = msgPtr->pid;
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	int getSenderShmemSize(void *)
+
+PURPOSE:	Returns the value of the local sender's shmem size in bytes after a 
+			Send() call.
+
+NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+
+RETURNS:	sender exists: int
+			sender shmem ptr is NULL: -1
+***********************************************************************/
+
+pid_t getSenderShmemSize(void *sender)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+int ret = -1;
+
+if (sender == NULL)
+	ret = -1;
+else
+	ret = msgPtr->shmsize;
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	int getSenderMsgSize(void *)
+
+PURPOSE:	Returns the value of the local sender's message size in bytes after 
+			a Send() call.
+
+NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+
+RETURNS:	sender exists: int
+			sender shmem ptr is NULL: -1
+***********************************************************************/
+
+int getSenderMsgSize(void *sender)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+int ret;
+
+if (sender == NULL)
+	ret = -1;
+else
+	ret = msgPtr->nbytes;
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	int getSenderRplySize(void *)
+
+PURPOSE:	Returns the value of the local sender's reply message size in bytes 
+			after a Send() call.
+
+NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+
+RETURNS:	sender exists: int
+			sender shmem ptr is NULL: -1
+***********************************************************************/
+
+int getSenderRplySize(void *sender)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+int ret;
+
+if (sender == NULL)
+	ret = -1;
+else
+	ret = msgPtr->ybytes;
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	int rfd(void)
+
+PURPOSE:	Return the file descriptor to the receive fifo
+
+RETURNS:	success: a file descriptor > 2
+			failure: -1
+***********************************************************************/
+
+int rfd(void)
+{
+// WHO_AM_I SimParms is global 
+return SimParms.rfd;
+}
+
+/**********************************************************************
+FUNCTION:	int yfd(void)
+
+PURPOSE:	Return the file descriptor to the reply fifo
+
+RETURNS:	success: a file descriptor > 2
+			failure: -1
+***********************************************************************/
+
+int yfd(void)
+{
+// WHO_AM_I SimParms is global
+return SimParms.yfd;
+}
+
+/**********************************************************************
+FUNCTION:	void simRcopy(void *, void *, unsigned)
+
+PURPOSE:	Copy unsigned nbytes from the sender's shmem pointer
+			to the desired address void *dst 
+
+			Follows a Receiver(&id, NULL, 0) call.
+
+RETURNS:	nothing
+***********************************************************************/
+
+void simRcopy(void *sender, void *dst, unsigned nbytes)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+
+memcpy(dst, (void *)&msgPtr->data, nbytes);
+} 
+ 
+/**********************************************************************
+FUNCTION:	void simScopy(void *, unsigned)
+
+PURPOSE:	Copy unsigned nbytes from the sender's global shmem pointer
+			to the desired address void * 
+
+			Follows a Send(id, void *, NULL, outSize, inSize) call
+
+RETURNS:	nothing
+***********************************************************************/
+
+void simScopy(void *dst, unsigned nbytes)
+{
+FCMSG_REC *msgPtr = (FCMSG_REC *)SimParms.shmPtr;
+
+memcpy(dst, (void *)&msgPtr->data, nbytes);
+}
+
+/**********************************************************************
+FUNCTION:	int getWaitStats(SIM_WAIT_STATS *, bool)
+
+PURPOSE:	Copy the counts of waits, spins and blocks made while waiting
+			on the futex transport's shared memory for messages and replies.
+			The counts are set back to 0 if reset is true.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int getWaitStats(SIM_WAIT_STATS *stats, bool reset)
+{
+// SIM_WAIT_STATS SimWaitStats is global
+
+if (stats == NULL)
+	return -1;
+
+memcpy(stats, &SimWaitStats, sizeof(SIM_WAIT_STATS));
+
+if (reset)
+	memset(&SimWaitStats, 0, sizeof(SIM_WAIT_STATS));
+
+return 0;
+}
+
+/********************************************************************/
+/****************** MESSAGE SHARED MEMORY FUNCTIONS *****************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	int reserveShmem(unsigned, bool)
+
+PURPOSE:	Make sure that the sender's shmem holds messages of bufSize
+			bytes, rebuilding it as needed. With grow set the new shmem is
+			made larger than called for by the growth percentage, so that
+			a sender whose messages creep up in size soon settles on the
+			one shmem rather than rebuilding it at every new high.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by Send(), SendV(), AcquireSendBuffer(), Reserve(),
+			Locate() and openSRYopts().
+**********************************************************************/
+
+int reserveShmem(unsigned bufSize, bool grow)
+{
+// WHO_AM_I SimParms is global
+
+return resizeShmem(&SimParms.shmid, &SimParms.shmPtr, &SimParms.shmSize,
+																bufSize, grow);
+}
+
+/**********************************************************************
+FUNCTION:	int resizeShmem(int *, void **, unsigned *, unsigned, bool)
+
+PURPOSE:	Make sure that a message shmem, the one used by Send() or that
+			of a PostMessage() slot, holds messages of bufSize bytes. The
+			shmem is rebuilt as needed, growing it if grow is set.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by reserveShmem(), PostMessage().
+**********************************************************************/
+
+int resizeShmem(int *shmid, void **shmPtr, unsigned *shmSize, unsigned bufSize,
+																	bool grow)
+{
+unsigned long long size = bufSize;
+unsigned room = 0;
+// WHO_AM_I SimParms is global
+
+// large enough already
+if (*shmSize >= (bufSize + (unsigned)sizeof(FCMSG_REC)))
+	return 0;
+
+// grow geometrically from the current size
+if (grow && *shmSize)
+	{
+	room = *shmSize - sizeof(FCMSG_REC);
+	size = room + (unsigned long long)room * SimParms.shmGrowth / 100;
+	if (size < bufSize)
+		size = bufSize;
+	// leave room for the header and rounding up to whole pages
+	if (size > UINT_MAX / 2)
+		size = (bufSize > UINT_MAX / 2) ? bufSize : UINT_MAX / 2;
+	}
+
+// delete any past shmem
+if (*shmSize)
+	detachShmem(*shmid, *shmPtr, shmSize);
+
+// create new shmem
+return createShmem((unsigned)size, shmid, shmPtr, shmSize);
+}
+
+/**********************************************************************
+FUNCTION:	int createShmem(unsigned, int *, void **, unsigned *)
+
+PURPOSE:	Create and attach shared memory used for a message passing
+			buffer, setting its shmid, address and size.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by resizeShmem().
+**********************************************************************/
+
+int createShmem(unsigned bufSize, int *shmid, void **shmPtr, unsigned *shmSize)
+{
+const char *fn = "createShmem";
+unsigned memSize = 0;
+long pagesize = 0;
+int hugetlb = 0;
+void *ptr = NULL;
+FCMSG_REC *msgPtr = NULL;
+// WHO_AM_I SimParms is global
+
+// the SIM name and reply fifo of a Serve() worker are its dispatcher's
+if (SimServeWorker)
+	{
+	sryLog("%s: A Serve() worker cannot send.\n", fn);
+	return -1;
+	}
+
+// reserved huge pages come in their own size
+pagesize = sysconf(_SC_PAGESIZE);
+if (SimParms.hugePages == SIM_HUGE_EXPLICIT)
+	{
+	pagesize = getHugePageSize();
+	hugetlb = 1;
+	}
+
+// calculate the shmem size as a whole number of pages
+memSize = ((bufSize + sizeof(FCMSG_REC) + pagesize - 1) / pagesize) * pagesize;
+
+ptr = makeShmem(memSize, hugetlb, shmid);
+if (ptr == NULL && hugetlb)
+	{
+	// none reserved, or none left; don't keep asking
+	sryLog("%s: No huge pages-%s, using normal pages.\n", fn, strerror(errno));
+	SimParms.hugePages = SIM_HUGE_NONE;
+	pagesize = sysconf(_SC_PAGESIZE);
+	memSize = ((bufSize + sizeof(FCMSG_REC) + pagesize - 1) / pagesize) * 
+																	pagesize;
+	ptr = makeShmem(memSize, 0, shmid);
+	}
+if (ptr == NULL)
+	{
+	sryLog("%s: Unable to create shmem-%s.\n", fn, strerror(errno));
+	return -1;
+	}
+
+// ask for transparent huge pages
+if (SimParms.hugePages == SIM_HUGE_TRANSPARENT)
+	madvise(ptr, memSize, MADV_HUGEPAGE);
+
+// receivers need to know how to let go of this shmem
+msgPtr = (FCMSG_REC *)ptr;
+msgPtr->pid = SimParms.pid;
+msgPtr->shmBackend = SimParms.shmBackend;
+msgPtr->segSize = memSize;
+msgPtr->shmid = *shmid;
+
+*shmPtr = ptr;
+
+// this the maximum size for a message
+*shmSize = memSize;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	void *makeShmem(unsigned, int, int *)
+
+PURPOSE:	Create and attach memSize bytes of shared memory by way of the
+			chosen backend, from reserved huge pages if hugetlb is set.
+			shmid is set to the SysV shmid or the memfd.
+
+RETURNS:	success: address of the shmem
+			failure: NULL
+
+NOTE:		Called by createShmem().
+**********************************************************************/
+
+void *makeShmem(unsigned memSize, int hugetlb, int *shmid)
+{
+// WHO_AM_I SimParms is global
+void *ptr = NULL;
+int fd = -1, err = 0;
+
+if (SimParms.shmBackend == SIM_SHM_MEMFD)
+	{
+	// an anonymous file; gone once this process and its receivers let go
+	fd = syscall(SYS_memfd_create, "sim", MFD_CLOEXEC | 
+											(hugetlb ? MFD_HUGETLB : 0));
+	if (fd == -1)
+		return NULL;
+
+	if (ftruncate(fd, memSize) == -1)
+		ptr = MAP_FAILED;
+	else
+		ptr = mmap(NULL, memSize, PROT_READ | PROT_WRITE, MAP_SHARED | 
+							(SimParms.populate ? MAP_POPULATE : 0), fd, 0);
+	if (ptr == MAP_FAILED)
+		{
+		err = errno;
+		close(fd);
+		errno = err;
+		return NULL;
+		}
+
+	*shmid = fd;
+	return ptr;
+	}
+
+// create shmem for messages
+*shmid = shmget(IPC_PRIVATE, memSize, 0777 | IPC_CREAT | 
+											(hugetlb ? SHM_HUGETLB : 0));
+if (*shmid == -1)
+	return NULL;
+
+// attach the shmem for messages to this process
+ptr = (void *)shmat(*shmid, (void *)0, 0);
+
+// release shmem if and when owner dies by an untrappable signal
+err = errno;
+shmctl(*shmid, IPC_RMID, 0);
+errno = err;
+
+if (ptr == (void *)-1)
+	return NULL;
+
+#ifdef MADV_POPULATE_WRITE
+// prefault the shmem
+if (SimParms.populate)
+	madvise(ptr, memSize, MADV_POPULATE_WRITE);
+#endif
+
+return ptr;
+}
+
+/**********************************************************************
+FUNCTION:	long getHugePageSize(void)
+
+PURPOSE:	Find the size of the default reserved huge page.
+
+RETURNS:	huge page size in bytes
+**********************************************************************/
+
+long getHugePageSize(void)
+{
+FILE *fp = NULL;
+char line[100];
+long size = 2048; // kB, the usual size
+
+fp = fopen("/proc/meminfo", "r");
+if (fp != NULL)
+	{
+	while (fgets(line, sizeof line, fp) != NULL)
+		if (sscanf(line, "Hugepagesize: %ld kB", &size) == 1)
+			break;
+	fclose(fp);
+	}
+
+return size * 1024;
+}
+
+/**********************************************************************
+FUNCTION:	int detachShmem(int, void *, unsigned *)
+
+PURPOSE:	Detach shared memory used for a message passing	buffer.
+
+RETURNS:	success: 0
+			failure: -1
+**********************************************************************/	
+
+int detachShmem(int shmid, void *shmPtr, unsigned *shmSize)
+{
+const char *fn = "detachShmem";
+FCMSG_REC *msgPtr = (FCMSG_REC *)shmPtr;
+int rc = 0;
+// WHO_AM_I SimParms is global
+
+// detach shmem
+if (msgPtr->shmBackend == SIM_SHM_MEMFD)
+	{
+	rc = munmap(shmPtr, msgPtr->segSize);
+	close(shmid);
+	}
+else
+	rc = shmdt(shmPtr);
+if (rc == -1)
+	{
+	sryLog("%s: Unable to detach shmem-%s.\n", fn, strerror(errno));
+	return -1;
+	}
+
+// this the maximum size for a message, used as a check
+*shmSize = 0;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int collectPostedReply(int, void *)
+
+PURPOSE:	Wait for the reply to the message posted in a PostMessage() 
+			slot, copy it to inBuffer (or the SendAsync() reply buffer if
+			NULL) and free the slot.
+
+RETURNS:	success: size of replied message >=0
+			failure: -1
+
+NOTE:		Called by ReadTicketReply(), ReadAnyReply().
+**********************************************************************/
+
+int collectPostedReply(int ticket, void *inBuffer)
+{
+const char *fn = "collectPostedReply";
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+FCMSG_REC *msgPtr = (FCMSG_REC *)PostSlot[ticket].shmPtr;
+int rc = -1;
+// WHO_AM_I SimParms is global 
+// POST_SLOT PostSlot[] is global
+
+// spin on the reply state first, as the wait policy has it
+spinPostedReplies(&ticket, 1);
+
+// wait for the receiver to send fifo message to trigger the reply
+rc = waitReplyFifo(msgPtr, fifoBuf);
+if (rc != sizeof(FIFO_MSG))
+	{
+	sryLog("%s: Fifo read error\n", fn);
+	close(SimParms.yfd);
+	SimParms.yfd = -1;
+	}
+
+// the slot is free for the next PostMessage() whatever the outcome
+PostSlot[ticket].posted = false;
+if (rc != sizeof(FIFO_MSG))
+	return -1;
+
+// was there a problem in the send such as a call to ReplyError()?
+if (fifoMsg->shmid == -1)
+	{
+	sryLog("%s: receive/reply problem ... could be a failed receiver.\n", fn);
+	return -1;
+	}
+
+// a SendAsync() reply goes where it was asked to
+if (inBuffer == NULL)
+	inBuffer = PostSlot[ticket].inBuffer;
+
+// is there something to copy from the shmem?
+if (inBuffer != NULL && msgPtr->nbytes)
+	memcpy(inBuffer, (void *)&msgPtr->data, msgPtr->nbytes);
+
+// return the size of the reply message
+return msgPtr->nbytes;
+}
+
+/**********************************************************************
+FUNCTION:	bool spinPostedReplies(const int *, int)
+
+PURPOSE:	Spin on the reply states of posted messages, those of the count
+			tickets given or of all posted if NULL, for as long as the wait
+			policy has it before the caller blocks on the reply fifo. A 
+			reply sets its reply state ahead of writing the reply fifo, so
+			that whichever message is replied first is seen straight away.
+
+RETURNS:	a reply is in: true
+			time to block: false
+
+NOTE:		Called by collectPostedReply(), ReadAnyReply(), WaitReplies().
+**********************************************************************/
+
+bool spinPostedReplies(const int *tickets, int count)
+{
+// WHO_AM_I SimParms is global
+// POST_SLOT PostSlot[] is global
+// SIM_WAIT_STATS SimWaitStats is global
+FCMSG_REC *msgPtr = NULL;
+unsigned long spins = 0;
+int i = 0, n = 0, t = 0, state = REPLY_PENDING;
+
+if (SimParms.waitPolicy == SIM_WAIT_BLOCK)
+	return false;
+
+SimWaitStats.waits++;
+
+n = (tickets == NULL) ? MAX_NUM_POSTED_MESSAGES : count;
+for (spins = 0; SimParms.waitPolicy == SIM_WAIT_POLL || 
+									spins < SimParms.spinCount; spins++)
+	{
+	for (i = 0; i < n; i++)
+		{
+		t = (tickets == NULL) ? i : tickets[i];
+		if (!PostSlot[t].posted)
+			continue;
+		msgPtr = (FCMSG_REC *)PostSlot[t].shmPtr;
+		state = __atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE);
+		if (state == REPLY_DONE || state == REPLY_FAILED)
+			{
+			SimWaitStats.spins += spins;
+			SimWaitStats.spinHits++;
+			return true;
+			}
+		}
+
+	// a poller out of time goes on to time out in the fifo wait
+	if (SimDeadline.set && (spins & 1023) == 1023 && pastDeadline())
+		break;
+	SIM_CPU_RELAX();
+	}
+
+SimWaitStats.spins += spins;
+SimWaitStats.blocks++;
+
+return false;
+}
+
+/**********************************************************************
+FUNCTION:	void releaseAllPostSlots(void)
+
+PURPOSE:	Detach the shmem of all PostMessage() slots, abandoning any
+			messages awaiting replies.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild().
+**********************************************************************/
+
+void releaseAllPostSlots()
+{
+// POST_SLOT PostSlot[] is global
+
+for (int i = 0; i < MAX_NUM_POSTED_MESSAGES; i++)
+	{
+	if (PostSlot[i].shmSize)
+		detachShmem(PostSlot[i].shmid, PostSlot[i].shmPtr, 
+													&PostSlot[i].shmSize);
+	PostSlot[i].posted = false;
+	}
+}
+
+/**********************************************************************
+FUNCTION:	int abandonSend(FCMSG_REC *, char *)
+
+PURPOSE:	Give up on the reply to a Send() once the SendTimed() deadline
+			has passed. The reply state is marked abandoned, unless the
+			reply has come in at the last moment, and the shmem retired.
+
+RETURNS:	success: sizeof FIFO_MSG, the reply came in after all
+			failure: -1, errno ETIMEDOUT if the message was abandoned
+
+NOTE:		Called by Send() when the wait for a reply fails.
+**********************************************************************/
+
+int abandonSend(FCMSG_REC *msgPtr, char *fifoBuf)
+{
+// SIM_DEADLINE SimDeadline is global
+int state = REPLY_PENDING;
+
+// any other failure stands
+if (!SimDeadline.set || errno != ETIMEDOUT)
+	return -1;
+
+// the receiver may reply at any moment; either it or this sender wins
+state = __atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE);
+while (state == REPLY_PENDING || state == REPLY_WAITING)
+	{
+	if (__atomic_compare_exchange_n(&msgPtr->replyState, &state, 
+			REPLY_ABANDONED, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		{
+		retireShmem();
+		errno = ETIMEDOUT;
+		return -1;
+		}
+	}
+
+/*
+Replied after all. With the fifo transport the reply fifo message may be yet to
+come; counted in ReplyFifoTokens as a spare, it does no harm.
+*/
+((FIFO_MSG *)fifoBuf)->shmid = (state == REPLY_DONE) ? 0 : -1;
+((FIFO_MSG *)fifoBuf)->pid = 0;
+
+return sizeof(FIFO_MSG);
+}
+
+/**********************************************************************
+FUNCTION:	void retireShmem(void)
+
+PURPOSE:	Put the Send() shmem of an abandoned message aside, for the
+			next message to go in new shmem. The retired shmem is marked 
+			as no longer in use, so that receivers skip the message, but 
+			stays attached a while longer so that its shmid (or memfd 
+			number) cannot be taken by new shmem while a trigger for the 
+			abandoned message may yet be received.
+
+RETURNS:	nothing
+
+NOTE:		Called by abandonSend().
+**********************************************************************/
+
+void retireShmem()
+{
+// WHO_AM_I SimParms is global
+// RETIRED_SHMEM RetiredShmem[] is global
+// int RetiredShmemNext is global
+RETIRED_SHMEM *entry = &RetiredShmem[RetiredShmemNext];
+
+// receivers skip the message and a late Reply() finds no reply fifo
+((FCMSG_REC *)SimParms.shmPtr)->pid = 0;
+
+// the oldest retired shmem makes room
+if (entry->shmSize)
+	detachShmem(entry->shmid, entry->shmPtr, &entry->shmSize);
+
+entry->shmid = SimParms.shmid;
+entry->shmPtr = SimParms.shmPtr;
+entry->shmSize = SimParms.shmSize;
+RetiredShmemNext = (RetiredShmemNext + 1) % MAX_NUM_RETIRED_SHMEM;
+
+// the next Send() makes new shmem
+SimParms.shmid = -1;
+SimParms.shmPtr = (void *)NULL;
+SimParms.shmSize = 0;
+}
+
+/**********************************************************************
+FUNCTION:	void releaseRetiredShmem(void)
+
+PURPOSE:	Detach all of the shmem retired by abandonSend().
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild().
+**********************************************************************/
+
+void releaseRetiredShmem()
+{
+// RETIRED_SHMEM RetiredShmem[] is global
+
+for (int i = 0; i < MAX_NUM_RETIRED_SHMEM; i++)
+	{
+	if (RetiredShmem[i].shmSize)
+		detachShmem(RetiredShmem[i].shmid, RetiredShmem[i].shmPtr, 
+												&RetiredShmem[i].shmSize);
+	}
+}
+
+/********************************************************************/
+/************** SENDER SHARED MEMORY ATTACHMENT FUNCTIONS ***********/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	void *attachSenderShmem(int, pid_t)
+
+PURPOSE:	Return the address of a sender's message shared memory. An
+			attachment made for an earlier message from the same sender is
+			reused, otherwise the shmem is attached and cached. owner is
+			the pid holding a memfd shmem, 0 for SysV shmem. The cache is
+			the receiver's own: an attachment is known by its shmid, which
+			is not reused while the shmem is attached here, or by its memfd
+			and owner, and is good for as long as senderAlive() says so.
+
+RETURNS:	success: the sender id (shmem address)
+			failure: NULL
+**********************************************************************/
+
+void *attachSenderShmem(int shmid, pid_t owner)
+{
+// SENDER_SHMEM SenderShmem[] is global
+// unsigned long SenderShmemClock is global
+SENDER_SHMEM *entry = NULL, *victim = NULL;
+FCMSG_REC *msgPtr = NULL;
+void *shmPtr = NULL;
+ino_t ino = 0;
+int i = 0;
+
+SenderShmemClock++;
+
+// look for an existing attachment
+for (i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+	{
+	if (SenderShmem[i].shmid == shmid && SenderShmem[i].owner == owner &&
+											SenderShmem[i].shmPtr != NULL)
+		{
+		entry = &SenderShmem[i];
+		break;
+		}
+	}
+
+if (entry != NULL)
+	{
+	if (senderAlive(entry))
+		{
+		entry->lastUse = SenderShmemClock;
+		return entry->shmPtr;
+		}
+
+	// the sender is gone, start over
+	releaseSenderShmem(entry->shmPtr);
+	}
+
+// attach the sender's shmem
+shmPtr = mapSenderShmem(shmid, owner, &ino);
+if (shmPtr == NULL)
+	return NULL;
+msgPtr = (FCMSG_REC *)shmPtr;
+
+/*
+A sender that outgrew its shmem has made a new one with createShmem(); any
+attachment to its old shmem (for the same slot) is of no further use, and 
+nor are those of senders that have gone away.
+*/
+for (i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+	{
+	entry = &SenderShmem[i];
+	if (entry->shmPtr == NULL || isSenderBlocked(entry->shmPtr))
+		continue;
+	// a PostMessage() slot has a shmem of its own
+	if (!senderAlive(entry) || (entry->pid == msgPtr->pid && 
+				!strcmp(((FCMSG_REC *)entry->shmPtr)->whom, msgPtr->whom) &&
+				((FCMSG_REC *)entry->shmPtr)->slot == msgPtr->slot))
+		releaseSenderShmem(entry->shmPtr);
+	}
+
+// find a free slot
+for (i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+	{
+	if (SenderShmem[i].shmPtr == NULL)
+		{
+		victim = &SenderShmem[i];
+		break;
+		}
+	}
+
+// no free slot; evict the least recently used idle attachment
+if (victim == NULL)
+	{
+	for (i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+		{
+		entry = &SenderShmem[i];
+		if (entry->shmPtr == NULL || isSenderBlocked(entry->shmPtr))
+			continue;
+		if (victim == NULL || entry->lastUse < victim->lastUse)
+			victim = entry;
+		}
+
+	/*
+	every slot holds a reply-blocked sender; nothing can be cached, and the
+	attachment is detached by doneSenderShmem() once the message is done with
+	*/
+	if (victim == NULL)
+		return shmPtr;
+
+	releaseSenderShmem(victim->shmPtr);
+	}
+
+victim->shmid = shmid;
+victim->owner = owner;
+victim->ino = ino;
+victim->pid = msgPtr->pid;
+victim->shmPtr = shmPtr;
+victim->lastUse = SenderShmemClock;
+
+return shmPtr;
+}
+
+/**********************************************************************
+FUNCTION:	int releaseSenderShmem(void *)
+
+PURPOSE:	Detach a sender's message shared memory and remove it from the
+			attachment cache.
+
+RETURNS:	success: 0
+			failure: -1
+**********************************************************************/
+
+int releaseSenderShmem(void *sender)
+{
+// SENDER_SHMEM SenderShmem[] is global
+int ret = -1;
+
+if (sender == NULL)
+	return -1;
+
+for (int i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+	{
+	if (SenderShmem[i].shmPtr == sender)
+		{
+		SenderShmem[i].shmid = -1;
+		SenderShmem[i].owner = 0;
+		SenderShmem[i].ino = 0;
+		SenderShmem[i].pid = -1;
+		SenderShmem[i].shmPtr = (void *)NULL;
+		SenderShmem[i].lastUse = 0;
+		ret = 0;
+		break;
+		}
+	}
+
+// an uncached attachment is simply detached
+unmapSenderShmem(sender);
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	void doneSenderShmem(void *, bool)
+
+PURPOSE:	Let go of a sender's message shared memory once its message
+			has been replied to, relayed on or abandoned. An attachment 
+			the cache had no room for is detached; a cached one is kept 
+			for the sender's next message unless the sender is gone.
+
+RETURNS:	nothing
+
+NOTE:		Called by Receive(), Reply(), ReplyError(), Relay().
+**********************************************************************/
+
+void doneSenderShmem(void *sender, bool gone)
+{
+// bool SimServeWorker is global
+
+/*
+A Serve() worker's sender was attached by the dispatcher, whose cache the
+worker cannot see; serveWorker() and the dispatcher see to it.
+*/
+if (SimServeWorker)
+	return;
+
+if (gone || !isSenderCached(sender))
+	releaseSenderShmem(sender);
+}
+
+/**********************************************************************
+FUNCTION:	bool isSenderCached(void *)
+
+PURPOSE:	This function checks whether a sender's message shared memory
+			is held in the attachment cache.
+
+RETURNS:	cached: true
+			not cached: false
+
+NOTE:		Called by doneSenderShmem(), Serve().
+**********************************************************************/
+
+bool isSenderCached(void *sender)
+{
+// SENDER_SHMEM SenderShmem[] is global
+
+for (int i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+	{
+	if (SenderShmem[i].shmPtr == sender)
+		return true;
+	}
+
+return false;
+}
+
+/**********************************************************************
+FUNCTION:	bool senderAlive(SENDER_SHMEM *)
+
+PURPOSE:	Check that a cached attachment still stands for the shmem its
+			sender sends from, by the receiver's own record rather than 
+			anything in the shmem. A SysV shmem is good for as long as the
+			sender is running. A memfd number is reused by the sender once
+			it is closed, so a memfd shmem is good for as long as the 
+			owner still holds the same file (inode) under that number.
+
+RETURNS:	good: true
+			gone: false
+
+NOTE:		Called by attachSenderShmem().
+**********************************************************************/
+
+bool senderAlive(SENDER_SHMEM *entry)
+{
+char path[50];
+struct stat st;
+
+// SysV shmem
+if (entry->owner == 0)
+	return (kill(entry->pid, 0) == 0 || errno == EPERM);
+
+// memfd shmem
+sprintf(path, "/proc/%d/fd/%d", entry->owner, entry->shmid);
+return (stat(path, &st) == 0 && st.st_ino == entry->ino);
+}
+
+/**********************************************************************
+FUNCTION:	void *mapSenderShmem(int, pid_t, ino_t *)
+
+PURPOSE:	Attach a sender's message shared memory. A memfd shmem is
+			reached through the owner's /proc/<pid>/fd entry, which the
+			kernel allows for processes of the same user only, and its
+			length is noted by addSenderMap(). The inode of a memfd shmem,
+			0 for SysV shmem, is returned by way of ino.
+
+RETURNS:	success: address of the shmem
+			failure: NULL
+
+NOTE:		Called by attachSenderShmem().
+**********************************************************************/
+
+void *mapSenderShmem(int shmid, pid_t owner, ino_t *ino)
+{
+const char *fn = "mapSenderShmem";
+// WHO_AM_I SimParms is global
+char path[50];
+struct stat st;
+void *shmPtr = NULL;
+int fd = -1;
+
+*ino = 0;
+
+// SysV shmem
+if (owner == 0)
+	{
+	shmPtr = (void *)shmat(shmid, (void *)0, 0);
+	return (shmPtr == (void *)-1) ? NULL : shmPtr;
+	}
+
+// memfd shmem
+sprintf(path, "/proc/%d/fd/%d", owner, shmid);
+fd = open(path, O_RDWR);
+if (fd == -1)
+	{
+	if (errno == EACCES || errno == EPERM)
+		sryLog("%s: memfd shmem of pid %d not open to this user-%s.\n", fn, 
+														owner, strerror(errno));
+	return NULL;
+	}
+
+if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(FCMSG_REC))
+	{
+	close(fd);
+	return NULL;
+	}
+
+shmPtr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED | 
+							(SimParms.populate ? MAP_POPULATE : 0), fd, 0);
+
+// the mapping holds on to the memfd
+close(fd);
+
+if (shmPtr == MAP_FAILED)
+	return NULL;
+
+if (addSenderMap(shmPtr, st.st_size) == -1)
+	{
+	munmap(shmPtr, st.st_size);
+	return NULL;
+	}
+
+*ino = st.st_ino;
+return shmPtr;
+}
+
+/**********************************************************************
+FUNCTION:	void unmapSenderShmem(void *)
+
+PURPOSE:	Detach a sender's message shared memory. A memfd shmem is 
+			unmapped with the length it was mapped with, as noted by 
+			mapSenderShmem() rather than anything the sender wrote in it; 
+			any other is SysV shmem.
+
+RETURNS:	nothing
+
+NOTE:		Called by releaseSenderShmem(), serveWorker().
+**********************************************************************/
+
+void unmapSenderShmem(void *sender)
+{
+size_t size = takeSenderMap(sender);
+
+if (size)
+	munmap(sender, size);
+else
+	shmdt(sender);
+}
+
+/**********************************************************************
+FUNCTION:	int addSenderMap(void *, size_t)
+
+PURPOSE:	Note the length a sender's memfd shmem was mapped with. The 
+			table is doubled in size when full.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by mapSenderShmem().
+**********************************************************************/
+
+int addSenderMap(void *shmPtr, size_t mapSize)
+{
+// SENDER_MAPS SenderMaps is global
+SENDER_MAPS *t = &SenderMaps;
+SENDER_MAP *p = NULL;
+unsigned size = 0;
+int ret = 0;
+
+pthread_mutex_lock(&t->lock);
+
+if (t->count == t->size)
+	{
+	size = t->size ? t->size * 2 : MIN_NUM_SENDER_MAPS;
+	p = (SENDER_MAP *)realloc(t->map, size * sizeof(SENDER_MAP));
+	if (p == NULL)
+		ret = -1;
+	else
+		{
+		t->map = p;
+		t->size = size;
+		}
+	}
+
+if (ret == 0)
+	{
+	t->map[t->count].shmPtr = shmPtr;
+	t->map[t->count].mapSize = mapSize;
+	t->count++;
+	}
+
+pthread_mutex_unlock(&t->lock);
+
+return ret;
+}
+
+/**********************************************************************
+FUNCTION:	size_t takeSenderMap(void *)
+
+PURPOSE:	Look up, and forget, the length a sender's memfd shmem was 
+			mapped with.
+
+RETURNS:	memfd shmem: the mapped length
+			otherwise: 0
+
+NOTE:		Called by unmapSenderShmem().
+**********************************************************************/
+
+size_t takeSenderMap(void *shmPtr)
+{
+// SENDER_MAPS SenderMaps is global
+SENDER_MAPS *t = &SenderMaps;
+size_t mapSize = 0;
+
+pthread_mutex_lock(&t->lock);
+
+for (unsigned i = 0; i < t->count; i++)
+	{
+	if (t->map[i].shmPtr == shmPtr)
+		{
+		mapSize = t->map[i].mapSize;
+		t->map[i] = t->map[--t->count];
+		break;
+		}
+	}
+
+pthread_mutex_unlock(&t->lock);
+
+return mapSize;
+}
+
+/**********************************************************************
+FUNCTION:	void releaseAllSenderShmem(void)
+
+PURPOSE:	Detach all cached sender message shared memory.
+
+RETURNS:	nothing
+**********************************************************************/
+
+void releaseAllSenderShmem()
+{
+// SENDER_SHMEM SenderShmem[] is global
+
+for (int i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+	{
+	if (SenderShmem[i].shmPtr != NULL)
+		releaseSenderShmem(SenderShmem[i].shmPtr);
+	}
+}
+
+/********************************************************************/
+/************************* FIFO FUNCTIONS ***************************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	int createFifos(void)
+
+PURPOSE:	Name, create and open receive and reply fifos.
+
+RETURNS:	success (valid fifo fd): 0
+			failure (no valid fifo): -1
+***********************************************************************/
+
+int createFifos()
+{
+const char *fn = "createFifos";
+/*
+more space than required, typically a path and name
+such as "/var/tmp/simName.12345" is usual
+*/
+char rname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+char yname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+// WHO_AM_I SimParms is global; partly populated in openSRY()
+// char *SimFifoPath is global; set in openSRY()
+
+// receive fifo
+sprintf(rname, "%s/R_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+// reply fifo
+sprintf(yname, "%s/Y_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+
+// create receive fifo
+if (mkfifo(rname, 0666) == -1)
+	{
+	sryLog("%s: Unable to create fifo %s-%s.\n", fn, rname, strerror(errno));
+	return -1;
+	}
+// create reply fifo
+if (mkfifo(yname, 0666) == -1)
+	{
+	sryLog("%s: Unable to create fifo %s-%s.\n", fn, yname, strerror(errno));
+	return -1;
+	}
+
+// receive fifo; masks the mode 0666 with user's umask
+if (chmod(rname, 0666) == -1)
+	{
+	sryLog("%s: Unable to chmod fifo %s-%s.\n", fn, rname, strerror(errno));
+	return -1;
+	}
+// reply fifo; masks the mode 0666 with user's umask
+if (chmod(yname, 0666) == -1)
+	{
+	sryLog("%s: Unable to chmod fifo %s-%s.\n", fn, yname, strerror(errno));
+	return -1;
+	}
+
+// open receive fifo, close when not needed 
+SimParms.rfd = open(rname, O_RDWR);
+if (SimParms.rfd == -1)
+	{
+	sryLog("%s: Unable to open fifo %s-%s.\n", fn, rname, strerror(errno));
+	return -1;
+	}
+// open reply fifo for use, close when not needed 
+SimParms.yfd = open(yname, O_RDWR);
+if (SimParms.yfd == -1)
+	{
+	sryLog("%s: Unable to open fifo %s-%s.\n", fn, yname, strerror(errno));
+	return -1;
+	}
+
+// register the name; should that fail the name is found by way of the fifos
+registerName(SimParms.whom, SimParms.pid);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int detachFifos(void)
+
+PURPOSE:	Close receive and reply fifo file descriptors.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int detachFifos()
+{
+// WHO_AM_I SimParms is global; populated in openSRY()
+
+// close the receive fifo
+if (SimParms.rfd != -1)
+	{
+	close(SimParms.rfd);
+	SimParms.rfd = -1;
+	}
+
+// close the reply fifo
+if (SimParms.yfd != -1)
+	{
+	close(SimParms.yfd);
+	SimParms.yfd = -1;
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int deleteFifos(void)
+
+PURPOSE:	Remove receive and reply fifos.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int deleteFifos()
+{
+//const char *fn = "deleteFifos";
+/*
+more space than required, typically a path and name
+such as "/var/tmp/simName.12345" is usual
+*/
+char rname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+char yname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+// WHO_AM_I SimParms is global; populated in openSRY()
+// char *SimFifoPath is global; set early on in openSRY()
+
+// receive fifo
+sprintf(rname, "%s/R_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+// reply fifo
+sprintf(yname, "%s/Y_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+
+// close Receive and replY fifos
+detachFifos();
+
+// no longer to be found by name
+deregisterName(SimParms.whom, SimParms.pid);
+
+// check for presence of receive fifo
+if (access(rname, F_OK) == 0)
+	{
+	// delete the receive fifo
+	if (remove(rname) == -1)
+		{
+		/*
+		sryLog("%s: Unable to remove fifo %s-%s.\n", fn, rname, 
+														strerror(errno));
+		return -1;
+		*/
+		}
+	}		
+
+// check for presence of reply fifo
+if (access(yname, F_OK) == 0)
+	{
+	// delete the reply fifo
+	if (remove(yname) == -1)
+		{
+		/*
+		sryLog("%s: Unable to remove fifo %s-%s.\n", fn, yname, 
+														strerror(errno));
+		return -1;
+		*/
+		}
+	}
+	
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int readFifoMsg(int, char *)
+
+PURPOSE:	read any pending bytes from specified fifo fd, waiting no
+			longer than the deadline if one is set.
+
+RETURNS:	success: sizeof FIFO_MSG
+			failure: != sizeof FIFO_MSG, errno ETIMEDOUT past the deadline
+**********************************************************************/	
+
+int readFifoMsg(int fd, char *buf)
+{
+int numBytes = 0, bytesToGo = 0, rc = 0;
+char *p = buf;
+
+if (pollDeadline(fd) == -1)
+	return -1;
+
+for (int i = 0; i < 10; i++)
+	{
+	bytesToGo = sizeof(FIFO_MSG) - numBytes;
+	if (bytesToGo <= 0)
+		break;
+	rc = read(fd, p, bytesToGo);
+	numBytes += rc;
+	p += rc;
+	}
+
+return numBytes;
+}
+
+/**********************************************************************
+FUNCTION:	int waitReplyFifo(FCMSG_REC *, char *)
+
+PURPOSE:	Wait on the reply fifo for the receiver's Reply() or 
+			ReplyError() to the message in msgPtr. With messages posted the
+			reply fifo messages can come in any order; each reply sets the
+			reply state in its own shmem and writes one fifo message, and
+			fifo messages read ahead of their replies are counted in
+			ReplyFifoTokens.
+
+RETURNS:	success: sizeof FIFO_MSG, fifo message shmid 0 or -1 on error
+			failure: != sizeof FIFO_MSG
+
+NOTE:		Called by Send(), collectPostedReply().
+***********************************************************************/
+
+int waitReplyFifo(FCMSG_REC *msgPtr, char *fifoBuf)
+{
+// WHO_AM_I SimParms is global
+// int ReplyFifoTokens is global
+int state = REPLY_PENDING, rc = 0;
+
+// read fifo messages until this message is replied and one is in hand for it
+while (true)
+	{
+	state = __atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE);
+	if ((state == REPLY_DONE || state == REPLY_FAILED) && ReplyFifoTokens > 0)
+		break;
+	rc = readFifoMsg(SimParms.yfd, fifoBuf);
+	if (rc != sizeof(FIFO_MSG))
+		return rc;
+	ReplyFifoTokens++;
+	}
+ReplyFifoTokens--;
+
+((FIFO_MSG *)fifoBuf)->shmid = (state == REPLY_DONE) ? 0 : -1;
+((FIFO_MSG *)fifoBuf)->pid = 0;
+
+return sizeof(FIFO_MSG);
+}
+
+/**********************************************************************
+FUNCTION:	int openReplyFifo(const pid_t, const char *)
+
+PURPOSE:	Return a write descriptor to a sender's reply fifo. The fifo is
+			opened on the first reply to the sender and the descriptor is
+			kept for subsequent replies.
+
+RETURNS:	success: a file descriptor > 2; ReplyFifoHint is its entry
+			failure: -1
+
+NOTE:		Called by putReplyFifo(), writeUringReply().
+***********************************************************************/
+
+int openReplyFifo(const pid_t pid, const char *whom)
+{
+// REPLY_FIFO ReplyFifo[] is global
+// int ReplyFifoHint is global
+// char *SimFifoPath is global
+char fifoName[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+REPLY_FIFO *entry = &ReplyFifo[ReplyFifoHint], *victim = NULL;
+int fd = -1;
+
+// most likely the sender that was just received
+if (entry->pid == pid && !strcmp(entry->whom, whom))
+	{
+	entry->lastUse = SenderShmemClock;
+	return entry->fd;
+	}
+
+for (int i = 0; i < MAX_NUM_REPLY_FIFOS; i++)
+	{
+	entry = &ReplyFifo[i];
+	if (entry->pid == pid && !strcmp(entry->whom, whom))
+		{
+		entry->lastUse = SenderShmemClock;
+		ReplyFifoHint = i;
+		return entry->fd;
+		}
+
+	// remember a free slot or else the least recently used one
+	if (victim == NULL || (victim->fd != -1 && (entry->fd == -1 ||
+											entry->lastUse < victim->lastUse)))
+		victim = entry;
+	}
+
+// set the sender's reply fifo path and name
+sprintf(fifoName, "%s/Y_%s.%d", SimFifoPath, whom, pid);
+
+/*
+Non-blocking so that the open fails rather than waits should the sender have
+died leaving its fifo behind.
+*/
+fd = open(fifoName, O_WRONLY | O_NONBLOCK);
+if (fd == -1)
+	return -1;
+
+// make room in the table
+if (victim->fd != -1)
+	close(victim->fd);
+
+strcpy(victim->whom, whom);
+victim->pid = pid;
+victim->fd = fd;
+victim->lastUse = SenderShmemClock;
+ReplyFifoHint = victim - ReplyFifo;
+
+// io_uring writes to the registered copy
+setUringFile(ReplyFifoHint + 1, fd);
+
+return fd;
+}
+
+/**********************************************************************
+FUNCTION:	int writeReplyFifo(FCMSG_REC *, char *)
+
+PURPOSE:	Write a fifo message to a sender's reply fifo, now by way of
+			the cached descriptor or in a batch by way of io_uring.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by Reply(), ReplyError().
+***********************************************************************/
+
+int writeReplyFifo(FCMSG_REC *msgPtr, char *fifoBuf)
+{
+// WHO_AM_I SimParms is global
+
+// a sender with several messages posted goes by the reply state
+__atomic_store_n(&msgPtr->replyState, (((FIFO_MSG *)fifoBuf)->shmid == -1) ? 
+							REPLY_FAILED : REPLY_DONE, __ATOMIC_RELEASE);
+
+if (SimParms.ioEngine == SIM_IO_URING)
+	return writeUringReply(msgPtr, fifoBuf);
+
+return putReplyFifo(msgPtr->pid, msgPtr->whom, fifoBuf);
+}
+
+/**********************************************************************
+FUNCTION:	int putReplyFifo(const pid_t, const char *, char *)
+
+PURPOSE:	Write a fifo message to a sender's reply fifo by way of the
+			cached descriptor. A stale descriptor is reopened once.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by writeReplyFifo(), reapUring().
+***********************************************************************/
+
+int putReplyFifo(const pid_t pid, const char *whom, char *fifoBuf)
+{
+int fd = -1;
+
+for (int i = 0; i < 2; i++)
+	{
+	fd = openReplyFifo(pid, whom);
+	if (fd == -1)
+		return -1;
+
+	if (write(fd, fifoBuf, sizeof(FIFO_MSG)) == sizeof(FIFO_MSG))
+		return 0;
+
+	/*
+	EPIPE: nobody is reading the fifo any more, the sender has gone away or
+	its name and pid have since been reused; try again with a fresh open
+	*/
+	closeReplyFifo(pid, whom);
+	if (errno != EPIPE)
+		break;
+	}
+
+return -1;
+}
+
+/**********************************************************************
+FUNCTION:	void closeReplyFifo(const pid_t, const char *)
+
+PURPOSE:	Close a cached reply fifo descriptor of a sender.
+
+RETURNS:	nothing
+
+NOTE:		Called by putReplyFifo(), closeAllReplyFifos(), chkStatus().
+***********************************************************************/
+
+void closeReplyFifo(const pid_t pid, const char *name)
+{
+// REPLY_FIFO ReplyFifo[] is global
+
+for (int i = 0; i < MAX_NUM_REPLY_FIFOS; i++)
+	{
+	if (ReplyFifo[i].pid == pid && !strcmp(ReplyFifo[i].whom, name))
+		{
+		close(ReplyFifo[i].fd);
+		setUringFile(i + 1, -1);
+		ReplyFifo[i].whom[0] = 0;
+		ReplyFifo[i].pid = -1;
+		ReplyFifo[i].fd = -1;
+		ReplyFifo[i].lastUse = 0;
+		break;
+		}
+	}
+}
+
+/**********************************************************************
+FUNCTION:	void closeAllReplyFifos(void)
+
+PURPOSE:	Close all cached reply fifo descriptors.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild().
+***********************************************************************/
+
+void closeAllReplyFifos()
+{
+// REPLY_FIFO ReplyFifo[] is global
+
+for (int i = 0; i < MAX_NUM_REPLY_FIFOS; i++)
+	{
+	if (ReplyFifo[i].fd != -1)
+		closeReplyFifo(ReplyFifo[i].pid, ReplyFifo[i].whom);
+	}
+}
+
+/**********************************************************************
+FUNCTION:	int getFifoName(const char *, char *)
+
+PURPOSE:	Find a receive fifo based on the sim name.
+
+RETURNS:	success: 0 
+			failure: -1
+***********************************************************************/
+
+int getFifoName(const char *simName, char *fifoName)
+{
+const char *fn = "getFifoName";
+DIR *directory = NULL;
+struct dirent *file = NULL;
+int len = 0, ret = -1;
+char entryName[128];
+pid_t pid = -1;
+// char *SimFifoPath is global
+// SIM_REGISTRY *SimRegistry is global
+
+// look up the name registry first
+if (SimRegistry != NULL)
+	{
+	pid = lookupName(simName, NULL);
+	if (pid != -1)
+		{
+		sprintf(fifoName, "%s/R_%s.%d", SimFifoPath, simName, pid);
+		return 0;
+		}
+	}
+
+/*
+A receiver not in the registry, one whose registration failed or that does not
+use the registry, is still found by way of its fifo.
+*/
+
+// open the fifo directory
+directory = opendir(SimFifoPath);
+if (directory == NULL)
+	{
+	sryLog("%s: Unable to open fifo directory %s.\n", fn, SimFifoPath);
+	return -1;
+	}
+
+// the fifo directory file name based on the SIM name passed in 
+sprintf(entryName, "R_%s", simName); 
+len = strlen(entryName);
+
+// check for a match
+while ((file = readdir(directory)) != NULL)
+	{
+	// check for a match
+	if (file->d_name[len] == '.' && !memcmp(file->d_name, entryName, len) &&
+									isPidSuffix(file->d_name + len + 1))
+		{
+		// sim names match
+		sprintf(fifoName, "%s/%s", SimFifoPath, file->d_name);
+		ret = 0;
+		break;
+		}
+	}
+
+closedir(directory);
+
+return ret;
+}
+
+/********************************************************************/
+/********************* FUTEX TRANSPORT FUNCTIONS ********************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	int simFutex(int *, int, int)
+
+PURPOSE:	Wait on or wake a futex word in memory shared between
+			processes. A wait ends at the deadline, if one is set.
+
+RETURNS:	as per the futex system call, errno ETIMEDOUT past the deadline
+***********************************************************************/
+
+int simFutex(int *addr, int op, int val)
+{
+// SIM_DEADLINE SimDeadline is global
+
+// the bitset wait takes an absolute CLOCK_MONOTONIC time
+if (op == FUTEX_WAIT && SimDeadline.set)
+	return syscall(SYS_futex, addr, FUTEX_WAIT_BITSET, val, &SimDeadline.at, 
+												NULL, FUTEX_BITSET_MATCH_ANY);
+
+return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+/**********************************************************************
+FUNCTION:	int createMailbox(void)
+
+PURPOSE:	Name, create and map the futex transport mailbox of this
+			process. Senders map the same file in order to hand triggers
+			straight to a receiver waiting in Receive().
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by openSRY().
+***********************************************************************/
+
+int createMailbox()
+{
+const char *fn = "createMailbox";
+char mname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+int fd = -1;
+void *p = NULL;
+// WHO_AM_I SimParms is global; partly populated in openSRY()
+// char *SimFifoPath is global; set in openSRY()
+
+// mailbox file lives alongside the fifos
+sprintf(mname, "%s/M_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+
+// a leftover from an earlier process of the same name and pid is of no use
+remove(mname);
+
+fd = open(mname, O_RDWR | O_CREAT | O_EXCL, 0666);
+if (fd == -1)
+	{
+	sryLog("%s: Unable to create mailbox %s-%s.\n", fn, mname, strerror(errno));
+	return -1;
+	}
+
+// masks the mode 0666 with user's umask
+if (fchmod(fd, 0666) == -1 || ftruncate(fd, sizeof(SIM_MAILBOX)) == -1)
+	{
+	sryLog("%s: Unable to size mailbox %s-%s.\n", fn, mname, strerror(errno));
+	close(fd);
+	remove(mname);
+	return -1;
+	}
+
+p = mmap(NULL, sizeof(SIM_MAILBOX), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+close(fd);
+if (p == MAP_FAILED)
+	{
+	sryLog("%s: Unable to map mailbox %s-%s.\n", fn, mname, strerror(errno));
+	remove(mname);
+	return -1;
+	}
+
+SimParms.mbox = (SIM_MAILBOX *)p;
+SimParms.mbox->pid = SimParms.pid;
+SimParms.mbox->state = MBOX_RUNNING;
+SimParms.mbox->token = 0;
+SimParms.mbox->fifoCount = 0;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int detachMailbox(void)
+
+PURPOSE:	Unmap the futex transport mailbox of this process.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by closeSRYchild(), deleteMailbox().
+***********************************************************************/
+
+int detachMailbox()
+{
+// WHO_AM_I SimParms is global
+
+if (SimParms.mbox == NULL)
+	return -1;
+
+munmap(SimParms.mbox, sizeof(SIM_MAILBOX));
+SimParms.mbox = NULL;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int deleteMailbox(void)
+
+PURPOSE:	Unmap and remove the futex transport mailbox of this process.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by closeSRY().
+***********************************************************************/
+
+int deleteMailbox()
+{
+char mname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
+
+if (detachMailbox() == -1)
+	return -1;
+
+sprintf(mname, "%s/M_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+remove(mname);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	SIM_MAILBOX *attachMailbox(const char *)
+
+PURPOSE:	Map the mailbox file of a futex transport receiver.
+
+RETURNS:	success: pointer to the mailbox
+			failure or fifo only receiver: NULL
+***********************************************************************/
+
+SIM_MAILBOX *attachMailbox(const char *mname)
+{
+int fd = -1;
+void *p = NULL;
+
+fd = open(mname, O_RDWR);
+if (fd == -1)
+	return NULL;
+
+p = mmap(NULL, sizeof(SIM_MAILBOX), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+close(fd);
+
+return (p == MAP_FAILED) ? NULL : (SIM_MAILBOX *)p;
+}
+
+/**********************************************************************
+FUNCTION:	LOCATED_RECEIVER *addLocatedReceiver(int, const char *)
+
+PURPOSE:	Record a receive fifo fd along with the receiver's mailbox and
+			proxy table, if the receiver has them.
+
+RETURNS:	pointer to the table entry
+
+NOTE:		Called by Locate(), findLocatedReceiver().
+***********************************************************************/
+
+LOCATED_RECEIVER *addLocatedReceiver(int fd, const char *fifoName)
+{
+// LOCATED_RECEIVER LocatedReceiver[] is global
+// int LocatedReceiverHint is global
+char mname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+LOCATED_RECEIVER *entry = NULL;
+struct stat st;
+unsigned generation = 0;
+char *p = NULL, *dot = NULL;
+
+// an fd number is reused once closed, so any earlier record is out of date
+for (int i = 0; i < MAX_NUM_LOCATED_RECEIVERS; i++)
+	{
+	if (LocatedReceiver[i].fd == fd)
+		{
+		entry = &LocatedReceiver[i];
+		break;
+		}
+	if (entry == NULL && LocatedReceiver[i].fd == -1)
+		entry = &LocatedReceiver[i];
+	}
+
+// table full; take the slot following the last one used
+if (entry == NULL)
+	entry = &LocatedReceiver[(LocatedReceiverHint + 1) % MAX_NUM_LOCATED_RECEIVERS];
+
+if (entry->mbox != NULL)
+	munmap(entry->mbox, sizeof(SIM_MAILBOX));
+if (entry->proxies != NULL)
+	munmap(entry->proxies, sizeof(SIM_PROXY_TABLE));
+
+// the mailbox of R_name.12345 is M_name.12345, its proxy table Q_name.12345
+snprintf(mname, sizeof mname, "%s", fifoName);
+p = strrchr(mname, '/');
+p = (p == NULL) ? mname : p + 1;
+
+entry->fd = fd;
+entry->pid = -1;
+entry->mbox = NULL;
+entry->proxies = NULL;
+entry->name[0] = 0;
+entry->generation = 0;
+entry->dev = 0;
+entry->ino = 0;
+if (!strncmp(p, "R_", 2))
+	{
+	// the receiver's name and pid
+	dot = strrchr(p, '.');
+	if (dot != NULL && dot - p - 2 <= MAX_SIM_NAME_LEN)
+		{
+		memcpy(entry->name, p + 2, dot - p - 2);
+		entry->name[dot - p - 2] = 0;
+		entry->pid = atoi(dot + 1);
+		}
+
+	*p = 'M';
+	entry->mbox = attachMailbox(mname);
+	*p = 'Q';
+	entry->proxies = attachProxyTable(mname);
+	}
+
+// note what to check when Locate() is asked for the receiver again
+if (fstat(fd, &st) == 0)
+	{
+	entry->dev = st.st_dev;
+	entry->ino = st.st_ino;
+	}
+if (entry->name[0] && lookupName(entry->name, &generation) == entry->pid)
+	entry->generation = generation;
+
+LocatedReceiverHint = entry - LocatedReceiver;
+
+return entry;
+}
+
+/**********************************************************************
+FUNCTION:	LOCATED_RECEIVER *findLocatedReceiver(int)
+
+PURPOSE:	Look up the record of a receive fifo fd. An fd that did not
+			come by way of Locate() in this process, eg. inherited, is
+			recorded here and now.
+
+RETURNS:	pointer to the table entry
+
+NOTE:		Called by writeTrigger().
+***********************************************************************/
+
+LOCATED_RECEIVER *findLocatedReceiver(int fd)
+{
+// LOCATED_RECEIVER LocatedReceiver[] is global
+// int LocatedReceiverHint is global
+char fdName[50], fifoName[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+ssize_t len = 0;
+
+// most likely the receiver that was sent to last
+if (LocatedReceiver[LocatedReceiverHint].fd == fd)
+	return &LocatedReceiver[LocatedReceiverHint];
+
+for (int i = 0; i < MAX_NUM_LOCATED_RECEIVERS; i++)
+	{
+	if (LocatedReceiver[i].fd == fd)
+		{
+		LocatedReceiverHint = i;
+		return &LocatedReceiver[i];
+		}
+	}
+
+// recover the receive fifo name from the fd
+sprintf(fdName, "/proc/self/fd/%d", fd);
+len = readlink(fdName, fifoName, sizeof(fifoName) - 1);
+fifoName[(len < 0) ? 0 : len] = 0;
+
+return addLocatedReceiver(fd, fifoName);
+}
+
+/**********************************************************************
+FUNCTION:	LOCATED_RECEIVER *findLocatedName(const char *)
+
+PURPOSE:	Look up a receiver located earlier by its SIM name.
+
+RETURNS:	success: pointer to the table entry
+			failure: NULL
+
+NOTE:		Called by Locate().
+***********************************************************************/
+
+LOCATED_RECEIVER *findLocatedName(const char *name)
+{
+// LOCATED_RECEIVER LocatedReceiver[] is global
+
+for (int i = 0; i < MAX_NUM_LOCATED_RECEIVERS; i++)
+	{
+	if (LocatedReceiver[i].fd != -1 && !strcmp(LocatedReceiver[i].name, name))
+		return &LocatedReceiver[i];
+	}
+
+return NULL;
+}
+
+/**********************************************************************
+FUNCTION:	bool chkLocatedReceiver(LOCATED_RECEIVER *)
+
+PURPOSE:	Check that a receiver located earlier may be handed out again
+			by Locate(): its fd is still open on its receive fifo and the
+			same receiver is still running under the name.
+
+RETURNS:	good to reuse: true
+			not to be reused: false
+
+NOTE:		Called by Locate().
+***********************************************************************/
+
+bool chkLocatedReceiver(LOCATED_RECEIVER *entry)
+{
+// SIM_REGISTRY *SimRegistry is global
+struct stat st;
+unsigned generation = 0;
+pid_t pid = -1;
+
+// the caller has closed the fd; the number may since have been reused
+if (fstat(entry->fd, &st) == -1 || st.st_dev != entry->dev || 
+												st.st_ino != entry->ino)
+	{
+	if (entry->mbox != NULL)
+		munmap(entry->mbox, sizeof(SIM_MAILBOX));
+	if (entry->proxies != NULL)
+		munmap(entry->proxies, sizeof(SIM_PROXY_TABLE));
+	entry->fd = -1;
+	entry->pid = -1;
+	entry->mbox = NULL;
+	entry->proxies = NULL;
+	entry->name[0] = 0;
+	return false;
+	}
+
+/*
+The name has since been taken by another receiver, or the receiver is gone. A
+receiver that was not in the registry when located (generation 0) is stale only
+should another have registered the name.
+*/
+if (SimRegistry != NULL)
+	pid = lookupName(entry->name, &generation);
+if ((pid != -1 && (pid != entry->pid || generation != entry->generation)) ||
+			(pid == -1 && entry->generation != 0) ||
+			chkStatus(entry->pid, entry->name) == false)
+	{
+	// the fd is still the caller's to close
+	entry->name[0] = 0;
+	return false;
+	}
+
+return true;
+}
+
+/**********************************************************************
+FUNCTION:	void releaseAllLocatedReceivers(void)
+
+PURPOSE:	Unmap the mailboxes and proxy tables of all located receivers
+			and clear the table.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild().
+***********************************************************************/
+
+void releaseAllLocatedReceivers()
+{
+// LOCATED_RECEIVER LocatedReceiver[] is global
+
+for (int i = 0; i < MAX_NUM_LOCATED_RECEIVERS; i++)
+	{
+	if (LocatedReceiver[i].mbox != NULL)
+		munmap(LocatedReceiver[i].mbox, sizeof(SIM_MAILBOX));
+	if (LocatedReceiver[i].proxies != NULL)
+		munmap(LocatedReceiver[i].proxies, sizeof(SIM_PROXY_TABLE));
+	LocatedReceiver[i].fd = -1;
+	LocatedReceiver[i].pid = -1;
+	LocatedReceiver[i].mbox = NULL;
+	LocatedReceiver[i].proxies = NULL;
+	LocatedReceiver[i].name[0] = 0;
+	}
+}
+
+/**********************************************************************
+FUNCTION:	int writeTrigger(int, char *)
+
+PURPOSE:	Deliver a fifo message (message trigger or proxy) to a
+			receiver. A futex transport receiver asleep in Receive() is
+			handed the message through its mailbox; otherwise the message
+			is written to the receive fifo as always so that the receiver
+			may select()/poll() on rfd().
+
+RETURNS:	success: sizeof FIFO_MSG
+			failure: -1
+
+NOTE:		Called by Send(), PostMessage(), Trigger(), Relay().
+***********************************************************************/
+
+int writeTrigger(int fd, char *fifoBuf)
+{
+LOCATED_RECEIVER *entry = findLocatedReceiver(fd);
+SIM_MAILBOX *mbox = entry->mbox;
+int state = MBOX_RUNNING;
+
+// fifo only receiver
+if (mbox == NULL)
+	{
+	if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
+		{
+		// the receiver is gone; Locate() must not hand out this fd again
+		if (errno == EPIPE)
+			entry->name[0] = 0;
+		return -1;
+		}
+	return sizeof(FIFO_MSG);
+	}
+
+// hand the message straight to a receiver asleep or spinning in Receive()
+state = __atomic_load_n(&mbox->state, __ATOMIC_RELAXED);
+if ((state == MBOX_PARKED || state == MBOX_SPINNING) &&
+		__atomic_compare_exchange_n(&mbox->state, &state, MBOX_CLAIMED, false,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+	mbox->token = ((FIFO_MSG *)fifoBuf)->shmid;
+	mbox->tokenPid = ((FIFO_MSG *)fifoBuf)->pid;
+	mbox->tokenPriority = ((FIFO_MSG *)fifoBuf)->priority;
+	__atomic_store_n(&mbox->state, MBOX_HANDED, __ATOMIC_RELEASE);
+
+	// a spinning receiver sees the handoff for itself
+	if (state == MBOX_SPINNING)
+		return sizeof(FIFO_MSG);
+
+	// nobody woken; the receiver may not have got as far as the wait or be gone
+	if (simFutex(&mbox->state, FUTEX_WAKE, 1) == 0 &&
+			(getpriority(PRIO_PROCESS, entry->pid) == -1) && (errno == ESRCH))
+		{
+		entry->name[0] = 0;
+		errno = EPIPE;
+		return -1;
+		}
+	return sizeof(FIFO_MSG);
+	}
+
+/*
+The receiver is busy or waiting in select()/poll() on its fifo. Count the
+message before writing it so that a receiver about to sleep in Receive()
+knows to read the fifo instead.
+*/
+__atomic_add_fetch(&mbox->fifoCount, 1, __ATOMIC_SEQ_CST);
+if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
+	{
+	__atomic_sub_fetch(&mbox->fifoCount, 1, __ATOMIC_SEQ_CST);
+	if (errno == EPIPE)
+		entry->name[0] = 0;
+	return -1;
+	}
+
+// the receiver went to sleep without seeing the count; wake it to read the fifo
+state = MBOX_PARKED;
+if (__atomic_compare_exchange_n(&mbox->state, &state, MBOX_NUDGED, false,
+										__ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+	simFutex(&mbox->state, FUTEX_WAKE, 1);
+
+return sizeof(FIFO_MSG);
+}
+
+/**********************************************************************
+FUNCTION:	int readTrigger(char *)
+
+PURPOSE:	Wait for a fifo message (message trigger or proxy) from a
+			sender. With the futex transport messages written to the
+			receive fifo are taken first, then the receiver spins and/or
+			sleeps on its mailbox according to the wait policy.
+
+RETURNS:	success: sizeof FIFO_MSG
+			failure: != sizeof FIFO_MSG
+
+NOTE:		Called by Receive().
+***********************************************************************/
+
+int readTrigger(char *fifoBuf)
+{
+// WHO_AM_I SimParms is global
+// SIM_WAIT_STATS SimWaitStats is global
+SIM_MAILBOX *mbox = SimParms.mbox;
+int state = MBOX_PARKED, next = MBOX_PARKED, numBytes = 0;
+unsigned long spins = 0;
+bool blocked = false;
+
+// fifo transport, a batch of triggers at a time by way of io_uring if in use
+if (mbox == NULL)
+	{
+	if (SimParms.ioEngine == SIM_IO_URING)
+		return readUringTrigger(fifoBuf);
+	return readFifoMsg(SimParms.rfd, fifoBuf);
+	}
+
+SimWaitStats.waits++;
+
+while (true)
+	{
+	// messages written to the fifo while this receiver was not waiting
+	if (__atomic_load_n(&mbox->fifoCount, __ATOMIC_SEQ_CST) > 0)
+		{
+		numBytes = readFifoMsg(SimParms.rfd, fifoBuf);
+		__atomic_sub_fetch(&mbox->fifoCount, 1, __ATOMIC_SEQ_CST);
+		break;
+		}
+
+	// let senders know that this receiver is waiting
+	state = (SimParms.waitPolicy == SIM_WAIT_BLOCK) ? MBOX_PARKED : MBOX_SPINNING;
+	__atomic_store_n(&mbox->state, state, __ATOMIC_SEQ_CST);
+
+	// spin on the mailbox for a while (or for ever if polling)
+	for (spins = 0; state == MBOX_SPINNING; spins++)
+		{
+		if (__atomic_load_n(&mbox->fifoCount, __ATOMIC_SEQ_CST) > 0)
+			next = MBOX_RUNNING;
+		else if (SimParms.waitPolicy == SIM_WAIT_SPIN && 
+											spins >= SimParms.spinCount)
+			next = MBOX_PARKED;
+		// a poller out of time parks, and so times out in the futex wait
+		else if (SimDeadline.set && (spins & 1023) == 1023 && pastDeadline())
+			next = MBOX_PARKED;
+		else
+			{
+			SIM_CPU_RELAX();
+			state = __atomic_load_n(&mbox->state, __ATOMIC_ACQUIRE);
+			continue;
+			}
+
+		// stop spinning unless a sender has just claimed the mailbox
+		if (__atomic_compare_exchange_n(&mbox->state, &state, next, false,
+										__ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE))
+			state = next;
+		break;
+		}
+	SimWaitStats.spins += spins;
+
+	// message in the fifo
+	if (state == MBOX_RUNNING)
+		continue;
+
+	// go to sleep, unless a sender has written to the fifo in the meantime
+	if (state == MBOX_PARKED &&
+				__atomic_load_n(&mbox->fifoCount, __ATOMIC_SEQ_CST) > 0)
+		{
+		if (__atomic_compare_exchange_n(&mbox->state, &state, MBOX_RUNNING,
+							false, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE))
+			continue;
+		}
+
+	// a sender changes the state from parked to handed (or nudged)
+	while (state == MBOX_PARKED || state == MBOX_CLAIMED)
+		{
+		// a sender is part way through a handoff
+		if (state == MBOX_CLAIMED)
+			sched_yield();
+		else if (simFutex(&mbox->state, FUTEX_WAIT, state) == 0 ||
+										errno == EAGAIN || errno == EINTR)
+			blocked = true;
+		else if (errno != ETIMEDOUT)
+			return -1;
+		// out of time, unless a sender got in first
+		else if (__atomic_compare_exchange_n(&mbox->state, &state, 
+				MBOX_RUNNING, false, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE))
+			{
+			errno = ETIMEDOUT;
+			return -1;
+			}
+		else
+			continue;
+		state = __atomic_load_n(&mbox->state, __ATOMIC_ACQUIRE);
+		}
+
+	__atomic_store_n(&mbox->state, MBOX_RUNNING, __ATOMIC_RELAXED);
+
+	// handed straight over
+	if (state == MBOX_HANDED)
+		{
+		((FIFO_MSG *)fifoBuf)->shmid = mbox->token;
+		((FIFO_MSG *)fifoBuf)->pid = mbox->tokenPid;
+		((FIFO_MSG *)fifoBuf)->priority = mbox->tokenPriority;
+		numBytes = sizeof(FIFO_MSG);
+		break;
+		}
+
+	// nudged; the message is in the fifo
+	}
+
+if (blocked)
+	SimWaitStats.blocks++;
+else if (spins)
+	SimWaitStats.spinHits++;
+
+return numBytes;
+}
+
+/**********************************************************************
+FUNCTION:	int waitReplyFutex(FCMSG_REC *, char *)
+
+PURPOSE:	Wait on the reply futex in the sender's shmem for the
+			receiver's Reply() or ReplyError(), spinning first according
+			to the wait policy.
+
+RETURNS:	success: sizeof FIFO_MSG, fifo message shmid 0 or -1 on error
+			failure: -1
+
+NOTE:		Called by Send(), collectPostedReply().
+***********************************************************************/
+
+int waitReplyFutex(FCMSG_REC *msgPtr, char *fifoBuf)
+{
+// WHO_AM_I SimParms is global
+// SIM_WAIT_STATS SimWaitStats is global
+int state = REPLY_PENDING;
+unsigned long spins = 0;
+bool blocked = false;
+
+SimWaitStats.waits++;
+
+// spin on the reply futex for a while (or for ever if polling)
+if (SimParms.waitPolicy != SIM_WAIT_BLOCK)
+	{
+	for (spins = 0; SimParms.waitPolicy == SIM_WAIT_POLL || 
+										spins < SimParms.spinCount; spins++)
+		{
+		state = __atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE);
+		if (state == REPLY_DONE || state == REPLY_FAILED)
+			break;
+		// a poller out of time goes on to time out in the futex wait
+		if (SimDeadline.set && (spins & 1023) == 1023 && pastDeadline())
+			break;
+		SIM_CPU_RELAX();
+		}
+	SimWaitStats.spins += spins;
+	}
+
+while (true)
+	{
+	state = __atomic_load_n(&msgPtr->replyState, __ATOMIC_ACQUIRE);
+	if (state == REPLY_DONE || state == REPLY_FAILED)
+		break;
+
+	// let the receiver know that it must wake this sender
+	if (state == REPLY_PENDING)
+		{
+		if (!__atomic_compare_exchange_n(&msgPtr->replyState, &state,
+				REPLY_WAITING, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+			continue;
+		}
+
+	blocked = true;
+	if (simFutex(&msgPtr->replyState, FUTEX_WAIT, REPLY_WAITING) == -1 &&
+								errno != EAGAIN && errno != EINTR)
+		return -1;
+	}
+
+if (blocked)
+	SimWaitStats.blocks++;
+else if (spins)
+	SimWaitStats.spinHits++;
+
+((FIFO_MSG *)fifoBuf)->shmid = (state == REPLY_DONE) ? 0 : -1;
+((FIFO_MSG *)fifoBuf)->pid = 0;
+
+return sizeof(FIFO_MSG);
+}
+
+/**********************************************************************
+FUNCTION:	int postReplyFutex(FCMSG_REC *, char *)
+
+PURPOSE:	Set the reply futex in a sender's shmem according to the fifo
+			message and wake the sender if it is asleep.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by Reply(), ReplyError().
+***********************************************************************/
+
+int postReplyFutex(FCMSG_REC *msgPtr, char *fifoBuf)
+{
+int state = (((FIFO_MSG *)fifoBuf)->shmid == -1) ? REPLY_FAILED : REPLY_DONE;
+
+state = __atomic_exchange_n(&msgPtr->replyState, state, __ATOMIC_ACQ_REL);
+if (state != REPLY_WAITING)
+	return 0;
+
+// nobody woken; the sender may not have got as far as the wait or be gone
+if (simFutex(&msgPtr->replyState, FUTEX_WAKE, 1) == 0 && 
+											chkSender(msgPtr) == false)
+	{
+	errno = EPIPE;
+	return -1;
+	}
+
+return 0;
+}
+
+/********************************************************************/
+/********************* PRIORITY ORDER FUNCTIONS *********************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	int takeTrigger(char *)
+
+PURPOSE:	Hand Receive() its next fifo message. In arrival order this is
+			the next one from readTrigger(). In priority order all of the
+			triggers already waiting are first gathered into a heap, 
+			waiting for one if there are none, and the one of highest 
+			priority taken, the earliest of any of equal priority.
+
+RETURNS:	success: sizeof FIFO_MSG
+			failure: != sizeof FIFO_MSG
+
+NOTE:		Called by Receive().
+***********************************************************************/
+
+int takeTrigger(char *fifoBuf)
+{
+// WHO_AM_I SimParms is global
+// SIM_PENDING SimPending is global
+int rc = 0;
+
+if (SimParms.receiveOrder == SIM_ORDER_FIFO)
+	return readTrigger(fifoBuf);
+
+if (gatherTriggers() == -1)
+	return -1;
+
+// nothing waiting; wait for a trigger, then take in any that came with it
+if (SimPending.count == 0)
+	{
+	rc = readTrigger(fifoBuf);
+	if (rc != sizeof(FIFO_MSG))
+		return rc;
+	pushPending((FIFO_MSG *)fifoBuf);
+	if (gatherTriggers() == -1)
+		return -1;
+	}
+
+popPending((FIFO_MSG *)fifoBuf);
+
+// the receiving thread runs at the message's priority until the next one
+if (SimParms.receiveOrder == SIM_ORDER_INHERIT)
+	inheritPriority(((FIFO_MSG *)fifoBuf)->priority);
+
+return sizeof(FIFO_MSG);
+}
+
+/**********************************************************************
+FUNCTION:	int gatherTriggers(void)
+
+PURPOSE:	Move the triggers waiting on the receive fifo, or already read
+			ahead by io_uring, into the heap without blocking, for as long
+			as there is room.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by takeTrigger().
+***********************************************************************/
+
+int gatherTriggers()
+{
+// WHO_AM_I SimParms is global
+// SIM_PENDING SimPending is global
+FIFO_MSG msg;
+int rc = 0;
+
+while (SimPending.count < MAX_NUM_PENDING_TRIGGERS && triggerReady())
+	{
+	if (SimParms.ioEngine == SIM_IO_URING)
+		rc = readUringTrigger((char *)&msg);
+	else
+		rc = readFifoMsg(SimParms.rfd, (char *)&msg);
+	if (rc != sizeof(FIFO_MSG))
+		return -1;
+
+	// the futex transport counts the triggers written to the fifo
+	if (SimParms.mbox != NULL)
+		__atomic_sub_fetch(&SimParms.mbox->fifoCount, 1, __ATOMIC_SEQ_CST);
+
+	pushPending(&msg);
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	bool triggerReady(void)
+
+PURPOSE:	Check, without blocking, for a trigger to be read.
+
+RETURNS:	true if there is one, false if not
+
+NOTE:		Called by gatherTriggers().
+***********************************************************************/
+
+bool triggerReady()
+{
+// WHO_AM_I SimParms is global
+// SIM_URING SimUring is global
+struct pollfd pfd;
+
+// a futex transport receiver is not parked, so senders count fifo writes
+if (SimParms.mbox != NULL)
+	return __atomic_load_n(&SimParms.mbox->fifoCount, __ATOMIC_SEQ_CST) > 0;
+
+if (SimParms.ioEngine == SIM_IO_URING && SimUring.count > 0)
+	return true;
+
+pfd.fd = SimParms.rfd;
+pfd.events = POLLIN;
+
+return poll(&pfd, 1, 0) > 0;
+}
+
+/**********************************************************************
+FUNCTION:	bool pendingBefore(const PENDING_TRIGGER *, 
+												const PENDING_TRIGGER *)
+
+PURPOSE:	Compare two held triggers, higher priority first and then in
+			order of arrival.
+
+RETURNS:	true if a is to be received before b, false otherwise
+
+NOTE:		Called by pushPending(), popPending().
+***********************************************************************/
+
+bool pendingBefore(const PENDING_TRIGGER *a, const PENDING_TRIGGER *b)
+{
+if (a->msg.priority != b->msg.priority)
+	return a->msg.priority > b->msg.priority;
+
+return a->seq < b->seq;
+}
+
+/**********************************************************************
+FUNCTION:	void pushPending(const FIFO_MSG *)
+
+PURPOSE:	Add a trigger to the heap, which must have room for it.
+
+RETURNS:	nothing
+
+NOTE:		Called by takeTrigger(), gatherTriggers().
+***********************************************************************/
+
+void pushPending(const FIFO_MSG *msg)
+{
+// SIM_PENDING SimPending is global
+PENDING_TRIGGER *heap = SimPending.heap, entry;
+int i = SimPending.count++, parent = 0;
+
+entry.msg = *msg;
+entry.seq = SimPending.seq++;
+
+// sift up from the bottom
+while (i > 0)
+	{
+	parent = (i - 1) / 2;
+	if (!pendingBefore(&entry, &heap[parent]))
+		break;
+	heap[i] = heap[parent];
+	i = parent;
+	}
+heap[i] = entry;
+}
+
+/**********************************************************************
+FUNCTION:	void popPending(FIFO_MSG *)
+
+PURPOSE:	Take the trigger on top of the heap, which must not be empty.
+
+RETURNS:	nothing
+
+NOTE:		Called by takeTrigger().
+***********************************************************************/
+
+void popPending(FIFO_MSG *msg)
+{
+// SIM_PENDING SimPending is global
+PENDING_TRIGGER *heap = SimPending.heap, last;
+int i = 0, child = 0;
+
+*msg = heap[0].msg;
+last = heap[--SimPending.count];
+
+// sift the last one down from the top
+while ((child = 2 * i + 1) < SimPending.count)
+	{
+	if (child + 1 < SimPending.count && pendingBefore(&heap[child + 1], 
+																&heap[child]))
+		child++;
+	if (!pendingBefore(&heap[child], &last))
+		break;
+	heap[i] = heap[child];
+	i = child;
+	}
+heap[i] = last;
+}
+
+/**********************************************************************
+FUNCTION:	void inheritPriority(int)
+
+PURPOSE:	Have the calling thread run at the priority of the message it
+			has received, under SCHED_FIFO, or at its own priority again
+			for a priority of 0. Without the privilege to do so the 
+			receiver goes on taking messages in priority order alone.
+
+RETURNS:	nothing
+
+NOTE:		Called by takeTrigger(), closeSRY().
+***********************************************************************/
+
+void inheritPriority(int priority)
+{
+const char *fn = "inheritPriority";
+// SIM_INHERITED SimInherited is global
+// WHO_AM_I SimParms is global
+struct sched_param param;
+int rc = 0, lo = 0, hi = 0;
+
+if (priority == SimInherited.priority)
+	return;
+
+// the thread's own scheduling, to go back to
+if (SimInherited.priority == 0)
+	pthread_getschedparam(pthread_self(), &SimInherited.policy, 
+														&SimInherited.param);
+
+if (priority > 0)
+	{
+	lo = sched_get_priority_min(SCHED_FIFO);
+	hi = sched_get_priority_max(SCHED_FIFO);
+	param.sched_priority = (priority < lo) ? lo : (priority > hi) ? hi : priority;
+	rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+	}
+else
+	rc = pthread_setschedparam(pthread_self(), SimInherited.policy, 
+														&SimInherited.param);
+if (rc == 0)
+	{
+	SimInherited.priority = priority;
+	return;
+	}
+
+// most likely short of CAP_SYS_NICE
+sryLog("%s: Unable to take on priority %d-%s, priority order only.\n", fn, 
+													priority, strerror(rc));
+if (SimInherited.priority > 0)
+	pthread_setschedparam(pthread_self(), SimInherited.policy, 
+														&SimInherited.param);
+SimInherited.priority = 0;
+SimParms.receiveOrder = SIM_ORDER_PRIORITY;
+}
+
+/********************************************************************/
+/******************* COALESCED PROXY FUNCTIONS **********************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	int createProxyTable(void)
+
+PURPOSE:	Name, create and map the proxy table of a receiver coalescing
+			proxies. Senders map the same file in order to count their
+			proxies in it rather than queue each one on the receive fifo.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by openSRYopts().
+***********************************************************************/
+
+int createProxyTable()
+{
+const char *fn = "createProxyTable";
+char qname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+int fd = -1;
+void *p = NULL;
+// WHO_AM_I SimParms is global; partly populated in openSRY()
+// char *SimFifoPath is global; set in openSRY()
+
+// proxy table file lives alongside the fifos and mailbox
+sprintf(qname, "%s/Q_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+
+// a leftover from an earlier process of the same name and pid is of no use
+remove(qname);
+
+fd = open(qname, O_RDWR | O_CREAT | O_EXCL, 0666);
+if (fd == -1)
+	{
+	sryLog("%s: Unable to create proxy table %s-%s.\n", fn, qname, 
+															strerror(errno));
+	return -1;
+	}
+
+// masks the mode 0666 with user's umask; all of the slots start out free
+if (fchmod(fd, 0666) == -1 || ftruncate(fd, sizeof(SIM_PROXY_TABLE)) == -1)
+	{
+	sryLog("%s: Unable to size proxy table %s-%s.\n", fn, qname, 
+															strerror(errno));
+	close(fd);
+	remove(qname);
+	return -1;
+	}
+
+p = mmap(NULL, sizeof(SIM_PROXY_TABLE), PROT_READ | PROT_WRITE, MAP_SHARED, 
+																	fd, 0);
+close(fd);
+if (p == MAP_FAILED)
+	{
+	sryLog("%s: Unable to map proxy table %s-%s.\n", fn, qname, 
+															strerror(errno));
+	remove(qname);
+	return -1;
+	}
+
+SimParms.proxies = (SIM_PROXY_TABLE *)p;
+SimParms.proxies->pid = SimParms.pid;
+SimParms.proxies->armed = 0;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int detachProxyTable(void)
+
+PURPOSE:	Unmap the proxy table of this process.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by closeSRYchild(), deleteProxyTable().
+***********************************************************************/
+
+int detachProxyTable()
+{
+// WHO_AM_I SimParms is global
+
+if (SimParms.proxies == NULL)
+	return -1;
+
+munmap(SimParms.proxies, sizeof(SIM_PROXY_TABLE));
+SimParms.proxies = NULL;
+
+// any proxies taken from it and not yet received go with it
+SimProxyBurst.count = 0;
+SimProxyBurst.next = 0;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int deleteProxyTable(void)
+
+PURPOSE:	Unmap and remove the proxy table of this process.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by closeSRY().
+***********************************************************************/
+
+int deleteProxyTable()
+{
+char qname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
+
+if (detachProxyTable() == -1)
+	return -1;
+
+sprintf(qname, "%s/Q_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+remove(qname);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	SIM_PROXY_TABLE *attachProxyTable(const char *)
+
+PURPOSE:	Map the proxy table file of a receiver coalescing proxies.
+
+RETURNS:	success: pointer to the proxy table
+			failure or receiver queuing proxies: NULL
+
+NOTE:		Called by addLocatedReceiver().
+***********************************************************************/
+
+SIM_PROXY_TABLE *attachProxyTable(const char *qname)
+{
+int fd = -1;
+void *p = NULL;
+
+fd = open(qname, O_RDWR);
+if (fd == -1)
+	return NULL;
+
+p = mmap(NULL, sizeof(SIM_PROXY_TABLE), PROT_READ | PROT_WRITE, MAP_SHARED, 
+																	fd, 0);
+close(fd);
+
+return (p == MAP_FAILED) ? NULL : (SIM_PROXY_TABLE *)p;
+}
+
+/**********************************************************************
+FUNCTION:	int postProxy(int, int)
+
+PURPOSE:	Count a proxy in the proxy table of a receiver coalescing
+			proxies. The proxy's slot is found, or claimed, by probing on
+			from its hash. Only the first proxy counted since the receiver
+			last looked at the table writes a wakeup to the receive fifo,
+			so that a burst of proxies costs the receiver one fifo read.
+			Control proxies, from PROXY_CONTROL_MIN up, are never counted
+			and neither are proxies for which the table has no room. 
+			Should the wakeup not be written the count is taken back out.
+
+RETURNS:	counted: 1
+			to be queued on the receive fifo as always: 0
+			failure: -1
+
+NOTE:		Called by Trigger(), writeGroupTrigger().
+***********************************************************************/
+
+int postProxy(int fd, int proxy)
+{
+// int SimSendPriority is global
+LOCATED_RECEIVER *entry = findLocatedReceiver(fd);
+SIM_PROXY_TABLE *table = entry->proxies;
+PROXY_SLOT *slot = NULL;
+char fifoBuf[sizeof(FIFO_MSG)];
+FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+int seen = 0, count = 0;
+
+// a receiver queuing proxies, or a proxy that must not be merged with others
+if (table == NULL || proxy >= PROXY_CONTROL_MIN)
+	return 0;
+
+// a slot, once claimed, stays with its proxy for the life of the receiver
+for (unsigned i = 0; i < MAX_NUM_COALESCED_PROXIES; i++)
+	{
+	slot = &table->slot[((unsigned)proxy + i) % MAX_NUM_COALESCED_PROXIES];
+	seen = __atomic_load_n(&slot->proxy, __ATOMIC_ACQUIRE);
+	if (seen == 0)
+		__atomic_compare_exchange_n(&slot->proxy, &seen, proxy, false, 
+										__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	if (seen == 0 || seen == proxy)
+		break;
+	slot = NULL;
+	}
+
+// the table is taken up by other proxies
+if (slot == NULL)
+	return 0;
+
+__atomic_add_fetch(&slot->count, 1, __ATOMIC_SEQ_CST);
+
+// a wakeup is already on its way; the receiver takes this count along with it
+if (__atomic_exchange_n(&table->armed, 1, __ATOMIC_SEQ_CST))
+	return 1;
+
+fifoMsg->shmid = -PROXY_COALESCED;
+fifoMsg->pid = 0;
+fifoMsg->priority = SimSendPriority;
+
+if (writeTrigger(fd, fifoBuf) != sizeof(FIFO_MSG))
+	{
+	__atomic_store_n(&table->armed, 0, __ATOMIC_SEQ_CST);
+
+	// a failed Trigger() leaves no count behind, unless already taken
+	count = __atomic_load_n(&slot->count, __ATOMIC_ACQUIRE);
+	while (count > 0 && !__atomic_compare_exchange_n(&slot->count, &count, 
+					count - 1, false, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE))
+		;
+	return -1;
+	}
+
+return 1;
+}
+
+/**********************************************************************
+FUNCTION:	void drainProxyTable(void)
+
+PURPOSE:	Take the counts of all of the proxies waiting in this
+			receiver's proxy table, to be received one distinct proxy at
+			a time. The table is disarmed first, so that a proxy counted
+			after its slot has been read brings another wakeup.
+
+RETURNS:	nothing
+
+NOTE:		Called by Receive().
+***********************************************************************/
+
+void drainProxyTable()
+{
+// WHO_AM_I SimParms is global
+// SIM_PROXY_BURST SimProxyBurst is global
+SIM_PROXY_TABLE *table = SimParms.proxies;
+int proxy = 0, count = 0;
+
+SimProxyBurst.count = 0;
+SimProxyBurst.next = 0;
+
+__atomic_store_n(&table->armed, 0, __ATOMIC_SEQ_CST);
+
+// slots are claimed by probing, so free ones may lie between those in use
+for (int i = 0; i < MAX_NUM_COALESCED_PROXIES; i++)
+	{
+	proxy = __atomic_load_n(&table->slot[i].proxy, __ATOMIC_ACQUIRE);
+	if (proxy == 0)
+		continue;
+
+	count = __atomic_exchange_n(&table->slot[i].count, 0, __ATOMIC_SEQ_CST);
+	if (count > 0)
+		{
+		SimProxyBurst.slot[SimProxyBurst.count].proxy = proxy;
+		SimProxyBurst.slot[SimProxyBurst.count].count = count;
+		SimProxyBurst.count++;
+		}
+	}
+}
+
+/**********************************************************************
+FUNCTION:	bool takeProxyBurst(char *)
+
+PURPOSE:	Hand Receive() the next proxy taken from the proxy table, if
+			any, as a fifo message, noting its count for getProxyCount().
+
+RETURNS:	true if there was one, false if not
+
+NOTE:		Called by Receive().
+***********************************************************************/
+
+bool takeProxyBurst(char *fifoBuf)
+{
+// SIM_PROXY_BURST SimProxyBurst is global
+// int SimProxyCount is global
+PROXY_SLOT *slot = NULL;
+
+// a proxy off the fifo counts once
+SimProxyCount = 1;
+
+if (SimProxyBurst.next >= SimProxyBurst.count)
+	return false;
+
+slot = &SimProxyBurst.slot[SimProxyBurst.next++];
+((FIFO_MSG *)fifoBuf)->shmid = -slot->proxy;
+((FIFO_MSG *)fifoBuf)->pid = 0;
+((FIFO_MSG *)fifoBuf)->priority = 0;
+SimProxyCount = slot->count;
+
+return true;
+}
+
+/********************************************************************/
+/******************* RECEIVER GROUP FUNCTIONS ***********************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	SIM_GROUP_TABLE *attachGroupTable(const char *, bool)
+
+PURPOSE:	Map the member table of a receiver group, the G_ file named
+			for the group, creating the file if asked. The file outlives
+			its members, as does the name registry, so that a group keeps
+			its name between runs.
+
+RETURNS:	success: pointer to the group table
+			failure: NULL
+
+NOTE:		Called by joinGroup(), locateGroup().
+***********************************************************************/
+
+SIM_GROUP_TABLE *attachGroupTable(const char *group, bool create)
+{
+const char *fn = "attachGroupTable";
+char gname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 10];
+int fd = -1;
+void *p = NULL;
+// char *SimFifoPath is global; set in openSRY()
+
+if (strlen(group) == 0 || strlen(group) > MAX_SIM_NAME_LEN)
+	{
+	sryLog("%s: Bad group name <%s>.\n", fn, group);
+	return NULL;
+	}
+
+sprintf(gname, "%s/G_%s", SimFifoPath, group);
+
+fd = open(gname, create ? O_RDWR | O_CREAT : O_RDWR, 0666);
+if (fd == -1)
+	{
+	if (create)
+		sryLog("%s: Unable to open group %s-%s.\n", fn, gname, strerror(errno));
+	return NULL;
+	}
+
+/*
+masks the mode 0666 with user's umask; sizing a table already there leaves
+its members be, so that members starting together may all do so
+*/
+if (create && (fchmod(fd, 0666) == -1 || 
+							ftruncate(fd, sizeof(SIM_GROUP_TABLE)) == -1))
+	{
+	sryLog("%s: Unable to size group %s-%s.\n", fn, gname, strerror(errno));
+	close(fd);
+	return NULL;
+	}
+
+p = mmap(NULL, sizeof(SIM_GROUP_TABLE), PROT_READ | PROT_WRITE, MAP_SHARED, 
+																	fd, 0);
+close(fd);
+if (p == MAP_FAILED)
+	{
+	sryLog("%s: Unable to map group %s-%s.\n", fn, gname, strerror(errno));
+	return NULL;
+	}
+
+return (SIM_GROUP_TABLE *)p;
+}
+
+/**********************************************************************
+FUNCTION:	int joinGroup(const char *)
+
+PURPOSE:	Take a member slot in a receiver group's table, either a free
+			one or that of a member that died without leaving. The slot
+			is only marked ready once the member's name is filled in.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by openSRYopts().
+***********************************************************************/
+
+int joinGroup(const char *group)
+{
+const char *fn = "joinGroup";
+SIM_GROUP_TABLE *table = NULL;
+GROUP_MEMBER *member = NULL;
+pid_t pid = 0;
+// WHO_AM_I SimParms is global
+
+table = attachGroupTable(group, true);
+if (table == NULL)
+	return -1;
+
+for (int i = 0; i < MAX_NUM_GROUP_MEMBERS; i++)
+	{
+	pid = __atomic_load_n(&table->member[i].pid, __ATOMIC_ACQUIRE);
+
+	// a member that is no longer running gives up its slot
+	if (pid != 0)
+		{
+		errno = 0;
+		if (getpriority(PRIO_PROCESS, pid) != -1 || errno != ESRCH)
+			continue;
+		}
+
+	if (__atomic_compare_exchange_n(&table->member[i].pid, &pid, 
+				SimParms.pid, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		{
+		member = &table->member[i];
+		SimParms.groupSlot = i;
+		break;
+		}
+	}
+
+if (member == NULL)
+	{
+	sryLog("%s: Group %s is full.\n", fn, group);
+	munmap(table, sizeof(SIM_GROUP_TABLE));
+	return -1;
+	}
+
+// senders holding the last member's fd know to locate this one afresh
+__atomic_store_n(&member->ready, 0, __ATOMIC_RELEASE);
+strcpy(member->name, SimParms.whom);
+__atomic_store_n(&member->outstanding, 0, __ATOMIC_RELAXED);
+__atomic_add_fetch(&member->generation, 1, __ATOMIC_ACQ_REL);
+__atomic_store_n(&member->ready, 1, __ATOMIC_RELEASE);
+
+SimParms.group = table;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	void leaveGroup(void)
+
+PURPOSE:	Give up this receiver's slot in its group so that senders no
+			longer pick it, and unmap the group table.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY().
+***********************************************************************/
+
+void leaveGroup()
+{
+// WHO_AM_I SimParms is global
+GROUP_MEMBER *member = NULL;
+pid_t pid = SimParms.pid;
+
+if (SimParms.group == NULL)
+	return;
+
+member = &SimParms.group->member[SimParms.groupSlot];
+__atomic_store_n(&member->ready, 0, __ATOMIC_RELEASE);
+__atomic_store_n(&member->outstanding, 0, __ATOMIC_RELAXED);
+
+// a sender may already have given the slot up on our behalf
+__atomic_compare_exchange_n(&member->pid, &pid, 0, false, __ATOMIC_ACQ_REL, 
+															__ATOMIC_ACQUIRE);
+
+detachGroup();
+}
+
+/**********************************************************************
+FUNCTION:	void detachGroup(void)
+
+PURPOSE:	Unmap the table of the group this receiver belongs to, the
+			slot staying as it is.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRYchild(), leaveGroup().
+***********************************************************************/
+
+void detachGroup()
+{
+// WHO_AM_I SimParms is global
+
+if (SimParms.group == NULL)
+	return;
+
+munmap(SimParms.group, sizeof(SIM_GROUP_TABLE));
+SimParms.group = NULL;
+SimParms.groupSlot = -1;
+}
+
+/**********************************************************************
+FUNCTION:	int locateGroup(const char *)
+
+PURPOSE:	Locate a receiver group for Send() and the rest to spread
+			their messages over its members. The group must have at least
+			one member ready at the time.
+
+RETURNS:	success: group id >= SIM_GROUP_ID
+			failure: -1
+
+NOTE:		Called by Locate().
+***********************************************************************/
+
+int locateGroup(const char *group)
+{
+const char *fn = "locateGroup";
+SIM_GROUP *g = NULL;
+int ready = 0;
+// SIM_GROUP SimGroup[] is global
+
+// a group located earlier keeps its id and its members' fds
+for (int i = 0; i < MAX_NUM_GROUPS; i++)
+	{
+	if (SimGroup[i].table != NULL && !strcmp(SimGroup[i].name, group))
+		{
+		g = &SimGroup[i];
+		break;
+		}
+	if (g == NULL && SimGroup[i].table == NULL)
+		g = &SimGroup[i];
+	}
+
+if (g == NULL)
+	{
+	sryLog("%s: Too many groups located.\n", fn);
+	return -1;
+	}
+
+if (g->table == NULL)
+	{
+	g->table = attachGroupTable(group, false);
+	if (g->table == NULL)
+		{
+		sryLog("%s: No such group %s.\n", fn, group);
+		return -1;
+		}
+	sprintf(g->name, "%s", group);
+	for (int i = 0; i < MAX_NUM_GROUP_MEMBERS; i++)
+		{
+		g->fd[i] = -1;
+		g->generation[i] = 0;
+		}
+	}
+
+for (int i = 0; i < MAX_NUM_GROUP_MEMBERS; i++)
+	ready += __atomic_load_n(&g->table->member[i].ready, __ATOMIC_ACQUIRE);
+
+if (ready == 0)
+	{
+	sryLog("%s: Group %s has no members.\n", fn, group);
+	return -1;
+	}
+
+return SIM_GROUP_ID + (g - SimGroup);
+}
+
+/**********************************************************************
+FUNCTION:	int pickGroupMember(SIM_GROUP *, int)
+
+PURPOSE:	Choose the group member for the next message. A SendKeyed()
+			key always picks the same member for as long as the members
+			stay the same. Otherwise it is round robin, or the member with
+			the fewest messages outstanding, ties going round robin.
+
+RETURNS:	success: member slot
+			no members ready: -1
+
+NOTE:		Called by writeGroupTrigger().
+***********************************************************************/
+
+int pickGroupMember(SIM_GROUP *g, int policy)
+{
+// long SimSendKey is global
+SIM_GROUP_TABLE *table = g->table;
+int ready[MAX_NUM_GROUP_MEMBERS];
+int n = 0, best = -1, least = 0, load = 0;
+unsigned turn = 0;
+
+// the members ready, in slot order
+for (int i = 0; i < MAX_NUM_GROUP_MEMBERS; i++)
+	if (__atomic_load_n(&table->member[i].ready, __ATOMIC_ACQUIRE))
+		ready[n++] = i;
+
+if (n == 0)
+	return -1;
+
+if (SimSendKey >= 0)
+	return ready[SimSendKey % n];
+
+// the turn moves on each time, across all of the senders
+turn = __atomic_fetch_add(&table->next, 1, __ATOMIC_RELAXED);
+
+if (policy == SIM_GROUP_ROUND_ROBIN)
+	return ready[turn % n];
+
+for (int i = 0; i < n; i++)
+	{
+	int slot = ready[(turn + i) % n];
+
+	load = __atomic_load_n(&table->member[slot].outstanding, __ATOMIC_RELAXED);
+	if (best == -1 || load < least)
+		{
+		best = slot;
+		least = load;
+		}
+	}
+
+return best;
+}
+
+/**********************************************************************
+FUNCTION:	int groupMemberFd(SIM_GROUP *, int)
+
+PURPOSE:	Return the receive fifo fd of a group member, locating the
+			member when it is first picked or its slot has been taken by
+			another receiver since.
+
+RETURNS:	success: fd
+			failure: -1
+
+NOTE:		Called by writeGroupTrigger().
+***********************************************************************/
+
+int groupMemberFd(SIM_GROUP *g, int slot)
+{
+GROUP_MEMBER *member = &g->table->member[slot];
+char name[MAX_SIM_NAME_LEN + 1];
+unsigned generation = 0;
+
+generation = __atomic_load_n(&member->generation, __ATOMIC_ACQUIRE);
+if (g->fd[slot] != -1 && g->generation[slot] == generation)
+	return g->fd[slot];
+
+// the receiver this fd was for has left the group
+if (g->fd[slot] != -1)
+	{
+	close(g->fd[slot]);
+	g->fd[slot] = -1;
+	}
+
+snprintf(name, sizeof name, "%s", member->name);
+g->fd[slot] = Locate("", name, 0, SIM_LOCAL);
+g->generation[slot] = generation;
+
+return g->fd[slot];
+}
+
+/**********************************************************************
+FUNCTION:	void dropGroupMember(SIM_GROUP *, int)
+
+PURPOSE:	Give up on a group member that could not be sent to. One that
+			is no longer running is taken out of the group for all of the
+			senders.
+
+RETURNS:	nothing
+
+NOTE:		Called by writeGroupTrigger().
+***********************************************************************/
+
+void dropGroupMember(SIM_GROUP *g, int slot)
+{
+GROUP_MEMBER *member = &g->table->member[slot];
+pid_t pid = __atomic_load_n(&member->pid, __ATOMIC_ACQUIRE);
+
+if (pid != 0 && chkStatus(pid, member->name) == false)
+	{
+	__atomic_store_n(&member->ready, 0, __ATOMIC_RELEASE);
+	__atomic_compare_exchange_n(&member->pid, &pid, 0, false, 
+										__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	}
+
+if (g->fd[slot] != -1)
+	{
+	close(g->fd[slot]);
+	g->fd[slot] = -1;
+	}
+}
+
+/**********************************************************************
+FUNCTION:	int writeGroupTrigger(int, char *, FCMSG_REC *, int)
+
+PURPOSE:	Deliver a fifo message (message trigger or proxy) to one of
+			the members of a receiver group. A message is counted as
+			outstanding at the member, and noted in the sender's shmem
+			against the member so that its Reply() takes the count off
+			again. A member that cannot be written to is passed over for
+			the next one.
+
+RETURNS:	success: sizeof FIFO_MSG
+			failure: -1
+
+NOTE:		Called by sendTrigger(), Trigger().
+***********************************************************************/
+
+int writeGroupTrigger(int id, char *fifoBuf, FCMSG_REC *msgPtr, int policy)
+{
+const char *fn = "writeGroupTrigger";
+SIM_GROUP *g = NULL;
+GROUP_MEMBER *member = NULL;
+int slot = -1, fd = -1, rc = -1;
+// SIM_GROUP SimGroup[] is global
+
+if (id - SIM_GROUP_ID >= MAX_NUM_GROUPS || 
+									SimGroup[id - SIM_GROUP_ID].table == NULL)
+	{
+	sryLog("%s: SIM group id is out of range.\n", fn);
+	errno = EBADF;
+	return -1;
+	}
+g = &SimGroup[id - SIM_GROUP_ID];
+
+for (int tries = 0; tries < MAX_NUM_GROUP_MEMBERS; tries++)
+	{
+	slot = pickGroupMember(g, policy);
+	if (slot == -1)
+		break;
+	member = &g->table->member[slot];
+
+	fd = groupMemberFd(g, slot);
+	if (fd == -1)
+		{
+		dropGroupMember(g, slot);
+		continue;
+		}
+
+	// a proxy is not replied to and so is never outstanding
+	if (msgPtr == NULL)
+		{
+		rc = postProxy(fd, -((FIFO_MSG *)fifoBuf)->shmid);
+		if (rc == 0)
+			rc = (writeTrigger(fd, fifoBuf) == sizeof(FIFO_MSG)) ? 1 : -1;
+		if (rc == 1)
+			return sizeof(FIFO_MSG);
+		dropGroupMember(g, slot);
+		continue;
+		}
+
+	msgPtr->groupPid = __atomic_load_n(&member->pid, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&member->outstanding, 1, __ATOMIC_RELAXED);
+
+	if (writeTrigger(fd, fifoBuf) == sizeof(FIFO_MSG))
+		return sizeof(FIFO_MSG);
+
+	__atomic_sub_fetch(&member->outstanding, 1, __ATOMIC_RELAXED);
+	msgPtr->groupPid = 0;
+	dropGroupMember(g, slot);
+	}
+
+sryLog("%s: No member of group %s to send to.\n", fn, g->name);
+errno = EPIPE;
+return -1;
+}
+
+/**********************************************************************
+FUNCTION:	int sendTrigger(int, char *, FCMSG_REC *, int)
+
+PURPOSE:	Deliver the fifo message for a message in shmem either to a
+			receiver or to a member of a receiver group.
+
+RETURNS:	success: sizeof FIFO_MSG
+			failure: -1
+
+NOTE:		Called by Send(), PostMessage(), Relay().
+***********************************************************************/
+
+int sendTrigger(int fd, char *fifoBuf, FCMSG_REC *msgPtr, int policy)
+{
+if (fd >= SIM_GROUP_ID)
+	return writeGroupTrigger(fd, fifoBuf, msgPtr, policy);
+
+msgPtr->groupPid = 0;
+
+return writeTrigger(fd, fifoBuf);
+}
+
+/**********************************************************************
+FUNCTION:	void uncountGroupMsg(FCMSG_REC *)
+
+PURPOSE:	Take a message that was sent to this receiver as a member of
+			its group off the member's outstanding count, once it is
+			replied to, relayed on or found abandoned.
+
+RETURNS:	nothing
+
+NOTE:		Called by Receive(), Reply(), ReplyError(), Relay().
+***********************************************************************/
+
+void uncountGroupMsg(FCMSG_REC *msgPtr)
+{
+// WHO_AM_I SimParms is global
+
+if (SimParms.group == NULL || msgPtr->groupPid != SimParms.pid)
+	return;
+
+msgPtr->groupPid = 0;
+__atomic_sub_fetch(&SimParms.group->member[SimParms.groupSlot].outstanding, 
+														1, __ATOMIC_RELAXED);
+}
+
+/**********************************************************************
+FUNCTION:	void releaseAllGroups(void)
+
+PURPOSE:	Close the members' fds and unmap the tables of all located
+			receiver groups and clear the table.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild().
+***********************************************************************/
+
+void releaseAllGroups()
+{
+// SIM_GROUP SimGroup[] is global
+
+for (int i = 0; i < MAX_NUM_GROUPS; i++)
+	{
+	if (SimGroup[i].table == NULL)
+		continue;
+
+	for (int j = 0; j < MAX_NUM_GROUP_MEMBERS; j++)
+		if (SimGroup[i].fd[j] != -1)
+			close(SimGroup[i].fd[j]);
+
+	munmap(SimGroup[i].table, sizeof(SIM_GROUP_TABLE));
+	SimGroup[i].table = NULL;
+	}
+}
+
+/********************************************************************/
+/************************** LOG FUNCTIONS ***************************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	void initLog(void)
+
+PURPOSE:	Set up sryLog() once for the process: read SIM_LOG_LEVEL 
+			(error/warn/info/debug), SIM_LOG_RATE (lines a second of a 
+			format, 0 for no limit) and SIM_LOG_SIZE (bytes of LogFile 
+			before rotation), ready the ring, and see to it that lines 
+			still on the ring are written out on exit.
+
+RETURNS:	nothing
+
+NOTE:		Called by way of pthread_once() by putLog(), sryLogFlush().
+***********************************************************************/
+
+void initLog()
+{
+// SIM_LOG SimLog is global
+// SIM_LOG_RING SimLogRing is global
+const char *levels[] = {"error", "warn", "info", "debug"};
+char *p = NULL;
+
+p = getenv("SIM_LOG_LEVEL");
+if (p != NULL)
+	{
+	for (int i = SIM_LOG_ERROR; i <= SIM_LOG_DEBUG; i++)
+		if (!strcmp(p, levels[i]))
+			SimLog.level = i;
+	}
+
+p = getenv("SIM_LOG_RATE");
+if (p != NULL && atoi(p) >= 0)
+	SimLog.rate = atoi(p);
+
+p = getenv("SIM_LOG_SIZE");
+if (p != NULL && atol(p) > 0)
+	SimLog.maxSize = atol(p);
+
+// each record is good for the first time round the ring
+for (unsigned long i = 0; i < MAX_NUM_LOG_RECORDS; i++)
+	SimLogRing.rec[i].seq = i;
+
+atexit(drainLogAtExit);
+pthread_atfork(NULL, NULL, forkedLog);
+}
+
+/**********************************************************************
+FUNCTION:	int putLog(int, const char *, va_list)
+
+PURPOSE:	Put a sryLog() line on the log ring. A position is claimed by
+			a compare and swap of the ring head, the line formatted into 
+			its record and the record then marked ready for the flusher,
+			so that threads never wait on each other. A full ring drops 
+			the line, counting it, rather than hold up the caller.
+
+RETURNS:	success (or filtered out): 0
+			failure: -1
+
+NOTE:		Called by sryLog(), sryLogLevel().
+***********************************************************************/
+
+int putLog(int level, const char *format, va_list args)
+{
+// SIM_LOG SimLog is global
+// SIM_LOG_RING SimLogRing is global
+// bool PrintSimError is global
+LOG_RECORD *rec = NULL;
+unsigned long pos = 0, seq = 0;
+int suppressed = 0, len = 0;
+char tstr[50];
+struct tm tm;
+
+pthread_once(&SimLogOnce, initLog);
+
+if (level > SimLog.level)
+	return 0;
+
+// too many of the same format this second
+suppressed = rateLog(format);
+if (suppressed == -1)
+	return 0;
+
+// the flusher is started by the first line, and again in a forked child
+if (!__atomic_load_n(&SimLog.started, __ATOMIC_ACQUIRE))
+	startLogFlusher();
+
+pos = __atomic_load_n(&SimLogRing.head, __ATOMIC_RELAXED);
+while (true)
+	{
+	rec = &SimLogRing.rec[pos & (MAX_NUM_LOG_RECORDS - 1)];
+	seq = __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE);
+
+	// not yet written out since last time round the ring
+	if (seq < pos)
+		{
+		__atomic_add_fetch(&SimLogRing.dropped, 1, __ATOMIC_RELAXED);
+		return -1;
+		}
+
+	if (seq == pos && __atomic_compare_exchange_n(&SimLogRing.head, &pos, 
+						pos + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		break;
+
+	// another thread took the position; pos now holds the next one
+	if (seq > pos)
+		pos = __atomic_load_n(&SimLogRing.head, __ATOMIC_RELAXED);
+	}
+
+rec->tod = time(NULL);
+rec->level = level;
+if (suppressed)
+	len = snprintf(rec->text, sizeof rec->text, "(%d like this suppressed) ", 
+																suppressed);
+vsnprintf(rec->text + len, sizeof rec->text - len, format, args);
+
+// print to screen?
+if (PrintSimError)
+	{
+	strftime(tstr, sizeof tstr, "%D %T", gmtime_r(&rec->tod, &tm));
+	printf("%s *** %s\n", tstr, rec->text);
+	}
+
+__atomic_store_n(&rec->seq, pos + 1, __ATOMIC_RELEASE);
+
+// wake the flusher if it has gone to sleep
+if (__atomic_load_n(&SimLog.idle, __ATOMIC_SEQ_CST) && 
+						__atomic_exchange_n(&SimLog.idle, 0, __ATOMIC_SEQ_CST))
+	syscall(SYS_futex, &SimLog.idle, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int rateLog(const char *)
+
+PURPOSE:	Count a line of a sryLog() format against SIM_LOG_RATE lines
+			a second. The format string's address stands for the call 
+			site, so that nothing need be formatted to tell repeats.
+
+RETURNS:	to be logged: number of lines suppressed since the last one 
+			logged
+			to be suppressed: -1
+***********************************************************************/
+
+int rateLog(const char *format)
+{
+// SIM_LOG SimLog is global
+// LOG_RATE SimLogRate[] is global
+const char *seen = NULL;
+LOG_RATE *entry = NULL;
+time_t now = 0, second = 0;
+unsigned home = 0;
+
+if (SimLog.rate == 0)
+	return 0;
+
+// find or claim the format's entry by probing from its address
+home = hashSender(format, MAX_NUM_LOG_FORMATS);
+for (unsigned i = 0; i < MAX_NUM_LOG_FORMATS; i++)
+	{
+	entry = &SimLogRate[(home + i) & (MAX_NUM_LOG_FORMATS - 1)];
+	seen = __atomic_load_n(&entry->format, __ATOMIC_ACQUIRE);
+	if (seen == NULL)
+		__atomic_compare_exchange_n(&entry->format, &seen, format, false, 
+										__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	if (seen == NULL || seen == format)
+		break;
+	entry = NULL;
+	}
+
+// too many formats to keep track of; these go unlimited
+if (entry == NULL)
+	return 0;
+
+// the first line of a new second starts the count again
+now = time(NULL);
+second = __atomic_load_n(&entry->second, __ATOMIC_RELAXED);
+if (second != now && __atomic_compare_exchange_n(&entry->second, &second, 
+					now, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+	__atomic_store_n(&entry->count, 0, __ATOMIC_RELAXED);
+
+if (__atomic_add_fetch(&entry->count, 1, __ATOMIC_RELAXED) > SimLog.rate)
+	{
+	__atomic_add_fetch(&entry->suppressed, 1, __ATOMIC_RELAXED);
+	return -1;
+	}
+
+return __atomic_exchange_n(&entry->suppressed, 0, __ATOMIC_RELAXED);
+}
+
+/**********************************************************************
+FUNCTION:	int startLogFlusher(void)
+
+PURPOSE:	Start the log flusher thread, with all signals blocked so that
+			they go to the program's own threads.
+
+RETURNS:	success: 0
+			failure, the lines being written out by sryLogFlush() and on
+			exit only: -1
+
+NOTE:		Called by putLog().
+***********************************************************************/
+
+int startLogFlusher()
+{
+// SIM_LOG SimLog is global
+pthread_t tid;
+pthread_attr_t attr;
+sigset_t all, old;
+int rc = 0;
+
+if (__atomic_exchange_n(&SimLog.started, 1, __ATOMIC_ACQ_REL))
+	return 0;
+
+sigfillset(&all);
+pthread_sigmask(SIG_SETMASK, &all, &old);
+pthread_attr_init(&attr);
+pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+rc = pthread_create(&tid, &attr, logFlusher, NULL);
+pthread_attr_destroy(&attr);
+pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+return (rc == 0) ? 0 : -1;
+}
+
+/**********************************************************************
+FUNCTION:	void *logFlusher(void *)
+
+PURPOSE:	The log flusher thread. Writes out the lines on the log ring
+			as they come and sleeps on a futex when there are none, to 
+			be woken by the next line put.
+
+RETURNS:	never returns
+
+NOTE:		Started by startLogFlusher().
+***********************************************************************/
+
+void *logFlusher(void *)
+{
+// SIM_LOG SimLog is global
+// SIM_LOG_RING SimLogRing is global
+struct timespec second = {1, 0};
+
+while (true)
+	{
+	drainLog();
+
+	/*
+	Go idle before looking at the ring again, so that a line put meanwhile
+	either is seen here or wakes the futex.
+	*/
+	__atomic_store_n(&SimLog.idle, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&SimLogRing.head, __ATOMIC_SEQ_CST) != 
+							__atomic_load_n(&SimLogRing.tail, __ATOMIC_SEQ_CST))
+		{
+		__atomic_store_n(&SimLog.idle, 0, __ATOMIC_SEQ_CST);
+		sched_yield();
+		continue;
+		}
+
+	syscall(SYS_futex, &SimLog.idle, FUTEX_WAIT_PRIVATE, 1, &second, NULL, 0);
+	}
+
+return NULL;
+}
+
+/**********************************************************************
+FUNCTION:	int drainLog(void)
+
+PURPOSE:	Take the lines ready on the log ring and write them to 
+			LogFile in one go, along with a count of any lines dropped. 
+			LogFile is kept open, for drainLogOnSignal() to write to, 
+			and is rotated to LogFile.1 once it would grow past 
+			SIM_LOG_SIZE.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by logFlusher(), sryLogFlush(), drainLogAtExit().
+***********************************************************************/
+
+int drainLog()
+{
+// SIM_LOG SimLog is global
+// SIM_LOG_RING SimLogRing is global
+const char *levels[] = {"", "warn: ", "info: ", "debug: "};
+static char buf[MAX_NUM_LOG_RECORDS * (MAX_LOG_LINE_LEN + 40) + 100];
+char oldFile[PATH_MAX], tstr[50];
+LOG_RECORD *rec = NULL;
+unsigned long pos = 0, dropped = 0;
+size_t len = 0;
+struct stat s;
+struct tm tm;
+int rc = 0;
+
+// buf, the ring's tail and SimLog.fd are the one drainer's at a time
+pthread_mutex_lock(&SimLogLock);
+
+for (pos = SimLogRing.tail; ; pos++)
+	{
+	rec = &SimLogRing.rec[pos & (MAX_NUM_LOG_RECORDS - 1)];
+	if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != pos + 1)
+		break;
+
+	strftime(tstr, sizeof tstr, "%D %T", gmtime_r(&rec->tod, &tm));
+	len += sprintf(buf + len, "%s *** %s%s", tstr, 
+				levels[(rec->level > 0 && rec->level <= SIM_LOG_DEBUG) ? 
+													rec->level : 0], rec->text);
+
+	// free for the next time round the ring
+	__atomic_store_n(&rec->seq, pos + MAX_NUM_LOG_RECORDS, __ATOMIC_RELEASE);
+	}
+__atomic_store_n(&SimLogRing.tail, pos, __ATOMIC_SEQ_CST);
+
+dropped = __atomic_exchange_n(&SimLogRing.dropped, 0, __ATOMIC_RELAXED);
+if (dropped)
+	len += sprintf(buf + len, "sryLog: %lu lines dropped, log ring full\n", 
+																	dropped);
+
+if (len == 0)
+	{
+	pthread_mutex_unlock(&SimLogLock);
+	return 0;
+	}
+
+if (SimLog.fd == -1)
+	SimLog.fd = open(LogFile, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+if (SimLog.fd != -1 && fstat(SimLog.fd, &s) == 0 && s.st_size > 0 && 
+									s.st_size + (long)len > SimLog.maxSize)
+	{
+	// keep the one file of older lines
+	close(SimLog.fd);
+	snprintf(oldFile, sizeof oldFile, "%s.1", LogFile);
+	rename(LogFile, oldFile);
+	SimLog.fd = open(LogFile, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+	}
+
+if (SimLog.fd == -1 || write(SimLog.fd, buf, len) == -1)
+	rc = -1;
+
+pthread_mutex_unlock(&SimLogLock);
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	void drainLogAtExit(void)
+
+PURPOSE:	Write out the lines still on the log ring as the process 
+			exits.
+
+RETURNS:	nothing
+
+NOTE:		Registered with atexit() by initLog().
+***********************************************************************/
+
+void drainLogAtExit()
+{
+drainLog();
+}
+
+/**********************************************************************
+FUNCTION:	void drainLogOnSignal(void)
+
+PURPOSE:	Write out the lines still on the log ring from a signal 
+			handler. Only write(2) is used, to the LogFile drainLog() 
+			keeps open, and the lines go without their timestamps, as 
+			strftime() and sprintf() are not async-signal-safe. Should
+			the signal have come to a thread draining the ring, the 
+			lines are left rather than the process deadlock on 
+			SimLogLock.
+
+RETURNS:	nothing
+
+NOTE:		Called by hndlSignals().
+***********************************************************************/
+
+void drainLogOnSignal()
+{
+// SIM_LOG SimLog is global
+// SIM_LOG_RING SimLogRing is global
+const char *levels[] = {"", "warn: ", "info: ", "debug: "};
+const char *level = NULL;
+LOG_RECORD *rec = NULL;
+unsigned long pos = 0;
+
+if (pthread_mutex_trylock(&SimLogLock) != 0)
+	return;
+
+// open() is async-signal-safe, should nothing have been drained yet
+if (SimLog.fd == -1)
+	SimLog.fd = open(LogFile, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+if (SimLog.fd == -1)
+	{
+	pthread_mutex_unlock(&SimLogLock);
+	return;
+	}
+
+for (pos = SimLogRing.tail; ; pos++)
+	{
+	rec = &SimLogRing.rec[pos & (MAX_NUM_LOG_RECORDS - 1)];
+	if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != pos + 1)
+		break;
+
+	level = levels[(rec->level > 0 && rec->level <= SIM_LOG_DEBUG) ? 
+																rec->level : 0];
+	if (write(SimLog.fd, "*** ", 4) == -1 || 
+			write(SimLog.fd, level, strlen(level)) == -1 ||
+			write(SimLog.fd, rec->text, strnlen(rec->text, 
+											sizeof rec->text)) == -1)
+		break;
+
+	__atomic_store_n(&rec->seq, pos + MAX_NUM_LOG_RECORDS, __ATOMIC_RELEASE);
+	}
+__atomic_store_n(&SimLogRing.tail, pos, __ATOMIC_SEQ_CST);
+
+pthread_mutex_unlock(&SimLogLock);
+}
+
+/**********************************************************************
+FUNCTION:	void forkedLog(void)
+
+PURPOSE:	Ready sryLog() in a forked child. The parent's flusher thread
+			is not carried over and its lines on the ring are its own to
+			write out, so the ring is emptied and the child starts its
+			own flusher with its first line.
+
+RETURNS:	nothing
+
+NOTE:		Registered with pthread_atfork() by initLog().
+***********************************************************************/
+
+void forkedLog()
+{
+// SIM_LOG SimLog is global
+// SIM_LOG_RING SimLogRing is global
+
+pthread_mutex_init(&SimLogLock, NULL);
+
+SimLogRing.head = 0;
+SimLogRing.tail = 0;
+SimLogRing.dropped = 0;
+for (unsigned long i = 0; i < MAX_NUM_LOG_RECORDS; i++)
+	SimLogRing.rec[i].seq = i;
+
+SimLog.started = 0;
+SimLog.idle = 0;
+}
+
+/********************************************************************/
+/********************* NAME REGISTRY FUNCTIONS **********************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	int setFifoPath(void)
+
+PURPOSE:	Set the global SimFifoPath from SIM_FIFO_PATH, or to the
+			default if SIM_FIFO_PATH is not defined, and check it.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int setFifoPath(void)
+{
+const char *fn = "setFifoPath";
+char *p = NULL;
+// char *SimFifoPath is global
+
+/*
+set the global SimFifoPath
+set to Default_Fifo_Path if SIM_FIFO_PATH not defined
+*/
+p = getenv("SIM_FIFO_PATH");
+if (p == NULL)
+	strcpy(SimFifoPath, DefaultFifoPath);
+else
+	{
+	if (strlen(p) > MAX_FIFO_PATH_LEN)
+		{
+		sryLog("%s: exported SIM fifo path name too long.\n", fn);
+		return -1;
+		}
+	sprintf(SimFifoPath, "%s", p);
+	}
+
+// check for access to fifo path
+if (access(SimFifoPath, F_OK) == -1)
+	{
+	sryLog("%s: No SIM fifo path defined.\n", fn);
+	return -1;
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int openRegistry(void)
+
+PURPOSE:	Map the name registry file under the fifo path, creating it if
+			this is the first SIM process to run there.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int openRegistry(void)
+{
+const char *fn = "openRegistry";
+char rname[MAX_FIFO_PATH_LEN + 20];
+struct stat st;
+void *ptr = NULL;
+int fd = -1;
+// char *SimFifoPath is global
+// SIM_REGISTRY *SimRegistry is global
+
+// already mapped
+if (SimRegistry != NULL)
+	return 0;
+
+sprintf(rname, "%s/%s", SimFifoPath, RegistryName);
+fd = open(rname, O_RDWR | O_CREAT, 0666);
+if (fd == -1)
+	{
+	sryLog("%s: Unable to open registry %s-%s.\n", fn, rname, strerror(errno));
+	return -1;
+	}
+
+// masks the mode 0666 with user's umask; only the creator is able to
+fchmod(fd, 0666);
+
+/*
+All zeroes is an empty and unlocked registry, so whichever process gets here
+first merely sizes the file.
+*/
+if (fstat(fd, &st) == -1 || (st.st_size < (off_t)sizeof(SIM_REGISTRY) &&
+						ftruncate(fd, sizeof(SIM_REGISTRY)) == -1))
+	{
+	sryLog("%s: Unable to size registry %s-%s.\n", fn, rname, strerror(errno));
+	close(fd);
+	return -1;
+	}
+
+ptr = mmap(NULL, sizeof(SIM_REGISTRY), PROT_READ | PROT_WRITE, MAP_SHARED, 
+																	fd, 0);
+close(fd);
+if (ptr == MAP_FAILED)
+	{
+	sryLog("%s: Unable to map registry %s-%s.\n", fn, rname, strerror(errno));
+	return -1;
+	}
+
+SimRegistry = (SIM_REGISTRY *)ptr;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	void closeRegistry(void)
+
+PURPOSE:	Unmap the name registry.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY().
+***********************************************************************/
+
+void closeRegistry(void)
+{
+// SIM_REGISTRY *SimRegistry is global
+
+if (SimRegistry != NULL)
+	{
+	munmap((void *)SimRegistry, sizeof(SIM_REGISTRY));
+	SimRegistry = NULL;
+	}
+}
+
+/**********************************************************************
+FUNCTION:	void lockRegistry(void)
+
+PURPOSE:	Take the registry lock. A lock left held by a thread that has
+			since died is taken over.
+
+RETURNS:	nothing
+***********************************************************************/
+
+void lockRegistry(void)
+{
+// SIM_REGISTRY *SimRegistry is global
+pid_t tid = (pid_t)syscall(SYS_gettid);
+pid_t owner = 0;
+
+while (!__atomic_compare_exchange_n(&SimRegistry->lock, &owner, tid, false, 
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+	// interrupted by a signal while holding the lock, on the way out
+	if (owner == tid)
+		return;
+
+	// the holder is gone; try again expecting its thread id
+	errno = 0;
+	if ((getpriority(PRIO_PROCESS, owner) == -1) && (errno == ESRCH))
+		continue;
+
+	// the registry is only ever held briefly
+	sched_yield();
+	owner = 0;
+	}
+}
+
+/**********************************************************************
+FUNCTION:	void unlockRegistry(void)
+
+PURPOSE:	Release the registry lock.
+
+RETURNS:	nothing
+***********************************************************************/
+
+void unlockRegistry(void)
+{
+// SIM_REGISTRY *SimRegistry is global
+
+__atomic_store_n(&SimRegistry->lock, 0, __ATOMIC_RELEASE);
+}
+
+/**********************************************************************
+FUNCTION:	unsigned hashName(const char *)
+
+PURPOSE:	Hash a SIM name (FNV-1a) to its home slot in the registry.
+
+RETURNS:	slot index
+***********************************************************************/
+
+unsigned hashName(const char *name)
+{
+unsigned hash = 2166136261u;
+
+for (; *name; name++)
+	{
+	hash ^= (unsigned char)*name;
+	hash *= 16777619u;
+	}
+
+return hash & (MAX_NUM_REGISTRY_ENTRIES - 1);
+}
+
+/**********************************************************************
+FUNCTION:	int findRegistryEntry(const char *)
+
+PURPOSE:	Look for a registered SIM name. The registry must be locked.
+
+RETURNS:	success: index of the entry
+			failure: -1
+***********************************************************************/
+
+int findRegistryEntry(const char *name)
+{
+// SIM_REGISTRY *SimRegistry is global
+REGISTRY_ENTRY *entry = NULL;
+unsigned i, slot, home = hashName(name);
+
+for (i = 0; i < MAX_NUM_REGISTRY_ENTRIES; i++)
+	{
+	slot = (home + i) & (MAX_NUM_REGISTRY_ENTRIES - 1);
+	entry = &SimRegistry->entry[slot];
+
+	// the name was never registered past here
+	if (entry->state == REG_EMPTY)
+		break;
+
+	if (entry->state == REG_USED && !strcmp(entry->name, name))
+		return slot;
+	}
+
+return -1;
+}
+
+/**********************************************************************
+FUNCTION:	int registerName(const char *, pid_t)
+
+PURPOSE:	Register a SIM name as belonging to pid, replacing any earlier
+			registration of the name.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by createFifos().
+***********************************************************************/
+
+int registerName(const char *name, pid_t pid)
+{
+const char *fn = "registerName";
+// SIM_REGISTRY *SimRegistry is global
+REGISTRY_ENTRY *entry = NULL;
+unsigned i, slot, home = hashName(name);
+int found = -1, overflow = 0;
+
+if (SimRegistry == NULL)
+	return -1;
+
+lockRegistry();
+
+for (i = 0; i < MAX_NUM_REGISTRY_ENTRIES; i++)
+	{
+	slot = (home + i) & (MAX_NUM_REGISTRY_ENTRIES - 1);
+	entry = &SimRegistry->entry[slot];
+
+	if (entry->state == REG_USED)
+		{
+		// a stale registration of the same name
+		if (!strcmp(entry->name, name))
+			{
+			found = slot;
+			break;
+			}
+		continue;
+		}
+
+	// the first free slot, unless the name turns up further along
+	if (found == -1)
+		found = slot;
+
+	// the name was never registered past here
+	if (entry->state == REG_EMPTY)
+		break;
+	}
+
+if (found == -1)
+	{
+	// lookups of the name miss and go on to search the fifo path
+	overflow = SimRegistry->overflow;
+	SimRegistry->overflow = 1;
+	unlockRegistry();
+
+	// once until the registry has room again
+	if (!overflow)
+		sryLog("%s: SIM name registry is full.\n", fn);
+	return -1;
+	}
+
+entry = &SimRegistry->entry[found];
+strcpy(entry->name, name);
+entry->pid = pid;
+entry->generation = ++SimRegistry->generation;
+entry->state = REG_USED;
+
+unlockRegistry();
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	void deregisterName(const char *, pid_t)
+
+PURPOSE:	Remove the registration of a SIM name if it belongs to pid.
+
+RETURNS:	nothing
+
+NOTE:		Called by deleteFifos(), chkStatus().
+***********************************************************************/
+
+void deregisterName(const char *name, pid_t pid)
+{
+// SIM_REGISTRY *SimRegistry is global
+int slot = -1;
+
+if (SimRegistry == NULL)
+	return;
+
+lockRegistry();
+
+slot = findRegistryEntry(name);
+if (slot != -1 && SimRegistry->entry[slot].pid == pid)
+	{
+	SimRegistry->entry[slot].state = REG_DELETED;
+
+	// there is room for a name again
+	SimRegistry->overflow = 0;
+	}
+
+unlockRegistry();
+}
+
+/**********************************************************************
+FUNCTION:	pid_t lookupName(const char *, unsigned *)
+
+PURPOSE:	Look up the pid registered for a SIM name along with the
+			generation of the registration, if asked for.
 
-RETURNS:	success: 0
+RETURNS:	success: pid
 			failure: -1
 ***********************************************************************/
 
-int openSRY(const char *name)
+pid_t lookupName(const char *name, unsigned *generation)
 {
-// WHO_AM_I SimParms is global
-// char *SimFifoPath is global
-// int RemoteReceiverId[] is global
-// void *BlockedSenderId[] is global
-const char *fn = "openSRY";
-char *p = NULL;
-int len = 0;
+// SIM_REGISTRY *SimRegistry is global
 pid_t pid = -1;
+int slot = -1;
 
-// is this process already SIM enabled? 
-if (sim_check() == true)
-	{
-	sryLog("%s: SIM already active for this process.\n", fn);
+if (SimRegistry == NULL)
 	return -1;
-	}
 
-// needed for a number of purposes such as unique naming, checking ...
-SimParms.pid = getpid();
+lockRegistry();
 
-// set up the SIM name by checking the length of the passed in name 
-len = strlen(name);
-if (len == 0) // SIM name too short
-	{
-	sryLog("%s: SIM name too short.\n", fn);
-	return -1;
-	}
-else if (len <= (MAX_SIM_NAME_LEN)) // acceptable name for SIM
-	{
-	strcpy(SimParms.whom, name);
-	}
-else // passed in name too long
+slot = findRegistryEntry(name);
+if (slot != -1)
 	{
-	sryLog("%s: SIM name too long.\n", fn);
-	return -1;
+	pid = SimRegistry->entry[slot].pid;
+	if (generation != NULL)
+		*generation = SimRegistry->entry[slot].generation;
 	}
 
-/*
-set the global SimFifoPath
-set to Default_Fifo_Path if SIM_FIFO_PATH not defined
-*/
-p = getenv("SIM_FIFO_PATH");
-if (p == NULL)
-	strcpy(SimFifoPath, DefaultFifoPath);
-else
-	{
-	if (strlen(p) > MAX_FIFO_PATH_LEN)
-		{
-		sryLog("%s: exported SIM fifo path name too long.\n", fn);
-		return -1;
-		}
-	sprintf(SimFifoPath, "%s", p);
-	}
+unlockRegistry();
 
-// check for access to fifo path
-if (access(SimFifoPath, F_OK) == -1)
+return pid;
+}
+
+/**********************************************************************
+FUNCTION:	pid_t scanFifoPath(const char *, const char *)
+
+PURPOSE:	Search the fifo path for a file of the form kindName.12345, 
+			for a name that is not in the registry.
+
+RETURNS:	success: pid
+			failure: -1
+
+NOTE:		Called by chkNamePid(), chkChannelPid(), chkStreamPid().
+***********************************************************************/
+
+pid_t scanFifoPath(const char *kind, const char *name)
+{
+const char *fn = "scanFifoPath";
+DIR *directory = NULL;
+struct dirent *file = NULL;
+int len = 0;
+pid_t pid = -1;
+char entryName[128];
+// char *SimFifoPath is global
+
+// open the fifo directory
+directory = opendir(SimFifoPath);
+if (directory == NULL)
 	{
-	sryLog("%s: No SIM fifo path defined.\n", fn);
+	sryLog("%s: Unable to open fifo directory %s.\n", fn, SimFifoPath);
 	return -1;
 	}
 
-// check if the name is already in use
-pid = chkNamePid(name);
-if (pid != -1)
+// the length of the kind and name passed in
+snprintf(entryName, sizeof entryName, "%s%s", kind, name);
+len = strlen(entryName);
+
+// check fifo directory entries for a match
+while ( (file = readdir(directory)) != NULL )
 	{
-	// pid is real; is the program still running?
-	if (chkStatus(pid, name) == true)
+	// check for a match
+	if (file->d_name[len] == '.' && !memcmp(file->d_name, entryName, len) &&
+									isPidSuffix(file->d_name + len + 1))
 		{
-		sryLog("%s: SIM name is already in use.\n", fn);
-		return -1;
+		// extract the pid; file name is of the form: R_name.12345
+		pid = atoi(file->d_name + len + 1);
+		break;
 		}
 	}
 
-// name, create and open the receive and reply fifos
-if (createFifos() == -1)
-	{
-	sryLog("%s: Fifo creation error\n", fn);
-	return -1;
-	}
+closedir(directory);
 
-// shmem size = 0 indicates shmem has not yet been made
-SimParms.shmSize = 0;
+return pid;
+}
 
-// add a signal handler
-initSignalHandling();
+/**********************************************************************
+FUNCTION:	pid_t getSimPid(const char *)
 
-//add the exit functionality
-atexit(exitFunc);
+PURPOSE:	Return the pid of the running SIM program with the SIM name.
+			Need not be called by a SIM enabled process.
 
-// initialize table of possible surrogates
-for (int i = 0; i < MAX_NUM_REMOTE_RECEIVERS; i++)
-	RemoteReceiverId[i] = -1;
+RETURNS:	success: pid
+			failure: -1
+***********************************************************************/
 
-// initialize table of reply-blocked senders
-for (int i = 0; i < MAX_NUM_BLOCKED_SENDERS; i++)
-	BlockedSenderId[i] = (void *)NULL;
+pid_t getSimPid(const char *name)
+{
+pid_t pid = -1;
+// char *SimFifoPath is global
 
-return 0;
+if (SimFifoPath[0] == '\0' && setFifoPath() == -1)
+	return -1;
+
+// the fifo path is searched should there be no registry
+openRegistry();
+
+pid = chkNamePid(name);
+
+// pid is real; is the program still running?
+if (pid != -1 && chkStatus(pid, name) == false)
+	pid = -1;
+
+return pid;
 }
 
 /**********************************************************************
-FUNCTION:	int closeSRY(void)
+FUNCTION:	int getSimNames(SIM_NAME *, int)
 
-PURPOSE:	Removes SIM functionality upon process exit or SRY cancelled
-			SRY instantiation.
+PURPOSE:	List up to max of the running SIM programs found in the name
+			registry. Need not be called by a SIM enabled process.
 
-RETURNS:	success: 0
+RETURNS:	success: number of SIM programs listed
 			failure: -1
 ***********************************************************************/
 
-int closeSRY()
+int getSimNames(SIM_NAME *names, int max)
 {
-//const char *fn = "closeSRY";
-// WHO_AM_I SimParms is global 
-// int RemoteReceiverId[] is global
-// void *BlockedSenderId[] is global
-	
-// is this process SIM enabled? 
-if (sim_check() == false)
-	{
-//	sryLog("%s: No SIM name attached.\n", fn);
+// SIM_REGISTRY *SimRegistry is global
+// char *SimFifoPath is global
+REGISTRY_ENTRY *entry = NULL;
+int i, count = 0, running = 0;
+
+if (SimFifoPath[0] == '\0' && setFifoPath() == -1)
 	return -1;
-	}
 
-// release any reply-blocked senders
-for (int i = 0; i < MAX_NUM_BLOCKED_SENDERS; i++)
-	{
-	if (BlockedSenderId[i] != (void *)NULL)
-		{
-		ReplyError(BlockedSenderId[i]);
-		BlockedSenderId[i] = (void *)NULL;
-		}		
-	}
+if (openRegistry() == -1)
+	return -1;
 
-// remove any surrogates
-for (int i = 0; i < MAX_NUM_REMOTE_RECEIVERS; i++)
+// copy the registered names
+lockRegistry();
+for (i = 0; i < MAX_NUM_REGISTRY_ENTRIES && count < max; i++)
 	{
-	if (RemoteReceiverId[i] != -1)
+	entry = &SimRegistry->entry[i];
+	if (entry->state == REG_USED)
 		{
-		Trigger(RemoteReceiverId[i], PROXY_SHUTDOWN);
-		RemoteReceiverId[i] = -1;
-		}		
+		strcpy(names[count].name, entry->name);
+		names[count].pid = entry->pid;
+		count++;
+		}
 	}
+unlockRegistry();
 
-// delete message shared memory segment
-if (SimParms.shmSize)
-	detachShmem();
-
-// delete receive and reply fifos
-deleteFifos();
-
-// for checking purposes
-SimParms.pid = -1;
+// drop (and clean up after) programs that are no longer running
+for (i = 0; i < count; i++)
+	if (chkStatus(names[i].pid, names[i].name) == true)
+		names[running++] = names[i];
 
-return 0;
+return running;
 }
 
+/********************************************************************/
+/***************** PUBLISH/SUBSCRIBE CHANNEL FUNCTIONS **************/
+/********************************************************************/
+
 /**********************************************************************
-FUNCTION:	int closeSRYchild(void)
+FUNCTION:	SIM_CHANNEL *getChannel(int, bool, const char *)
 
-PURPOSE:	Removes a parent's SIM functionality from a child process.
+PURPOSE:	Look up a channel of this thread by its id, checking that it
+			was published (or subscribed to) as the caller fn expects.
 
-RETURNS:	success: 0
-			failure: -1
+RETURNS:	success: pointer to the channel
+			failure: NULL
 ***********************************************************************/
 
-int closeSRYchild()
+SIM_CHANNEL *getChannel(int channel, bool publisher, const char *fn)
 {
-// WHO_AM_I SimParms is global 
-const char *fn = "closeSRYchild";
-	
-// is this process SIM enabled? 
-if (sim_check() == false)
+// SIM_CHANNEL SimChannel[] is global
+
+if (channel < 0 || channel >= MAX_NUM_CHANNELS || SimChannel[channel].hdr == NULL)
 	{
-	sryLog("%s: No SIM name attached.\n", fn);
-	return -1;
+	sryLog("%s: No channel %d.\n", fn, channel);
+	return NULL;
 	}
 
-// detach message shared memory segment
-if (SimParms.shmSize)
-	detachShmem();
+if (SimChannel[channel].publisher != publisher)
+	{
+	sryLog("%s: Channel %d is not %s.\n", fn, channel, 
+								publisher ? "published" : "subscribed to");
+	return NULL;
+	}
 
-// detach from the receive and reply fifos
-detachFifos();
+return &SimChannel[channel];
+}
 
-// for checking purposes
-SimParms.pid = -1;
+/**********************************************************************
+FUNCTION:	int freeChannel(void)
 
-return 0;
+PURPOSE:	Find a free entry in this thread's table of channels.
+
+RETURNS:	success: channel id
+			failure: -1
+***********************************************************************/
+
+int freeChannel()
+{
+// SIM_CHANNEL SimChannel[] is global
+
+for (int i = 0; i < MAX_NUM_CHANNELS; i++)
+	if (SimChannel[i].hdr == NULL)
+		return i;
+
+return -1;
 }
 
 /**********************************************************************
-FUNCTION:	int Send(int, void *, unsigned, void *, unsigned)
+FUNCTION:	CHANNEL_HDR *createChannel(const char *, unsigned, unsigned, 
+																size_t *)
 
-PURPOSE:	This function sends SIM messages to other processes.
+PURPOSE:	Name, create and map the P_ file of a channel with a ring of
+			numSlots messages of up to msgSize bytes.
 
-RETURNS:	success: number of bytes from Reply >= 0
-			failure: -1
+RETURNS:	success: pointer to the channel header
+			failure: NULL
+
+NOTE:		Called by OpenChannel().
 ***********************************************************************/
 
-int Send(int fd, void *outBuffer, unsigned outBytes, void *inBuffer, unsigned 
-inBytes)
+CHANNEL_HDR *createChannel(const char *name, unsigned msgSize, 
+											unsigned numSlots, size_t *mapSize)
 {
-const char *fn = "Send";
-char fifoBuf[sizeof(FIFO_MSG)];
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
-unsigned bufSize = 0;
-FCMSG_REC *msgPtr = NULL;
-// WHO_AM_I SimParms is global 
+const char *fn = "createChannel";
+char cname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 20];
+CHANNEL_HDR *hdr = NULL;
+unsigned slotOffset, slotSize;
+unsigned long long size;
+int fd = -1;
+void *p = NULL;
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
 
-// is this process SIM enabled? 
-if (sim_check() == false)
+// the header and each of the slots start on a cache line of their own
+slotOffset = (sizeof(CHANNEL_HDR) + 63) & ~63u;
+slotSize = (sizeof(CHANNEL_SLOT) + msgSize + 63) & ~63u;
+size = slotOffset + (unsigned long long)slotSize * numSlots;
+if (size > (size_t)-1)
 	{
-	sryLog("%s: SIM not active\n", fn);
-	return -1;
+	sryLog("%s: Channel of %llu bytes is too large.\n", fn, size);
+	return NULL;
 	}
 
-// check the veracity of the fd
-if (fd < 3)
+// channel file lives alongside the fifos
+sprintf(cname, "%s/P_%s.%d", SimFifoPath, name, SimParms.pid);
+
+// a leftover from an earlier process of the same name and pid is of no use
+remove(cname);
+
+fd = open(cname, O_RDWR | O_CREAT | O_EXCL, 0666);
+if (fd == -1)
 	{
-	sryLog("%s: SIM id is out of range.\n", fn);
-	return -1;
+	sryLog("%s: Unable to create channel %s-%s.\n", fn, cname, strerror(errno));
+	return NULL;
 	}
 
-// calculate the largest buffer size for this messaging
-bufSize = (outBytes >= inBytes) ? outBytes : inBytes;
+// masks the mode 0666 with user's umask
+if (fchmod(fd, 0666) == -1 || ftruncate(fd, (off_t)size) == -1)
+	{
+	sryLog("%s: Unable to size channel %s-%s.\n", fn, cname, strerror(errno));
+	close(fd);
+	remove(cname);
+	return NULL;
+	}
 
-// build shmem as needed
-if (SimParms.shmSize < (bufSize + (unsigned)sizeof(FCMSG_REC)))
+p = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+close(fd);
+if (p == MAP_FAILED)
 	{
-	// delete any past shmem
-	if (SimParms.shmSize)
-		detachShmem();
-	
-	// create new shmem	
-	if (createShmem(bufSize) == -1)
-		{
-		sryLog("%s: Create shmem error\n", fn);
-		return -1;
-		}
+	sryLog("%s: Unable to map channel %s-%s.\n", fn, cname, strerror(errno));
+	remove(cname);
+	return NULL;
 	}
 
-// copy the message into shmem to be read by the receiver
-msgPtr = (FCMSG_REC *)SimParms.shmPtr;
-strcpy(msgPtr->whom, SimParms.whom);
-msgPtr->pid = SimParms.pid;
-msgPtr->shmsize = bufSize;
-msgPtr->nbytes = outBytes;
-msgPtr->ybytes = inBytes;
-if (outBuffer != NULL)
-	memcpy((void *)&msgPtr->data, outBuffer, outBytes);
+// a new file is all zeroes; no messages and no subscribers
+hdr = (CHANNEL_HDR *)p;
+hdr->msgSize = msgSize;
+hdr->slotSize = slotSize;
+hdr->numSlots = numSlots;
+hdr->slotOffset = slotOffset;
+hdr->pid = SimParms.pid;
 
-// line up the triggering message for the fifo
-fifoMsg->shmid = SimParms.shmid;
+*mapSize = (size_t)size;
 
-/*
-sender writes on receiver's fifo
-receiver will read the fifo and get sender's shmem id (schmid)
-*/
-if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
-	{
-	sryLog("%s: Unable to write to fifo -%s\n", fn, strerror(errno));
-	return -1;
-	}
+return hdr;
+}
 
-// wait for the receiver to send fifo message to trigger the reply
-if (readFifoMsg(SimParms.yfd, fifoBuf) != sizeof(FIFO_MSG))
+/**********************************************************************
+FUNCTION:	CHANNEL_HDR *attachChannel(const char *, pid_t, size_t *)
+
+PURPOSE:	Map the P_ file of a channel published by pid.
+
+RETURNS:	success: pointer to the channel header
+			failure: NULL
+
+NOTE:		Called by Subscribe().
+***********************************************************************/
+
+CHANNEL_HDR *attachChannel(const char *name, pid_t pid, size_t *mapSize)
+{
+char cname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 20];
+CHANNEL_HDR *hdr = NULL;
+struct stat st;
+int fd = -1;
+void *p = NULL;
+// char *SimFifoPath is global
+
+sprintf(cname, "%s/P_%s.%d", SimFifoPath, name, pid);
+
+fd = open(cname, O_RDWR);
+if (fd == -1)
+	return NULL;
+
+if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(CHANNEL_HDR))
 	{
-	sryLog("%s: Fifo read error\n", fn);
-	close(SimParms.yfd);
-	SimParms.yfd = -1;
-	return -1;
+	close(fd);
+	return NULL;
 	}
 
-// was there a problem in the send such as a call to ReplyError()?
-if (fifoMsg->shmid == -1)
+p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+close(fd);
+if (p == MAP_FAILED)
+	return NULL;
+
+// the ring must lie within the file, and the header be filled in
+hdr = (CHANNEL_HDR *)p;
+if (hdr->pid != pid || hdr->numSlots == 0 || 
+	hdr->slotOffset + (unsigned long long)hdr->slotSize * hdr->numSlots > 
+												(unsigned long long)st.st_size)
 	{
-	sryLog("%s: receive/reply problem ... could be a failed receiver.\n", fn);
-	return -1;
+	munmap(p, (size_t)st.st_size);
+	return NULL;
 	}
 
-// copy the reply message
-if (inBuffer != NULL)
-	if (msgPtr->nbytes)
-		memcpy(inBuffer, (void *)&msgPtr->data, msgPtr->nbytes);
+*mapSize = (size_t)st.st_size;
 
-// return the size of the reply message
-return msgPtr->nbytes;
+return hdr;
 }
 
 /**********************************************************************
-FUNCTION:	int PostMesssage(int, void *, unsigned, unsigned)
+FUNCTION:	pid_t chkChannelPid(const char *)
 
-PURPOSE:	This function sends SIM messages to other processes, however
-			it does not return a reply. It is essentially the "top half"
-			of a Send().
+PURPOSE:	Return the pid of the publisher of a channel, found in the name
+			registry or failing that by its P_ file.
 
-RETURNS:	success: 0
+RETURNS:	success: pid
 			failure: -1
 ***********************************************************************/
 
-int PostMessage(int fd, void *outBuffer, unsigned outBytes, unsigned inBytes)
+pid_t chkChannelPid(const char *name)
 {
-const char *fn = "PostMessage";
-char fifoBuf[sizeof(FIFO_MSG)];
-unsigned bufSize = 0;
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
-FCMSG_REC *msgPtr = NULL;
-// WHO_AM_I SimParms is global 
-
-// is this process SIM enabled? 
-if (sim_check() == false)
-	{
-	sryLog("%s: SIM not active\n", fn);
-	return -1;
-	}
+// SIM_REGISTRY *SimRegistry is global
+pid_t pid = -1;
 
-// check the veracity of the fd
-if (fd < 3)
+if (SimRegistry != NULL)
 	{
-	sryLog("%s: SIM id is out of range.\n", fn);
-	return -1;
+	pid = lookupName(name, NULL);
+	if (pid != -1)
+		return pid;
 	}
 
-// calculate the largest buffer size for this messaging
-bufSize = (outBytes >= inBytes) ? outBytes : inBytes;
-
-// build shmem as needed
-if (SimParms.shmSize < (bufSize + (unsigned)sizeof(FCMSG_REC)))
-	{
-	// delete any past shmem
-	if (SimParms.shmSize)
-		detachShmem();
-	
-	// create new shmem	
-	if (createShmem(bufSize) == -1)
-		{
-		sryLog("%s: Create shmem error\n", fn);
-		return -1;
-		}
-	}
+// nor need a name be in the registry, see getFifoName()
+return scanFifoPath("P_", name);
+}
 
-// copy the message into shmem to be read by the receiver
-msgPtr = (FCMSG_REC *)SimParms.shmPtr;
-strcpy(msgPtr->whom, SimParms.whom);
-msgPtr->pid = SimParms.pid;
-msgPtr->shmsize = bufSize;
-msgPtr->nbytes = outBytes;
-msgPtr->ybytes = inBytes;
-if (outBuffer != NULL)
-	memcpy((void *)&msgPtr->data, outBuffer, outBytes);
+/**********************************************************************
+FUNCTION:	CHANNEL_SLOT *channelSlot(CHANNEL_HDR *, unsigned long)
 
-// line up the triggering message for the fifo
-fifoMsg->shmid = SimParms.shmid;
+PURPOSE:	Find the slot of the ring that holds message seq.
 
-/*
-sender writes on receiver's fifo
-receiver will read the fifo and get sender's shmem id (schmid)
-*/
-if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
-	{
-	sryLog("%s: Unable to write to fifo -%s\n", fn, strerror(errno));
-	return -1;
-	}
+RETURNS:	pointer to the slot
+***********************************************************************/
 
-return 0;
+CHANNEL_SLOT *channelSlot(CHANNEL_HDR *hdr, unsigned long seq)
+{
+return (CHANNEL_SLOT *)((char *)hdr + hdr->slotOffset + 
+						(size_t)(seq & (hdr->numSlots - 1)) * hdr->slotSize);
 }
 
 /**********************************************************************
-FUNCTION:	int ReadReply(void *)
+FUNCTION:	int joinChannel(SIM_CHANNEL *)
 
-PURPOSE:	This function receives SIM reply messages from other processes.
-			It is essentially the "bottom half" of a Send(). Follows a call
-			to PostMessage().
+PURPOSE:	Take a place among the subscribers of a channel, one left by a
+			subscriber that is gone if need be, and make the S_ fifo by
+			which the publisher nudges ChannelFd().
 
-RETURNS:	success: size of replied message >=0
+RETURNS:	success: 0
 			failure: -1
+
+NOTE:		Called by Subscribe().
 ***********************************************************************/
 
-int ReadReply(void *inBuffer)
+int joinChannel(SIM_CHANNEL *c)
 {
-const char *fn = "ReadReply";
-char fifoBuf[sizeof(FIFO_MSG)];
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
-FCMSG_REC *msgPtr = NULL;
-// WHO_AM_I SimParms is global 
+const char *fn = "joinChannel";
+char sname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 30];
+CHANNEL_SUBSCRIBER *sub = c->hdr->sub;
+pid_t owner = 0;
+int i, place = -1;
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
 
-// is this process SIM enabled? 
-if (sim_check() == false)
+// a free place
+for (i = 0; i < MAX_NUM_CHANNEL_SUBSCRIBERS && place == -1; i++)
 	{
-	sryLog("%s: SIM not active\n", fn);
-	return -1;
+	owner = 0;
+	if (__atomic_compare_exchange_n(&sub[i].pid, &owner, SimParms.pid, false,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		place = i;
 	}
 
-// wait for the receiver to send fifo message to trigger the reply
-if (readFifoMsg(SimParms.yfd, fifoBuf) != sizeof(FIFO_MSG))
+// failing that, the place of a subscriber that is no longer running
+for (i = 0; i < MAX_NUM_CHANNEL_SUBSCRIBERS && place == -1; i++)
 	{
-	sryLog("%s: Fifo read error\n", fn);
-	close(SimParms.yfd);
-	SimParms.yfd = -1;
-	return -1;
+	owner = __atomic_load_n(&sub[i].pid, __ATOMIC_RELAXED);
+	errno = 0;
+	if (owner > 0 && getpriority(PRIO_PROCESS, owner) == -1 && errno == ESRCH &&
+		__atomic_compare_exchange_n(&sub[i].pid, &owner, SimParms.pid, false,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+		// its S_ fifo was left behind
+		sprintf(sname, "%s/S_%s_%d.%d", SimFifoPath, c->name, i, owner);
+		remove(sname);
+		place = i;
+		}
 	}
 
-// was there a problem in the send such as a call to ReplyError()?
-if (fifoMsg->shmid == -1)
+if (place == -1)
 	{
-	sryLog("%s: receive/reply problem ... could be a failed receiver.\n", fn);
+	sryLog("%s: No room for another subscriber to channel %s.\n", fn, c->name);
 	return -1;
 	}
 
-// line up on the reply message
-msgPtr = (FCMSG_REC *)SimParms.shmPtr;
+// the publisher reopens the S_ fifo of a place taken anew
+__atomic_store_n(&sub[place].notify, 0, __ATOMIC_RELAXED);
+__atomic_add_fetch(&sub[place].generation, 1, __ATOMIC_RELEASE);
+
+sprintf(sname, "%s/S_%s_%d.%d", SimFifoPath, c->name, place, SimParms.pid);
+remove(sname);
 
-// check the size of the sender's reply buffer
-if (sizeof inBuffer < msgPtr->nbytes)
+// masks the mode 0666 with user's umask
+if (mkfifo(sname, 0666) == -1 || chmod(sname, 0666) == -1)
 	{
-	sryLog("%s: buffer too small for reply.\n", fn);
+	sryLog("%s: Unable to create fifo %s-%s.\n", fn, sname, strerror(errno));
+	remove(sname);
+	__atomic_store_n(&sub[place].pid, 0, __ATOMIC_RELEASE);
 	return -1;
 	}
 
-// is there something to copy from the shmem?
-if (msgPtr->nbytes)
-	memcpy(inBuffer, (void *)&msgPtr->data, msgPtr->nbytes);
+// read and write, so that the publisher can always open it
+c->fd = open(sname, O_RDWR | O_NONBLOCK);
+if (c->fd == -1)
+	{
+	sryLog("%s: Unable to open fifo %s-%s.\n", fn, sname, strerror(errno));
+	remove(sname);
+	__atomic_store_n(&sub[place].pid, 0, __ATOMIC_RELEASE);
+	return -1;
+	}
 
-// return the size of the reply message
-return msgPtr->nbytes;
+c->place = place;
+
+return 0;
 }
 
 /**********************************************************************
-FUNCTION:	int Trigger(int, int)
+FUNCTION:	void leaveChannel(SIM_CHANNEL *)
 
-PURPOSE:	This function sends a proxy to a receiver type process.
+PURPOSE:	Give up a subscriber's place in a channel and remove its S_
+			fifo.
 
-RETURNS:	success: 0
-			failure: -1
+RETURNS:	nothing
+
+NOTE:		Called by releaseChannel().
 ***********************************************************************/
 
-int Trigger(int fd, int proxy)
+void leaveChannel(SIM_CHANNEL *c)
 {
-const char *fn = "Trigger";
-char fifoBuf[sizeof(FIFO_MSG)];
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
+char sname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 30];
+CHANNEL_SUBSCRIBER *sub = &c->hdr->sub[c->place];
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
 
-// is this process SIM enabled? 
-if (sim_check() == false)
-	{
-	sryLog("%s: SIM not active.\n", fn);
-	return -1;
-	}
+close(c->fd);
+c->fd = -1;
+sprintf(sname, "%s/S_%s_%d.%d", SimFifoPath, c->name, c->place, SimParms.pid);
+remove(sname);
 
-// check proxy value
-if (proxy < 1)
+__atomic_store_n(&sub->notify, 0, __ATOMIC_RELAXED);
+__atomic_add_fetch(&sub->generation, 1, __ATOMIC_RELEASE);
+__atomic_store_n(&sub->pid, 0, __ATOMIC_RELEASE);
+}
+
+/**********************************************************************
+FUNCTION:	int takeChannelMsg(SIM_CHANNEL *, void *, unsigned)
+
+PURPOSE:	Copy out the next message of a subscribed channel, should it
+			fit in maxBytes, skipping over (and counting) any messages 
+			written over before they could be read.
+
+RETURNS:	success: message size
+			failure: -1 if there is no message to read
+
+NOTE:		Called by ReadChannel().
+***********************************************************************/
+
+int takeChannelMsg(SIM_CHANNEL *c, void *inBuffer, unsigned maxBytes)
+{
+CHANNEL_HDR *hdr = c->hdr;
+CHANNEL_SLOT *slot = NULL;
+unsigned long head, seq;
+unsigned nbytes;
+
+while (true)
 	{
-	sryLog("%s: Improper proxy value, should be > 0.\n", fn);
-	return -1;
+	head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+	if (c->next > head)
+		return -1;
+
+	// the ring only holds the last numSlots messages
+	if (head - c->next >= hdr->numSlots)
+		{
+		c->lost += head - hdr->numSlots + 1 - c->next;
+		c->next = head - hdr->numSlots + 1;
+		}
+
+	slot = channelSlot(hdr, c->next);
+	seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+	if (seq == c->next)
+		{
+		nbytes = slot->nbytes;
+		if (inBuffer != NULL && nbytes <= maxBytes)
+			memcpy(inBuffer, &slot->data, nbytes);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		// still the same message once copied?
+		if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq)
+			{
+			c->next++;
+			return (int)nbytes;
+			}
+		}
+
+	// written over since the head was read; go on to the next
+	c->lost++;
+	c->next++;
 	}
+}
 
-// negative value marks a proxy
-fifoMsg->shmid = -proxy;
+/**********************************************************************
+FUNCTION:	unsigned long channelWaiting(SIM_CHANNEL *)
 
-if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
+PURPOSE:	Count the messages of a subscribed channel yet to be read, 
+			leaving out those already written over.
+
+RETURNS:	number of messages
+***********************************************************************/
+
+unsigned long channelWaiting(SIM_CHANNEL *c)
+{
+unsigned long waiting;
+
+waiting = __atomic_load_n(&c->hdr->head, __ATOMIC_SEQ_CST) + 1 - c->next;
+
+return (waiting > c->hdr->numSlots) ? c->hdr->numSlots : waiting;
+}
+
+/**********************************************************************
+FUNCTION:	int waitChannel(SIM_CHANNEL *)
+
+PURPOSE:	Sleep on the wake futex of a subscribed channel until the next
+			message is published or the channel closed. The publisher is 
+			looked for every second in case it has gone without closing.
+
+RETURNS:	success: 0, to look for a message again
+			failure: -1 if the publisher is gone
+
+NOTE:		Called by ReadChannel().
+***********************************************************************/
+
+int waitChannel(SIM_CHANNEL *c)
+{
+const char *fn = "waitChannel";
+CHANNEL_HDR *hdr = c->hdr;
+struct timespec second = {1, 0};
+int wake, rc = 0;
+
+__atomic_add_fetch(&hdr->sleepers, 1, __ATOMIC_SEQ_CST);
+wake = __atomic_load_n(&hdr->wake, __ATOMIC_SEQ_CST);
+
+// the publisher only wakes sleepers it knows of; look again before sleeping
+if (!channelWaiting(c) && !__atomic_load_n(&hdr->closed, __ATOMIC_ACQUIRE))
+	rc = syscall(SYS_futex, &hdr->wake, FUTEX_WAIT, wake, &second, NULL, 0);
+
+__atomic_sub_fetch(&hdr->sleepers, 1, __ATOMIC_SEQ_CST);
+
+if (rc == -1 && errno == ETIMEDOUT)
 	{
-	sryLog("%s: unable to write to fifo -%s\n", fn, strerror(errno));
-	return -1;
+	// errno must be cleared prior to getpriority() call
+	errno = 0;
+	if (getpriority(PRIO_PROCESS, hdr->pid) == -1 && errno == ESRCH)
+		{
+		sryLog("%s: Publisher of channel %s is gone.\n", fn, c->name);
+		return -1;
+		}
 	}
 
 return 0;
 }
 
 /**********************************************************************
-FUNCTION:	int Receive(void **, void *, unsigned)
+FUNCTION:	void notifySubscribers(SIM_CHANNEL *, bool)
 
-PURPOSE:	This function receives SIM messages from other processes.
+PURPOSE:	Write a byte to the S_ fifo of each subscriber of a published
+			channel that has asked for one by way of ChkChannel(), or to
+			that of every subscriber if all.
 
-RETURNS:	success: message size in bytes
-			failure: -1
+RETURNS:	nothing
+
+NOTE:		Called by Publish(), releaseChannel().
 ***********************************************************************/
 
-int Receive(void **sender, void *inBuffer, unsigned maxBytes)
+void notifySubscribers(SIM_CHANNEL *c, bool all)
 {
-const char *fn = "Receive";
-char fifoBuf[sizeof(FIFO_MSG)];
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
-FCMSG_REC *msgRec = NULL;
-// WHO_AM_I SimParms is global 
-// int SimSenderShmid is global
+char sname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 30];
+CHANNEL_SUBSCRIBER *sub = NULL;
+unsigned generation;
+pid_t pid;
+char nudge = 0;
+// char *SimFifoPath is global
 
-// is this process SIM enabled? 
-if (sim_check() == false)
+for (int i = 0; i < MAX_NUM_CHANNEL_SUBSCRIBERS; i++)
 	{
-	sryLog("%s: SIM not active.\n", fn);
-	return -1;
-	}
+	sub = &c->hdr->sub[i];
 
-// reset the SimSenderShmid, needed by Relay()
-SimSenderShmid = -1;
+	// a subscriber asks for one nudge at a time
+	if (!all && (!__atomic_load_n(&sub->notify, __ATOMIC_SEQ_CST) ||
+						!__atomic_exchange_n(&sub->notify, 0, __ATOMIC_SEQ_CST)))
+		continue;
 
-// wait on the fifo for a triggering message from a sending process
-if (readFifoMsg(SimParms.rfd, fifoBuf) != sizeof(FIFO_MSG))
-	{
-	sryLog("%s: Fifo read error.\n", fn);
-	close(SimParms.rfd);
-	SimParms.rfd = -1;
-	return -1;
-	} 
+	pid = __atomic_load_n(&sub->pid, __ATOMIC_ACQUIRE);
+	if (pid == 0)
+		continue;
 
-// set the global for sender's shmid for Relay to work
-SimSenderShmid = fifoMsg->shmid;
+	// the cached S_ fifo is that of an earlier subscriber in this place
+	generation = __atomic_load_n(&sub->generation, __ATOMIC_ACQUIRE);
+	if (c->subFd[i] != -1 && c->subGeneration[i] != generation)
+		{
+		close(c->subFd[i]);
+		c->subFd[i] = -1;
+		}
 
-// is the message a proxy?
-if (fifoMsg->shmid < 0)
-	return (-1 + fifoMsg->shmid); // -2 or less (shmid is already negative)
+	if (c->subFd[i] == -1)
+		{
+		sprintf(sname, "%s/S_%s_%d.%d", SimFifoPath, c->name, i, pid);
+		c->subFd[i] = open(sname, O_WRONLY | O_NONBLOCK);
+		if (c->subFd[i] == -1)
+			continue;
+		c->subGeneration[i] = generation;
+		}
 
-/*
-Attach the sender's shmem to this process.
-Known to fail if sender suddenly disappears. 
-Saving this value allows the Reply() to use the same shmem.
-*/
-*sender = (void *)shmat(fifoMsg->shmid, (void *)0, 0);
-if (*sender == (void *)-1)
-	{
-	sryLog("%s: shmid=%d cannot attach to shmem-%s\n", fn, fifoMsg->shmid, 
-															strerror(errno));
-	ReplyError(*sender);
-	return -1;
+	// a full fifo is readable already; a subscriber gone leaves EPIPE
+	if (write(c->subFd[i], &nudge, 1) == -1 && errno != EAGAIN)
+		{
+		close(c->subFd[i]);
+		c->subFd[i] = -1;
+		}
 	}
+}
 
-// line up on the message
-msgRec = (FCMSG_REC *)*sender;
+/**********************************************************************
+FUNCTION:	void releaseChannel(SIM_CHANNEL *, bool)
 
-// copy the data out of the shmem or not?
-if (inBuffer != NULL)
+PURPOSE:	Close a published channel, which its subscribers read to the
+			end, or give up a subscription. A forked child merely detaches
+			from the channels of its parent.
+
+RETURNS:	nothing
+
+NOTE:		Called by CloseChannel(), releaseAllChannels().
+***********************************************************************/
+
+void releaseChannel(SIM_CHANNEL *c, bool detach)
+{
+char cname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 20];
+CHANNEL_HDR *hdr = c->hdr;
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
+
+if (c->publisher)
 	{
-	// is the message larger than the receiver's message buffer?
-	if (msgRec->nbytes > maxBytes)
+	if (!detach)
 		{
-		sryLog("%s: message size %d > buffer size %d\n", fn, msgRec->nbytes, 
-																	maxBytes);
-		ReplyError(*sender);
-		return -1;
+		// no new subscribers
+		deregisterName(c->name, SimParms.pid);
+		sprintf(cname, "%s/P_%s.%d", SimFifoPath, c->name, SimParms.pid);
+		remove(cname);
+
+		// wake and nudge all of the subscribers to read to the end
+		__atomic_store_n(&hdr->closed, 1, __ATOMIC_RELEASE);
+		__atomic_add_fetch(&hdr->wake, 1, __ATOMIC_SEQ_CST);
+		simFutex(&hdr->wake, FUTEX_WAKE, INT_MAX);
+		notifySubscribers(c, true);
 		}
 
-	// copy the message 
-	memcpy(inBuffer, (void *)&msgRec->data, msgRec->nbytes);
+	for (int i = 0; i < MAX_NUM_CHANNEL_SUBSCRIBERS; i++)
+		if (c->subFd[i] != -1)
+			{
+			close(c->subFd[i]);
+			c->subFd[i] = -1;
+			}
+	}
+else if (!detach)
+	leaveChannel(c);
+else
+	{
+	close(c->fd);
+	c->fd = -1;
+	}
+
+munmap(hdr, c->mapSize);
+c->hdr = NULL;
+}
+
+/**********************************************************************
+FUNCTION:	void releaseAllChannels(bool)
+
+PURPOSE:	Close, or detach from, all of this thread's channels.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild().
+***********************************************************************/
+
+void releaseAllChannels(bool detach)
+{
+// SIM_CHANNEL SimChannel[] is global
+
+for (int i = 0; i < MAX_NUM_CHANNELS; i++)
+	if (SimChannel[i].hdr != NULL)
+		releaseChannel(&SimChannel[i], detach);
+}
+
+/********************************************************************/
+/************************** STREAM FUNCTIONS ************************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	SIM_STREAM *getStream(int, bool, const char *)
+
+PURPOSE:	Look up a stream of this thread by its id, checking that it is
+			produced (or consumed) as the caller fn expects.
+
+RETURNS:	success: pointer to the stream
+			failure: NULL
+***********************************************************************/
+
+SIM_STREAM *getStream(int stream, bool producer, const char *fn)
+{
+// SIM_STREAM SimStream[] is global
+
+if (stream < 0 || stream >= MAX_NUM_STREAMS || SimStream[stream].hdr == NULL)
+	{
+	sryLog("%s: No stream %d.\n", fn, stream);
+	return NULL;
 	}
 
-// save this sender in case of failure before a reply can made
-saveSenderId(*sender);
+if (SimStream[stream].producer != producer)
+	{
+	sryLog("%s: Stream %d is not %s.\n", fn, stream, 
+										producer ? "produced" : "consumed");
+	return NULL;
+	}
 
-// return the size of the message
-return msgRec->nbytes;
+return &SimStream[stream];
 }
 
 /**********************************************************************
-FUNCTION:	int Reply(void *, void *, unsigned)
+FUNCTION:	int freeStream(void)
 
-PURPOSE:	This function replies SIM messages to sender processes.
+PURPOSE:	Find a free entry in this thread's table of streams.
 
-RETURNS:	success: number of reply bytes (nbytes) >= 0
+RETURNS:	success: stream id
 			failure: -1
 ***********************************************************************/
 
-int Reply(void *sender, void *outBuffer, unsigned nbytes)
+int freeStream()
 {
-const char *fn = "Reply";
-char fifoBuf[sizeof(FIFO_MSG)];
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
-FCMSG_REC *msgPtr = NULL;
-char fifoName[256];
-int fd = -1, ret = -1;
-// WHO_AM_I SimParms is global 
-// char *SimFifoPath is global
-// int SimSenderShmid is global
+// SIM_STREAM SimStream[] is global
 
-// is this process SIM enabled? 
-if (sim_check() == false)
-	{
-	sryLog("%s: SIM not active.\n", fn);
-	return -1;
-	}
+for (int i = 0; i < MAX_NUM_STREAMS; i++)
+	if (SimStream[i].hdr == NULL)
+		return i;
 
-// set a pointer to the sender's shmem
-msgPtr = (FCMSG_REC *)sender;
+return -1;
+}
 
-// set the sender's reply fifo path and name
-sprintf(fifoName, "%s/Y_%s.%d", SimFifoPath, msgPtr->whom, msgPtr->pid);
+/**********************************************************************
+FUNCTION:	STREAM_HDR *createStream(const char *, unsigned, unsigned, int, 
+															int, size_t *)
 
-// check that sender's reply buffer is large enough
-if (nbytes > msgPtr->ybytes)
-	{
-	// set up fifo trigger message for error
-	fifoMsg->shmid = -1;
-	// set error
-	sryLog("%s: Reply message too large.\n", fn);
-	}
-else
-	{
-	// set up fifo trigger message for success 
-	fifoMsg->shmid = 0;
-	// set the reply message header
-	msgPtr->nbytes = nbytes;
-	// copy the reply message into sender's shmem
-	if (outBuffer != NULL)
-		memcpy((void *)&msgPtr->data, outBuffer, nbytes);
-	ret = nbytes;
-	}
+PURPOSE:	Name, create and map the T_ file of a stream with a ring of 
+			size bytes.
+
+RETURNS:	success: pointer to the stream header
+			failure: NULL
+
+NOTE:		Called by OpenStream().
+***********************************************************************/
+
+STREAM_HDR *createStream(const char *name, unsigned recSize, unsigned size, 
+									int policy, int proxy, size_t *mapSize)
+{
+const char *fn = "createStream";
+char tname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 20];
+STREAM_HDR *hdr = NULL;
+unsigned ringOffset;
+int fd = -1;
+void *p = NULL;
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
+
+// the ring starts on a cache line of its own
+ringOffset = (sizeof(STREAM_HDR) + 63) & ~63u;
+
+// stream file lives alongside the fifos
+sprintf(tname, "%s/T_%s.%d", SimFifoPath, name, SimParms.pid);
 
-// detach sender's shmem from this process
-shmdt(sender);
+// a leftover from an earlier process of the same name and pid is of no use
+remove(tname);
 
-// open the sender's fifo
-fd = open(fifoName, O_WRONLY);
+fd = open(tname, O_RDWR | O_CREAT | O_EXCL, 0666);
 if (fd == -1)
 	{
-	sryLog("%s: Unable to open fifo-%s.\n", fn, strerror(errno));
-	return -1;
+	sryLog("%s: Unable to create stream %s-%s.\n", fn, tname, strerror(errno));
+	return NULL;
 	}
 
-// write the fifo message to unblock the sender
-if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
+// masks the mode 0666 with user's umask
+if (fchmod(fd, 0666) == -1 || ftruncate(fd, (off_t)ringOffset + size) == -1)
 	{
-	sryLog("%s: Unable to write to fifo.\n", fn);
+	sryLog("%s: Unable to size stream %s-%s.\n", fn, tname, strerror(errno));
 	close(fd);
-	return -1;
+	remove(tname);
+	return NULL;
 	}
 
-// close the sender's fifo 
+p = mmap(NULL, (size_t)ringOffset + size, PROT_READ | PROT_WRITE, MAP_SHARED,
+																	fd, 0);
 close(fd);
+if (p == MAP_FAILED)
+	{
+	sryLog("%s: Unable to map stream %s-%s.\n", fn, tname, strerror(errno));
+	remove(tname);
+	return NULL;
+	}
 
-// reset the SimSenderShmid
-SimSenderShmid = -1;
-
-// remove this sender that was saved in case of a failure
-removeSenderId(sender);
-
-return ret;
+// a new file is all zeroes; no records and no producer
+hdr = (STREAM_HDR *)p;
+hdr->policy = policy;
+hdr->proxy = proxy;
+hdr->recSize = recSize;
+hdr->size = size;
+hdr->ringOffset = ringOffset;
+strcpy(hdr->whom, SimParms.whom);
+hdr->notify = proxy ? 1 : 0;
+hdr->pid = SimParms.pid;
+
+*mapSize = (size_t)ringOffset + size;
+return hdr;
 }
 
 /**********************************************************************
-FUNCTION:	int ReplyError(void *)
+FUNCTION:	STREAM_HDR *attachStream(const char *, pid_t, size_t *)
 
-PURPOSE:	This function replies an error condition to a reply-blocked
-			sender.
+PURPOSE:	Map the T_ file of a stream consumed by pid.
 
-RETURNS:	success: 0
-			failure: -1
+RETURNS:	success: pointer to the stream header
+			failure: NULL
+
+NOTE:		Called by ConnectStream().
 ***********************************************************************/
 
-int ReplyError(void *sender)
+STREAM_HDR *attachStream(const char *name, pid_t pid, size_t *mapSize)
 {
-const char *fn = "ReplyError";
-char fifoName[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
+char tname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 20];
+STREAM_HDR *hdr = NULL;
+struct stat st;
 int fd = -1;
-char fifoBuf[sizeof(FIFO_MSG)];
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
-FCMSG_REC *msgPtr = NULL;
-// WHO_AM_I SimParms is global 
+void *p = NULL;
 // char *SimFifoPath is global
 
-// is this process SIM enabled? 
-if (sim_check() == false)
-	{
-	sryLog("%s: SIM not active.\n", fn);
-	return -1;
-	}
-	
-// remove this sender from the reply-blocked sender table
-removeSenderId(sender);
-
-// line up on the fifo message
-msgPtr = (FCMSG_REC *)sender;
-
-// set the fifo path and name
-sprintf(fifoName, "%s/Y_%s.%d", SimFifoPath, msgPtr->whom, msgPtr->pid);
+sprintf(tname, "%s/T_%s.%d", SimFifoPath, name, pid);
 
-// detach sender's shmem from this process
-shmdt(sender);
-
-// set up fifo message, -1 indicates an error condition
-fifoMsg->shmid = -1;
-
-// open the fifo
-fd = open(fifoName, O_WRONLY);
+fd = open(tname, O_RDWR);
 if (fd == -1)
-	{
-	sryLog("%s: Fifo %s open failure - %s.\n", fn, fifoName, strerror(errno));
-	return -1;
-	}
+	return NULL;
 
-// write the fifo trigger message
-if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
+if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(STREAM_HDR))
 	{
-	sryLog("%s: Fifo write failure -%s\n", fn, strerror(errno));
 	close(fd);
-	return -1;
+	return NULL;
 	}
 
-// close the fifo 
+p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
 close(fd);
+if (p == MAP_FAILED)
+	return NULL;
+
+// the ring must be a power of 2 and lie within the file
+hdr = (STREAM_HDR *)p;
+if (hdr->pid != pid || hdr->size == 0 || (hdr->size & (hdr->size - 1)) ||
+	hdr->ringOffset < sizeof(STREAM_HDR) ||
+	(unsigned long long)hdr->ringOffset + hdr->size > 
+												(unsigned long long)st.st_size)
+	{
+	munmap(p, (size_t)st.st_size);
+	return NULL;
+	}
 
-// if we got this far the message has been sent and return success
-return 0;
+*mapSize = (size_t)st.st_size;
+return hdr;
 }
 
 /**********************************************************************
-FUNCTION:	int Relay(void *, int)
+FUNCTION:	pid_t chkStreamPid(const char *)
 
-PURPOSE:	This function relays a SIM message to another process.
+PURPOSE:	Return the pid of the consumer of a stream, found in the name
+			registry or failing that by its T_ file.
 
-RETURNS:	success: 0
+RETURNS:	success: pid
 			failure: -1
 ***********************************************************************/
 
-int Relay(void *sender, int fd)
+pid_t chkStreamPid(const char *name)
 {
-const char *fn = "Relay";
-char fifoBuf[sizeof(FIFO_MSG)];
-FIFO_MSG *fifoMsg = (FIFO_MSG *)fifoBuf;
-// WHO_AM_I SimParms is global 
-// int sim_sender_shmid is global
+// SIM_REGISTRY *SimRegistry is global
+pid_t pid = -1;
 
-// is this process SIM enabled? 
-if (sim_check() == false)
+if (SimRegistry != NULL)
 	{
-	sryLog("%s: SIM not active.\n", fn);
-	return -1;
+	pid = lookupName(name, NULL);
+	if (pid != -1)
+		return pid;
 	}
-	
-fifoMsg->shmid = SimSenderShmid;
 
-// write the fifo message to unblock the sender
-if (write(fd, fifoBuf, sizeof(FIFO_MSG)) != sizeof(FIFO_MSG))
-	{
-	sryLog("%s: unable to write to fifo\n", fn);
-	close(fd);
-	return -1;
-	}
-else
-	{
-	// remove this sender that was saved in case of failure
-	removeSenderId(sender);
+// nor need a name be in the registry, see getFifoName()
+return scanFifoPath("T_", name);
+}
 
-	// reset the _simpl_sender_shmid
-	SimSenderShmid = -1;
+/**********************************************************************
+FUNCTION:	STREAM_REC *streamRec(SIM_STREAM *, unsigned long)
 
-	// detach sender's shmem from this process
-	shmdt(sender);
-	}
+PURPOSE:	Find the record of the ring at byte count pos.
 
-return 0;
+RETURNS:	pointer to the record
+***********************************************************************/
+
+STREAM_REC *streamRec(SIM_STREAM *s, unsigned long pos)
+{
+return (STREAM_REC *)(s->ring + (pos & (s->hdr->size - 1)));
 }
 
 /**********************************************************************
-FUNCTION:	int returnProxy(int)
+FUNCTION:	unsigned streamRecLen(unsigned)
 
-PURPOSE:	Return the true value of a received proxy.
+PURPOSE:	Return the bytes taken up in a ring by a record of nbytes.
 
-RETURNS:	The true value of a proxy should be >= 1.
-			(the value entered should be <= -2)
+RETURNS:	bytes, a multiple of 8
 ***********************************************************************/
 
-int returnProxy(int value)
+unsigned streamRecLen(unsigned nbytes)
 {
-return (value > -2) ? -1 : abs(value + 1);
+return (sizeof(STREAM_REC) + nbytes + 7) & ~7u;
 }
 
 /**********************************************************************
-FUNCTION:	int Locate(const char *, const char *, int, const int)
+FUNCTION:	void commitStream(SIM_STREAM *)
 
-PURPOSE:	Main purpose is to decide whether to use local or remote
-			name locating based on the type of host name (hName) string,
-			if any.
-			Returns the fd of the receive fifo of a sim receiver.
+PURPOSE:	Move the head of a stream on past the records reserved, waking
+			the consumer should it be asleep in ReadStream() and 
+			triggering its proxy should it have asked for it.
 
-RETURNS:	success: >= 0
-			failure: -1
+RETURNS:	nothing
+
+NOTE:		Called by CommitStream(), makeStreamRoom(), releaseStream().
 ***********************************************************************/
 
-int Locate(const char *hostName, const char *processName, int msgSize,
-		 												  const int protocol)
+void commitStream(SIM_STREAM *s)
 {
-const char *fn = "Locate";
-int rc = -1;
-pid_t pid = -1;
+STREAM_HDR *hdr = s->hdr;
 
-// is this process SIM enabled? 
-if (sim_check() == false)
-	{
-	sryLog("%s: SIM not active.\n", fn);
-	return -1;
-	}
+// only the producer moves the head on
+if (s->reserve == __atomic_load_n(&hdr->head, __ATOMIC_RELAXED))
+	return;
 
-// there must at least be a destination process name
-if (strlen(processName) == 0)
+__atomic_store_n(&hdr->head, s->reserve, __ATOMIC_SEQ_CST);
+
+// the consumer is woken once for each time it went to sleep
+if (__atomic_load_n(&hdr->consumerWaiting, __ATOMIC_SEQ_CST) &&
+			__atomic_exchange_n(&hdr->consumerWaiting, 0, __ATOMIC_SEQ_CST))
 	{
-	sryLog("%s: Missing receiver's SIM name.\n", fn);
-	return -1;
+	__atomic_add_fetch(&hdr->headWake, 1, __ATOMIC_SEQ_CST);
+	simFutex(&hdr->headWake, FUTEX_WAKE, 1);
 	}
 
-/*
-Local name locate: receiver treated as on same local host
-*/
+// and triggered once for each time it asked by way of ChkStream()
+if (hdr->proxy && __atomic_load_n(&hdr->notify, __ATOMIC_SEQ_CST) &&
+			__atomic_exchange_n(&hdr->notify, 0, __ATOMIC_SEQ_CST))
+	Trigger(s->consumerId, hdr->proxy);
+}
 
-// no entry in host field indicates a process on local host
-if (strlen(hostName) == 0)
+/**********************************************************************
+FUNCTION:	int makeStreamRoom(SIM_STREAM *, unsigned long)
+
+PURPOSE:	Make room for need more bytes in a full ring, as the stream's
+			policy says: wait for the consumer to read, drop the oldest
+			records unread, or fail.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by ReserveStream().
+***********************************************************************/
+
+int makeStreamRoom(SIM_STREAM *s, unsigned long need)
+{
+const char *fn = "makeStreamRoom";
+STREAM_HDR *hdr = s->hdr;
+STREAM_REC *rec = NULL;
+struct timespec second = {1, 0};
+unsigned long tail, next;
+int wake, rc;
+
+// the consumer cannot make room out of records it has not been sent
+commitStream(s);
+
+while (s->reserve + need - s->cached > hdr->size)
 	{
-	char fifoName[128];
+	if (__atomic_load_n(&hdr->closed, __ATOMIC_ACQUIRE))
+		{
+		sryLog("%s: Stream %s is closed.\n", fn, s->name);
+		return -1;
+		}
 
-	// find the receiver's fifo
-	rc = getFifoName(processName, fifoName);
-	if (rc == -1)
-		{	
-		sryLog("%s: Unable to find receiver's fifo.\n", fn);
+	// a full ring is to be expected, and so not logged
+	if (hdr->policy == SIM_STREAM_FAIL)
 		return -1;
+
+	if (hdr->policy == SIM_STREAM_DROP_OLDEST)
+		{
+		// all of the records are committed, and so may be dropped
+		tail = s->cached;
+		rec = streamRec(s, tail);
+		if (rec->nbytes == StreamPad)
+			next = tail + hdr->size - (tail & (hdr->size - 1));
+		else
+			next = tail + streamRecLen(rec->nbytes);
+
+		// unless the consumer has read the record meanwhile
+		if (__atomic_compare_exchange_n(&hdr->tail, &tail, next, false,
+										__ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE))
+			{
+			if (rec->nbytes != StreamPad)
+				__atomic_add_fetch(&hdr->dropped, 1, __ATOMIC_RELAXED);
+			tail = next;
+			}
+		s->cached = tail;
+		continue;
 		}
 
-// check if the receiver SIM name is in use
-pid = chkNamePid(processName);
-if (pid == -1)
-	{
-	sryLog("%s: receiver SIM name not in use.\n", fn);
-	return -1;
-	}
+	// the consumer only wakes a producer it knows to be waiting
+	__atomic_store_n(&hdr->producerWaiting, 1, __ATOMIC_SEQ_CST);
+	wake = __atomic_load_n(&hdr->tailWake, __ATOMIC_SEQ_CST);
+	s->cached = __atomic_load_n(&hdr->tail, __ATOMIC_SEQ_CST);
 
-// pid is real; is the receiver program still running?
-if (chkStatus(pid, processName) == false)
-	{
-	sryLog("%s: receiver not SIM enabled.\n", fn);
-	return -1;
-	}
+	rc = 0;
+	if (s->reserve + need - s->cached > hdr->size && 
+							!__atomic_load_n(&hdr->closed, __ATOMIC_ACQUIRE))
+		rc = syscall(SYS_futex, &hdr->tailWake, FUTEX_WAIT, wake, &second,
+																	NULL, 0);
 
-// open the fifo for triggering message passing
-rc = open(fifoName, O_WRONLY);
-if (rc == -1)
-	sryLog("%s: %s\n", fn, strerror(errno));
-    // leave Locate, done with local needs
-	return rc;
+	__atomic_store_n(&hdr->producerWaiting, 0, __ATOMIC_RELAXED);
+	s->cached = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+
+	// the consumer is looked for every second in case it has gone
+	if (rc == -1 && errno == ETIMEDOUT)
+		{
+		// errno must be cleared prior to getpriority() call
+		errno = 0;
+		if (getpriority(PRIO_PROCESS, hdr->pid) == -1 && errno == ESRCH)
+			{
+			// as good as closed; the commits fail from now on
+			__atomic_store_n(&hdr->closed, 1, __ATOMIC_RELEASE);
+			sryLog("%s: Consumer of stream %s is gone.\n", fn, s->name);
+			return -1;
+			}
+		}
 	}
 
-/*
- Remote name locate: receiver treated as on remote host
-*/
+return 0;
+}
 
-/*
-host name indicates that process is not local or is a surrogate loopback test
-using local host
-*/
-SUR_REQUEST_MSG lout;
-SUR_REQUEST_REPLY lin;
-SUR_NAME_LOCATE_MSG rout;
-SUR_NAME_LOCATE_REPLY rin;
-char surrogateParent[MAX_SIM_NAME_LEN + 1];
-char surrogateChild[MAX_SIM_NAME_LEN + 1];
-int wid = -1;
-unsigned i = 0;
-// int RemoteReceiverId[] is global
+/**********************************************************************
+FUNCTION:	bool advanceStream(SIM_STREAM *, unsigned long, unsigned long)
 
-// choose the communication protocol (TCP/IP, RS232 etc.)
-switch (protocol)
-	{
-	case SIM_RS232:
-		sprintf(surrogateParent, "%s", RS232_Surr_R);
-		break;
+PURPOSE:	Move the tail of a stream on from one record to the next once
+			it has been read, waking the producer should it be waiting for
+			room and there be plenty of it.
 
-	case SIM_LOCAL:
-	case SIM_TCP:
-	default:
-		sprintf(surrogateParent, "%s", TCP_Surr_R);
-		break;
-	}
-	
-// do a local name locate for *_surrogate_R
-// Note: the * indicates the surrogate protocol such as TCP etc.
-if ((wid = Locate("", surrogateParent, 0, protocol)) == -1)
+RETURNS:	true, or false should the producer have dropped the record 
+			while it was being read
+
+NOTE:		Called by ReadStream().
+***********************************************************************/
+
+bool advanceStream(SIM_STREAM *s, unsigned long from, unsigned long to)
+{
+STREAM_HDR *hdr = s->hdr;
+unsigned long used;
+
+if (hdr->policy == SIM_STREAM_DROP_OLDEST)
 	{
-	sryLog("%s: surrogate R name locate failure.\n", fn);
-	return -1;
+	if (!__atomic_compare_exchange_n(&hdr->tail, &from, to, false, 
+										__ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		return false;
 	}
+else
+	__atomic_store_n(&hdr->tail, to, __ATOMIC_SEQ_CST);
 
-// send request to surrogate_R for a local *_surrogate_r child
-lout.token = SUR_REQUEST;
-if (Send(wid, &lout, sizeof lout, &lin, sizeof lin) == -1)
+if (!__atomic_load_n(&hdr->producerWaiting, __ATOMIC_SEQ_CST))
+	return true;
+
+// a record at a time would have the two take turns at every record
+used = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE) - to;
+if ((used == 0 || used <= hdr->size / 2) &&
+			__atomic_exchange_n(&hdr->producerWaiting, 0, __ATOMIC_SEQ_CST))
 	{
-	sryLog("%s: surrogate R send failure.\n", fn);
-	return -1;
+	__atomic_add_fetch(&hdr->tailWake, 1, __ATOMIC_SEQ_CST);
+	simFutex(&hdr->tailWake, FUTEX_WAKE, 1);
 	}
 
-// set the name of the *_surrogate_r program
-switch (protocol)
-	{
-	case SIM_RS232:
-		sprintf(surrogateChild, "%s%d", RS232_Surr_r, lin.pid);
-		break;
+return true;
+}
 
-	case SIM_LOCAL:
-	case SIM_TCP:
-	default:
-		sprintf(surrogateChild, "%s%d", TCP_Surr_r, lin.pid);
-		break;
-	}
+/**********************************************************************
+FUNCTION:	int waitStream(SIM_STREAM *)
 
-//printf("remote locate: local name=%s\n", surrogateChild);
+PURPOSE:	Sleep on the head futex of a stream until the next commit, or
+			the producer closes. The producer is looked for every second 
+			in case it has gone without closing.
 
-// do a local name locate for *_surrogate_r_pid
-if ((rc = Locate("", surrogateChild, 0, protocol)) == -1)
+RETURNS:	success: 0, to look for a record again
+			failure: -1 if the producer is gone
+
+NOTE:		Called by ReadStream().
+***********************************************************************/
+
+int waitStream(SIM_STREAM *s)
+{
+const char *fn = "waitStream";
+STREAM_HDR *hdr = s->hdr;
+struct timespec second = {1, 0};
+pid_t producer;
+int wake, rc = 0;
+
+__atomic_store_n(&hdr->consumerWaiting, 1, __ATOMIC_SEQ_CST);
+wake = __atomic_load_n(&hdr->headWake, __ATOMIC_SEQ_CST);
+producer = __atomic_load_n(&hdr->producer, __ATOMIC_SEQ_CST);
+
+// the producer only wakes a consumer it knows to be waiting; look again
+if (__atomic_load_n(&hdr->head, __ATOMIC_SEQ_CST) == 
+									__atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE) &&
+	(producer != 0 || !__atomic_load_n(&hdr->connects, __ATOMIC_ACQUIRE)))
+	rc = syscall(SYS_futex, &hdr->headWake, FUTEX_WAIT, wake, &second, NULL, 0);
+
+__atomic_store_n(&hdr->consumerWaiting, 0, __ATOMIC_RELAXED);
+
+if (rc == -1 && errno == ETIMEDOUT && producer != 0)
 	{
-	sryLog("%s: surrogate r name locate failure.\n", fn);
-	return -1;
+	// errno must be cleared prior to getpriority() call
+	errno = 0;
+	if (getpriority(PRIO_PROCESS, producer) == -1 && errno == ESRCH)
+		{
+		// another producer may connect in its place
+		__atomic_compare_exchange_n(&hdr->producer, &producer, 0, false,
+										__ATOMIC_RELEASE, __ATOMIC_RELAXED);
+		sryLog("%s: Producer of stream %s is gone.\n", fn, s->name);
+		return -1;
+		}
 	}
 
-//printf("remote locate: found local %s\n", surrogateChild);
+return 0;
+}
 
-// make char based msg to send to surrogate_r_pid
-snprintf(rout.hdr.token, sizeof rout.hdr.token, "%d", SUR_NAME_LOCATE);
-strcpy(rout.hostName, hostName);
-strcpy(rout.sryName, processName);
-snprintf(rout.maxSize, sizeof rout.maxSize, "%d", msgSize);
+/**********************************************************************
+FUNCTION:	void releaseStream(SIM_STREAM *, bool)
 
-//printf("remote locate: begin send to %s\n", surrogateChild);
+PURPOSE:	Close a stream consumed by this thread, or disconnect from a 
+			stream as its producer, committing what was reserved. A forked
+			child merely detaches from the streams of its parent.
 
-// send remote name locate msg to surrogate_r_pid
-if (Send(rc, &rout, sizeof rout, &rin, sizeof rin) == -1)
+RETURNS:	nothing
+
+NOTE:		Called by CloseStream(), releaseAllStreams().
+***********************************************************************/
+
+void releaseStream(SIM_STREAM *s, bool detach)
+{
+char tname[MAX_FIFO_PATH_LEN + MAX_SIM_NAME_LEN + 20];
+STREAM_HDR *hdr = s->hdr;
+pid_t pid;
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
+
+if (!detach && s->producer)
 	{
-	sryLog("%s: r send failure.\n", fn);
-	return -1;
+	commitStream(s);
+
+	// another producer may connect; the consumer reads to the end
+	pid = SimParms.pid;
+	__atomic_compare_exchange_n(&hdr->producer, &pid, 0, false, 
+										__ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&hdr->headWake, 1, __ATOMIC_SEQ_CST);
+	simFutex(&hdr->headWake, FUTEX_WAKE, 1);
+	if (hdr->proxy && __atomic_exchange_n(&hdr->notify, 0, __ATOMIC_SEQ_CST))
+		Trigger(s->consumerId, hdr->proxy);
+	}
+else if (!detach)
+	{
+	// no new producers
+	deregisterName(s->name, SimParms.pid);
+	sprintf(tname, "%s/T_%s.%d", SimFifoPath, s->name, SimParms.pid);
+	remove(tname);
+
+	// nor any more records from the one connected
+	__atomic_store_n(&hdr->closed, 1, __ATOMIC_RELEASE);
+	__atomic_add_fetch(&hdr->tailWake, 1, __ATOMIC_SEQ_CST);
+	simFutex(&hdr->tailWake, FUTEX_WAKE, 1);
 	}
 
-//printf("remote locate: finished send to %s\n", surrogateChild);
+munmap(hdr, s->mapSize);
+s->hdr = NULL;
+}
 
-// convert result back to binary
-if (atoi(rin.result) == -1)
+/**********************************************************************
+FUNCTION:	void releaseAllStreams(bool)
+
+PURPOSE:	Close, or detach from, all of this thread's streams.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild().
+***********************************************************************/
+
+void releaseAllStreams(bool detach)
+{
+// SIM_STREAM SimStream[] is global
+
+for (int i = 0; i < MAX_NUM_STREAMS; i++)
+	if (SimStream[i].hdr != NULL)
+		releaseStream(&SimStream[i], detach);
+}
+
+/********************************************************************/
+/************************** SERVE FUNCTIONS *************************/
+/********************************************************************/
+
+/**********************************************************************
+FUNCTION:	void *serveWorker(void *)
+
+PURPOSE:	A Serve() worker thread. Takes up queued messages, runs the 
+			handler on them and sees that they are replied to.
+
+RETURNS:	NULL
+
+NOTE:		Started by Serve().
+***********************************************************************/
+
+void *serveWorker(void *ptr)
+{
+const char *fn = "serveWorker";
+SIM_SERVE *serve = (SIM_SERVE *)ptr;
+SIM_VIEW view;
+bool cached = false;
+int rc = 0;
+
+if (openServeWorker(serve) == -1)
 	{
-	sryLog("%s: remote locate failure.\n", fn);
-	return -1;
+	sryLog("%s: Worker not started.\n", fn);
+	return NULL;
 	}
 
-// add to the remote receiver offset table
-for (i = 0; i < MAX_NUM_REMOTE_RECEIVERS; i++)
+while (true)
 	{
-	if (RemoteReceiverId[i] == -1)
+	pthread_mutex_lock(&serve->lock);
+	while (serve->count == 0 && !serve->stop)
+		pthread_cond_wait(&serve->work, &serve->lock);
+	if (serve->stop)
 		{
-		RemoteReceiverId[i] = rc;
+		pthread_mutex_unlock(&serve->lock);
 		break;
 		}
-	}
+	view = serve->queue[serve->head];
+	cached = serve->cached[serve->head];
+	serve->head = (serve->head + 1) % MAX_NUM_SERVE_QUEUED;
+	serve->count--;
+	pthread_cond_signal(&serve->room);
+	pthread_mutex_unlock(&serve->lock);
 
-// the above loop didn't break ==> no room on table
-if (i == MAX_NUM_REMOTE_RECEIVERS)
-	{
-	sryLog("%s: no room on the remote receiver table.\n", fn);
-	return -1;
+	// the reply, from this thread, takes the sender off this thread's table
+	if (view.sender != NULL)
+		saveSenderId(view.sender);
+
+	rc = serve->handler(&view, serve->arg);
+
+	if (view.sender != NULL)
+		{
+		// not replied to by the handler
+		if (isSenderBlocked(view.sender))
+			ReplyError(view.sender);
+
+		// the dispatcher may now let go of the sender's shmem
+		releaseServedSender(serve->blocked, view.sender);
+
+		/*
+		An attachment the dispatcher could not cache is this thread's to 
+		detach, once the dispatcher no longer holds its address as blocked.
+		A cached one is the dispatcher's, even should the reply have failed; 
+		it is released when the sender is found to be gone.
+		*/
+		if (!cached)
+			unmapSenderShmem(view.sender);
+		}
+
+	if (rc == -1)
+		stopServe(serve);
 	}
 
-return rc;
+closeServeWorker();
+
+return NULL;
 }
 
 /**********************************************************************
-FUNCTION:	bool chkSender(void *sender)
+FUNCTION:	int openServeWorker(SIM_SERVE *)
 
-PURPOSE:	Checks on sender's existence. Called by a receiver between 
-			Receive() and Reply().
+PURPOSE:	Give a worker thread an instance of its own, in the dispatcher's
+			SIM name and pid so that it can reply, with tables of its own
+			and without fifos or shmem.
 
-RETURNS:	sender exists: true
-			sender does not exist: false
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by serveWorker().
 ***********************************************************************/
 
-bool chkSender(void *sender)
+int openServeWorker(SIM_SERVE *serve)
 {
-FCMSG_REC *rec = (FCMSG_REC *)sender;
+// WHO_AM_I SimParms is global
+// char *SimFifoPath is global
 
-return chkStatus(rec->pid, rec->whom);
-} 
+// the dispatcher's instance may well be the process' one
+if (openSimState() == -1)
+	return -1;
+
+SimParms = serve->parms;
+SimParms.rfd = -1;
+SimParms.yfd = -1;
+SimParms.shmid = -1;
+SimParms.shmPtr = (void *)NULL;
+SimParms.shmSize = 0;
+SimParms.mbox = NULL;
+SimParms.proxies = NULL;
+SimParms.ioEngine = SIM_IO_SYSCALL;
+strcpy(SimFifoPath, serve->fifoPath);
+SimServeWorker = true;
+
+initSimTables();
+
+return 0;
+}
 
 /**********************************************************************
-FUNCTION:	bool chkReceiver(const char *receiverSIMname, pid_t pid)
+FUNCTION:	void closeServeWorker(void)
 
-PURPOSE:	Can be used between multiple sends to the same receiver.
+PURPOSE:	Let go of what a worker thread opened for itself.
 
-RETURNS:	receiver exists: true
-			receiver does not exist: false
+RETURNS:	nothing
+
+NOTE:		Called by serveWorker(), closeSRY().
 ***********************************************************************/
 
-bool chkReceiver(const char *name, pid_t pid)
+void closeServeWorker()
 {
-bool ret = true;
+// WHO_AM_I SimParms is global
 
-if (!pid)
-	pid = chkNamePid(name);
+closeAllReplyFifos();
+releaseAllLocatedReceivers();
+releaseBlockedSenders(false);
+closeRegistry();
 
-if (pid != -1)
-	{
-	// pid is real; is the program still running?
-	if (chkStatus(pid, name) == false)
-		{
-		ret = false;
-		}
-	}
+SimServeWorker = false;
+SimParms.pid = -1;
 
-return ret;
+closeSimState();
 }
 
 /**********************************************************************
-FUNCTION:	int getSenderName(void *, char *senderName)
+FUNCTION:	void stopServe(SIM_SERVE *)
 
-PURPOSE:	Returns the local sender's sim name after a Send() call.
+PURPOSE:	Stop the workers and wake the dispatcher from its wait on the
+			receive fifo by way of the serving's eventfd.
 
-NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
-			As well, make certain that the pointer senderName that is passed
-			in points to a character array that is large enough to accomodate 
-			the the sim name or the memcpy will fail.
+RETURNS:	nothing
 
-RETURNS:	sender exists: set sender's sim name and return 0 
-			sender shmem ptr is NULL: -1
+NOTE:		Called by serveWorker(). The worker's own SIM instance plays no
+			part in it.
 ***********************************************************************/
 
-int getSenderName(void *sender, char *senderName)
+void stopServe(SIM_SERVE *serve)
 {
-FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
-int ret = 0;
+const char *fn = "stopServe";
+uint64_t one = 1;
+int stopped = 0;
+
+pthread_mutex_lock(&serve->lock);
+stopped = serve->stop;
+serve->stop = 1;
+pthread_cond_broadcast(&serve->work);
+pthread_cond_broadcast(&serve->room);
+pthread_mutex_unlock(&serve->lock);
+
+// another worker has seen to it
+if (stopped)
+	return;
+
+if (write(serve->wake, &one, sizeof(one)) != sizeof(one))
+	sryLog("%s: Unable to wake the dispatcher-%s.\n", fn, strerror(errno));
+}
 
-if (sender == NULL)
-	ret = -1;
-else
-	memcpy(senderName, msgPtr->whom, MAX_PROGRAM_NAME_LEN);
+/**********************************************************************
+FUNCTION:	int releaseServedSender(BLOCKED_SENDERS *, void *)
 
-return ret;
+PURPOSE:	Remove a sender from a table of reply-blocked senders, which 
+			may be another thread's. The table's lock keeps its owner from
+			growing it meanwhile.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by serveWorker().
+***********************************************************************/
+
+int releaseServedSender(BLOCKED_SENDERS *blocked, void *sender)
+{
+int rc = -1;
+
+pthread_mutex_lock(&blocked->lock);
+rc = dropBlockedSender(blocked, sender);
+pthread_mutex_unlock(&blocked->lock);
+
+return rc;
 }
 
+/********************************************************************/
+/************************ IO_URING FUNCTIONS ************************/
+/********************************************************************/
+
+#ifndef SIM_NO_IO_URING
+
 /**********************************************************************
-FUNCTION:	pid_t getSenderPid(void *)
+FUNCTION:	int openUring(void)
 
-PURPOSE:	Returns the value of the local sender's pid after a Send() call.
+PURPOSE:	Set up the receiver's io_uring: map its rings and register the
+			receive fifo as file 0 and room for the reply fifos after it.
 
-NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+RETURNS:	success: 0
+			failure: -1
 
-RETURNS:	sender exists: pid_t
-			sender shmem ptr is NULL: -1
+NOTE:		Called by openSRYopts().
 ***********************************************************************/
 
-pid_t getSenderPid(void *sender)
+int openUring()
 {
-FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
-pid_t ret;
+const char *fn = "openUring";
+struct io_uring_params params;
+int files[MAX_NUM_REPLY_FIFOS + 1];
+unsigned char *sq, *cq;
+void *ring;
+// SIM_URING SimUring is global
+// WHO_AM_I SimParms is global
 
-if (sender == NULL)
-	ret = -1;
-else
-	ret = msgPtr->pid;
+memset(&SimUring, 0, sizeof(SIM_URING));
+memset(&params, 0, sizeof(params));
 
-return ret;
+SimUring.fd = syscall(__NR_io_uring_setup, 2 * MAX_NUM_URING_TRIGGERS, &params);
+if (SimUring.fd == -1)
+	return -1;
+SimUring.entries = params.sq_entries;
+
+SimUring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+SimUring.cqRingSize = params.cq_off.cqes + 
+							params.cq_entries * sizeof(struct io_uring_cqe);
+
+// newer kernels map both rings at once
+if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+	if (SimUring.cqRingSize > SimUring.sqRingSize)
+		SimUring.sqRingSize = SimUring.cqRingSize;
+	SimUring.cqRingSize = 0;
+	}
+
+ring = mmap(NULL, SimUring.sqRingSize, PROT_READ | PROT_WRITE, 
+			MAP_SHARED | MAP_POPULATE, SimUring.fd, IORING_OFF_SQ_RING);
+if (ring == MAP_FAILED)
+	goto fail;
+SimUring.sqRing = ring;
+
+if (SimUring.cqRingSize)
+	{
+	ring = mmap(NULL, SimUring.cqRingSize, PROT_READ | PROT_WRITE, 
+				MAP_SHARED | MAP_POPULATE, SimUring.fd, IORING_OFF_CQ_RING);
+	if (ring == MAP_FAILED)
+		goto fail;
+	SimUring.cqRing = ring;
+	}
+
+ring = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), 
+			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, SimUring.fd, 
+			IORING_OFF_SQES);
+if (ring == MAP_FAILED)
+	goto fail;
+SimUring.sqes = (struct io_uring_sqe *)ring;
+
+sq = (unsigned char *)SimUring.sqRing;
+cq = SimUring.cqRingSize ? (unsigned char *)SimUring.cqRing : sq;
+SimUring.sqHead = (unsigned *)(sq + params.sq_off.head);
+SimUring.sqTail = (unsigned *)(sq + params.sq_off.tail);
+SimUring.sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+SimUring.sqArray = (unsigned *)(sq + params.sq_off.array);
+SimUring.cqHead = (unsigned *)(cq + params.cq_off.head);
+SimUring.cqTail = (unsigned *)(cq + params.cq_off.tail);
+SimUring.cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+SimUring.cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+// receive fifo and as yet unopened reply fifos
+files[0] = SimParms.rfd;
+for (int i = 1; i <= MAX_NUM_REPLY_FIFOS; i++)
+	files[i] = -1;
+if (syscall(__NR_io_uring_register, SimUring.fd, IORING_REGISTER_FILES, 
+										files, MAX_NUM_REPLY_FIFOS + 1) == -1)
+	{
+	sryLog("%s: Unable to register files-%s.\n", fn, strerror(errno));
+	goto fail;
+	}
+
+return 0;
+
+fail:
+closeUring(false);
+return -1;
 }
 
 /**********************************************************************
-FUNCTION:	int getSenderShmemSize(void *)
+FUNCTION:	void closeUring(bool)
 
-PURPOSE:	Returns the value of the local sender's shmem size in bytes after a 
-			Send() call.
+PURPOSE:	Tear down the receiver's io_uring, if set up. When flushing,
+			the replies in flight are seen through first.
 
-NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+RETURNS:	nothing
 
-RETURNS:	sender exists: int
-			sender shmem ptr is NULL: -1
+NOTE:		Called by openUring(), closeSRY(), closeSRYchild().
 ***********************************************************************/
 
-pid_t getSenderShmemSize(void *sender)
+void closeUring(bool flush)
 {
-FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
-int ret = -1;
+// SIM_URING SimUring is global
+// WHO_AM_I SimParms is global
 
-if (sender == NULL)
-	ret = -1;
-else
-	ret = msgPtr->shmsize;
+if (SimUring.entries == 0)
+	return;
 
-return ret;
+if (flush && SimParms.ioEngine == SIM_IO_URING)
+	{
+	enterUring(0);
+	while (SimUring.replies > 0)
+		if (enterUring(1) == -1)
+			break;
+	}
+
+// no more registered file updates
+if (SimParms.ioEngine == SIM_IO_URING)
+	SimParms.ioEngine = SIM_IO_SYSCALL;
+
+if (SimUring.sqes != NULL)
+	munmap(SimUring.sqes, SimUring.entries * sizeof(struct io_uring_sqe));
+if (SimUring.cqRing != NULL)
+	munmap(SimUring.cqRing, SimUring.cqRingSize);
+if (SimUring.sqRing != NULL)
+	munmap(SimUring.sqRing, SimUring.sqRingSize);
+close(SimUring.fd);
+
+memset(&SimUring, 0, sizeof(SIM_URING));
 }
 
 /**********************************************************************
-FUNCTION:	int getSenderMsgSize(void *)
+FUNCTION:	void setUringFile(int, int)
 
-PURPOSE:	Returns the value of the local sender's message size in bytes after 
-			a Send() call.
+PURPOSE:	Replace a registered file, ie. a reply fifo opened or closed.
 
-NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+RETURNS:	nothing
 
-RETURNS:	sender exists: int
-			sender shmem ptr is NULL: -1
+NOTE:		Called by openReplyFifo(), closeReplyFifo().
 ***********************************************************************/
 
-int getSenderMsgSize(void *sender)
+void setUringFile(int slot, int fd)
 {
-FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
-int ret;
+const char *fn = "setUringFile";
+struct io_uring_files_update update;
+// SIM_URING SimUring is global
+// WHO_AM_I SimParms is global
 
-if (sender == NULL)
-	ret = -1;
-else
-	ret = msgPtr->nbytes;
+if (SimParms.ioEngine != SIM_IO_URING)
+	return;
 
-return ret;
+memset(&update, 0, sizeof(update));
+update.offset = slot;
+update.fds = (unsigned long)&fd;
+
+if (syscall(__NR_io_uring_register, SimUring.fd, 
+							IORING_REGISTER_FILES_UPDATE, &update, 1) != 1)
+	sryLog("%s: Unable to register file %d-%s.\n", fn, slot, strerror(errno));
 }
 
 /**********************************************************************
-FUNCTION:	int getSenderRplySize(void *)
+FUNCTION:	int queueUring(int, int, void *, unsigned, unsigned long long)
 
-PURPOSE:	Returns the value of the local sender's reply message size in bytes 
-			after a Send() call.
+PURPOSE:	Queue a read or write of a registered file. Nothing is 
+			submitted unless the submission queue is full.
 
-NOTE:		If a garbage pointer is passed in, a garbage value will be returned.
+RETURNS:	success: 0
+			failure: -1
 
-RETURNS:	sender exists: int
-			sender shmem ptr is NULL: -1
+NOTE:		Called by readUringTrigger(), writeUringReply().
 ***********************************************************************/
 
-int getSenderRplySize(void *sender)
+int queueUring(int op, int slot, void *buf, unsigned len, unsigned long long data)
 {
-FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
-int ret;
+struct io_uring_sqe *sqe;
+unsigned tail;
+// SIM_URING SimUring is global
 
-if (sender == NULL)
-	ret = -1;
-else
-	ret = msgPtr->ybytes;
+tail = *SimUring.sqTail;
+if (tail - __atomic_load_n(SimUring.sqHead, __ATOMIC_ACQUIRE) == SimUring.entries)
+	{
+	if (enterUring(0) == -1)
+		return -1;
+	}
 
-return ret;
+sqe = &SimUring.sqes[tail & *SimUring.sqMask];
+memset(sqe, 0, sizeof(struct io_uring_sqe));
+sqe->opcode = op;
+sqe->flags = IOSQE_FIXED_FILE;
+sqe->fd = slot;
+sqe->addr = (unsigned long)buf;
+sqe->len = len;
+sqe->off = (unsigned long long)-1; // fifos have no offset
+sqe->user_data = data;
+
+SimUring.sqArray[tail & *SimUring.sqMask] = tail & *SimUring.sqMask;
+__atomic_store_n(SimUring.sqTail, tail + 1, __ATOMIC_RELEASE);
+
+return 0;
 }
 
 /**********************************************************************
-FUNCTION:	int rfd(void)
+FUNCTION:	int enterUring(unsigned)
 
-PURPOSE:	Return the file descriptor to the receive fifo
+PURPOSE:	Submit whatever is queued and, if asked, wait for at least
+			that many completions. Completions are then reaped.
 
-RETURNS:	success: a file descriptor > 2
+RETURNS:	success: 0
 			failure: -1
+
+NOTE:		Called by closeUring(), queueUring(), readUringTrigger(), 
+			writeUringReply().
 ***********************************************************************/
 
-int rfd(void)
+int enterUring(unsigned wait)
 {
-// WHO_AM_I SimParms is global 
-return SimParms.rfd;
+const char *fn = "enterUring";
+unsigned toSubmit;
+long rc;
+// SIM_URING SimUring is global
+
+do	{
+	toSubmit = *SimUring.sqTail - __atomic_load_n(SimUring.sqHead, __ATOMIC_ACQUIRE);
+	rc = syscall(__NR_io_uring_enter, SimUring.fd, toSubmit, wait, 
+						wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	}
+while (rc == -1 && errno == EINTR);
+
+reapUring();
+
+if (rc == -1)
+	{
+	sryLog("%s: io_uring_enter error-%s.\n", fn, strerror(errno));
+	return -1;
+	}
+
+return 0;
 }
 
 /**********************************************************************
-FUNCTION:	int yfd(void)
+FUNCTION:	void reapUring(void)
 
-PURPOSE:	Return the file descriptor to the reply fifo
+PURPOSE:	Go through the completions. A reply write that failed, most
+			likely on a stale reply fifo, is tried again by way of a 
+			plain write().
 
-RETURNS:	success: a file descriptor > 2
-			failure: -1
+RETURNS:	nothing
+
+NOTE:		Called by enterUring().
 ***********************************************************************/
 
-int yfd(void)
+void reapUring()
 {
-// WHO_AM_I SimParms is global
-return SimParms.yfd;
+const char *fn = "reapUring";
+struct io_uring_cqe *cqe;
+URING_REPLY *reply;
+unsigned head;
+// SIM_URING SimUring is global
+
+head = *SimUring.cqHead;
+while (head != __atomic_load_n(SimUring.cqTail, __ATOMIC_ACQUIRE))
+	{
+	cqe = &SimUring.cqes[head & *SimUring.cqMask];
+	if (cqe->user_data == URING_TRIGGER_READ)
+		{
+		SimUring.readResult = cqe->res;
+		SimUring.reading = false;
+		}
+	else
+		{
+		reply = &SimUring.reply[cqe->user_data];
+		if (cqe->res != sizeof(FIFO_MSG) && 
+				putReplyFifo(reply->pid, reply->whom, (char *)&reply->msg) == -1)
+			sryLog("%s: Unable to reply to %s.\n", fn, reply->whom);
+		reply->busy = false;
+		SimUring.replies--;
+		}
+	head++;
+	}
+
+__atomic_store_n(SimUring.cqHead, head, __ATOMIC_RELEASE);
 }
 
 /**********************************************************************
-FUNCTION:	void simRcopy(void *, void *, unsigned)
+FUNCTION:	int readUringTrigger(char *)
 
-PURPOSE:	Copy unsigned nbytes from the sender's shmem pointer
-			to the desired address void *dst 
+PURPOSE:	Hand over the next trigger message. When none are left from
+			the last read, as many as are waiting are read at once, the
+			one io_uring_enter() also reaping the reply writes done.
 
-			Follows a Receiver(&id, NULL, 0) call.
+RETURNS:	success: number of bytes read
+			failure: -1
 
-RETURNS:	nothing
+NOTE:		Called by readTrigger().
 ***********************************************************************/
 
-void simRcopy(void *sender, void *dst, unsigned nbytes)
+int readUringTrigger(char *fifoBuf)
 {
-FCMSG_REC *msgPtr = (FCMSG_REC *)sender;
+// SIM_URING SimUring is global
 
-memcpy(dst, (void *)&msgPtr->data, nbytes);
-} 
- 
-/**********************************************************************
-FUNCTION:	void simScopy(void *, unsigned)
+if (SimUring.count == 0)
+	{
+	// a ReceiveTimed() deadline is waited out before the read is queued
+	if (SimDeadline.set && pollDeadline(SimParms.rfd) == -1)
+		return -1;
 
-PURPOSE:	Copy unsigned nbytes from the sender's global shmem pointer
-			to the desired address void * 
+	if (queueUring(IORING_OP_READ, 0, SimUring.trigger, 
+					sizeof(SimUring.trigger), URING_TRIGGER_READ) == -1)
+		return -1;
 
-			Follows a Send(id, void *, NULL, outSize, inSize) call
+	SimUring.reading = true;
+	while (SimUring.reading)
+		{
+		if (enterUring(1) == -1)
+			return -1;
+		}
 
-RETURNS:	nothing
-***********************************************************************/
+	// each trigger is a single write to a pipe and so read whole
+	if (SimUring.readResult <= 0)
+		return SimUring.readResult == 0 ? 0 : -1;
+	SimUring.count = SimUring.readResult / sizeof(FIFO_MSG);
+	SimUring.next = 0;
+	}
 
-void simScopy(void *dst, unsigned nbytes)
-{
-FCMSG_REC *msgPtr = (FCMSG_REC *)SimParms.shmPtr;
+memcpy(fifoBuf, &SimUring.trigger[SimUring.next], sizeof(FIFO_MSG));
+SimUring.next++;
+SimUring.count--;
 
-memcpy(dst, (void *)&msgPtr->data, nbytes);
+return sizeof(FIFO_MSG);
 }
 
-/********************************************************************/
-/****************** MESSAGE SHARED MEMORY FUNCTIONS *****************/
-/********************************************************************/
-
 /**********************************************************************
-FUNCTION:	int createShmem(unsigned)
+FUNCTION:	int writeUringReply(FCMSG_REC *, char *)
 
-PURPOSE:	Create and attach shared memory used for a message passing
-			buffer.
+PURPOSE:	Queue the write of a fifo message to a sender's reply fifo 
+			and submit it. The write is never held back for the next 
+			trigger read: Reply() has told the caller the sender is 
+			replied to, and the receiver may go on to Send() to it.
 
 RETURNS:	success: 0
 			failure: -1
-**********************************************************************/
 
-int createShmem(unsigned bufSize)
-{
-const char *fn = "createShmem";
-unsigned memSize = 0;
-int i = 0;
-long pagesize = 0;
-// WHO_AM_I SimParms is global
+NOTE:		Called by writeReplyFifo().
+***********************************************************************/
 
-// calculate the shmem size based on the PAGE_SIZE
-pagesize = sysconf(_SC_PAGESIZE);
+int writeUringReply(FCMSG_REC *msgPtr, char *fifoBuf)
+{
+// SIM_URING SimUring is global
+// int ReplyFifoHint is global
+URING_REPLY *reply = NULL;
+int i, slot;
 
-// note that the loop limit is merely to prevent runaway
-for (memSize = pagesize, i = 1; i <= 10000; i++, memSize += pagesize)
-	if ( (bufSize + sizeof(FCMSG_REC)) <= memSize )
-		break;
+/*
+The write goes by the registered copy of the reply fifo. With fewer replies in
+flight than there are cached reply fifos, the least recently used one that 
+makes room for another is never one of theirs.
+*/
+if (openReplyFifo(msgPtr->pid, msgPtr->whom) == -1)
+	return -1;
+slot = ReplyFifoHint + 1;
 
-// create shmem for messages
-SimParms.shmid = shmget(IPC_PRIVATE, memSize, 0777 | IPC_CREAT);
-if (SimParms.shmid == -1)
+// a free reply, waiting on those in flight if need be
+while (true)
 	{
-	sryLog("%s: Unable to create shmem-%s.\n", fn, strerror(errno));
-	return -1;
+	for (i = 0; i < MAX_NUM_URING_TRIGGERS; i++)
+		{
+		if (!SimUring.reply[i].busy)
+			{
+			reply = &SimUring.reply[i];
+			break;
+			}
+		}
+	if (reply != NULL)
+		break;
+	if (enterUring(1) == -1)
+		return -1;
 	}
 
-// attach the shmem for messages to this process
-SimParms.shmPtr = (void *)shmat(SimParms.shmid, (void *)0, 0);
-if ((void *)SimParms.shmPtr == (void *)-1)
-	{
-	sryLog("%s: Unable to attach shmem to process-%s\n",fn, 
-															strerror(errno));
+reply->pid = msgPtr->pid;
+strcpy(reply->whom, msgPtr->whom);
+memcpy(&reply->msg, fifoBuf, sizeof(FIFO_MSG));
+
+if (queueUring(IORING_OP_WRITE, slot, &reply->msg, 
+												sizeof(FIFO_MSG), i) == -1)
 	return -1;
-	}
+reply->busy = true;
+SimUring.replies++;
 
-// release shmem if and when owner dies by an untrappable signal
-shmctl(SimParms.shmid, IPC_RMID, 0);
+return enterUring(0);
+}
 
-// this the maximum size for a message
-SimParms.shmSize = memSize;
+#else
 
-return 0;
+/*
+Built with SIM_NO_IO_URING: openUring() always fails and so the receiver goes
+on with syscalls; nothing else is ever called.
+*/
+
+int openUring()
+{
+errno = ENOSYS;
+return -1;
 }
 
-/**********************************************************************
-FUNCTION:	int detachShmem(void)
+void closeUring(bool flush)
+{
+(void)flush;
+}
 
-PURPOSE:	Detach shared memory used for a message passing	buffer.
+void setUringFile(int slot, int fd)
+{
+(void)slot;
+(void)fd;
+}
 
-RETURNS:	success: 0
-			failure: -1
-**********************************************************************/	
+int queueUring(int op, int slot, void *buf, unsigned len, unsigned long long data)
+{
+(void)op; (void)slot; (void)buf; (void)len; (void)data;
+return -1;
+}
 
-int detachShmem()
+int enterUring(unsigned wait)
 {
-const char *fn = "detachShmem";
-// WHO_AM_I SimParms is global
+(void)wait;
+return -1;
+}
 
-// detach shmem
-if (shmdt(SimParms.shmPtr) == -1)
-	{
-	sryLog("%s: Unable to detach shmem-%s.\n", fn, strerror(errno));
-	return -1;
-	}
+void reapUring()
+{
+}
 
-// this the maximum size for a message, used as a check
-SimParms.shmSize = 0;
+int readUringTrigger(char *fifoBuf)
+{
+(void)fifoBuf;
+return -1;
+}
 
-return 0;
+int writeUringReply(FCMSG_REC *msgPtr, char *fifoBuf)
+{
+(void)msgPtr;
+(void)fifoBuf;
+return -1;
 }
 
+#endif
+
 /********************************************************************/
-/************************* FIFO FUNCTIONS ***************************/
+/************************* REACTOR FUNCTIONS ************************/
 /********************************************************************/
 
 /**********************************************************************
-FUNCTION:	int createFifos(void)
+FUNCTION:	int openReactor(void)
 
-PURPOSE:	Name, create and open receive and reply fifos.
+PURPOSE:	Make the thread's epoll set and timerfd if not yet made.
 
-RETURNS:	success (valid fifo fd): 0
-			failure (no valid fifo): -1
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by ReactorMsg(), ReactorFd(), ReactorTimer(), Reactor().
 ***********************************************************************/
 
-int createFifos()
+int openReactor()
 {
-const char *fn = "createFifos";
-/*
-more space than required, typically a path and name
-such as "/var/tmp/simName.12345" is usual
-*/
-char rname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
-char yname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
-// WHO_AM_I SimParms is global; partly populated in openSRY()
-// char *SimFifoPath is global; set in openSRY()
+const char *fn = "openReactor";
+struct epoll_event ev;
+// SIM_REACTOR SimReactor is global
 
-// receive fifo
-sprintf(rname, "%s/R_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
-// reply fifo
-sprintf(yname, "%s/Y_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+if (SimReactor.pid == getpid())
+	return 0;
 
-// create receive fifo
-if (mkfifo(rname, 0666) == -1)
-	{
-	sryLog("%s: Unable to create fifo %s-%s.\n", fn, rname, strerror(errno));
-	return -1;
-	}
-// create reply fifo
-if (mkfifo(yname, 0666) == -1)
-	{
-	sryLog("%s: Unable to create fifo %s-%s.\n", fn, yname, strerror(errno));
-	return -1;
-	}
+// a forked child starts afresh rather than change its parent's epoll set
+closeReactor();
 
-// receive fifo; masks the mode 0666 with user's umask
-if (chmod(rname, 0666) == -1)
-	{
-	sryLog("%s: Unable to chmod fifo %s-%s.\n", fn, rname, strerror(errno));
-	return -1;
-	}
-// reply fifo; masks the mode 0666 with user's umask
-if (chmod(yname, 0666) == -1)
+SimReactor.epfd = epoll_create1(EPOLL_CLOEXEC);
+if (SimReactor.epfd == -1)
 	{
-	sryLog("%s: Unable to chmod fifo %s-%s.\n", fn, yname, strerror(errno));
+	sryLog("%s: Unable to create epoll set-%s.\n", fn, strerror(errno));
 	return -1;
 	}
+SimReactor.pid = getpid();
 
-// open receive fifo, close when not needed 
-SimParms.rfd = open(rname, O_RDWR);
-if (SimParms.rfd == -1)
-	{
-	sryLog("%s: Unable to open fifo %s-%s.\n", fn, rname, strerror(errno));
-	return -1;
-	}
-// open reply fifo for use, close when not needed 
-SimParms.yfd = open(yname, O_RDWR);
-if (SimParms.yfd == -1)
+SimReactor.tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+ev.events = EPOLLIN;
+ev.data.u64 = REACTOR_TIMERS;
+if (SimReactor.tfd == -1 || 
+		epoll_ctl(SimReactor.epfd, EPOLL_CTL_ADD, SimReactor.tfd, &ev) == -1)
 	{
-	sryLog("%s: Unable to open fifo %s-%s.\n", fn, yname, strerror(errno));
+	sryLog("%s: Unable to create timer-%s.\n", fn, strerror(errno));
+	closeReactor();
 	return -1;
 	}
 
@@ -1785,168 +11171,199 @@ return 0;
 }
 
 /**********************************************************************
-FUNCTION:	int detachFifos(void)
+FUNCTION:	void closeReactor(void)
 
-PURPOSE:	Close receive and reply fifo file descriptors.
+PURPOSE:	Close the thread's epoll set and timerfd and forget its 
+			callbacks.
+
+RETURNS:	nothing
+
+NOTE:		Called by openReactor(), closeSRY(), closeSRYchild().
+***********************************************************************/
+
+void closeReactor()
+{
+// SIM_REACTOR SimReactor is global
+
+if (SimReactor.pid == 0)
+	return;
+
+close(SimReactor.epfd);
+if (SimReactor.tfd != -1)
+	close(SimReactor.tfd);
+SimReactor.epfd = -1;
+SimReactor.tfd = -1;
+SimReactor.pid = 0;
+SimReactor.handler = NULL;
+
+for (int i = 0; i < MAX_NUM_REACTOR_FDS; i++)
+	SimReactor.fd[i].cb = NULL;
+
+for (int i = 0; i < MAX_NUM_REACTOR_TIMERS; i++)
+	SimReactor.timer[i].cb = NULL;
+}
+
+/**********************************************************************
+FUNCTION:	int armReactorTimer(void)
+
+PURPOSE:	Set the timerfd to expire with the earliest timer, or disarm 
+			it if there are none.
 
 RETURNS:	success: 0
 			failure: -1
+
+NOTE:		Called by ReactorTimer(), ReactorCancel(), fireReactorTimers().
 ***********************************************************************/
 
-int detachFifos()
+int armReactorTimer()
 {
-// WHO_AM_I SimParms is global; populated in openSRY()
+const char *fn = "armReactorTimer";
+struct itimerspec its;
+REACTOR_TIMER *timer = NULL, *first = NULL;
+// SIM_REACTOR SimReactor is global
 
-// close the receive fifo
-if (SimParms.rfd != -1)
+for (int i = 0; i < MAX_NUM_REACTOR_TIMERS; i++)
 	{
-	close(SimParms.rfd);
-	SimParms.rfd = -1;
+	timer = &SimReactor.timer[i];
+	if (timer->cb == NULL)
+		continue;
+	if (first == NULL || timer->due.tv_sec < first->due.tv_sec ||
+					(timer->due.tv_sec == first->due.tv_sec && 
+							timer->due.tv_nsec < first->due.tv_nsec))
+		first = timer;
 	}
 
-// close the reply fifo
-if (SimParms.yfd != -1)
-	{
-	close(SimParms.yfd);
-	SimParms.yfd = -1;
+// all zero disarms
+memset(&its, 0, sizeof its);
+if (first != NULL)
+	its.it_value = first->due;
+
+if (timerfd_settime(SimReactor.tfd, TFD_TIMER_ABSTIME, &its, NULL) == -1)
+	{
+	sryLog("%s: Unable to set timer-%s.\n", fn, strerror(errno));
+	return -1;
 	}
 
 return 0;
 }
 
 /**********************************************************************
-FUNCTION:	int deleteFifos(void)
+FUNCTION:	int fireReactorTimers(void)
 
-PURPOSE:	Remove receive and reply fifos.
+PURPOSE:	Run the callbacks of the timers that are due and set the next
+			expiry of the periodic ones.
 
-RETURNS:	success: 0
+RETURNS:	carry on: 0
+			stop: 1
 			failure: -1
+
+NOTE:		Called by Reactor().
 ***********************************************************************/
 
-int deleteFifos()
+int fireReactorTimers()
 {
-//const char *fn = "deleteFifos";
-/*
-more space than required, typically a path and name
-such as "/var/tmp/simName.12345" is usual
-*/
-char rname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
-char yname[MAX_FIFO_PATH_LEN + MAX_PROGRAM_NAME_LEN + 10];
-// WHO_AM_I SimParms is global; populated in openSRY()
-// char *SimFifoPath is global; set early on in openSRY()
+REACTOR_TIMER *timer = NULL;
+struct timespec now;
+uint64_t expirations = 0;
+int ret = 0;
+SIM_CALLBACK cb = NULL;
+// SIM_REACTOR SimReactor is global
 
-// receive fifo
-sprintf(rname, "%s/R_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
-// reply fifo
-sprintf(yname, "%s/Y_%s.%d", SimFifoPath, SimParms.whom, SimParms.pid);
+// nothing to do if a cancelled or reset timer got here first
+if (read(SimReactor.tfd, &expirations, sizeof expirations) != 
+														sizeof expirations)
+	return 0;
 
-// close Receive and replY fifos
-detachFifos();
+clock_gettime(CLOCK_MONOTONIC, &now);
 
-// check for presence of receive fifo
-if (access(rname, F_OK) == 0)
+for (int i = 0; i < MAX_NUM_REACTOR_TIMERS && ret == 0; i++)
 	{
-	// delete the receive fifo
-	if (remove(rname) == -1)
+	timer = &SimReactor.timer[i];
+	if (timer->cb == NULL || timer->due.tv_sec > now.tv_sec ||
+			(timer->due.tv_sec == now.tv_sec && timer->due.tv_nsec > now.tv_nsec))
+		continue;
+
+	// settled before the callback, which may cancel or reuse the timer
+	cb = timer->cb;
+	if (!timer->periodic)
+		timer->cb = NULL;
+	else
 		{
-		/*
-		sryLog("%s: Unable to remove fifo %s-%s.\n", fn, rname, 
-														strerror(errno));
-		return -1;
-		*/
+		// expiries missed while busy are not made up for
+		while (timer->due.tv_sec < now.tv_sec || (timer->due.tv_sec == 
+						now.tv_sec && timer->due.tv_nsec <= now.tv_nsec))
+			{
+			timer->due.tv_sec += timer->msecs / 1000;
+			timer->due.tv_nsec += (timer->msecs % 1000) * 1000000L;
+			if (timer->due.tv_nsec >= 1000000000L)
+				{
+				timer->due.tv_sec++;
+				timer->due.tv_nsec -= 1000000000L;
+				}
+			}
 		}
-	}		
 
-// check for presence of reply fifo
-if (access(yname, F_OK) == 0)
-	{
-	// delete the reply fifo
-	if (remove(yname) == -1)
-		{
-		/*
-		sryLog("%s: Unable to remove fifo %s-%s.\n", fn, yname, 
-														strerror(errno));
-		return -1;
-		*/
-		}
+	if (cb(i, timer->arg) == -1)
+		ret = 1;
 	}
-	
-return 0;
-}
-
-/**********************************************************************
-FUNCTION:	int readFifoMsg(int, char *)
-
-PURPOSE:	read any pending bytes from specified fifo fd.
-
-RETURNS:	success: sizeof FIFO_MSG
-			failure: != sizeof FIFO_MSG
-**********************************************************************/	
-
-int readFifoMsg(int fd, char *buf)
-{
-int numBytes = 0, bytesToGo = 0, rc = 0;
-char *p = buf;
 
-for (int i = 0; i < 10; i++)
-	{
-	bytesToGo = sizeof(FIFO_MSG) - numBytes;
-	if (bytesToGo <= 0)
-		break;
-	rc = read(fd, p, bytesToGo);
-	numBytes += rc;
-	p += rc;
-	}
+if (armReactorTimer() == -1)
+	return -1;
 
-return numBytes;
+return ret;
 }
 
 /**********************************************************************
-FUNCTION:	int getFifoName(const char *, char *)
+FUNCTION:	int dispatchReactorMsg(void)
 
-PURPOSE:	Find a receive fifo based on the sim name.
+PURPOSE:	Receive a message or proxy and pass it to the ReactorMsg() 
+			handler.
 
-RETURNS:	success: 0 
+RETURNS:	carry on: 0
+			stop: 1
 			failure: -1
+
+NOTE:		Called by Reactor().
 ***********************************************************************/
 
-int getFifoName(const char *simName, char *fifoName)
+int dispatchReactorMsg()
 {
-const char *fn = "getFifoName";
-DIR *directory = NULL;
-struct dirent *file = NULL;
-int len = 0, ret = -1;
-char entryName[128];
-// char *SimFifoPath is global
+SIM_VIEW view;
+int rc = 0;
+// WHO_AM_I SimParms is global
+// SIM_REACTOR SimReactor is global
 
-// open the fifo directory
-directory = opendir(SimFifoPath);
-if (directory == NULL)
+if (SimReactor.buf == NULL)
+	rc = ReceiveView(&view);
+else
 	{
-	sryLog("%s: Unable to open fifo directory %s.\n", fn, SimFifoPath);
-	return -1;
+	view.sender = NULL;
+	rc = Receive(&view.sender, SimReactor.buf, SimReactor.size);
+	if (rc >= 0)
+		{
+		view.data = SimReactor.buf;
+		view.nbytes = rc;
+		view.ybytes = ((FCMSG_REC *)view.sender)->ybytes;
+		}
 	}
 
-// the fifo directory file name based on the SIM name passed in 
-sprintf(entryName, "R_%s", simName); 
-len = strlen(entryName);
+/*
+Receive() has said what went wrong; only the loss of the receive fifo is the
+end of the reactor
+*/
+if (rc == -1)
+	return (SimParms.rfd == -1) ? -1 : 0;
 
-// check for a match
-while ((file = readdir(directory)) != NULL)
+// a proxy has its value in place of a message
+if (rc < -1)
 	{
-	// check for a match
-	if (file->d_name[len] == '.' && !memcmp(file->d_name, entryName, len))
-		{
-		// sim names match
-		sprintf(fifoName, "%s/%s", SimFifoPath, file->d_name);
-		ret = 0;
-		break;
-		}
+	view.sender = NULL;
+	view.data = NULL;
+	view.nbytes = returnProxy(rc);
+	view.ybytes = 0;
 	}
 
-closedir(directory);
-
-return ret;
+return (SimReactor.handler(&view, SimReactor.arg) == -1) ? 1 : 0;
 }
 
 /********************************************************************/
@@ -2005,7 +11422,10 @@ switch (signo)
 
 	default:
 		// clean up SIM stuff
-		closeSRY();
+		exitFunc();
+
+		// nor is the log written out on exit, see drainLogAtExit()
+		drainLogOnSignal();
 
 		// don't call atexit() because we have already run closeSRY()
 		_exit(EXIT_SUCCESS);
@@ -2044,6 +11464,8 @@ RETURNS:	nothing
 inline void exitFunc()
 {
 // separate function in order to conveniently allow added bits as necessary
+// other threads' instances first, while this one's registry is still mapped
+removeAllSimInstances();
 closeSRY();
 }
 
@@ -2051,112 +11473,354 @@ closeSRY();
 FUNCTION:	int sryLog(const char *, ...)
 
 PURPOSE:	sry errors/messages are recorded to a text file that is
-			not	allowed to grow past a certain limit.
+			not	allowed to grow past a certain limit. The line is put
+			on the log ring and written out by the log flusher thread,
+			so that logging never holds up the message path.
 
-RETURNS:	int
+RETURNS:	success (or rate limited): 0
+			failure: -1
 **********************************************************************/
 
 int sryLog(const char *format, ...)
 {
-const char *logFile = LogFile;
-int fd = -1;
-struct stat s;
-char tstr[50], dstr[100];
 va_list args;
+int rc = 0;
+
+va_start(args, format);
+rc = putLog(SIM_LOG_ERROR, format, args);
+va_end(args);
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int sryLogLevel(int, const char *, ...)
+
+PURPOSE:	Log a line as sryLog() does, at one of SIM_LOG_LEVELS. Lines
+			of a level above SIM_LOG_LEVEL are not logged at all.
+
+RETURNS:	success (or filtered out): 0
+			failure: -1
+**********************************************************************/
+
+int sryLogLevel(int level, const char *format, ...)
+{
+va_list args;
+int rc = 0;
+
+va_start(args, format);
+rc = putLog(level, format, args);
+va_end(args);
+
+return rc;
+}
+
+/**********************************************************************
+FUNCTION:	int sryLogFlush(void)
+
+PURPOSE:	Write out the lines on the log ring now, rather than wait for
+			the log flusher thread.
+
+RETURNS:	success: 0
+			failure: -1
+**********************************************************************/
+
+int sryLogFlush()
+{
+pthread_once(&SimLogOnce, initLog);
+
+return drainLog();
+}
+
+/**********************************************************************
+FUNCTION:	int saveSenderId(void *)
+
+PURPOSE:	This function adds a reply blocked sender to the global
+			table, growing the table should it be getting full.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int saveSenderId(void *sender)
+{
+// BLOCKED_SENDERS BlockedSenders is global
+BLOCKED_SENDERS *t = &BlockedSenders;
+void *seen = NULL;
+unsigned i = 0;
+
+// kept at most three quarters full, so that probes stay short
+if ((t->used + 1) * 4 > t->size * 3 && growBlockedSenders() == -1)
+	return -1;
+
+/*
+Only this thread adds senders, so the first free or gone slot is this one's
+to take. Serve() workers only ever turn a sender into SENDER_GONE.
+*/
+for (i = hashSender(sender, t->size); ; i = (i + 1) & (t->size - 1))
+	{
+	seen = __atomic_load_n(&t->slot[i], __ATOMIC_ACQUIRE);
+	if (seen == NULL || seen == SENDER_GONE)
+		break;
+	}
+
+if (seen == NULL)
+	t->used++;
+__atomic_store_n(&t->slot[i], sender, __ATOMIC_RELEASE);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int removeSenderId(void *)
+
+PURPOSE:	This function removes a reply blocked sender from the global
+			table.
+
+RETURNS:	success: 0
+			failure: -1
+***********************************************************************/
+
+int removeSenderId(void *sender)
+{
+// BLOCKED_SENDERS BlockedSenders is global
+
+return dropBlockedSender(&BlockedSenders, sender);
+}
+
+/**********************************************************************
+FUNCTION:	bool isSenderBlocked(void *)
+
+PURPOSE:	This function checks whether a sender is on the reply blocked
+			sender table.
+
+RETURNS:	reply blocked: true
+			not reply blocked: false
+***********************************************************************/
+
+bool isSenderBlocked(void *sender)
+{
+// BLOCKED_SENDERS BlockedSenders is global
+BLOCKED_SENDERS *t = &BlockedSenders;
+void *seen = NULL;
+
+if (sender == NULL || t->size == 0)
+	return false;
+
+for (unsigned i = hashSender(sender, t->size); ; i = (i + 1) & (t->size - 1))
+	{
+	seen = __atomic_load_n(&t->slot[i], __ATOMIC_ACQUIRE);
+	if (seen == sender)
+		return true;
+	if (seen == NULL)
+		return false;
+	}
+}
+
+/**********************************************************************
+FUNCTION:	unsigned hashSender(const void *, unsigned)
+
+PURPOSE:	Hash a sender id, the address of its shmem, to its home slot in
+			a reply-blocked sender table of size slots.
+
+RETURNS:	slot index
+***********************************************************************/
+
+unsigned hashSender(const void *sender, unsigned size)
+{
+// shmem is at least 16 byte aligned; Fibonacci hashing spreads the rest
+unsigned long long h = (unsigned long)sender >> 4;
+
+h *= 0x9E3779B97F4A7C15ULL;
+
+return (unsigned)(h >> 32) & (size - 1);
+}
+
+/**********************************************************************
+FUNCTION:	int growBlockedSenders(void)
+
+PURPOSE:	Rebuild the reply-blocked sender table with room for twice the
+			senders on it, leaving out those gone. Serve() workers taking
+			senders off wait on the table's lock meanwhile.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by saveSenderId().
+***********************************************************************/
+
+int growBlockedSenders()
+{
+const char *fn = "growBlockedSenders";
+// BLOCKED_SENDERS BlockedSenders is global
+BLOCKED_SENDERS *t = &BlockedSenders;
+void **slot = NULL, **old = NULL;
+unsigned size = MIN_NUM_BLOCKED_SENDERS, live = 0, oldSize = 0, j = 0;
+
+pthread_mutex_lock(&t->lock);
+
+for (unsigned i = 0; i < t->size; i++)
+	if (t->slot[i] != NULL && t->slot[i] != SENDER_GONE)
+		live++;
+
+// at most half full once rebuilt
+while (size < (live + 1) * 2)
+	size *= 2;
+
+slot = (void **)calloc(size, sizeof(void *));
+if (slot == NULL)
+	{
+	pthread_mutex_unlock(&t->lock);
+	sryLog("%s: No room for %u reply-blocked senders.\n", fn, live + 1);
+	return -1;
+	}
+
+for (unsigned i = 0; i < t->size; i++)
+	{
+	if (t->slot[i] == NULL || t->slot[i] == SENDER_GONE)
+		continue;
+	for (j = hashSender(t->slot[i], size); slot[j] != NULL; j = (j + 1) & 
+																(size - 1))
+		;
+	slot[j] = t->slot[i];
+	}
+
+old = t->slot;
+oldSize = t->size;
+t->slot = slot;
+t->size = size;
+t->used = live;
+
+pthread_mutex_unlock(&t->lock);
+
+if (oldSize)
+	free(old);
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	int dropBlockedSender(BLOCKED_SENDERS *, void *)
+
+PURPOSE:	Take a sender off a table of reply-blocked senders, leaving 
+			SENDER_GONE in its slot.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by removeSenderId(), releaseServedSender().
+***********************************************************************/
+
+int dropBlockedSender(BLOCKED_SENDERS *t, void *sender)
+{
+void *seen = NULL;
+
+if (sender == NULL || t->size == 0)
+	return -1;
+
+for (unsigned i = hashSender(sender, t->size); ; i = (i + 1) & (t->size - 1))
+	{
+	seen = __atomic_load_n(&t->slot[i], __ATOMIC_ACQUIRE);
+	if (seen == NULL)
+		return -1;
+
+	// the sender may be taken off by its worker and by ReplyError() at once
+	if (seen == sender && __atomic_compare_exchange_n(&t->slot[i], &seen, 
+				SENDER_GONE, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+		return 0;
+	}
+}
 
-// set time string
-time_t tod = time(NULL);
-strftime(tstr, sizeof tstr, "%D %T", gmtime(&tod));
+/**********************************************************************
+FUNCTION:	void releaseBlockedSenders(bool)
 
-// set comment string
-va_start(args, format);
-vsnprintf(dstr, sizeof dstr, format, args);
-va_end(args);
+PURPOSE:	Empty the reply-blocked sender table and free it, replying an
+			error to each of the senders still on it if asked.
 
-// print to screen?
-if (PrintSimError)
-	printf("%s *** %s\n", tstr, dstr);
+RETURNS:	nothing
 
-if (stat(logFile, &s) == -1) // file does not exist
-	{
-	fd = open(logFile, O_WRONLY | O_CREAT, 0644);
-	}
-else // file exists
-	{
-	if (s.st_size < MaxLogSize)
-		fd = open(logFile, O_WRONLY | O_APPEND, 0644); // append
-	else
-		fd = open(logFile, O_WRONLY | O_TRUNC | O_CREAT, 0644); // truncate
-	}
+NOTE:		Called by closeSRY(), closeServeWorker(), initSimTables().
+***********************************************************************/
 
-if (fd != -1)
+void releaseBlockedSenders(bool reply)
+{
+// BLOCKED_SENDERS BlockedSenders is global
+BLOCKED_SENDERS *t = &BlockedSenders;
+void *sender = NULL;
+
+for (unsigned i = 0; reply && i < t->size; i++)
 	{
-	if (write(fd, tstr, strlen(tstr)) == -1)
-		return -1;
-	if (write(fd, " *** ", 5) == -1)
-		return -1;
-	if (write(fd, dstr, strlen(dstr)) == -1)
-		return -1;
-	close(fd);
+	sender = t->slot[i];
+	if (sender != NULL && sender != SENDER_GONE)
+		ReplyError(sender);
 	}
-else
-	return -1;
-	
-return 0;
+
+pthread_mutex_lock(&t->lock);
+if (t->size)
+	free(t->slot);
+t->slot = NULL;
+t->size = 0;
+t->used = 0;
+pthread_mutex_unlock(&t->lock);
 }
 
 /**********************************************************************
-FUNCTION:	int saveSenderId(void *)
+FUNCTION:	int addRemoteReceiver(int)
 
-PURPOSE:	This function adds a reply blocked sender to the global
-			array.
+PURPOSE:	Note the surrogate_r fd of a remote receiver, to be shut down
+			on closeSRY(). The table is doubled in size when full.
 
 RETURNS:	success: 0
 			failure: -1
+
+NOTE:		Called by Locate().
 ***********************************************************************/
 
-int saveSenderId(void *sender)
+int addRemoteReceiver(int fd)
 {
-// void *BlockedSenderId[] is global
+// REMOTE_RECEIVERS RemoteReceivers is global
+REMOTE_RECEIVERS *t = &RemoteReceivers;
+int *p = NULL;
+unsigned size = 0;
 
-// take the first available slot
-for (int i = 0; i < MAX_NUM_BLOCKED_SENDERS; i++)
+if (t->count == t->size)
 	{
-	if (BlockedSenderId[i] == (void *)NULL)
-		{
-		BlockedSenderId[i] = sender;
-		return 0;
-		}
+	size = t->size ? t->size * 2 : MIN_NUM_REMOTE_RECEIVERS;
+	p = (int *)realloc(t->fd, size * sizeof(int));
+	if (p == NULL)
+		return -1;
+	t->fd = p;
+	t->size = size;
 	}
 
-return -1;
+t->fd[t->count++] = fd;
+
+return 0;
 }
 
 /**********************************************************************
-FUNCTION:	int removeSenderId(void *)
+FUNCTION:	void releaseRemoteReceivers(bool)
 
-PURPOSE:	This function removes a reply blocked sender from the global
-			array.
+PURPOSE:	Empty the remote receiver table and free it, shutting down the
+			surrogates if asked.
 
-RETURNS:	success: 0
-			failure: -1
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), initSimTables().
 ***********************************************************************/
 
-int removeSenderId(void *sender)
+void releaseRemoteReceivers(bool shutdown)
 {
-// void *BlockedSenderId[] is global
+// REMOTE_RECEIVERS RemoteReceivers is global
+REMOTE_RECEIVERS *t = &RemoteReceivers;
 
-// initialize table of reply-blocked senders
-for (int i = 0; i < MAX_NUM_BLOCKED_SENDERS; i++)
-	{
-	if (BlockedSenderId[i] == sender)
-		{
-		BlockedSenderId[i] = (void *)NULL;
-		return 0;
-		}
-	}
+for (unsigned i = 0; shutdown && i < t->count; i++)
+	Trigger(t->fd[i], PROXY_SHUTDOWN);
 
-return -1;
+free(t->fd);
+t->fd = NULL;
+t->count = 0;
+t->size = 0;
 }
 
 /**********************************************************************
@@ -2229,42 +11893,41 @@ RETURNS:	receiver exists, pid >= 0
 
 pid_t chkNamePid(const char *name)
 {
-const char *fn = "chkName";
-DIR *directory = NULL;
-struct dirent *file = NULL;
-int len = 0;
 pid_t pid = -1;
-char entryName[128];
-// char *SimFifoPath is global
+// SIM_REGISTRY *SimRegistry is global
 
-// open the fifo directory
-directory = opendir(SimFifoPath);
-if (directory == NULL)
+// look up the name registry first
+if (SimRegistry != NULL)
 	{
-	sryLog("%s: Unable to open fifo directory %s.\n", fn, SimFifoPath);
-	return -1;
+	pid = lookupName(name, NULL);
+	if (pid != -1)
+		return pid;
 	}
 
-// the length of the sim name passed in + 1
+// nor need a name be in the registry, see getFifoName()
 // form of fifo name is R_simName.12345
-sprintf(entryName, "R_%s", name);
-len = strlen(entryName);
+return scanFifoPath("R_", name);
+}
 
-// check fifo directory entries for a match
-while ( (file = readdir(directory)) != NULL )
-	{
-	// check for a match
-	if (file->d_name[len] == '.' && !memcmp(file->d_name, entryName, len))
-		{
-		// extract the pid; fifo name is of the form: R_name.12345
-		pid = atoi(file->d_name + len + 1);
-		break;
-		}
-	}
+/**********************************************************************
+FUNCTION:	bool isPidSuffix(const char *)
 
-closedir(directory);
+PURPOSE:	Check that what follows the '.' of a fifo name is a pid, so
+			that "svc" does not match the fifo R_svc.t3.12345 of "svc.t3".
 
-return pid;
+RETURNS:	true/false
+ ***********************************************************************/
+
+bool isPidSuffix(const char *str)
+{
+if (*str == '\0')
+	return false;
+
+for (; *str; str++)
+	if (*str < '0' || *str > '9')
+		return false;
+
+return true;
 }
 
 /**********************************************************************
@@ -2280,8 +11943,6 @@ bool chkStatus(const pid_t pid, const char *name)
 {
 //const char *fn = "chkStatus";
 bool ret = true;
-char fifoFile[400];
-// char *SimFifoPath is global
 
 if (pid > 0)
 	{
@@ -2290,10 +11951,7 @@ if (pid > 0)
 	if ( (getpriority(PRIO_PROCESS, pid) == -1) && (errno == ESRCH) )
 		{
 		// this program is not running so remove old fifos if they exist
-		sprintf(fifoFile, "%s/R_%s.%d", SimFifoPath, name, pid);
-		remove(fifoFile);
-		sprintf(fifoFile, "%s/Y_%s.%d", SimFifoPath, name, pid);
-		remove(fifoFile);
+		removeSimFiles(pid, name);
 		// process doesn't exist'
 		ret = false;
 		}
@@ -2301,6 +11959,419 @@ if (pid > 0)
 
 return ret;
 }
+
+/**********************************************************************
+FUNCTION:	void initSimTables(void)
+
+PURPOSE:	Initialize the tables of surrogates, reply-blocked senders, 
+			cached sender shmem attachments and reply fifos, located 
+			receivers and receiver groups, PostMessage() slots, retired 
+			shmem, channels and streams.
+
+RETURNS:	nothing
+
+NOTE:		Called by openSRYopts(), openServeWorker().
+***********************************************************************/
+
+void initSimTables()
+{
+// REMOTE_RECEIVERS RemoteReceivers is global
+// BLOCKED_SENDERS BlockedSenders is global
+// SENDER_SHMEM SenderShmem[] is global
+// REPLY_FIFO ReplyFifo[] is global
+// LOCATED_RECEIVER LocatedReceiver[] is global
+// POST_SLOT PostSlot[] is global
+// RETIRED_SHMEM RetiredShmem[] is global
+// SIM_CHANNEL SimChannel[] is global
+
+// initialize table of possible surrogates
+releaseRemoteReceivers(false);
+
+// initialize table of reply-blocked senders
+releaseBlockedSenders(false);
+
+// initialize table of cached sender shmem attachments
+for (int i = 0; i < MAX_NUM_ATTACHED_SENDERS; i++)
+	{
+	SenderShmem[i].shmid = -1;
+	SenderShmem[i].owner = 0;
+	SenderShmem[i].ino = 0;
+	SenderShmem[i].pid = -1;
+	SenderShmem[i].shmPtr = (void *)NULL;
+	SenderShmem[i].lastUse = 0;
+	}
+
+// initialize table of cached reply fifo descriptors
+for (int i = 0; i < MAX_NUM_REPLY_FIFOS; i++)
+	{
+	ReplyFifo[i].whom[0] = 0;
+	ReplyFifo[i].pid = -1;
+	ReplyFifo[i].fd = -1;
+	ReplyFifo[i].lastUse = 0;
+	}
+
+// initialize table of located receivers
+for (int i = 0; i < MAX_NUM_LOCATED_RECEIVERS; i++)
+	{
+	LocatedReceiver[i].fd = -1;
+	LocatedReceiver[i].pid = -1;
+	LocatedReceiver[i].mbox = NULL;
+	LocatedReceiver[i].name[0] = 0;
+	}
+
+// initialize table of PostMessage() slots
+for (int i = 0; i < MAX_NUM_POSTED_MESSAGES; i++)
+	{
+	PostSlot[i].shmid = -1;
+	PostSlot[i].shmPtr = (void *)NULL;
+	PostSlot[i].shmSize = 0;
+	PostSlot[i].posted = false;
+	PostSlot[i].seq = 0;
+	PostSlot[i].inBuffer = NULL;
+	}
+ReplyFifoTokens = 0;
+
+// initialize table of shmem given up on by SendTimed()
+for (int i = 0; i < MAX_NUM_RETIRED_SHMEM; i++)
+	{
+	RetiredShmem[i].shmid = -1;
+	RetiredShmem[i].shmPtr = (void *)NULL;
+	RetiredShmem[i].shmSize = 0;
+	}
+RetiredShmemNext = 0;
+SimDeadline.set = false;
+
+// no triggers held for priority order
+SimPending.count = 0;
+SimPending.seq = 0;
+SimInherited.priority = 0;
+
+// no coalesced proxies taken from the proxy table
+SimProxyBurst.count = 0;
+SimProxyBurst.next = 0;
+SimProxyCount = 1;
+
+// initialize table of channels
+for (int i = 0; i < MAX_NUM_CHANNELS; i++)
+	{
+	SimChannel[i].hdr = NULL;
+	SimChannel[i].fd = -1;
+	}
+
+// initialize table of streams
+for (int i = 0; i < MAX_NUM_STREAMS; i++)
+	SimStream[i].hdr = NULL;
+
+// initialize table of located receiver groups
+for (int i = 0; i < MAX_NUM_GROUPS; i++)
+	SimGroup[i].table = NULL;
+SimSendKey = -1;
+}
+
+/**********************************************************************
+FUNCTION:	void removeSimFiles(const pid_t, const char *)
+
+PURPOSE:	Remove the fifos, mailbox, proxy table and registration of a
+			SIM instance that is gone, or about to be, or those of a 
+			channel or stream.
+
+RETURNS:	nothing
+
+NOTE:		Called by chkStatus(), removeAllSimInstances().
+***********************************************************************/
+
+void removeSimFiles(const pid_t pid, const char *name)
+{
+char fifoFile[400];
+// char *SimFifoPath is global
+
+// remove old fifos if they exist
+sprintf(fifoFile, "%s/R_%s.%d", SimFifoPath, name, pid);
+remove(fifoFile);
+sprintf(fifoFile, "%s/Y_%s.%d", SimFifoPath, name, pid);
+remove(fifoFile);
+// and the futex transport mailbox and the proxy table
+sprintf(fifoFile, "%s/M_%s.%d", SimFifoPath, name, pid);
+remove(fifoFile);
+sprintf(fifoFile, "%s/Q_%s.%d", SimFifoPath, name, pid);
+remove(fifoFile);
+// or the file of a channel or stream of that name
+sprintf(fifoFile, "%s/P_%s.%d", SimFifoPath, name, pid);
+remove(fifoFile);
+sprintf(fifoFile, "%s/T_%s.%d", SimFifoPath, name, pid);
+remove(fifoFile);
+// as well as any cached descriptor to its reply fifo
+closeReplyFifo(pid, name);
+// and its registration
+deregisterName(name, pid);
+}
+
+/**********************************************************************
+FUNCTION:	void addSimInstance(void)
+
+PURPOSE:	Note the calling thread's SIM instance in the process wide 
+			table, so that its fifos can be removed on exit by whichever
+			thread exits the process.
+
+RETURNS:	nothing
+
+NOTE:		Called by openSRYopts().
+***********************************************************************/
+
+void addSimInstance()
+{
+const char *fn = "addSimInstance";
+// SIM_INSTANCE SimInstance[] is global
+// int SimInstanceSlot is global
+int unused = 0;
+
+for (int i = 0; i < MAX_NUM_SIM_INSTANCES; i++)
+	{
+	unused = 0;
+	if (__atomic_compare_exchange_n(&SimInstance[i].used, &unused, 1, false,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+		SimInstance[i].pid = SimParms.pid;
+		strcpy(SimInstance[i].whom, SimParms.whom);
+		SimInstanceSlot = i;
+		return;
+		}
+	}
+
+sryLog("%s: Too many SIM instances, fifos left on exit.\n", fn);
+}
+
+/**********************************************************************
+FUNCTION:	void removeSimInstance(void)
+
+PURPOSE:	Remove the calling thread's SIM instance from the process wide
+			table.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY().
+***********************************************************************/
+
+void removeSimInstance()
+{
+// SIM_INSTANCE SimInstance[] is global
+// int SimInstanceSlot is global
+
+if (SimInstanceSlot == -1)
+	return;
+
+__atomic_store_n(&SimInstance[SimInstanceSlot].used, 0, __ATOMIC_RELEASE);
+SimInstanceSlot = -1;
+}
+
+/**********************************************************************
+FUNCTION:	void removeAllSimInstances(void)
+
+PURPOSE:	Remove the fifos, mailboxes and registrations of the SIM 
+			instances of other threads, which cannot run closeSRY() on
+			their own once the process exits.
+
+RETURNS:	nothing
+
+NOTE:		Called by exitFunc().
+***********************************************************************/
+
+void removeAllSimInstances()
+{
+// SIM_INSTANCE SimInstance[] is global
+// int SimInstanceSlot is global
+pid_t pid = getpid();
+
+for (int i = 0; i < MAX_NUM_SIM_INSTANCES; i++)
+	{
+	if (i == SimInstanceSlot || 
+					!__atomic_load_n(&SimInstance[i].used, __ATOMIC_ACQUIRE))
+		continue;
+
+	// a forked child does not remove its parent's instances
+	if (SimInstance[i].pid == pid)
+		removeSimFiles(SimInstance[i].pid, SimInstance[i].whom);
+
+	__atomic_store_n(&SimInstance[i].used, 0, __ATOMIC_RELEASE);
+	}
+}
+
+/**********************************************************************
+FUNCTION:	int openSimState(void)
+
+PURPOSE:	Give the calling thread a SIM instance of its own, not yet 
+			open, in place of the process' one, SimDefault.
+
+RETURNS:	success: 0
+			failure: -1
+
+NOTE:		Called by openSRYopts(), openServeWorker().
+***********************************************************************/
+
+int openSimState()
+{
+const char *fn = "openSimState";
+static const SIM_STATE init = SIM_STATE_INIT;
+SIM_STATE *state = NULL;
+// SIM_STATE *SimState is global
+
+if (SimState->perThread)
+	{
+	sryLog("%s: SIM already active for this thread.\n", fn);
+	return -1;
+	}
+
+state = (SIM_STATE *)malloc(sizeof(SIM_STATE));
+if (state == NULL)
+	{
+	sryLog("%s: No memory for a SIM instance-%s.\n", fn, strerror(errno));
+	return -1;
+	}
+
+*state = init;
+state->perThread = true;
+SimState = state;
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	void closeSimState(void)
+
+PURPOSE:	Free the calling thread's own SIM instance, once closed, and 
+			go back to the process' one.
+
+RETURNS:	nothing
+
+NOTE:		Called by closeSRY(), closeSRYchild(), closeServeWorker().
+***********************************************************************/
+
+void closeSimState()
+{
+SIM_STATE *state = SimState;
+// SIM_STATE *SimState is global
+// SIM_STATE SimDefault is global
+
+if (!state->perThread)
+	return;
+
+pthread_mutex_destroy(&state->blockedSenders.lock);
+SimState = &SimDefault;
+free(state);
+}
+
+/**********************************************************************
+FUNCTION:	unsigned iovLength(const struct iovec *, int)
+
+PURPOSE:	Total the lengths of an array of buffers.
+
+RETURNS:	the number of bytes in all of the buffers
+
+NOTE:		Called by SendV() and ReplyV().
+**********************************************************************/
+
+unsigned iovLength(const struct iovec *iov, int iovcnt)
+{
+unsigned len = 0;
+
+for (int i = 0; i < iovcnt; i++)
+	len += iov[i].iov_len;
+
+return len;
+}
+
+/**********************************************************************
+FUNCTION:	void setDeadline(unsigned)
+
+PURPOSE:	Set the deadline of a timed call msecs milliseconds from now.
+
+RETURNS:	nothing
+
+NOTE:		Called by SendTimed(), ReceiveTimed() and LocateTimed().
+**********************************************************************/
+
+void setDeadline(unsigned msecs)
+{
+// SIM_DEADLINE SimDeadline is global
+
+clock_gettime(CLOCK_MONOTONIC, &SimDeadline.at);
+SimDeadline.at.tv_sec += msecs / 1000;
+SimDeadline.at.tv_nsec += (long)(msecs % 1000) * 1000000L;
+if (SimDeadline.at.tv_nsec >= 1000000000L)
+	{
+	SimDeadline.at.tv_sec++;
+	SimDeadline.at.tv_nsec -= 1000000000L;
+	}
+SimDeadline.set = true;
+}
+
+/**********************************************************************
+FUNCTION:	bool pastDeadline(void)
+
+PURPOSE:	Check whether the deadline of a timed call has passed.
+
+RETURNS:	true if so, false if not or if there is no deadline
+
+NOTE:		Called by readTrigger(), waitReplyFutex().
+**********************************************************************/
+
+bool pastDeadline()
+{
+// SIM_DEADLINE SimDeadline is global
+struct timespec now;
+
+if (!SimDeadline.set)
+	return false;
+
+clock_gettime(CLOCK_MONOTONIC, &now);
+
+return now.tv_sec > SimDeadline.at.tv_sec || (now.tv_sec == 
+					SimDeadline.at.tv_sec && now.tv_nsec >= SimDeadline.at.tv_nsec);
+}
+
+/**********************************************************************
+FUNCTION:	int pollDeadline(int)
+
+PURPOSE:	Wait for fd to become readable, no longer than the deadline of
+			a timed call. Without a deadline it returns at once.
+
+RETURNS:	success: 0, fd readable or no deadline
+			failure: -1, errno ETIMEDOUT past the deadline
+
+NOTE:		Called by readFifoMsg(), readUringTrigger().
+**********************************************************************/
+
+int pollDeadline(int fd)
+{
+// SIM_DEADLINE SimDeadline is global
+struct pollfd pfd;
+struct timespec now;
+long msecs = 0;
+int rc = 0;
+
+if (!SimDeadline.set)
+	return 0;
+
+pfd.fd = fd;
+pfd.events = POLLIN;
+
+do	{
+	// rounded up so as not to wake just short of the deadline
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	msecs = (SimDeadline.at.tv_sec - now.tv_sec) * 1000L + 
+						(SimDeadline.at.tv_nsec - now.tv_nsec + 999999L) / 1000000L;
+	rc = poll(&pfd, 1, (msecs > 0) ? (int)msecs : 0);
+	}
+while (rc == -1 && errno == EINTR);
+
+if (rc == 0)
+	{
+	errno = ETIMEDOUT;
+	return -1;
+	}
+
+return (rc == -1) ? -1 : 0;
+}
 /*#############################################################################
 							End SRY C/C++ Functions
 ##############################################################################*/
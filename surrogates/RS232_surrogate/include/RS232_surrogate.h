@@ -33,6 +33,15 @@ typedef enum
 	OUT
 	} MSG_TYPE;
 
+// what the Reactor() callbacks of a surrogate child work with
+typedef struct
+	{
+	SRY *sry;
+	int id;				// surrogate_s: the local receiver
+	int kaCounter;		// keep alives gone unanswered
+	int yBytes;			// surrogate_s: reply size of the posted message
+	} SUR_CHILD;
+
 // function prototypes within RS232_surrogate.c
 int initialize(int, char **);
 
@@ -47,7 +56,8 @@ void surrogate_S(void);
 // function prototypes within RS232_surrogate_r.c
 void surrogate_r(void);
 int hndlRemoteNameLocate(SRY&);
-int hndlMsg(SRY&, int *);
+int hndlMsg(SIM_VIEW *, void *);
+int chkLocalSender(int, void *);
 int sendKeepAliveMsg(SRY&, int *);
 void hndlClose(SRY&);
 int hndlProxy(SRY&, int);
@@ -55,8 +65,9 @@ void replyFailure(SRY&, char *);
 
 // function prototypes within RS232_surrogate_s.c
 void surrogate_s(void);
-int hndlMessage(SRY&, int, int *, int *);
-int hndlReply(SRY&, int);
+int hndlMessage(SIM_VIEW *, void *);
+int hndlReply(int, void *);
+int chkLocalReceiver(int, void *);
 void errorReply(SRY&);
 
 // function prototypes within surrogateUtils.c
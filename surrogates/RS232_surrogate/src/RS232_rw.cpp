@@ -297,14 +297,18 @@ while (true)
 		continue;
 		}
 
-	// send  message to the appropriate receiver
+	/*
+	The name located id is kept open; Locate() hands the same id back for
+	the next message to this receiver for as long as it is running. It is
+	closed once the receiver is gone or its connection is closing.
+	*/
 	if (nee.Send(id, MemArea, hdrSize + numBytes, nullptr, 0) == -1)
 		{
 		sryLog("%s: send to %s error.\n", n.c_str(), receiver);
+		close(id);
 		}
-
-	// close the name located id
-	close(id);
+	else if (token == SUR_CLOSE)
+		close(id);
 	}
 }	
 
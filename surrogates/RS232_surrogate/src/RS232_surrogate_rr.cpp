@@ -46,11 +46,8 @@ void surrogate_r()
 // SerialWriter is global
 // KaTimeout is global
 // SurRpid is global
-// Sender is global
 std::string n = RS232_Surr_r, &p = n;
-fd_set watchset, inset;
-struct timeval tv, *timeoutPtr;
-int ret, kaCounter = 0, fds[1];
+SUR_CHILD child;
 
 // get the pid
 SurRpid = getpid();
@@ -80,88 +77,24 @@ if (hndlRemoteNameLocate(noo) == -1)
 	exit(EXIT_FAILURE);
 	}
 
-// for local sim messages 
-fds[0] = nee.rfd();
-
-// set select parameters
-FD_ZERO(&watchset);
-FD_SET(fds[0], &watchset);
+child.sry = &nee;
+child.kaCounter = 0;
 
-// set timer values in case of keep alive
-if (!KaTimeout)
-	timeoutPtr = nullptr;
-else
+/*
+local sim messages and replies/keep alive replies from the remote surrogate
+both come in as sim messages; the keep alive timer only if asked for
+*/
+if (nee.ReactorMsg(hndlMsg, &child, nullptr, 0) == -1 || (KaTimeout &&
+	nee.ReactorTimer(KaTimeout * 1000, true, chkLocalSender, &child) == -1))
 	{
-	tv.tv_sec = KaTimeout;
-	tv.tv_usec = 0;
-	timeoutPtr = &tv;
+	sryLog("%s: reactor set up error\n", p.c_str());
+	exit(EXIT_FAILURE);
 	}
 
-while (true)
-	{
-	// reset the fd set each time
-	inset = watchset;
-
-	// let select be the trigger on the file descriptor/timer
-	ret = select(fds[0]+1, &inset, NULL, NULL, timeoutPtr);
-	if (ret > 0) 
-		{
-		if (FD_ISSET(fds[0], &inset))
-			{
-			// this is a local simpl Send message
-			// or send reply/keep alive reply from remote surrogate
-			if (hndlMsg(noo, &kaCounter) == -1)
-				{
-				sryLog("%s: hndlSendMsg error\n", p.c_str());
-				exit(EXIT_FAILURE);
-				}
-			}
-		else 
-			{
-			// unknown fd error
-			sryLog("%s: unknown fd on select-%s\n", p.c_str(), strerror(errno));
-			}
-		}
-	else if (ret == 0) 
-		{
-		// a good opportunity to check on the local sender
-		if (nee.chkSender(Sender) == false)
-			{
-			// sender has gone and somehow left this surrogate behind
-			// one posibility is that the sender was SIGKILL'd
-			// send a close message to the remote surrogate partner
-			hndlClose(noo);
-			exit(EXIT_SUCCESS);
-			}	
-			
-		/*
-		select timer kick returns 0 --> send a keep alive message to 
-		surrogate partner
-		*/
-		if (sendKeepAliveMsg(noo, &kaCounter) == -1)
-			{
-			sryLog("%s: sendKeepAliveMsg error\n", p.c_str());
-			exit(EXIT_FAILURE);
-			}
-
-		// check the number of keep alive messages sent
-		if (kaCounter > KaFailLimit)
-			{
-			sryLog("%s: too many keep alive failures.\n", p.c_str());
-			exit(EXIT_FAILURE);
-			}
-
-		// timer values must be reset each time as necessary
-		tv.tv_sec = KaTimeout;
-		tv.tv_usec = 0;
-		timeoutPtr = &tv;
-		}
-	else
-		{
-		// select error
-		sryLog("%s: select error-%s\n", p.c_str(), strerror(errno));
-		}
-	}
+// only returns on an error, the handlers exit on a close
+nee.Reactor();
+sryLog("%s: reactor stopped\n", p.c_str());
+exit(EXIT_FAILURE);
 }
 		
 /**********************************************************************
@@ -301,7 +234,7 @@ return 0;
 }
 
 /**********************************************************************
-FUNCTION:	hndlMsg(SRY&, int *)
+FUNCTION:	hndlMsg(SIM_VIEW *, void *)
 
 PURPOSE:	Handle sim SUR_SEND call from a local sender intended
 			for a remote receiver.
@@ -309,37 +242,29 @@ PURPOSE:	Handle sim SUR_SEND call from a local sender intended
 RETURNS:	int	
 **********************************************************************/	
 
-int hndlMsg(SRY &c, int *kaCounter)
+int hndlMsg(SIM_VIEW *view, void *arg)
 {
 // InMsgArea is global
 // InMsgSize is global
 // OutMsgArea is global
 // OutMsgSize is global
 // SurSpid is global
+// Sender is global
 const std::string fn("hndlMsg_rs232");
+SUR_CHILD *child = (SUR_CHILD *)arg;
+SRY &c = *child->sry;
 std::string senderName;
-int nBytes, yBytes, maxBytes, proxyValue, token;
+int nBytes, yBytes, maxBytes, token;
 unsigned numBytes;
-void *sender, *serialSender, *localSender = nullptr;
+void *sender = view->sender, *serialSender;
 const static int hdrSize = sizeof(SUR_MSG_HDR);
 SUR_MSG_HDR *in, *out;
 
-// receive message from the local sender or the serial reader
-nBytes = c.Receive(&sender, nullptr, 0);
-if (nBytes == -1)
-	{
-	sryLog("%s: receive error.\n",fn.c_str());
-	return -1;
-	}
-
 // is it a trigger proxy?
-if (nBytes < -1)
+if (sender == nullptr)
 	{
-	// get the value of the proxy
-	proxyValue = c.returnProxy(nBytes);
-	
 	// is it a close up shop proxy?
-	if (proxyValue == PROXY_SHUTDOWN)
+	if ((int)view->nbytes == PROXY_SHUTDOWN)
 		{
 		// send a close message to the remote surrogate partner
 		hndlClose(c);
@@ -347,10 +272,13 @@ if (nBytes < -1)
 		}
 	else
 		{
-		return hndlProxy(c, proxyValue);
+		return hndlProxy(c, view->nbytes);
 		}
 	}
 
+// a message from the local sender or the serial reader
+nBytes = view->nbytes;
+
 // get the sender information
 c.getSenderName(sender, senderName);
 
@@ -385,7 +313,7 @@ if ( !strcmp(senderName.c_str(), RS232_READER) ) // msg sent from serial reader
 		{
 		case SUR_REPLY:
 			// reply message from remote receiver to local ipc sender
-			if (c.Reply(localSender, InMsgArea + hdrSize, numBytes) == -1)
+			if (c.Reply(Sender, InMsgArea + hdrSize, numBytes) == -1)
 				{
 				sryLog("%s: reply error.\n", fn.c_str());
 				return -1;
@@ -393,11 +321,11 @@ if ( !strcmp(senderName.c_str(), RS232_READER) ) // msg sent from serial reader
 			break;
 
 		case SUR_ALIVE_REPLY:
-			*kaCounter = 0;
+			child->kaCounter = 0;
 			break;
 
 		case SUR_ERROR:
-			c.ReplyError(localSender);
+			c.ReplyError(Sender);
 			// surrogate sender dies upon this error ==> we are not needed
 			exit(EXIT_FAILURE);
 
@@ -409,10 +337,10 @@ if ( !strcmp(senderName.c_str(), RS232_READER) ) // msg sent from serial reader
 else // from the local sender
 	{
 	// set the sender
-	localSender = sender;
+	Sender = sender;
 
 	// what is the size of the expected reply message?
-	yBytes = c.getSenderRplySize(localSender);
+	yBytes = c.getSenderRplySize(Sender);
 
 	// which is larger, the sent or the replied message?
 	maxBytes = (nBytes > yBytes) ? nBytes : yBytes;
@@ -426,7 +354,7 @@ else // from the local sender
 		}
 
 	// get the message from sender's shmem
-	c.simRcopy(localSender, OutMsgArea + hdrSize, nBytes);
+	c.simRcopy(Sender, OutMsgArea + hdrSize, nBytes);
 
 	// build the message going to the other box	
 	out = (SUR_MSG_HDR *)OutMsgArea;
@@ -439,7 +367,7 @@ else // from the local sender
 	if (c.Send(SerialWriter, OutMsgArea, hdrSize + nBytes, nullptr, 0) == -1)
 		{
 		sryLog("%s: send error on msg.\n", fn.c_str());
-		c.ReplyError(localSender);	
+		c.ReplyError(Sender);	
 		return -1;
 		}
 	}
@@ -447,6 +375,46 @@ else // from the local sender
 return 0;
 }
 
+/**********************************************************************
+FUNCTION:	chkLocalSender(int, void *)
+
+PURPOSE:	Check on the local sender and keep the remote surrogate 
+			alive every KaTimeout seconds.
+
+RETURNS:	int	
+**********************************************************************/	
+
+int chkLocalSender(int timer, void *arg)
+{
+// Sender is global
+const std::string fn("chkLocalSender_rs232");
+SUR_CHILD *child = (SUR_CHILD *)arg;
+(void)timer;
+
+// a good opportunity to check on the local sender
+if (child->sry->chkSender(Sender) == false)
+	{
+	// sender has gone and somehow left this surrogate behind
+	// one posibility is that the sender was SIGKILL'd
+	// send a close message to the remote surrogate partner
+	hndlClose(*child->sry);
+	exit(EXIT_SUCCESS);
+	}	
+
+// send a keep alive message to surrogate partner
+if (sendKeepAliveMsg(*child->sry, &child->kaCounter) == -1)
+	return -1;
+
+// check the number of keep alive messages sent
+if (child->kaCounter > KaFailLimit)
+	{
+	sryLog("%s: too many keep alive failures.\n", fn.c_str());
+	return -1;
+	}
+
+return 0;
+}
+
 /**********************************************************************
 FUNCTION:	sendKeepAliveMsg(SRY &c, int *)
 
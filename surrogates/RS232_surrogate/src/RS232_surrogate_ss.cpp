@@ -41,9 +41,8 @@ void surrogate_s()
 // SurSpid is global
 // SurRpid is global
 std::string n = RS232_Surr_s, &p = n;
-int fds[2], maxFd, retVal, ret, id, result, yBytes = 0, kaCounter = 0;
-fd_set inset, watchset; 
-struct timeval tv, *timeoutPtr;
+int id, result;
+SUR_CHILD child;
 SUR_NAME_LOCATE_MSG *surMsg = (SUR_NAME_LOCATE_MSG *)InMsgArea;
 
 // we need the pid of the remote surrogate_r
@@ -93,122 +92,59 @@ if (nee.Send(SerialWriter, &reply, size, nullptr, 0) == -1)
 if (result == -1)
 	exit(EXIT_SUCCESS);
 
-// arm select
-fds[0] = nee.rfd();
-fds[1] = nee.yfd();
-maxFd = (fds[0] > fds[1]) ? fds[0] : fds[1];
-maxFd += 1;
-
-FD_ZERO(&watchset);
-FD_SET(fds[0], &watchset);
-FD_SET(fds[1], &watchset);
-
-// initialize timeout structure
-if (!KaTimeout)
-	{
-	timeoutPtr = nullptr;
-	}
-else
-	{
-	tv.tv_sec = KaTimeout;
-	tv.tv_usec = 0;
-	timeoutPtr = &tv;
-	}
- 
-// handle incoming messages destined for a local receiver
-while (true)
+child.sry = &nee;
+child.id = id;
+child.kaCounter = 0;
+child.yBytes = 0;
+
+/*
+messages from the surrogate partner come in through the serial reader, the
+local receiver's replies on the reply fd; the keep alive timer only if asked
+for
+*/
+if (nee.ReactorMsg(hndlMessage, &child, nullptr, 0) == -1 ||
+	nee.ReactorFd(nee.yfd(), hndlReply, &child) == -1 || (KaTimeout &&
+	nee.ReactorTimer(KaTimeout * 1000, true, chkLocalReceiver, &child) == -1))
 	{
-	// reset the fd set each time
-	inset = watchset;
-
-	// let select be the trigger on the file descriptors/timer
-	retVal = select(maxFd, &inset, NULL, NULL, timeoutPtr);
-	if (retVal > 0) 
-		{
-		if (FD_ISSET(fds[0], &inset))
-			{
-			// a message from surrogate partner
-			ret = hndlMessage(noo, id, &kaCounter, &yBytes);
-			if (ret == -1)
-				{
-				errorReply(noo);
-				exit(EXIT_FAILURE);
-				}
-			}
-		else if (FD_ISSET(fds[1], &inset))
-			{
-			// a reply from local receiver
-			ret = hndlReply(noo, yBytes);
-			if (ret == -1)
-				{
-				errorReply(noo);
-				exit(EXIT_FAILURE);
-				}
-			}
-		else 
-			{
-			// unknown fd error
-			sryLog("%s: fd error on select\n", p.c_str());
-			}
-		}
-	else if (retVal == 0) 
-		{
-		// a good opportunity to check on the local receiver
-		if (nee.chkReceiver("", SurRpid) == false)
-			{
-			// could also send a close message to surrogate_r partner
-			// surrogate_r should pick up on the ka failures
-			exit(EXIT_SUCCESS);
-			}
-				
-		// select timer has gone off check the kaCounter
-		kaCounter += 1;
-		if (kaCounter > KaFailLimit)
-			{
-			// we assume that our surrogate partner is no longer
-			exit(EXIT_SUCCESS);
-			}
-	
-		// timer values must be reset each time as necessary
-		tv.tv_sec = KaTimeout;
-		tv.tv_usec = 0;
-		timeoutPtr = &tv;
-		}
-	else
-		{
-		// select error
-		sryLog("%s: select error-%s\n", p.c_str(), strerror(errno));
-		}
+	sryLog("%s: reactor set up error\n", p.c_str());
+	errorReply(noo);
+	exit(EXIT_FAILURE);
 	}
+
+// only returns on an error, the handlers exit on a close
+nee.Reactor();
+errorReply(noo);
+exit(EXIT_FAILURE);
 }
 
 /**********************************************************************
-FUNCTION:	hndlMessage(SRY&, int, int *, int *)
+FUNCTION:	hndlMessage(SIM_VIEW *, void *)
 
 PURPOSE:	Deal with an incoming messages from the receiver surrogate.
 
 RETURNS:	int	
 **********************************************************************/	
 
-int hndlMessage(SRY &c, int fd, int *kaCounter, int *yBytes)
+int hndlMessage(SIM_VIEW *view, void *arg)
 {
 // InMsgArea is global
 // OutMsgArea is global
 // SerialWriter is global
 const std::string fn("hndlMessage_rs232");
-int nBytes, token, proxyValue, msgSize;
-void *serialR;
+SUR_CHILD *child = (SUR_CHILD *)arg;
+SRY &c = *child->sry;
+int nBytes, token, proxyValue, msgSize = view->nbytes;
+void *serialR = view->sender;
 SUR_MSG_HDR *hdr;
 const static int hdrSize = sizeof(SUR_MSG_HDR);
 SUR_KA_REPLY_MSG *out;
 const static int outSize = sizeof(SUR_KA_REPLY_MSG);
 SUR_PROXY_MSG *prox;
 
-// receive message from the serial reader
-msgSize = c.Receive(&serialR, nullptr, 0);
-if (msgSize == -1)
+// only the serial reader sends here, never a proxy
+if (serialR == nullptr)
 	{
-	sryLog("%s: receive error.\n", fn.c_str());
+	sryLog("%s: unexpected proxy.\n", fn.c_str());
 	return -1;
 	}
 
@@ -239,10 +175,11 @@ switch (token)
 	case SUR_SEND:
 		// set send and reply message sizes
 		nBytes = atoi(hdr->nbytes);
-		*yBytes = atoi(hdr->ybytes);
+		child->yBytes = atoi(hdr->ybytes);
 		
 		// send message to local receiver process
-		if (c.PostMessage(fd, InMsgArea + hdrSize, nBytes, *yBytes) == -1)
+		if (c.PostMessage(child->id, InMsgArea + hdrSize, nBytes, 
+													child->yBytes) == -1)
 			{
 			sryLog("%s: send error.\n", fn.c_str());
 			return -1;
@@ -255,7 +192,7 @@ switch (token)
 		proxyValue = atoi(prox->proxy);
 
 		// trigger proxy
-		if (c.Trigger(fd, proxyValue) == -1)
+		if (c.Trigger(child->id, proxyValue) == -1)
 			{
 			sryLog("%s: trigger error.\n", fn.c_str());
 			return -1;
@@ -263,7 +200,7 @@ switch (token)
 		break;
 
 	case SUR_ALIVE:
-		*kaCounter = 0;
+		child->kaCounter = 0;
 
 		// compose the reply message
 		out = (SUR_KA_REPLY_MSG *)OutMsgArea;
@@ -291,19 +228,23 @@ return 0;
 }
 
 /**********************************************************************
-FUNCTION:	hndlReply(SRY&, int)
+FUNCTION:	hndlReply(int, void *)
 
 PURPOSE:	Deal with replies from the receiver process.
 
 RETURNS:	int	
 **********************************************************************/	
 
-int hndlReply(SRY &c, int yBytes)
+int hndlReply(int fd, void *arg)
 {
 // OutMsgArea is global
 // SerialWriter is global
 // SurRpid is global
 const std::string fn("hndlReply_rs232");
+SUR_CHILD *child = (SUR_CHILD *)arg;
+SRY &c = *child->sry;
+int yBytes = child->yBytes;
+(void)fd;
 int replySize;
 const static int hdrSize = sizeof(SUR_MSG_HDR);
 
@@ -338,6 +279,40 @@ if (c.Send(SerialWriter, OutMsgArea, hdrSize + replySize, nullptr, 0) == -1)
 return 0;
 }
 	
+/**********************************************************************
+FUNCTION:	chkLocalReceiver(int, void *)
+
+PURPOSE:	Check on the local receiver and the surrogate partner's keep
+			alive messages every KaTimeout seconds.
+
+RETURNS:	int	
+**********************************************************************/	
+
+int chkLocalReceiver(int timer, void *arg)
+{
+// SurRpid is global
+SUR_CHILD *child = (SUR_CHILD *)arg;
+(void)timer;
+
+// a good opportunity to check on the local receiver
+if (child->sry->chkReceiver("", SurRpid) == false)
+	{
+	// could also send a close message to surrogate_r partner
+	// surrogate_r should pick up on the ka failures
+	exit(EXIT_SUCCESS);
+	}
+		
+// the timer has gone off check the kaCounter
+child->kaCounter += 1;
+if (child->kaCounter > KaFailLimit)
+	{
+	// we assume that our surrogate partner is no longer
+	exit(EXIT_SUCCESS);
+	}
+
+return 0;
+}
+
 /**********************************************************************
 FUNCTION:	errorReply(SRY&)
 
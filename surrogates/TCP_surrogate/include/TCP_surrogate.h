@@ -25,6 +25,15 @@ AUTHOR:			John Collins
 #include <sim.h>
 #include <surrMsgs.h>
 
+// what the Reactor() callbacks of a surrogate child work with
+typedef struct
+	{
+	int sock;
+	long id;			// surrogate_s: the local receiver
+	std::string name;	// surrogate_s: its SIM name
+	SRY *sry;
+	} SUR_CHILD;
+
 // function prototypes within TCP_surrogate.c
 int initialize(int, char **);
 
@@ -34,8 +43,9 @@ void surrogate_R(void);
 // function prototypes in TCP_surrogate_rr.c
 void surrogate_r(void);
 int hndlRemoteNameLocate(SRY&);
-int hndlLocalMsg(int, SRY&);
-int hndlRemoteMsg(int, SRY&);
+int hndlLocalMsg(SIM_VIEW *, void *);
+int hndlRemoteMsg(int, void *);
+int chkLocalSender(int, void *);
 int sendKeepAliveMsg(int);
 int hndlProxy(int, int);
 
@@ -45,7 +55,8 @@ void surrogate_S(void);
 // function prototypes within TCP_surrogate_ss.c
 void surrogate_s(int);
 int nameLocateReply(int, long, pid_t);
-int hndlMsg(int, long, SRY&);
+int hndlMsg(int, void *);
+int chkLocalReceiver(int, void *);
 int hndlKeepAlive(int);
 void errorReply(int);
 
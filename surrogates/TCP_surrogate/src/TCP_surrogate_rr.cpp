@@ -43,11 +43,9 @@ RETURNS:	nothing, it is a forked process and never returns.
 
 void surrogate_r()
 {
-// KaTimeout, KaCtr, Sender are global
+// ChkTimeout, MsgMem, MsgMemSize are global
 std::string n = TCP_Surr_r, &p = n;
-int fds[2], maxFd, ret, sock;
-fd_set watchset, inset;
-struct timeval tv, *timeoutPtr;
+SUR_CHILD child;
 
 // set the SIM name of this forked program
 p += std::to_string(getpid());
@@ -60,86 +58,30 @@ SRY nee(p);
 SRY &noo = nee;
 
 // a remote name locate message will be the first thing to happen
-if ((sock = hndlRemoteNameLocate(noo)) == -1)
+if ((child.sock = hndlRemoteNameLocate(noo)) == -1)
 	{
 	sryLog("%s: name locate error.\n", p.c_str());
 	exit(EXIT_FAILURE);
 	}
-
-// for local sry messages 
-fds[0] = nee.rfd();
-
-// for remote surrogate messages; sock set in hndlRemoteNameLocate() above 
-fds[1] = sock;
-
-// set select parameters
-FD_ZERO(&watchset);
-FD_SET(fds[0], &watchset);
-FD_SET(fds[1], &watchset);
-maxFd = (fds[0] > fds[1]) ? fds[0] + 1 : fds[1] + 1;
-
-while (true)
+child.sry = &nee;
+
+/*
+local sry messages are received straight into the message memory behind the
+header, remote surrogate messages come in on the socket set in 
+hndlRemoteNameLocate() above and the local sender is checked on periodically
+*/
+if (nee.ReactorMsg(hndlLocalMsg, &child, MsgMem, MsgMemSize) == -1 ||
+	nee.ReactorFd(child.sock, hndlRemoteMsg, &child) == -1 ||
+	nee.ReactorTimer(ChkTimeout * 1000, true, chkLocalSender, &child) == -1)
 	{
-	inset = watchset;
-	tv.tv_sec = ChkTimeout;
-	tv.tv_usec = 0;
-	timeoutPtr = &tv;
-
-	// let select be the trigger on the file descriptors/timer
-	ret = select(maxFd, &inset, NULL, NULL, timeoutPtr);
-	if (ret > 0) // local or remote message coming in
-		{
-		if (FD_ISSET(fds[0], &inset))
-			{
-			// this is a local simpl Send message
-			if (hndlLocalMsg(sock, noo) == -1)
-				{
-				sryLog("%s: hndlLocalMsg error.\n", p.c_str());
-				exit(EXIT_FAILURE);
-				}
-			}
-		else if (FD_ISSET(fds[1], &inset))
-			{
-			// send reply or keep alive reply from the remote surrogate 
-			if (hndlRemoteMsg(sock, noo) == -1)
-				{
-				sryLog("%s: hndlRemoteMsg error.\n", p.c_str());
-				exit(EXIT_FAILURE);
-				}
-			}
-		else 
-			{
-			// unknown fd error
-			sryLog("%s: unknown fd on select-%s.\n", p.c_str(),strerror(errno));
-			}
-		}
-	else if (ret == 0) // timer
-		{
-		// check on the local sender
-		if (nee.chkSender(Sender) == false)
-			{
-			// sender has gone and somehow left this surrogate behind
-			// one posibility is that the sender was SIGKILL'd
-			// send a close message to the remote surrogate partner
-			hndlClose(sock);
-			exit(EXIT_SUCCESS);
-			}
-
-		// keep alive on?
-		if (KaFlag)
-			{
-			if (sendKeepAliveMsg(sock) == -1)
-				{
-				sryLog("%s: sendKeepAliveMsg error.\n", p.c_str());
-				exit(EXIT_FAILURE);
-				}
-			}
-		}
-	else // select error
-		{
-		sryLog("%s: select error-%s.\n", p.c_str(), strerror(errno));
-		}
+	sryLog("%s: reactor set up error.\n", p.c_str());
+	exit(EXIT_FAILURE);
 	}
+
+// only returns on an error, the handlers exit on a close
+nee.Reactor();
+sryLog("%s: reactor stopped.\n", p.c_str());
+exit(EXIT_FAILURE);
 }
 
 /**********************************************************************
@@ -279,59 +221,51 @@ return sock;
 }
 
 /**********************************************************************
-FUNCTION:	hndlLocalMsg(int, SRY&)
+FUNCTION:	hndlLocalMsg(SIM_VIEW *, void *)
 
 PURPOSE:	Handle simpl SUR_SEND call from a local sender intended
-			for a remote receiver.
+			for a remote receiver. The message has been received into
+			MsgMem by the reactor.
 
 RETURNS:	int
 
 **********************************************************************/	
 
-int hndlLocalMsg(int sock, SRY &c)
+int hndlLocalMsg(SIM_VIEW *view, void *arg)
 {
-// MsgMem, MsgMemSize, HdrMemSize, Sender are global
+// HdrMemSize, TotMem, Sender are global
 const std::string fn("hndlLocalMsg");
-int msgSize, proxy;
+SUR_CHILD *child = (SUR_CHILD *)arg;
 SUR_MSG_HDR *hdr = (SUR_MSG_HDR *)HdrMem;
 
-// receive message from the local sender
-msgSize = c.Receive(&Sender, MsgMem, MsgMemSize);
-if (msgSize == -1)
-	{
-	sryLog("%s: receive error.\n",fn.c_str());
-	return -1;
-	}
-
 // is it a trigger proxy?
-if (msgSize < -1)
+if (view->sender == nullptr)
 	{
-	// get the value of the proxy
-	proxy = c.returnProxy(msgSize);
-	
 	// is it a close up shop proxy?
-	if (proxy == PROXY_SHUTDOWN)
+	if ((int)view->nbytes == PROXY_SHUTDOWN)
 		{
 		// send a close message to the remote surrogate partner
-		hndlClose(sock);
+		hndlClose(child->sock);
 		exit(EXIT_SUCCESS);
 		}
 	else
 		{
-		return hndlProxy(sock, proxy);
+		return hndlProxy(child->sock, view->nbytes);
 		}
 	}
 
+Sender = view->sender;
+
 // build the message going to the other box	
 snprintf(hdr->token, sizeof hdr->token, "%d", SUR_SEND);
-snprintf(hdr->nbytes, sizeof hdr->nbytes, "%d", msgSize);
-snprintf(hdr->ybytes, sizeof hdr->ybytes, "%d", c.getSenderRplySize(Sender));
+snprintf(hdr->nbytes, sizeof hdr->nbytes, "%u", view->nbytes);
+snprintf(hdr->ybytes, sizeof hdr->ybytes, "%u", view->ybytes);
 
 // send the message via the socket to the other box
-if (surWrite(sock, TotMem, HdrMemSize + msgSize) == -1)
+if (surWrite(child->sock, TotMem, HdrMemSize + view->nbytes) == -1)
 	{
 	sryLog("%s: write error on msg-%s.\n", fn.c_str(), strerror(errno));
-	c.ReplyError(Sender);
+	child->sry->ReplyError(Sender);
 	return -1;
 	}
 
@@ -339,17 +273,18 @@ return 0;
 }
 
 /**********************************************************************
-FUNCTION:	hndlRemoteMsg(int, SRY&)
+FUNCTION:	hndlRemoteMsg(int, void *)
 
 PURPOSE:	Handle incoming tcp/ip messages from the remote surrogate. 
 
 RETURNS:	int
 **********************************************************************/	
 
-int hndlRemoteMsg(int sock, SRY &c)
+int hndlRemoteMsg(int sock, void *arg)
 {
 // MsgMem, HdrMem, HdrMemSize, Sender, KaCtr are global
 const std::string fn("hndlRemoteMsg");
+SRY &c = *((SUR_CHILD *)arg)->sry;
 int ybytes;
 SUR_MSG_HDR *hdr = (SUR_MSG_HDR *)HdrMem;
 
@@ -404,6 +339,38 @@ switch (atoi(hdr->token))
 return 0;
 }
 
+/**********************************************************************
+FUNCTION:	chkLocalSender(int, void *)
+
+PURPOSE:	Periodically check on the local sender and keep the remote
+			surrogate alive.
+
+RETURNS:	int
+**********************************************************************/	
+
+int chkLocalSender(int timer, void *arg)
+{
+// Sender, KaFlag are global
+SUR_CHILD *child = (SUR_CHILD *)arg;
+(void)timer;
+
+// check on the local sender
+if (child->sry->chkSender(Sender) == false)
+	{
+	// sender has gone and somehow left this surrogate behind
+	// one posibility is that the sender was SIGKILL'd
+	// send a close message to the remote surrogate partner
+	hndlClose(child->sock);
+	exit(EXIT_SUCCESS);
+	}
+
+// keep alive on?
+if (KaFlag)
+	return sendKeepAliveMsg(child->sock);
+
+return 0;
+}
+
 /**********************************************************************
 FUNCTION:	sendKeepAliveMsg(int)
 
@@ -35,16 +35,14 @@ RETURNS:	nothing, it is a forked process and never returns.
 
 void surrogate_s(int sock)
 {
-// KaTimeout, KaHostName, SurrPort, MsgMem are global
+// ChkTimeout, MsgMem are global
 /*
 note that the name locate msg received by the parent is in a copy of
 MsgMem via the fork()
 */
 std::string n = TCP_Surr_s, &p = n;
-fd_set inset,  watchset; 
-struct timeval tv, *timeoutPtr;
+SUR_CHILD child;
 long id;
-int retVal;
 SUR_NAME_LOCATE_MSG *msg = (SUR_NAME_LOCATE_MSG *)MsgMem;
 pid_t childPid = getpid();
 
@@ -80,6 +78,12 @@ if (nameLocateReply(sock, id, childPid) == -1)
 if (id == -1)
 	exit(EXIT_SUCCESS);
 
+// keep the receiver name, MsgMem may move
+child.sock = sock;
+child.id = id;
+child.name = msg->sryName;
+child.sry = &nee;
+
 // check for adequate msg buffer
 if (setMsgBuffer(atoi(msg->maxSize)) == -1)
 	{ 
@@ -87,55 +91,23 @@ if (setMsgBuffer(atoi(msg->maxSize)) == -1)
 	exit(EXIT_FAILURE);	
 	}
 
-FD_ZERO(&watchset);
-FD_SET(sock, &watchset);
-
 // handle incoming messages destined for a local receiver
-while (true)
+if (nee.ReactorFd(sock, hndlMsg, &child) == -1 ||
+	nee.ReactorTimer(ChkTimeout * 1000, true, chkLocalReceiver, &child) == -1)
 	{
-	inset = watchset;
-	tv.tv_sec = ChkTimeout;
-	tv.tv_usec = 0;
-	timeoutPtr = &tv;
-
-	// let select be the trigger on the file descriptor/timer
-	retVal = select(sock + 1, &inset, NULL, NULL, timeoutPtr);
-	if (retVal > 0) 
-		{
-		if (FD_ISSET(sock, &inset))
-			{
-			// a message from surrogate partner
-			if (hndlMsg(sock, id, noo) == -1)
-				{
-				errorReply(sock);
-				exit(EXIT_FAILURE);
-				}
-			}
-		else 	// unknown fd error
-			{
-			sryLog("%s: fd error on select\n", p.c_str());
-			}
-		}
-	else if (retVal == 0) // timer
-		{
-		// check on the local receiver
-		// surrogate_r should also pick up on the ka failures (if active)
-		if (noo.chkReceiver(msg->sryName, 0) == false)
-			{
-			// send a close message to the remote surrogate partner
-			hndlClose(sock);
-			exit(EXIT_SUCCESS);
-			}
-		}
-	else	// select error
-		{
-		sryLog("%s: select error-%s\n", p.c_str(), strerror(errno));
-		}
+	sryLog("%s: reactor set up error\n", p.c_str());
+	errorReply(sock);
+	exit(EXIT_FAILURE);
 	}
+
+// only returns on an error, the handlers exit on a close
+nee.Reactor();
+errorReply(sock);
+exit(EXIT_FAILURE);
 }
 
 /**********************************************************************
-FUNCTION:	hndlMsg(int, long, SRY&)
+FUNCTION:	hndlMsg(int, void *)
 
 PURPOSE:	Deal with an incoming message from the remote receiver
 			surrogate.
@@ -144,10 +116,13 @@ RETURNS:	success:	 0
 			failure:	-1
 **********************************************************************/	
 
-int hndlMsg(int sock, long id, SRY &n)
+int hndlMsg(int sock, void *arg)
 {
 // HdrMem, HdrMemSize are global
 const std::string fn("hndlMsg");
+SUR_CHILD *child = (SUR_CHILD *)arg;
+SRY &n = *child->sry;
+long id = child->id;
 unsigned int nBytes, yBytes, maxBytes;
 int replySize;
 SUR_MSG_HDR *hdr = (SUR_MSG_HDR *)HdrMem;
@@ -241,6 +216,30 @@ switch (atoi(hdr->token))
 return 0;
 }
 
+/**********************************************************************
+FUNCTION:	chkLocalReceiver(int, void *)
+
+PURPOSE:	Periodically check on the local receiver.
+
+RETURNS:	success:	 0
+**********************************************************************/	
+
+int chkLocalReceiver(int timer, void *arg)
+{
+SUR_CHILD *child = (SUR_CHILD *)arg;
+(void)timer;
+
+// surrogate_r should also pick up on the ka failures (if active)
+if (child->sry->chkReceiver(child->name.c_str(), 0) == false)
+	{
+	// send a close message to the remote surrogate partner
+	hndlClose(child->sock);
+	exit(EXIT_SUCCESS);
+	}
+
+return 0;
+}
+
 /**********************************************************************
 FUNCTION:	int nameLocateReply(int, long, pid_t)
 
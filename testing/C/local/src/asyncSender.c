@@ -0,0 +1,109 @@
+/******************************************************************************
+FILE:			asyncSender.c
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program keeps a message to each of several receivers in
+				flight at once. Whichever receiver replies first is read by
+				way of WaitReplies() and sent its next message straight away,
+				until each receiver has had # messages. It is meant to work
+				with receiver.c.
+
+AUTHOR:			FC Software Inc.
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sim.h>
+
+#define MAX_RECEIVERS	8
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int receiverId[MAX_RECEIVERS], ticket[MAX_RECEIVERS], sent[MAX_RECEIVERS];
+int out[memLimit], in[MAX_RECEIVERS][memLimit];
+int numReceivers, limit, replies = 0, failures = 0, t, r;
+
+if (argc < 4 || argc - 3 > MAX_RECEIVERS)
+	{
+	printf("incorrect cmd line: asyncSender senderName # receiverName ...\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (openSRY(argv[1]) == -1)
+	{
+	printf("unable to initialize sry sender\n");
+	exit(EXIT_FAILURE);
+	}
+
+limit = atoi(argv[2]);
+numReceivers = argc - 3;
+
+// a first message to each of the receivers
+for (r = 0; r < numReceivers; r++)
+	{
+	receiverId[r] = Locate("", argv[r + 3], sizeof out, SIM_LOCAL);
+	if (receiverId[r] == -1)
+		{
+		printf("Can't locate receiver %s\n", argv[r + 3]);
+		exit(EXIT_FAILURE);
+		}
+
+	ticket[r] = SendAsync(receiverId[r], out, sizeof out, in[r], sizeof in[r]);
+	if (ticket[r] == -1)
+		{
+		printf("Failed send\n");
+		exit(EXIT_FAILURE);
+		}
+	sent[r] = 1;
+	}
+
+// the next message to whichever receiver replies
+while (numReceivers)
+	{
+	t = WaitReplies(ticket, numReceivers);
+	if (t == -1)
+		{
+		printf("Failed wait\n");
+		exit(EXIT_FAILURE);
+		}
+
+	for (r = 0; ticket[r] != t; r++)
+		;
+
+	if (ReadTicketReply(t, NULL) == -1)
+		failures++;
+	else
+		replies++;
+
+	if (sent[r] < limit)
+		{
+		ticket[r] = SendAsync(receiverId[r], out, sizeof out, in[r],
+																sizeof in[r]);
+		if (ticket[r] == -1)
+			{
+			printf("Failed send\n");
+			exit(EXIT_FAILURE);
+			}
+		sent[r]++;
+		continue;
+		}
+
+	// this receiver is done with, the last one takes its place
+	numReceivers--;
+	ticket[r] = ticket[numReceivers];
+	receiverId[r] = receiverId[numReceivers];
+	sent[r] = sent[numReceivers];
+	}
+
+printf("replies=%d failures=%d\n", replies, failures);
+
+if (closeSRY() == -1)
+	{
+	printf("Failed to close\n");
+	exit(EXIT_FAILURE);
+	}
+
+return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
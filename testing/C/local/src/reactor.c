@@ -0,0 +1,134 @@
+/******************************************************************************
+FILE:			reactor.c
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This file tests the reactor. It runs with sender.c. Messages
+				and proxies are received as by selector.c, the message count
+				is shown every second and a line of "quit" on stdin ends it.
+
+AUTHOR:			FC Software Inc.
+******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sim.h>
+
+static unsigned cnt = 0;
+
+static int hndlMsg(SIM_VIEW *, void *);
+static int hndlStdin(int, void *);
+static int hndlTimer(int, void *);
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int buf[memLimit];
+
+if (argc != 2)
+	{
+	printf("incorrect cmd line: reactor receiverName\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (openSRY(argv[1]) == -1)
+	{
+	printf("unable to initialize sry receiver\n");
+	exit(EXIT_FAILURE);
+	}
+
+// messages copied into buf, stdin lines and a 1 second timer
+if (ReactorMsg(hndlMsg, NULL, buf, sizeof buf) == -1 ||
+	ReactorFd(STDIN_FILENO, hndlStdin, NULL) == -1 ||
+	ReactorTimer(1000, true, hndlTimer, NULL) == -1)
+	{
+	printf("Failed reactor set up\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (Reactor() == -1)
+	{
+	printf("Failed reactor\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (closeSRY() == -1)
+	{
+	printf("Failed to close\n");
+	exit(EXIT_FAILURE);	
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	hndlMsg(SIM_VIEW *, void *)
+
+PURPOSE:	Reply to a message or show a proxy.
+
+RETURNS:	0, carry on
+**********************************************************************/
+
+static int hndlMsg(SIM_VIEW *view, void *arg)
+{
+(void)arg;
+
+if (view->sender == NULL)
+	{
+	printf("trigger proxy=%u\n", view->nbytes);
+	return 0;
+	}
+
+printf("Got message %u\n", ++cnt);
+
+if (Reply(view->sender, NULL, 0) == -1)
+	{
+	printf("Failed reply\n");
+	exit(EXIT_FAILURE);
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	hndlStdin(int, void *)
+
+PURPOSE:	Read a line from stdin.
+
+RETURNS:	0, carry on; -1 on quit or end of file
+**********************************************************************/
+
+static int hndlStdin(int fd, void *arg)
+{
+char line[80];
+ssize_t n;
+(void)arg;
+
+n = read(fd, line, sizeof line - 1);
+if (n <= 0)
+	return -1;
+line[n] = 0;
+
+return strncmp(line, "quit", 4) ? 0 : -1;
+}
+
+/**********************************************************************
+FUNCTION:	hndlTimer(int, void *)
+
+PURPOSE:	Show the number of messages so far.
+
+RETURNS:	0, carry on
+**********************************************************************/
+
+static int hndlTimer(int timer, void *arg)
+{
+(void)timer;
+(void)arg;
+
+printf("messages=%u\n", cnt);
+
+return 0;
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+FILE:			server.c
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This file tests Serve(). It runs with sender.c, receiver.c and
+				trigger.c. Messages are replied to by # worker threads, each
+				of which first tries to send the message on to the receiver;
+				a worker cannot send, so every such send should fail. A proxy
+				stops the serving.
+
+AUTHOR:			FC Software Inc.
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sim.h>
+
+static const char *ReceiverName;
+static unsigned Replied = 0;
+static unsigned Sent = 0;
+
+static int hndlMsg(SIM_VIEW *, void *);
+
+int main(int argc, char **argv)
+{
+int rc;
+
+if (argc != 4)
+	{
+	printf("incorrect cmd line: server serverName receiverName #\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (openSRY(argv[1]) == -1)
+	{
+	printf("unable to initialize sry server\n");
+	exit(EXIT_FAILURE);
+	}
+
+ReceiverName = argv[2];
+
+rc = Serve(hndlMsg, NULL, atoi(argv[3]));
+
+printf("replied=%u sent by a worker=%u\n", Replied, Sent);
+
+if (closeSRY() == -1)
+	{
+	printf("Failed to close\n");
+	exit(EXIT_FAILURE);
+	}
+
+return (rc == -1 || Sent > 0) ? EXIT_FAILURE : 0;
+}
+
+/**********************************************************************
+FUNCTION:	hndlMsg(SIM_VIEW *, void *)
+
+PURPOSE:	Try to send the message on to the receiver, which should fail,
+			and reply it back to the sender.
+
+RETURNS:	0, carry on; -1 on a proxy
+**********************************************************************/
+
+static int hndlMsg(SIM_VIEW *view, void *arg)
+{
+int in[1024];
+int receiverId;
+(void)arg;
+
+if (view->sender == NULL)
+	{
+	printf("trigger proxy=%u, stopping\n", view->nbytes);
+	return -1;
+	}
+
+receiverId = Locate("", ReceiverName, view->nbytes, SIM_LOCAL);
+if (receiverId != -1 &&
+		Send(receiverId, view->data, view->nbytes, in, sizeof in) != -1)
+	{
+	printf("Worker sent a message\n");
+	__atomic_add_fetch(&Sent, 1, __ATOMIC_RELAXED);
+	}
+
+if (Reply(view->sender, view->data, view->nbytes) == -1)
+	{
+	printf("Failed reply\n");
+	return -1;
+	}
+
+__atomic_add_fetch(&Replied, 1, __ATOMIC_RELAXED);
+
+return 0;
+}
@@ -0,0 +1,102 @@
+/******************************************************************************
+FILE:			streamReceiver.c
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program makes a stream whose records are read when its
+				proxy comes in by way of Receive(), along with any messages 
+				and other proxies, so that the one loop serves both. It stops
+				once the producer closes. It is meant to work with the CPP 
+				streamer.
+
+AUTHOR:			FC Software Inc.
+******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sim.h>
+
+#define STREAM_PROXY	1
+
+typedef struct
+	{
+	unsigned long seq;
+	unsigned long check;
+	} RECORD;
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int in[memLimit];
+int stream, msgSize, waiting, torn = 0;
+unsigned long count = 0, last = 0;
+void *senderId;
+RECORD rec;
+
+if (argc != 3)
+	{
+	printf("incorrect cmd line: streamReceiver receiverName streamName\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (openSRY(argv[1]) == -1)
+	{
+	printf("unable to initialize sry receiver\n");
+	exit(EXIT_FAILURE);
+	}
+
+stream = OpenStream(argv[2], sizeof rec, 1024, SIM_STREAM_BLOCK, STREAM_PROXY);
+if (stream == -1)
+	{
+	printf("Can't open stream %s\n", argv[2]);
+	exit(EXIT_FAILURE);
+	}
+
+while (true)
+	{
+	msgSize = Receive(&senderId, in, sizeof in);
+	if (msgSize == -1)
+		{
+		printf("Failed receive\n");
+		exit(EXIT_FAILURE);
+		}
+
+	// a message rather than the stream's proxy
+	if (msgSize >= 0)
+		{
+		Reply(senderId, NULL, 0);
+		continue;
+		}
+	if (returnProxy(msgSize) != STREAM_PROXY)
+		continue;
+
+	// read all there is; finding none asks for the proxy again
+	while ((waiting = ChkStream(stream)) > 0)
+		{
+		if (ReadStream(stream, &rec, sizeof rec) != sizeof rec)
+			{
+			printf("Failed read\n");
+			exit(EXIT_FAILURE);
+			}
+		if (rec.check != ~rec.seq || rec.seq != last + 1)
+			torn++;
+		last = rec.seq;
+		count++;
+		}
+
+	// the producer is done
+	if (waiting == -1)
+		break;
+	}
+
+printf("read=%lu last=%lu torn=%d\n", count, last, torn);
+
+if (closeSRY() == -1)
+	{
+	printf("Failed to close\n");
+	exit(EXIT_FAILURE);
+	}
+
+return torn ? EXIT_FAILURE : EXIT_SUCCESS;
+}
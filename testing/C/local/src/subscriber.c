@@ -0,0 +1,106 @@
+/******************************************************************************
+FILE:			subscriber.c
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program subscribes to a channel and polls the channel fd
+				along with stdin, reading the messages published whenever the
+				fd is readable. It stops once the publisher closes the channel
+				or on a line of "quit" typed in. It is meant to work with the
+				CPP publisher.
+
+AUTHOR:			FC Software Inc.
+******************************************************************************/
+
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sim.h>
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int in[memLimit];
+int channel, waiting, torn = 0, done = 0, j;
+unsigned long seq = 0, count = 0;
+struct pollfd fds[2];
+char line[80];
+
+if (argc != 3)
+	{
+	printf("incorrect cmd line: subscriber subscriberName channelName\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (openSRY(argv[1]) == -1)
+	{
+	printf("unable to initialize sry subscriber\n");
+	exit(EXIT_FAILURE);
+	}
+
+channel = Subscribe(argv[2]);
+if (channel == -1)
+	{
+	printf("Can't subscribe to channel %s\n", argv[2]);
+	exit(EXIT_FAILURE);
+	}
+
+fds[0].fd = ChannelFd(channel);
+fds[0].events = POLLIN;
+fds[1].fd = STDIN_FILENO;
+fds[1].events = POLLIN;
+
+while (!done)
+	{
+	if (poll(fds, 2, -1) == -1)
+		{
+		printf("Failed poll\n");
+		exit(EXIT_FAILURE);
+		}
+
+	if (fds[1].revents & POLLIN)
+		{
+		if (fgets(line, sizeof line, stdin) == NULL || !strncmp(line, "quit", 4))
+			done = 1;
+		}
+
+	if (!(fds[0].revents & POLLIN))
+		continue;
+
+	// read all there is; ChkChannel() finding none waits on the fd again
+	while ((waiting = ChkChannel(channel)) > 0)
+		{
+		if (ReadChannel(channel, in, sizeof in, &seq) == -1)
+			{
+			printf("Failed read\n");
+			exit(EXIT_FAILURE);
+			}
+		count++;
+
+		// the publisher fills message n with n
+		for (j = 0; j < memLimit; j++)
+			if (in[j] != (int)seq)
+				{
+				torn++;
+				break;
+				}
+		}
+
+	// closed by the publisher
+	if (waiting == -1)
+		done = 1;
+	}
+
+printf("read=%lu lost=%ld last=%lu torn=%d\n", count, getChannelLost(channel),
+																	seq, torn);
+
+if (closeSRY() == -1)
+	{
+	printf("Failed to close\n");
+	exit(EXIT_FAILURE);
+	}
+
+return torn ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+FILE:			threadSender.c
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program checks that the threads of a process share its
+				SIM instance unless they open their own. The main thread
+				opens SIM and a thread that has not opened it sends #
+				messages to the receiver by way of the main thread's
+				instance. Then a thread opening an instance of its own, with
+				the perThread option, sends # messages alongside the main
+				thread sending # messages. It is meant to work with
+				receiver.c.
+
+AUTHOR:			FC Software Inc.
+******************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define MEM_LIMIT	1024
+
+static const char *ReceiverName;
+static char ThreadName[MAX_SIM_NAME_LEN + 1];
+static int Limit;
+
+// send Limit messages to the receiver, returning the number that failed
+static int sendAll()
+{
+int out[MEM_LIMIT], in[MEM_LIMIT];
+int receiverId, failures = 0;
+
+receiverId = Locate("", ReceiverName, sizeof out, SIM_LOCAL);
+if (receiverId == -1)
+	return Limit;
+
+for (int i = 0; i < MEM_LIMIT; ++i)
+	out[i] = i;
+
+for (int i = 0; i < Limit; ++i)
+	if (Send(receiverId, out, sizeof out, in, sizeof in) == -1)
+		failures++;
+
+return failures;
+}
+
+// a thread that has not opened SIM sends by way of the process' instance
+static void *sharedSender(void *arg)
+{
+*(int *)arg = sendAll();
+return NULL;
+}
+
+// a thread with an instance of its own
+static void *ownSender(void *arg)
+{
+SIM_OPTIONS opts;
+
+if (initSimOptions(&opts) == -1)
+	{
+	*(int *)arg = Limit;
+	return NULL;
+	}
+opts.perThread = true;
+
+if (openSRYopts(ThreadName, &opts) == -1)
+	{
+	printf("unable to initialize the thread's own sry\n");
+	*(int *)arg = Limit;
+	return NULL;
+	}
+
+*(int *)arg = sendAll();
+
+closeSRY();
+return NULL;
+}
+
+int main(int argc, char **argv)
+{
+pthread_t tid;
+int sharedFailures = 0, ownFailures = 0, mainFailures = 0;
+
+if (argc != 4)
+	{
+	printf("incorrect cmd line: threadSender senderName receiverName #\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (openSRY(argv[1]) == -1)
+	{
+	printf("unable to initialize sry sender\n");
+	exit(EXIT_FAILURE);
+	}
+
+ReceiverName = argv[2];
+Limit = atoi(argv[3]);
+snprintf(ThreadName, sizeof ThreadName, "%.*s.t1", MAX_SIM_NAME_LEN - 3,
+																	argv[1]);
+
+// the main thread waits while the other thread uses its instance
+if (pthread_create(&tid, NULL, sharedSender, &sharedFailures) != 0)
+	{
+	printf("unable to start a thread\n");
+	exit(EXIT_FAILURE);
+	}
+pthread_join(tid, NULL);
+
+// both send at once, each by way of its own instance
+if (pthread_create(&tid, NULL, ownSender, &ownFailures) != 0)
+	{
+	printf("unable to start a thread\n");
+	exit(EXIT_FAILURE);
+	}
+mainFailures = sendAll();
+pthread_join(tid, NULL);
+
+printf("failures: shared thread %d, own thread %d, main thread %d\n",
+								sharedFailures, ownFailures, mainFailures);
+
+closeSRY();
+
+return (sharedFailures || ownFailures || mainFailures) ? EXIT_FAILURE : 0;
+}
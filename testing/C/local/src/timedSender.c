@@ -0,0 +1,77 @@
+/******************************************************************************
+FILE:			timedSender.c
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program locates a receiver and sends it # messages with
+				SendTimed(), giving up on any reply that takes longer than
+				msecs milliseconds. Replies and timeouts are counted; a reply
+				that comes in must still be the one for its own message. It
+				is meant to work with receiver.c, stopped now and then (kill
+				-STOP/-CONT) so that some of the sends run out of time.
+
+AUTHOR:			FC Software Inc.
+******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sim.h>
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int out[memLimit], in[memLimit];
+int receiverId, limit, msecs, rc;
+int replies = 0, timeouts = 0, failures = 0;
+
+if (argc != 5)
+	{
+	printf("incorrect cmd line: timedSender senderName receiverName # msecs\n");
+	exit(EXIT_FAILURE);
+	}
+
+if (openSRY(argv[1]) == -1)
+	{
+	printf("unable to initialize sry sender\n");
+	exit(EXIT_FAILURE);
+	}
+
+limit = atoi(argv[3]);
+msecs = atoi(argv[4]);
+
+receiverId = LocateTimed("", argv[2], sizeof out, SIM_LOCAL, msecs);
+if (receiverId == -1)
+	{
+	printf("Can't locate receiver %s\n", argv[2]);
+	exit(EXIT_FAILURE);
+	}
+
+for (int i = 0; i < memLimit; ++i)
+	out[i] = i;
+
+for (int j = 0; j < limit; j++)
+	{
+	in[0] = -1;
+	rc = SendTimed(receiverId, out, sizeof out, in, sizeof in, msecs);
+	if (rc == -1 && errno == ETIMEDOUT)
+		timeouts++;
+	else if (rc == -1)
+		failures++;
+	// receiver.c replies the numbers in reverse order
+	else if (rc != (int)sizeof in || in[0] != memLimit - 1)
+		failures++;
+	else
+		replies++;
+	}
+
+printf("replies=%d timeouts=%d failures=%d\n", replies, timeouts, failures);
+
+if (closeSRY() == -1)
+	{
+	printf("Failed to close\n");
+	exit(EXIT_FAILURE);
+	}
+
+return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
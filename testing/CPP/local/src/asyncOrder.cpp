@@ -0,0 +1,133 @@
+/*******************************************************************************
+FILE:			asyncOrder.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program checks that coroutines awaiting SendAsync() 
+				replies are resumed in the order the replies come in, not 
+				the order the messages were sent, under the futex transport
+				and a spin or poll wait policy (spin unless SIM_WAIT_POLICY 
+				says poll). One coroutine 
+				sends the first receiver a single message and the others send
+				the other receivers # messages each. The first receiver is 
+				meant to be slow, a timedReceiver holding every message, and
+				the others quick, receivers; every quick coroutine must then
+				be done before the slow reply is in.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <coroutine>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sim.h>
+
+using namespace std;
+
+const int memLimit = 1024;
+
+// fire and forget coroutine; it runs until its first co_await
+struct Task
+	{
+	struct promise_type
+		{
+		Task get_return_object() { return {}; }
+		suspend_never initial_suspend() noexcept { return {}; }
+		suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { terminate(); }
+		};
+	};
+
+static Task callReceiver(SRY&, int, int, int, vector<int>&);
+
+int main(int argc, char **argv)
+{
+vector<int> receiverId, done;
+string hname;
+SIM_OPTIONS opts;
+int limit, id;
+
+if (argc < 5)
+	{
+	cout << "incorrect cmd line: asyncOrder senderName # slowReceiverName ";
+	cout << "receiverName ..." << endl;
+	exit(EXIT_FAILURE);
+	}
+
+if (initSimOptions(&opts) == -1)
+	{
+	cout << "Bad SIM options" << endl;
+	exit(EXIT_FAILURE);
+	}
+opts.transport = SIM_FUTEX;
+if (opts.waitPolicy == SIM_WAIT_BLOCK)
+	opts.waitPolicy = SIM_WAIT_SPIN;
+
+SRY nee(argv[1], opts);
+
+limit = atoi(argv[2]);
+
+for (int i = 3; i < argc; i++)
+	{
+	if ((id = nee.Locate(hname, argv[i], memLimit * sizeof(int), SIM_LOCAL)) == -1)
+		{
+		cout << "Can't locate receiver " << argv[i] << endl;
+		exit(EXIT_FAILURE);
+		}
+	receiverId.push_back(id);
+	}
+
+// the slow receiver's message goes first, ahead of all of the others
+callReceiver(nee, receiverId[0], 0, 1, done);
+for (size_t i = 1; i < receiverId.size(); i++)
+	callReceiver(nee, receiverId[i], i, limit, done);
+
+while (nee.ResumeAsync(true) > 0)
+	;
+
+cout << "done in order:";
+for (auto r : done)
+	cout << " " << argv[r + 3];
+cout << endl;
+
+// the slow receiver's coroutine must be the last one done
+if (done.size() != receiverId.size() || done.back() != 0)
+	{
+	cout << "replies not taken in the order they came" << endl;
+	return EXIT_FAILURE;
+	}
+
+return EXIT_SUCCESS;
+}
+
+/**********************************************************************
+FUNCTION:	Task callReceiver(SRY&, int, int, int, vector<int>&)
+
+PURPOSE:	Send limit messages to receiver num one after the other, then
+			note that it is done.
+
+RETURNS:	nothing
+**********************************************************************/
+
+static Task callReceiver(SRY &nee, int id, int num, int limit, vector<int> &done)
+{
+int out[memLimit], in[memLimit];
+
+// every message is held by a timedReceiver holding every one
+out[0] = 1;
+
+for (int i = 0; i < limit; i++)
+	{
+	if (co_await nee.SendAsync(id, out, sizeof out, in, sizeof in) == -1)
+		{
+		cout << "Failed send" << endl;
+		co_return;
+		}
+	}
+
+done.push_back(num);
+}
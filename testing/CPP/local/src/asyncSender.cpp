@@ -0,0 +1,124 @@
+/*******************************************************************************
+FILE:			asyncSender.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program keeps a message to each of several receivers in
+				flight at once from the one thread. It first does so with
+				SendAsync() reply handles and get(), then with one coroutine
+				per receiver that co_awaits its replies, the coroutines being
+				resumed by ResumeAsync(). It is meant to work with receiver.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <coroutine>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sim.h>
+
+using namespace std;
+
+const int memLimit = 1024;
+
+// fire and forget coroutine; it runs until its first co_await
+struct Task
+	{
+	struct promise_type
+		{
+		Task get_return_object() { return {}; }
+		suspend_never initial_suspend() noexcept { return {}; }
+		suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { terminate(); }
+		};
+	};
+
+static Task callReceiver(SRY&, int, int, int&);
+
+int main(int argc, char **argv)
+{
+vector<int> receiverId;
+string hname;
+int limit, replies = 0, failures = 0, id;
+
+if (argc < 4)
+	{
+	cout << "incorrect cmd line: asyncSender senderName # receiverName ...";
+	cout << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+limit = atoi(argv[2]);
+
+for (int i = 3; i < argc; i++)
+	{
+	if ((id = nee.Locate(hname, argv[i], memLimit * sizeof(int), SIM_LOCAL)) == -1)
+		{
+		cout << "Can't locate receiver " << argv[i] << endl;
+		exit(EXIT_FAILURE);
+		}
+	receiverId.push_back(id);
+	}
+
+// post to all of the receivers, then gather the replies
+vector<int> out(memLimit), in(memLimit * receiverId.size());
+for (int j = 0; j < limit; j++)
+	{
+	vector<SRY_ASYNC> reply;
+	for (size_t i = 0; i < receiverId.size(); i++)
+		reply.push_back(nee.SendAsync(receiverId[i], out.data(),
+					memLimit * sizeof(int), &in[i * memLimit], memLimit * sizeof(int)));
+
+	for (auto &r : reply)
+		{
+		if (r.get() == -1)
+			failures++;
+		else
+			replies++;
+		}
+	}
+cout << "futures: replies=" << replies << " failures=" << failures << endl;
+
+// a coroutine per receiver, all run by the one thread
+replies = 0;
+for (auto r : receiverId)
+	callReceiver(nee, r, limit, replies);
+
+while (nee.ResumeAsync(true) > 0)
+	;
+cout << "coroutines: replies=" << replies << endl;
+
+return (failures || replies != limit * (int)receiverId.size()) ?
+													EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**********************************************************************
+FUNCTION:	Task callReceiver(SRY&, int, int, int&)
+
+PURPOSE:	Send limit messages to a receiver one after the other, the
+			thread going on to the other coroutines while each awaits its
+			reply.
+
+RETURNS:	nothing
+**********************************************************************/
+
+static Task callReceiver(SRY &nee, int id, int limit, int &replies)
+{
+int out[memLimit], in[memLimit];
+
+for (int i = 0; i < limit; i++)
+	{
+	if (co_await nee.SendAsync(id, out, sizeof out, in, sizeof in) == -1)
+		{
+		cout << "Failed send" << endl;
+		co_return;
+		}
+	replies++;
+	}
+}
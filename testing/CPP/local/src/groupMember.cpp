@@ -0,0 +1,68 @@
+/*******************************************************************************
+FILE:			groupMember.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program joins a receiver group and replies to each of
+				the messages sent to it with its own SIM name, so that the 
+				sender can see which member took the message. A proxy ends
+				it. It is meant to work with groupSender.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sim.h>
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+char buf[4096];
+int msgSize;
+unsigned int cnt = 0;
+void *senderId;
+SIM_OPTIONS opts;
+
+if (argc != 3)
+	{
+	cout << "incorrect cmd line: groupMember receiverName groupName" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+if (initSimOptions(&opts) == -1)
+	{
+	cout << "Bad SIM options" << endl;
+	exit(EXIT_FAILURE);
+	}
+opts.group = argv[2];
+
+SRY nee(argv[1], opts);
+
+while (true)
+	{
+	msgSize = nee.Receive(&senderId, buf, sizeof buf);
+	if (msgSize == -1)
+		{
+		cout << "Failed receive" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+	if (msgSize < -1)
+		break;
+
+	snprintf(buf, sizeof buf, "%s", argv[1]);
+	if (nee.Reply(senderId, buf, strlen(buf) + 1) == -1)
+		{
+		cout << "Failed reply" << endl;
+		exit(EXIT_FAILURE);
+		}
+	++cnt;
+	}
+
+cout << argv[1] << ": replied to " << cnt << " messages" << endl;
+
+return 0;
+}
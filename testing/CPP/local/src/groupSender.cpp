@@ -0,0 +1,87 @@
+/*******************************************************************************
+FILE:			groupSender.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program locates a receiver group as @groupName and sends
+				it # messages, which the group's members share between them,
+				and then # messages by SendKeyed() under the one key, which
+				must all go to the same member. The replies tell which of
+				the members took each message. A proxy to each member by
+				name ends them. It is meant to work with groupMember.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <sim.h>
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+char in[MAX_SIM_NAME_LEN + 1], out[10] = "";
+map<string, int> shared;
+string hname, keyed;
+int groupId, limit, failures = 0;
+
+if (argc != 4)
+	{
+	cout << "incorrect cmd line: groupSender senderName groupName #" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+limit = atoi(argv[3]);
+
+if ((groupId = nee.Locate(hname, string("@") + argv[2], sizeof out, 
+														SIM_LOCAL)) == -1)
+	{
+	cout << "Can't locate group " << argv[2] << endl;
+	exit(EXIT_FAILURE);
+	}
+
+// spread over the members
+for (int i = 0; i < limit; i++)
+	{
+	if (nee.Send(groupId, out, sizeof out, in, sizeof in) == -1)
+		{
+		cout << "Failed send" << endl;
+		exit(EXIT_FAILURE);
+		}
+	shared[in]++;
+	}
+
+for (auto &m : shared)
+	cout << "shared: " << m.first << "=" << m.second << endl;
+
+// all to the one member
+for (int i = 0; i < limit; i++)
+	{
+	if (nee.SendKeyed(groupId, out, sizeof out, in, sizeof in, 7) == -1)
+		{
+		cout << "Failed send" << endl;
+		exit(EXIT_FAILURE);
+		}
+	if (i == 0)
+		keyed = in;
+	else if (keyed != in)
+		failures++;
+	}
+
+cout << "keyed: " << keyed << "=" << limit - failures << endl;
+
+// a proxy to each member by name ends it
+for (auto &m : shared)
+	{
+	int id = nee.Locate(hname, m.first, 0, SIM_LOCAL);
+	if (id == -1 || nee.Trigger(id, 1) == -1)
+		failures++;
+	}
+
+return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
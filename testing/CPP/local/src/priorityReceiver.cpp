@@ -0,0 +1,73 @@
+/*******************************************************************************
+FILE:			priorityReceiver.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program notes the proxies that it receives. The proxy
+				pauseProxy has it stop receiving for a second, long enough 
+				for a backlog to build up. A message is replied with the list
+				of proxies received since the last pause, in the order they 
+				were received. It is meant to work with prioritySender and to
+				be run with SIM_RECEIVE_ORDER=priority (or inherit).
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const int pauseProxy = 1000;
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int msgSize, proxy, buf[memLimit];
+void *senderId;
+vector<int> proxies;
+
+if (argc != 2)
+	{
+	cout << "incorrect cmd line: priorityReceiver receiverName" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+while (true)
+	{
+	msgSize = nee.Receive(&senderId, buf, sizeof buf);
+	if (msgSize == -1)
+		{
+		cout << "Failed receive" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+	if (msgSize < -1)
+		{
+		proxy = nee.returnProxy(msgSize);
+		if (proxy == pauseProxy)
+			{
+			proxies.clear();
+			sleep(1);
+			}
+		else
+			proxies.push_back(proxy);
+		continue;
+		}
+
+	if (nee.Reply(senderId, proxies.data(), proxies.size() * sizeof(int)) == -1)
+		{
+		cout << "Failed reply" << endl;
+		exit(EXIT_FAILURE);	
+		}
+	cout << "replied " << proxies.size() << " proxies" << endl;
+	}
+
+return 0;
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************
+FILE:			prioritySender.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program pauses a receiver and, while it is paused, 
+				triggers # proxies with priorities from 0 to 9 in a mixed up
+				order. It then sends a message of priority 0, which must be
+				received after all of them, and is replied the order in which
+				the proxies were received. That order must be highest priority
+				first and in order of sending among equal priorities. It is 
+				meant to work with priorityReceiver.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sim.h>
+
+using namespace std;
+
+const int pauseProxy = 1000, memLimit = 1024;
+
+int main(int argc, char **argv)
+{
+int receiverId, limit, nbytes, in[memLimit], outOfOrder = 0;
+string hname;
+
+if (argc != 4)
+	{
+	cout << "incorrect cmd line: prioritySender senderName receiverName #";
+	cout << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+limit = atoi(argv[3]);
+if (limit < 1 || limit >= pauseProxy || limit > memLimit)
+	{
+	cout << "# must be from 1 to " << pauseProxy - 1 << endl;
+	exit(EXIT_FAILURE);
+	}
+
+if ((receiverId = nee.Locate(hname, argv[2], 0, SIM_LOCAL)) == -1)
+	{
+	cout << "Can't locate receiver " << argv[2] << endl;
+	exit(EXIT_FAILURE);
+	}
+
+// have the receiver stop for a backlog to build up, ahead of any proxies
+if (nee.TriggerPriority(receiverId, pauseProxy, SIM_MAX_PRIORITY) == -1)
+	{
+	cout << "Failed trigger" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+// proxy i goes with priority (i * 7) % 10
+for (int i = 1; i <= limit; i++)
+	{
+	if (nee.TriggerPriority(receiverId, i, (i * 7) % 10) == -1)
+		{
+		cout << "Failed trigger" << endl;
+		exit(EXIT_FAILURE);
+		}
+	}
+
+// the lowest priority and the last to be sent, so the last received
+nbytes = nee.SendPriority(receiverId, NULL, 0, in, sizeof in, 0);
+if (nbytes != limit * (int)sizeof(int))
+	{
+	cout << "Failed send, or proxies missing" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+for (int i = 1; i < limit; i++)
+	{
+	int p = (in[i - 1] * 7) % 10, q = (in[i] * 7) % 10;
+	if (p < q || (p == q && in[i - 1] > in[i]))
+		outOfOrder++;
+	}
+
+cout << "proxies=" << limit << " out of order=" << outOfOrder << endl;
+
+return outOfOrder ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+FILE:			proxyCounter.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program receives proxies coalesced in its proxy table
+				until # of them have been triggered. Each distinct proxy of
+				a burst is received once and its count added up. A message
+				is replied with the number of proxies counted so far. It is 
+				meant to work with trigger.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <sim.h>
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int msgSize, proxy, count, limit, buf[memLimit];
+int counted = 0, receives = 0;
+void *senderId;
+SIM_OPTIONS opts;
+
+if (argc != 3)
+	{
+	cout << "incorrect cmd line: proxyCounter receiverName #" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+limit = atoi(argv[2]);
+
+if (initSimOptions(&opts) == -1)
+	{
+	cout << "Bad SIM options" << endl;
+	exit(EXIT_FAILURE);
+	}
+opts.proxyMode = SIM_PROXY_COALESCE;
+
+SRY nee(argv[1], opts);
+
+while (counted < limit)
+	{
+	msgSize = nee.Receive(&senderId, buf, sizeof buf);
+	if (msgSize == -1)
+		{
+		cout << "Failed receive" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+	if (msgSize < -1)
+		{
+		proxy = nee.returnProxy(msgSize);
+		count = nee.getProxyCount();
+		cout << "proxy=" << proxy << " count=" << count << endl;
+		counted += count;
+		receives++;
+		continue;
+		}
+
+	if (nee.Reply(senderId, &counted, sizeof counted) == -1)
+		{
+		cout << "Failed reply" << endl;
+		exit(EXIT_FAILURE);	
+		}
+	}
+
+cout << "proxies=" << counted << " receives=" << receives << endl;
+
+return 0;
+}
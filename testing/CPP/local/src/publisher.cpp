@@ -0,0 +1,74 @@
+/*******************************************************************************
+FILE:			publisher.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program makes a publish/subscribe channel and publishes #
+				messages of 1024 integers on it, one every msecs milliseconds,
+				each filled with its own count. It then closes the channel so
+				that its subscribers finish. It is meant to work with 
+				subscriber.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const int memLimit = 1024, depth = 64;
+
+int main(int argc, char **argv)
+{
+int channel, limit, msecs, out[memLimit];
+
+if (argc != 5)
+	{
+	cout << "incorrect cmd line: publisher publisherName channelName # msecs";
+	cout << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+limit = atoi(argv[3]);
+msecs = atoi(argv[4]);
+
+if ((channel = nee.OpenChannel(argv[2], sizeof out, depth)) == -1)
+	{
+	cout << "Can't open channel " << argv[2] << endl;
+	exit(EXIT_FAILURE);
+	}
+
+// time for the subscribers to subscribe
+sleep(1);
+
+for (int i = 1; i <= limit; i++)
+	{
+	for (int j = 0; j < memLimit; j++)
+		out[j] = i;
+
+	if (nee.Publish(channel, out, sizeof out) == -1)
+		{
+		cout << "Failed publish" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+	if (msecs > 0)
+		usleep(msecs * 1000);
+	}
+
+cout << "published=" << limit << endl;
+
+if (nee.CloseChannel(channel) == -1)
+	{
+	cout << "Failed close" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+return 0;
+}
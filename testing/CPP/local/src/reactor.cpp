@@ -0,0 +1,131 @@
+/*******************************************************************************
+FILE:			reactor.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This file tests the reactor. It runs with sender.c. Messages
+				and proxies are received as by selector.cpp, the message
+				count is shown every second and a line of "quit" on stdin
+				ends it.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sim.h>
+
+using namespace std;
+
+static SRY *neewum;
+static unsigned cnt = 0;
+
+static int hndlMsg(SIM_VIEW *, void *);
+static int hndlStdin(int, void *);
+static int hndlTimer(int, void *);
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int buf[memLimit];
+string pname;
+
+if (argc != 2)
+	{
+	cout << "incorrect cmd line: reactor reactorName" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+pname = argv[1];
+
+SRY nee(pname);
+neewum = &nee;
+
+// messages copied into buf, stdin lines and a 1 second timer
+if (nee.ReactorMsg(hndlMsg, nullptr, buf, sizeof buf) == -1 ||
+	nee.ReactorFd(STDIN_FILENO, hndlStdin, nullptr) == -1 ||
+	nee.ReactorTimer(1000, true, hndlTimer, nullptr) == -1)
+	{
+	cout << "Failed reactor set up" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+if (nee.Reactor() == -1)
+	{
+	cout << "Failed reactor" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	hndlMsg(SIM_VIEW *, void *)
+
+PURPOSE:	Reply to a message or show a proxy.
+
+RETURNS:	0, carry on
+**********************************************************************/
+
+static int hndlMsg(SIM_VIEW *view, void *arg)
+{
+(void)arg;
+
+if (view->sender == nullptr)
+	{
+	cout << "trigger proxy=" << view->nbytes << endl;
+	return 0;
+	}
+
+cout << "Got message " << ++cnt << endl;
+
+if (neewum->Reply(view->sender, nullptr, 0) == -1)
+	{
+	cout << "Failed reply" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+return 0;
+}
+
+/**********************************************************************
+FUNCTION:	hndlStdin(int, void *)
+
+PURPOSE:	Read a line from stdin.
+
+RETURNS:	0, carry on; -1 on quit or end of file
+**********************************************************************/
+
+static int hndlStdin(int fd, void *arg)
+{
+char line[80];
+ssize_t n;
+(void)arg;
+
+n = read(fd, line, sizeof line - 1);
+if (n <= 0)
+	return -1;
+line[n] = 0;
+
+return strncmp(line, "quit", 4) ? 0 : -1;
+}
+
+/**********************************************************************
+FUNCTION:	hndlTimer(int, void *)
+
+PURPOSE:	Show the number of messages so far.
+
+RETURNS:	0, carry on
+**********************************************************************/
+
+static int hndlTimer(int timer, void *arg)
+{
+(void)timer;
+(void)arg;
+
+cout << "messages=" << cnt << endl;
+
+return 0;
+}
@@ -3,18 +3,47 @@ FILE:			sryLog.c
 
 DATE:			February 4, 2025
 
-DESCRIPTION:	This program tests the sryLog() function.
+DESCRIPTION:	This program tests the sryLog() function. It then logs a burst 
+				of the same line, most of which are rate limited, and times 
+				the calls, logs at each of the sryLogLevel() levels and writes
+				the log ring out with sryLogFlush().
 
 AUTHOR:			John Collins
 *******************************************************************************/
 
+#include <iostream>
+#include <sys/time.h>
 #include <sim.h>
 
+using namespace std;
+
+const int numLines = 10000;
+
 int main()
 {
 int a = 1, b = 2, c = 3;
+struct timeval start, stop;
+long total;
 
 sryLog("this a test of the emergency broadcast system: %d %d %d", a, b, c);
+
+gettimeofday(&start, NULL);
+for (int i = 0; i < numLines; i++)
+	sryLog("srylog: burst line %d\n", i);
+gettimeofday(&stop, NULL);
+
+total = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+cout << "srylog: " << numLines << " lines in " << total << " microseconds" << endl;
+
+sryLogLevel(SIM_LOG_WARN, "srylog: a warning\n");
+sryLogLevel(SIM_LOG_INFO, "srylog: some information\n");
+sryLogLevel(SIM_LOG_DEBUG, "srylog: debugging, logged only at SIM_LOG_LEVEL=debug\n");
+
+if (sryLogFlush() == -1)
+	{
+	cout << "Failed flush" << endl;
+	return EXIT_FAILURE;
+	}
 	
-return 0;
+return EXIT_SUCCESS;
 }
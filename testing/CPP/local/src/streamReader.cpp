@@ -0,0 +1,80 @@
+/*******************************************************************************
+FILE:			streamReader.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program makes a stream, with a policy of block, drop or
+				fail for when it is full, and reads its records, taking msecs
+				milliseconds over every thousand of them, until the producer
+				closes. Each record must be whole and come after the one 
+				before; the gaps in the counts must be the records dropped.
+				It is meant to work with streamer.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const unsigned depth = 1024;
+
+struct Record
+	{
+	unsigned long seq;
+	unsigned long check;
+	};
+
+int main(int argc, char **argv)
+{
+unsigned long count = 0, gaps = 0, torn = 0, last = 0;
+int stream, policy, msecs;
+Record rec;
+
+if (argc != 5)
+	{
+	cout << "incorrect cmd line: streamReader readerName streamName ";
+	cout << "block|drop|fail msecs" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+if (!strcmp(argv[3], "drop"))
+	policy = SIM_STREAM_DROP_OLDEST;
+else if (!strcmp(argv[3], "fail"))
+	policy = SIM_STREAM_FAIL;
+else
+	policy = SIM_STREAM_BLOCK;
+msecs = atoi(argv[4]);
+
+SRY nee(argv[1]);
+
+if ((stream = nee.OpenStream(argv[2], sizeof rec, depth, policy, 0)) == -1)
+	{
+	cout << "Can't open stream " << argv[2] << endl;
+	exit(EXIT_FAILURE);
+	}
+
+// read until the producer closes
+while (nee.ReadStream(stream, &rec, sizeof rec) == sizeof rec)
+	{
+	if (rec.check != ~rec.seq || rec.seq <= last)
+		torn++;
+	else if (rec.seq != last + 1)
+		gaps += rec.seq - last - 1;
+	last = rec.seq;
+
+	if (++count % 1000 == 0 && msecs > 0)
+		usleep(msecs * 1000);
+	}
+
+cout << "read=" << count << " dropped=" << gaps << " lost=";
+cout << nee.getStreamLost(stream) << " last=" << last << " torn=" << torn << endl;
+
+return (torn || gaps != (unsigned long)nee.getStreamLost(stream)) ? 
+														EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+FILE:			streamer.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program connects to a stream as its producer and writes
+				# records to it, reserving batch of them at a time before 
+				committing them all at once. Each record holds its own count
+				and that count's complement. A record refused by a full 
+				stream is tried again. It is meant to work with streamReader
+				and the C streamReceiver.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+struct Record
+	{
+	unsigned long seq;
+	unsigned long check;
+	};
+
+int main(int argc, char **argv)
+{
+struct timeval start, stop;
+unsigned long limit, refused = 0;
+long usecs;
+int stream, batch;
+Record *rec;
+
+if (argc != 5)
+	{
+	cout << "incorrect cmd line: streamer streamerName streamName # batch";
+	cout << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+limit = strtoul(argv[3], NULL, 10);
+batch = atoi(argv[4]);
+if (batch < 1)
+	batch = 1;
+
+if ((stream = nee.ConnectStream(argv[2])) == -1)
+	{
+	cout << "Can't connect to stream " << argv[2] << endl;
+	exit(EXIT_FAILURE);
+	}
+
+gettimeofday(&start, NULL);
+
+for (unsigned long i = 1; i <= limit; )
+	{
+	for (int j = 0; j < batch && i <= limit; j++, i++)
+		{
+		rec = (Record *)nee.ReserveStream(stream, sizeof(Record));
+		if (rec == NULL)
+			{
+			// a closed stream fails the commit too
+			if (nee.CommitStream(stream) == -1)
+				{
+				cout << "Failed reserve" << endl;
+				exit(EXIT_FAILURE);
+				}
+
+			// full, under SIM_STREAM_FAIL; give the reader a moment
+			refused++;
+			usleep(100);
+			j--;
+			i--;
+			continue;
+			}
+		rec->seq = i;
+		rec->check = ~i;
+		}
+
+	if (nee.CommitStream(stream) == -1)
+		{
+		cout << "Failed commit" << endl;
+		exit(EXIT_FAILURE);
+		}
+	}
+
+gettimeofday(&stop, NULL);
+usecs = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+
+cout << "written=" << limit << " refused=" << refused << " records/sec=";
+cout << (usecs ? limit * 1000000 / usecs : 0) << endl;
+
+if (nee.CloseStream(stream) == -1)
+	{
+	cout << "Failed close" << endl;
+	exit(EXIT_FAILURE);
+	}
+
+return 0;
+}
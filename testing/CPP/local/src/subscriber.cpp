@@ -0,0 +1,67 @@
+/*******************************************************************************
+FILE:			subscriber.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program subscribes to a channel and reads its messages,
+				taking msecs milliseconds over each, until the publisher 
+				closes the channel. Each message must be the one its sequence
+				number says it is, whole; a slow subscriber loses messages to
+				overrun instead. It is meant to work with publisher.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+const int memLimit = 1024;
+
+int main(int argc, char **argv)
+{
+int channel, msecs, in[memLimit], torn = 0;
+unsigned long seq = 0, count = 0;
+
+if (argc != 4)
+	{
+	cout << "incorrect cmd line: subscriber subscriberName channelName msecs";
+	cout << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+msecs = atoi(argv[3]);
+
+if ((channel = nee.Subscribe(argv[2])) == -1)
+	{
+	cout << "Can't subscribe to channel " << argv[2] << endl;
+	exit(EXIT_FAILURE);
+	}
+
+// fails once the channel is closed and all of it read
+while (nee.ReadChannel(channel, in, sizeof in, &seq) != -1)
+	{
+	count++;
+	// the publisher fills message n with n
+	for (int j = 0; j < memLimit; j++)
+		if (in[j] != (int)seq)
+			{
+			torn++;
+			break;
+			}
+
+	if (msecs > 0)
+		usleep(msecs * 1000);
+	}
+
+cout << "read=" << count << " lost=" << nee.getChannelLost(channel);
+cout << " last=" << seq << " torn=" << torn << endl;
+
+return torn ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+FILE:			timedReceiver.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program receives messages with ReceiveTimed() and replies
+				them back as they are. Every slowEvery'th message is held for
+				msecs milliseconds before the reply, by which time its sender
+				may have given up on it. Should no message come for a second
+				the receiver says so and carries on. It is meant to work with
+				timedSender.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <sim.h>
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;	
+int msgSize, buf[memLimit], slowEvery, msecs;
+void *senderId;
+unsigned int cnt = 0, late = 0;
+
+if (argc != 4)
+	{
+	cout << "incorrect cmd line: timedReceiver receiverName slowEvery msecs";
+	cout << endl;
+	exit(EXIT_FAILURE);
+	}
+
+slowEvery = atoi(argv[2]);
+msecs = atoi(argv[3]);
+
+SRY nee(argv[1]);
+
+while (true)
+	{
+	msgSize = nee.ReceiveTimed(&senderId, buf, sizeof buf, 1000);
+	if (msgSize == -1 && errno == ETIMEDOUT)
+		{
+		cout << "idle: replied=" << cnt << " given up on=" << late << endl;
+		continue;
+		}
+	if (msgSize == -1)
+		{
+		cout << "Failed receive" << endl;
+		exit(EXIT_FAILURE);
+		}
+
+	if (msgSize < -1)
+		{
+		cout << "trigger proxy=" << nee.returnProxy(msgSize) << endl;
+		continue;
+		}
+
+	if (slowEvery > 0 && buf[0] % slowEvery == 0)
+		usleep(msecs * 1000);
+
+	// the sender may well have given up on a slow reply
+	if (nee.Reply(senderId, buf, msgSize) == -1)
+		late++;
+	else
+		cnt++;
+	}
+
+return 0;
+}
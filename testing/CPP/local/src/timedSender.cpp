@@ -0,0 +1,73 @@
+/*******************************************************************************
+FILE:			timedSender.cpp
+
+DATE:			October 18, 2026
+
+DESCRIPTION:	This program sends # numbered messages to a receiver with
+				SendTimed(), giving up on any reply that takes longer than
+				msecs milliseconds. Each reply must carry the number of its 
+				own message; a late reply to a message given up on must never
+				turn up as the reply to a later one. It is meant to work with
+				timedReceiver.
+
+AUTHOR:			FC Software Inc.
+*******************************************************************************/
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sim.h>
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+const int memLimit = 1024;
+int out[memLimit], in[memLimit];
+int receiverId, limit, msecs, rc;
+int replies = 0, timeouts = 0, failures = 0;
+string hname;
+
+if (argc != 5)
+	{
+	cout << "incorrect cmd line: timedSender senderName receiverName # msecs";
+	cout << endl;
+	exit(EXIT_FAILURE);
+	}
+
+SRY nee(argv[1]);
+
+limit = atoi(argv[3]);
+msecs = atoi(argv[4]);
+
+if ((receiverId = nee.LocateTimed(hname, argv[2], sizeof out, SIM_LOCAL, 
+															msecs)) == -1)
+	{
+	cout << "Can't locate receiver " << argv[2] << endl;
+	exit(EXIT_FAILURE);
+	}
+
+for (int j = 0; j < limit; j++)
+	{
+	out[0] = j;
+	in[0] = -1;
+	rc = nee.SendTimed(receiverId, out, sizeof out, in, sizeof in, msecs);
+	if (rc == -1 && errno == ETIMEDOUT)
+		timeouts++;
+	else if (rc == -1)
+		failures++;
+	else if (in[0] != j)
+		{
+		cout << "reply " << in[0] << " to message " << j << endl;
+		failures++;
+		}
+	else
+		replies++;
+	}
+
+cout << "replies=" << replies << " timeouts=" << timeouts << " failures=";
+cout << failures << endl;
+
+return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -3,8 +3,10 @@ FILE:			simClean.cpp
 
 DATE:			February 11, 2025
 
-DESCRIPTION:	This utility cleans up orphaned SIMPL fifos which can be left over
-				from untrappable signals such as SIGKILL.
+DESCRIPTION:	This utility cleans up orphaned SIMPL fifos, futex transport
+				mailboxes, proxy tables, publish/subscribe channel files and
+				stream files which can be left over from untrappable signals
+				such as SIGKILL.
 
 AUTHOR:			John Collins
 *******************************************************************************/
@@ -21,7 +23,8 @@ using namespace std::filesystem;
 
 int main()
 {
-string fifoPath("/var/tmp"), fifoNameR, fifoNameY;
+string fifoPath("/var/tmp"), fifoNameR, fifoNameY, mboxName, proxyName, chanName,
+		subName, streamName;
 pid_t pid = 0;
 char *p;
 
@@ -40,23 +43,39 @@ if (exists(fifoPath) == false)
 // set the name patterns of the fifos to be searched for
 fifoNameR = fifoPath + "/R_";
 fifoNameY = fifoPath + "/Y_";
+mboxName = fifoPath + "/M_";
+proxyName = fifoPath + "/Q_";
+chanName = fifoPath + "/P_";
+subName = fifoPath + "/S_";
+streamName = fifoPath + "/T_";
 
 // eg. looking for /var/tmp/R_noodle.12345
 for (const auto& file : directory_iterator(fifoPath))
 	{
-	// ignore directory entry if not a fifo
-	if (!is_fifo(file))
-		continue;
-	
 	// convert iterator to a string for comparison purposes
 	string s = file.path().string();
 
-	// is the entry either the receive or the reply fifo? 
+	// ignore directory entry if not a fifo or a mailbox, proxy table, channel or
+	// stream file
+	if (!is_fifo(file) && (!is_regular_file(file) ||
+				(s.compare(0, mboxName.length(), mboxName, 0, mboxName.length()) &&
+				s.compare(0, proxyName.length(), proxyName, 0, proxyName.length()) &&
+				s.compare(0, chanName.length(), chanName, 0, chanName.length()) &&
+				s.compare(0, streamName.length(), streamName, 0, streamName.length()))))
+		continue;
+
+	// is the entry the receive, reply or subscriber fifo, mailbox, proxy table,
+	// channel or stream? 
 	if (!s.compare(0, fifoNameR.length(), fifoNameR, 0, fifoNameR.length()) ||
-		!s.compare(0, fifoNameY.length(), fifoNameY, 0, fifoNameY.length()))
+		!s.compare(0, fifoNameY.length(), fifoNameY, 0, fifoNameY.length()) ||
+		!s.compare(0, mboxName.length(), mboxName, 0, mboxName.length()) ||
+		!s.compare(0, proxyName.length(), proxyName, 0, proxyName.length()) ||
+		!s.compare(0, chanName.length(), chanName, 0, chanName.length()) ||
+		!s.compare(0, subName.length(), subName, 0, subName.length()) ||
+		!s.compare(0, streamName.length(), streamName, 0, streamName.length()))
 		{
-		// get the pid extension from the entry
-		int pos = s.find(".");
+		// get the pid extension from the entry; the last '.' in the name
+		int pos = s.rfind(".");
 		string sub = s.substr(pos + 1);
 		pid = stoi(sub);
 
@@ -13,6 +13,7 @@ AUTHOR:			John Collins
 #include <cstring>
 #include <cerrno>
 #include <filesystem>
+#include <sim.h>
 
 using namespace std;
 using namespace std::filesystem;
@@ -20,6 +21,8 @@ using namespace std::filesystem;
 int main()
 {
 string fifoPath("/var/tmp"), fifoNameR;
+static SIM_NAME names[MAX_NUM_REGISTRY_ENTRIES];
+int count;
 char *p;
 
 // get the fifo directory if exported variable exists
@@ -41,7 +44,16 @@ fifoNameR = fifoPath + "/R_";
 cout << "SIM Name:Pid" << endl;
 cout << "============" << endl;
 
-// eg. looking for /var/tmp/R_noodle.12345
+// the running sim processes according to the name registry
+count = getSimNames(names, MAX_NUM_REGISTRY_ENTRIES);
+if (count != -1)
+	{
+	for (int i = 0; i < count; i++)
+		cout << names[i].name << ":" << names[i].pid << endl;
+	return 0;
+	}
+
+// no registry; eg. looking for /var/tmp/R_noodle.12345
 for (const auto& file : directory_iterator(fifoPath))
 	{
 	// ignore directory entry if not a fifo
@@ -14,6 +14,7 @@ AUTHOR:			John Collins
 #include <cerrno>
 #include <csignal>
 #include <filesystem>
+#include <sim.h>
 
 using namespace std;
 using namespace std::filesystem;
@@ -44,38 +45,15 @@ if (exists(fifoPath) == false)
 	exit(EXIT_FAILURE);
 	}
 
-// set the names of the fifos to be searched for (without pid extension)
-fifoNameR = fifoPath + "/R_" + argv[1] + ".";
-fifoNameY = fifoPath + "/Y_" + argv[1] + ".";
+// look up the program by its SIM name
+pid = getSimPid(argv[1]);
 
-// eg. looking for /var/tmp/R_noodle.12345
-for (const auto& file : directory_iterator(fifoPath))
-	{
-	// ignore directory entry if not a fifo
-	if (!is_fifo(file))
-		continue;
-	
-	// convert iterator to a string for comparison purposes
-	string s = file.path().string();
-
-	// is the entry either the receive or the reply fifo? 
-	if (!s.compare(0, fifoNameR.length(), fifoNameR, 0, fifoNameR.length()) ||
-		!s.compare(0, fifoNameY.length(), fifoNameY, 0, fifoNameY.length()))
-		{
-		// get the pid extension from the entry
-		int pos = s.find(".");
-		string sub = s.substr(pos + 1);
-		pid = stoi(sub);
-	
-		// complete the fifo names for removal purposes
-		fifoNameR += sub;
-		fifoNameY += sub;
-		break;
-		}
-	}
+// set the names of the fifos for removal purposes, eg. /var/tmp/R_noodle.12345
+fifoNameR = fifoPath + "/R_" + argv[1] + "." + to_string(pid);
+fifoNameY = fifoPath + "/Y_" + argv[1] + "." + to_string(pid);
 
-// found a sim fifo by that name? (then pid will be nonzero)
-if (pid)
+// found a sim program by that name? (then pid will be positive)
+if (pid > 0)
 	{
 	// terminate this process
 	kill(pid, SIGTERM);